@@ -0,0 +1,137 @@
+/**
+ * @file generators.cpp
+ * @brief Implements the synthetic DAG generators used by the benchmark harness.
+ * @version 1.1.0
+ */
+
+#include "generators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace dagra::bench {
+
+    namespace {
+
+        std::string task_id(std::size_t index) {
+            return "t" + std::to_string(index);
+        }
+
+        core::Task make_task(std::size_t index) {
+            core::Task task;
+            task.id = task_id(index);
+            task.command = "true";
+            return task;
+        }
+
+    } // namespace
+
+    const std::vector<Shape>& all_shapes() {
+        static const std::vector<Shape> shapes = {Shape::Chain, Shape::FanOut, Shape::Layered, Shape::Lattice};
+        return shapes;
+    }
+
+    const char* shape_name(Shape shape) {
+        switch (shape) {
+        case Shape::Chain:
+            return "chain";
+        case Shape::FanOut:
+            return "fan-out";
+        case Shape::Layered:
+            return "layered";
+        case Shape::Lattice:
+            return "lattice";
+        }
+        return "unknown";
+    }
+
+    std::vector<core::Task> generate(Shape shape, std::size_t nodes, std::uint64_t seed) {
+        std::vector<core::Task> tasks;
+        tasks.reserve(nodes);
+
+        switch (shape) {
+        case Shape::Chain:
+            for (std::size_t i = 0; i < nodes; ++i) {
+                tasks.push_back(make_task(i));
+                if (i > 0) {
+                    tasks.back().dependencies.push_back(task_id(i - 1));
+                }
+            }
+            break;
+
+        case Shape::FanOut:
+            for (std::size_t i = 0; i < nodes; ++i) {
+                tasks.push_back(make_task(i));
+                if (i == 0) {
+                    continue;
+                }
+                if (i + 1 < nodes || nodes <= 2) {
+                    tasks.back().dependencies.push_back(task_id(0));
+                } else {
+                    tasks.back().dependencies.reserve(nodes - 2);
+                    for (std::size_t j = 1; j + 1 < nodes; ++j) {
+                        tasks.back().dependencies.push_back(task_id(j));
+                    }
+                }
+            }
+            break;
+
+        case Shape::Layered: {
+            std::mt19937_64 rng(seed);
+            const std::size_t width = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(nodes)));
+            for (std::size_t i = 0; i < nodes; ++i) {
+                tasks.push_back(make_task(i));
+                const std::size_t layer_start = i / width * width;
+                if (layer_start == 0) {
+                    continue;
+                }
+                const std::size_t previous = layer_start - width;
+                std::uniform_int_distribution<std::size_t> pick(0, width - 1);
+                const std::size_t edges = 1 + rng() % 3;
+                for (std::size_t e = 0; e < edges; ++e) {
+                    std::string dep = task_id(previous + pick(rng));
+                    auto& deps = tasks.back().dependencies;
+                    if (std::find(deps.begin(), deps.end(), dep) == deps.end()) {
+                        deps.push_back(std::move(dep));
+                    }
+                }
+            }
+            break;
+        }
+
+        case Shape::Lattice: {
+            const std::size_t side = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(nodes)));
+            for (std::size_t row = 0; row < side; ++row) {
+                for (std::size_t column = 0; column < side; ++column) {
+                    const std::size_t i = row * side + column;
+                    tasks.push_back(make_task(i));
+                    if (row > 0) {
+                        tasks.back().dependencies.push_back(task_id(i - side));
+                    }
+                    if (column > 0) {
+                        tasks.back().dependencies.push_back(task_id(i - 1));
+                    }
+                }
+            }
+            break;
+        }
+        }
+        return tasks;
+    }
+
+    std::string to_yaml(const std::vector<core::Task>& tasks) {
+        std::string yaml = "tasks:\n";
+        for (const auto& task : tasks) {
+            yaml += "  - id: " + task.id + "\n    command: \"" + task.command + "\"\n";
+            if (!task.dependencies.empty()) {
+                yaml += "    depends_on: [";
+                for (std::size_t i = 0; i < task.dependencies.size(); ++i) {
+                    yaml += (i == 0 ? "" : ", ") + task.dependencies[i];
+                }
+                yaml += "]\n";
+            }
+        }
+        return yaml;
+    }
+
+} // namespace dagra::bench
@@ -0,0 +1,55 @@
+/**
+ * @file generators.hpp
+ * @brief Declares the synthetic DAG generators used by the benchmark harness.
+ * @version 1.1.0
+ *
+ * This file contains the graph shapes that `dagra_bench` measures. Every
+ * generator is deterministic for a given size (and seed), so results from
+ * different builds are comparable.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dagra::bench {
+
+    /// @brief The synthetic graph shapes.
+    enum class Shape {
+        Chain,   ///< t0 <- t1 <- ... : no parallelism, maximal depth.
+        FanOut,  ///< One root, n-2 independent middle tasks, one sink depending on all of them.
+        Layered, ///< Random layered DAG: ~sqrt(n) layers, each task depends on up to 3 tasks of the previous layer.
+        Lattice  ///< Diamond lattice: a grid where each cell depends on its upper and left neighbours.
+    };
+
+    /// @brief All shapes, in reporting order.
+    const std::vector<Shape>& all_shapes();
+
+    /// @brief The name of a shape as used in benchmark names (e.g. "fan-out").
+    const char* shape_name(Shape shape);
+
+    /**
+     * @brief Generates a graph of roughly `nodes` tasks.
+     *
+     * Tasks are named `t<N>` and emitted in dependency order. The lattice is
+     * rounded down to a square, so it may contain slightly fewer tasks.
+     *
+     * @param shape The shape to generate.
+     * @param nodes The number of tasks.
+     * @param seed Seed for the random shapes.
+     * @return The tasks, each with a no-op `true` command.
+     */
+    std::vector<core::Task> generate(Shape shape, std::size_t nodes, std::uint64_t seed = 42);
+
+    /**
+     * @brief Renders tasks as a dagra YAML configuration.
+     * @param tasks The tasks to render.
+     * @return The YAML text.
+     */
+    std::string to_yaml(const std::vector<core::Task>& tasks);
+
+} // namespace dagra::bench
@@ -0,0 +1,304 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of `dagra_bench`, the scheduling overhead benchmark.
+ * @version 1.1.0
+ *
+ * Generates synthetic graphs of increasing size and times YAML parsing,
+ * compiled plan loading, graph construction, validation, task fusion and
+ * per-task dispatch through the Runner with an in-process no-op executor. Results are written as JSON so that
+ * runs can be compared across commits.
+ *
+ * Usage: dagra_bench [--max-nodes N] [--repetitions R] [-j N] [--filter TEXT] [--out FILE]
+ */
+
+#include "generators.hpp"
+#include "dagra/cache/plan_cache.hpp"
+#include "dagra/cli/parser.hpp"
+#include "dagra/core/analysis.hpp"
+#include "dagra/core/dag.hpp"
+#include "dagra/core/fusion.hpp"
+#include "dagra/core/selection.hpp"
+#include "dagra/execution/runner.hpp"
+#include "dagra/utils/json.hpp"
+#include "dagra/utils/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    /// @brief Command-line settings of a benchmark run.
+    struct BenchOptions {
+        std::size_t max_nodes = 100000;
+        std::size_t repetitions = 3;
+        std::size_t jobs = 0;
+        std::string filter;
+        std::string out_path;
+    };
+
+    /// @brief The timings of one benchmark.
+    struct Result {
+        std::string name;
+        std::string operation;
+        std::string shape;
+        std::size_t nodes = 0;
+        std::size_t edges = 0;
+        std::vector<double> seconds;
+    };
+
+    /// @brief A stream buffer that discards everything, used to silence the logger while timing.
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    BenchOptions parse_options(int argc, char* argv[]) {
+        BenchOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + arg + ".");
+                }
+                return argv[++i];
+            };
+            if (arg == "--max-nodes") {
+                options.max_nodes = std::stoul(value());
+            } else if (arg == "--repetitions") {
+                options.repetitions = std::max<std::size_t>(1, std::stoul(value()));
+            } else if (arg == "-j" || arg == "--jobs") {
+                options.jobs = std::stoul(value());
+            } else if (arg == "--filter") {
+                options.filter = value();
+            } else if (arg == "--out") {
+                options.out_path = value();
+            } else {
+                throw std::runtime_error("Usage: dagra_bench [--max-nodes N] [--repetitions R] [-j N] "
+                                         "[--filter TEXT] [--out FILE]");
+            }
+        }
+        return options;
+    }
+
+    /// @brief Times `body` once; `setup` runs beforehand and is not timed.
+    double time_once(const std::function<void()>& setup, const std::function<void()>& body) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        const std::size_t middle = values.size() / 2;
+        return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    void write_json(std::ostream& out, const BenchOptions& options, const std::vector<Result>& results) {
+        std::string json = "{\n  \"context\": {\"date\": \"" +
+                           dagra::utils::format_timestamp(std::chrono::system_clock::now()) +
+                           "\", \"repetitions\": " + std::to_string(options.repetitions) +
+                           ", \"jobs\": " + std::to_string(options.jobs) + "},\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            const double best = *std::min_element(r.seconds.begin(), r.seconds.end());
+            const double mid = median(r.seconds);
+            json += i == 0 ? "\n    {" : ",\n    {";
+            json += "\"name\": ";
+            dagra::utils::append_json_string(json, r.name);
+            json += ", \"operation\": \"" + r.operation + "\", \"shape\": \"" + r.shape +
+                    "\", \"nodes\": " + std::to_string(r.nodes) + ", \"edges\": " + std::to_string(r.edges) +
+                    ", \"min_ms\": " + std::to_string(best * 1e3) + ", \"median_ms\": " + std::to_string(mid * 1e3) +
+                    ", \"ns_per_node\": " + std::to_string(r.nodes > 0 ? mid * 1e9 / static_cast<double>(r.nodes) : 0.0) +
+                    "}";
+        }
+        json += "\n  ]\n}\n";
+        out << json;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // The runner logs every task; keep that off the terminal but still pay for it.
+    NullBuffer null_buffer;
+    std::streambuf* real_cout = std::cout.rdbuf(&null_buffer);
+    std::streambuf* real_cerr = std::cerr.rdbuf(&null_buffer);
+    std::ostream progress(real_cerr);
+
+    const fs::path yaml_path = fs::temp_directory_path() / "dagra_bench.yaml";
+    const fs::path plan_path = fs::temp_directory_path() / "dagra_bench.plan";
+    std::vector<Result> results;
+
+    for (std::size_t nodes = 100; nodes <= options.max_nodes; nodes *= 10) {
+        for (dagra::bench::Shape shape : dagra::bench::all_shapes()) {
+            const std::vector<dagra::core::Task> tasks = dagra::bench::generate(shape, nodes);
+            std::size_t edges = 0;
+            for (const auto& task : tasks) {
+                edges += task.dependencies.size();
+            }
+
+            auto measure = [&](const std::string& operation, const std::function<void()>& setup,
+                               const std::function<void()>& body) {
+                Result result;
+                result.operation = operation;
+                result.shape = dagra::bench::shape_name(shape);
+                result.nodes = tasks.size();
+                result.edges = edges;
+                result.name = operation + "/" + result.shape + "/" + std::to_string(nodes);
+                if (!options.filter.empty() && result.name.find(options.filter) == std::string::npos) {
+                    return;
+                }
+                progress << "  " << result.name << std::flush;
+                for (std::size_t rep = 0; rep < options.repetitions; ++rep) {
+                    result.seconds.push_back(time_once(setup, body));
+                }
+                dagra::utils::Logger::flush();
+                progress << "  " << median(result.seconds) * 1e3 << " ms" << std::endl;
+                results.push_back(std::move(result));
+            };
+
+            measure(
+                "parse_yaml",
+                [&]() {
+                    std::ofstream(yaml_path, std::ios::trunc) << dagra::bench::to_yaml(tasks);
+                },
+                [&]() { dagra::cli::Parser::parse_yaml(yaml_path.string()); });
+
+            measure(
+                "load_plan",
+                [&]() {
+                    dagra::core::Dag compiled;
+                    for (const auto& task : tasks) {
+                        compiled.add_task(task);
+                    }
+                    compiled.validate();
+                    dagra::cache::save_plan(compiled, {}, plan_path.string(), 0);
+                },
+                [&]() {
+                    dagra::core::Dag loaded;
+                    std::map<std::string, double> pools;
+                    if (!dagra::cache::load_plan(plan_path.string(), 0, loaded, pools)) {
+                        throw std::runtime_error("Failed to load the compiled plan.");
+                    }
+                });
+
+            std::vector<dagra::core::Task> copy;
+            measure(
+                "add_task", [&]() { copy = tasks; },
+                [&]() {
+                    dagra::core::Dag dag;
+                    dag.reserve(copy.size());
+                    for (auto& task : copy) {
+                        dag.add_task(std::move(task));
+                    }
+                });
+
+            dagra::core::Dag dag;
+            measure(
+                "validate",
+                [&]() {
+                    dag = dagra::core::Dag();
+                    for (const auto& task : tasks) {
+                        dag.add_task(task);
+                    }
+                },
+                [&]() { dag.validate(); });
+
+            // The middle task's closure is a fraction of most shapes.
+            const std::string target = tasks[tasks.size() / 2].id;
+            measure(
+                "select",
+                [&]() {
+                    dag = dagra::core::Dag();
+                    for (const auto& task : tasks) {
+                        dag.add_task(task);
+                    }
+                    dag.validate();
+                },
+                [&]() {
+                    const auto closure = dag.dependency_closure(dagra::core::select_targets(dag, {target}, {}));
+                    dagra::core::Dag selected = dag.subgraph(closure);
+                });
+
+            measure(
+                "fuse",
+                [&]() {
+                    dag = dagra::core::Dag();
+                    for (const auto& task : tasks) {
+                        dag.add_task(task);
+                    }
+                    dag.validate();
+                },
+                [&]() { dagra::core::FusedGraph fused = dagra::core::fuse_tasks(dag, {}); });
+
+            measure(
+                "analyze",
+                [&]() {
+                    dag = dagra::core::Dag();
+                    for (const auto& task : tasks) {
+                        dag.add_task(task);
+                    }
+                    dag.validate();
+                },
+                [&]() {
+                    dagra::core::GraphAnalysis analysis =
+                        dagra::core::analyze_graph(dag, std::vector<double>(dag.size(), 1.0));
+                });
+
+            measure(
+                "dispatch",
+                [&]() {
+                    dag = dagra::core::Dag();
+                    for (const auto& task : tasks) {
+                        dag.add_task(task);
+                    }
+                    dag.validate();
+                },
+                [&]() {
+                    dagra::execution::RunnerOptions runner_options;
+                    runner_options.jobs = options.jobs;
+                    runner_options.executor = [](const dagra::core::Task&) { return true; };
+                    dagra::execution::Runner runner(dag, runner_options);
+                    runner.execute_all();
+                });
+        }
+    }
+
+    std::error_code ec;
+    fs::remove(yaml_path, ec);
+    fs::remove(plan_path, ec);
+    dagra::utils::Logger::flush();
+    std::cout.rdbuf(real_cout);
+    std::cerr.rdbuf(real_cerr);
+
+    if (options.out_path.empty()) {
+        write_json(std::cout, options, results);
+    } else {
+        std::ofstream out(options.out_path, std::ios::trunc);
+        write_json(out, options, results);
+        if (!out) {
+            std::cerr << "Failed to write " << options.out_path << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file execution_cache.hpp
+ * @brief Declares the persistent, content-hash keyed execution cache.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `ExecutionCache` class and the
+ * cache key helpers. A task's key covers its command, environment, the
+ * contents of its declared input files and the keys of its dependencies.
+ * When a task's key matches the one recorded after its last successful run
+ * and its outputs still exist, the Runner skips it.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dagra::cache {
+
+    /**
+     * @brief Computes the cache key of a task.
+     * @param task The task whose command, environment and inputs are hashed.
+     * @param dependency_keys The keys of the task's dependencies, in declaration order.
+     * @param key Receives the computed key.
+     * @return False if an input file could not be read, in which case the task
+     *         must simply be run.
+     */
+    bool compute_key(const core::Task& task, const std::vector<std::uint64_t>& dependency_keys, std::uint64_t& key);
+
+    /**
+     * @brief Checks that every declared output of a task exists.
+     * @param task The task to check.
+     * @return True if all outputs exist (trivially true when none are declared).
+     */
+    bool outputs_exist(const core::Task& task);
+
+    /**
+     * @class ExecutionCache
+     * @brief A memory-mapped table from task ID hashes to the key of their last successful run.
+     *
+     * The on-disk file is an open-addressing hash table of fixed-size 16-byte
+     * slots behind a small header, so opening it is a single `mmap` and each
+     * lookup touches one or two cache lines. Lookups are lock-free and may be
+     * made from any thread; new entries are buffered in memory and written out
+     * by `save()`, which rewrites the file atomically.
+     */
+    class ExecutionCache {
+    public:
+        ExecutionCache() = default;
+        ~ExecutionCache();
+        ExecutionCache(const ExecutionCache&) = delete;
+        ExecutionCache& operator=(const ExecutionCache&) = delete;
+
+        /**
+         * @brief Maps an existing cache file. A missing or corrupt file yields an empty cache.
+         * @param path The cache file path.
+         */
+        void open(const std::string& path);
+
+        /// @brief True once `open` has been called.
+        bool is_open() const;
+
+        /**
+         * @brief Looks up the key recorded for a task.
+         * @param task_id The task ID.
+         * @param key Receives the recorded key.
+         * @return True if an entry exists.
+         */
+        bool lookup(const std::string& task_id, std::uint64_t& key) const;
+
+        /**
+         * @brief Records the key of a successful run. Thread-safe.
+         * @param task_id The task ID.
+         * @param key The key the task ran with.
+         */
+        void store(const std::string& task_id, std::uint64_t key);
+
+        /**
+         * @brief Writes the merged table back to disk if anything was stored.
+         * @throw std::runtime_error If the file cannot be written.
+         */
+        void save();
+
+    private:
+        /// @brief One slot of the on-disk table; `id_hash == 0` marks an empty slot.
+        struct Slot {
+            std::uint64_t id_hash;
+            std::uint64_t key;
+        };
+
+        void unmap();
+
+        std::string path_;
+        bool open_ = false;
+        void* mapping_ = nullptr;
+        std::size_t mapping_size_ = 0;
+        const Slot* slots_ = nullptr;
+        std::uint32_t capacity_ = 0;
+
+        std::mutex pending_mtx_;
+        std::unordered_map<std::uint64_t, std::uint64_t> pending_;
+    };
+
+} // namespace dagra::cache
@@ -0,0 +1,133 @@
+/**
+ * @file journal.hpp
+ * @brief Declares the append-only journal of completed tasks used by `--resume`.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `RunJournal` class and its key
+ * helper. While a run progresses, every task that completes is appended to
+ * the journal; if dagra is killed or the machine goes down, the next run
+ * with `--resume` replays the journal and only schedules what is left.
+ * Appends are handed to a background thread that writes and `fdatasync`s
+ * them in batches (group commit), so a completion never waits for the disk.
+ */
+
+#pragma once
+
+#include "dagra/core/dag.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dagra::cache {
+
+    /**
+     * @brief Computes the journal key of every task.
+     *
+     * A task's key hashes its ID, command, worker and environment together
+     * with the keys of its dependencies, so editing a task also changes the
+     * keys of everything downstream of it. Input file contents are not read;
+     * that is the execution cache's job.
+     *
+     * @param dag The validated graph.
+     * @return One key per task, indexed by `core::TaskIndex`.
+     */
+    std::vector<std::uint64_t> compute_journal_keys(const core::Dag& dag);
+
+    /**
+     * @class RunJournal
+     * @brief An append-only, crash-safe record of the tasks a run has completed.
+     *
+     * The file is a small header followed by fixed-size 24-byte records of
+     * the task ID hash, the task's journal key and a checksum of both. A
+     * crash can only leave a partial or garbled record at the end; `load`
+     * stops at the first one, and `open` cuts it off before appending.
+     *
+     * `append` only queues the record. A flusher thread writes everything
+     * queued since its last write in one `write` and one `fdatasync`, so
+     * records arriving while the disk is busy share the next sync. A crash
+     * therefore loses at most the records of the last unsynced batch, whose
+     * tasks simply run again.
+     */
+    class RunJournal {
+    public:
+        RunJournal() = default;
+
+        /// @brief Flushes outstanding records and stops the flusher thread.
+        ~RunJournal();
+
+        RunJournal(const RunJournal&) = delete;
+        RunJournal& operator=(const RunJournal&) = delete;
+
+        /**
+         * @brief Reads the records of an earlier run. A missing or foreign file yields no records.
+         * @param path The journal file.
+         */
+        void load(const std::string& path);
+
+        /**
+         * @brief Opens the journal for appending and starts the flusher thread.
+         *
+         * If `load` read records from the same path, they are kept and any
+         * damaged tail is truncated; otherwise the file starts out empty.
+         *
+         * @param path The journal file.
+         * @throw std::runtime_error If the file cannot be created or written.
+         */
+        void open(const std::string& path);
+
+        /**
+         * @brief Checks whether a task was recorded as completed with the given key.
+         * @param task_id The task's ID.
+         * @param key The task's current journal key.
+         * @return True if the loaded journal holds this task with this key.
+         */
+        bool contains(const std::string& task_id, std::uint64_t key) const;
+
+        /// @brief The number of distinct tasks read by `load`.
+        std::size_t loaded() const;
+
+        /**
+         * @brief Queues a completed task for the flusher thread; thread-safe and non-blocking.
+         * @param task_id The task's ID.
+         * @param key The task's journal key.
+         */
+        void append(const std::string& task_id, std::uint64_t key);
+
+        /// @brief Writes and syncs everything queued, then stops the flusher thread.
+        void close();
+
+        /// @brief The number of `fdatasync` batches written so far.
+        std::size_t batches() const;
+
+    private:
+        /// @brief One completed task as stored on disk.
+        struct Record {
+            std::uint64_t id_hash;
+            std::uint64_t key;
+            std::uint64_t check;
+        };
+        static_assert(sizeof(Record) == 24, "journal records are 24 bytes on disk");
+
+        /// @brief The flusher thread: writes and syncs queued records in batches.
+        void flush_loop();
+
+        std::unordered_map<std::uint64_t, std::uint64_t> entries_;
+        std::string loaded_path_;
+        std::size_t loaded_bytes_ = 0;
+
+        std::string path_;
+        int fd_ = -1;
+        std::thread flusher_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::vector<Record> pending_;
+        bool stopping_ = false;
+        std::size_t batches_ = 0;
+    };
+
+} // namespace dagra::cache
@@ -0,0 +1,62 @@
+/**
+ * @file plan_cache.hpp
+ * @brief Declares the compiled, memory-mapped execution plan cache.
+ * @version 1.1.0
+ *
+ * This file contains the functions that compile a validated task graph into
+ * a binary plan file and load it back. A plan is keyed by the content hash
+ * of the configuration file it was compiled from, so as long as the file is
+ * unchanged dagra can skip YAML parsing, dependency resolution and
+ * validation entirely.
+ */
+
+#pragma once
+
+#include "dagra/core/dag.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace dagra::cache {
+
+    /**
+     * @brief Hashes the contents of a configuration file.
+     * @param path The configuration file.
+     * @param hash Receives the hash.
+     * @return False if the file could not be read.
+     */
+    bool hash_config(const std::string& path, std::uint64_t& hash);
+
+    /**
+     * @brief Loads a compiled plan into a graph.
+     *
+     * The file is mapped read-only; task strings are copied out of its
+     * string table and the resolved edge array is installed with
+     * `Dag::assign_resolved`, so no name is looked up and nothing is parsed.
+     *
+     * @param path The plan file.
+     * @param config_hash The current hash of the configuration file.
+     * @param dag Receives the tasks on success; left untouched otherwise.
+     * @param resource_pools Receives the declared pool capacities on success.
+     * @return False if the plan is missing, corrupt, from another format
+     *         version, or was compiled from different configuration contents.
+     */
+    bool load_plan(const std::string& path, std::uint64_t config_hash, core::Dag& dag,
+                   std::map<std::string, double>& resource_pools);
+
+    /**
+     * @brief Compiles a validated graph into a plan file.
+     *
+     * The file holds a fixed-size record per task, the CSR dependency
+     * arrays and a string table, and is replaced atomically.
+     *
+     * @param dag A graph that passed `Dag::validate()`.
+     * @param resource_pools The pool capacities declared by the same configuration.
+     * @param path The plan file to write.
+     * @param config_hash The hash of the configuration file the graph came from.
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    void save_plan(const core::Dag& dag, const std::map<std::string, double>& resource_pools, const std::string& path,
+                   std::uint64_t config_hash);
+
+} // namespace dagra::cache
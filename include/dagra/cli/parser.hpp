@@ -11,23 +11,75 @@
 #pragma once
 
 #include "dagra/core/task.hpp"
+#include "dagra/history/report.hpp"
+#include "dagra/remote/agent.hpp"
+#include "dagra/utils/logger.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <map>
 #include <string>
 #include <vector>
 
 namespace dagra::cli {
 
+    /// @brief The action requested on the command line.
+    enum class Command {
+        Run,    ///< Execute (or dry-run) the tasks of a configuration file.
+        Report, ///< Print the task cost ranking and regressions (`dagra report`).
+        Analyze ///< Print graph statistics, the critical path and redundant edges (`dagra analyze`).
+    };
+
     /**
      * @struct AppOptions
      * @brief Holds the application's configuration parsed from command-line arguments.
      *
      * This includes the path to the main configuration file and any operational
-     * flags, such as whether to perform a dry run.
+     * flags, such as whether to perform a dry run or how many jobs to run at once.
      */
     struct AppOptions {
+        Command command = Command::Run;
         std::string config_filepath;
         bool dry_run = false;
+        std::size_t jobs = 0; ///< Maximum parallel tasks (`-j`); 0 means hardware concurrency.
+        bool keep_going = false; ///< True if `-k`/`--keep-going` was given.
+        bool fuse = false; ///< True if `--fuse` was given: run chains and batches of tasks in single shells.
+        bool event_loop = false; ///< True if `--event-loop` was given: wait for all task commands on one thread.
+        bool resume = false; ///< True if `--resume` was given: skip tasks the run journal records as completed.
+        int kill_grace_seconds = 5; ///< Delay between SIGTERM and SIGKILL when a task times out.
+        std::size_t worker_max_requests = 1000; ///< Tasks a persistent worker runs before it is replaced (`--worker-requests`); 0 means never.
+        bool use_cache = true; ///< False if `--no-cache` was given.
+        std::string cache_dir; ///< State directory (`--cache-dir`); empty means `.dagra` next to the config.
+        history::SortKey report_sort = history::SortKey::Wall; ///< Ranking metric for `dagra report` (`--sort`).
+        std::size_t report_limit = 20; ///< Tasks listed by `dagra report` (`--top`); 0 means all.
+        utils::Logger::Format log_format = utils::Logger::Format::Text; ///< `--log-format=text|json`.
+        std::string trace_path; ///< Chrome trace output file (`--trace`); empty disables tracing.
+        std::vector<std::string> targets; ///< Task IDs or glob patterns after the config file; empty runs every task.
+        std::vector<std::string> tags; ///< Tags selecting tasks to run (`--tag`, repeatable).
+        bool watch = false; ///< True if `--watch` was given: rerun affected tasks whenever inputs change.
+        std::size_t watch_debounce_ms = 200; ///< Quiet period before a watch rerun (`--debounce`).
+        std::string listen_address; ///< Address `dagra-worker` agents connect to (`--listen`); empty runs tasks locally.
+        std::string reduce_path; ///< Where `dagra analyze` writes the transitively reduced config (`--reduce`); empty writes none.
+    };
+
+    /**
+     * @struct Config
+     * @brief The contents of a configuration file.
+     */
+    struct Config {
+        /// @brief The tasks, in declaration order.
+        std::vector<core::Task> tasks;
+
+        /// @brief Declared capacities of named resource pools (top-level `resources:`).
+        std::map<std::string, double> resource_pools;
     };
 
+    /**
+     * @brief Resolves the directory holding dagra's persistent state (cache, history, ...).
+     * @param options The parsed command-line options.
+     * @return `cache_dir` if set, otherwise `.dagra` next to the configuration file.
+     */
+    std::filesystem::path state_directory(const AppOptions& options);
+
     /**
      * @class Parser
      * @brief A utility class for parsing command-line arguments and YAML files.
@@ -40,10 +92,28 @@ namespace dagra::cli {
          * @param argc The number of command-line arguments.
          * @param argv An array of command-line argument strings.
          * @return An AppOptions struct containing the parsed options.
-         * @throw std::runtime_error If the configuration file path is not provided.
+         * @throw std::runtime_error If the configuration file path is not provided
+         *        (it is optional for `report`) or an option value is invalid.
          */
         static AppOptions parse_args(int argc, char* argv[]);
 
+        /**
+         * @brief Parses the command-line arguments of `dagra-worker`.
+         * @param argc The number of command-line arguments.
+         * @param argv An array of command-line argument strings.
+         * @return The agent's options.
+         * @throw std::runtime_error If the coordinator address is missing or malformed, or an option is invalid.
+         */
+        static remote::AgentOptions parse_worker_args(int argc, char* argv[]);
+
+        /**
+         * @brief Parses a YAML configuration file: its tasks and its resource pools.
+         * @param filepath The absolute or relative path to the YAML configuration file.
+         * @return The tasks and pool capacities defined in the file.
+         * @throw std::runtime_error If the file is invalid or cannot be opened.
+         */
+        static Config parse_config(const std::string& filepath);
+
         /**
          * @brief Parses a YAML file to extract a list of tasks.
          * @param filepath The absolute or relative path to the YAML configuration file.
@@ -51,6 +121,14 @@ namespace dagra::cli {
          * @throw std::runtime_error If the file is invalid or cannot be opened.
          */
         static std::vector<core::Task> parse_yaml(const std::string& filepath);
+
+        /**
+         * @brief Writes a configuration file that `parse_config` reads back unchanged.
+         * @param config The tasks and pool capacities to write.
+         * @param filepath The file to create or replace.
+         * @throw std::runtime_error If the file cannot be written.
+         */
+        static void write_config(const Config& config, const std::string& filepath);
     };
 
 } // namespace dagra::cli
@@ -0,0 +1,120 @@
+/**
+ * @file analysis.hpp
+ * @brief Declares the structural analysis behind `dagra analyze`.
+ * @version 1.1.0
+ *
+ * This file contains the functions that measure a validated graph: its
+ * size, depth and width, its weighted critical path and the speedup that
+ * path allows, and its redundant edges, i.e. dependencies already implied
+ * by other dependencies. Redundant edges make every dependency check and
+ * closure walk do extra work and hide which chains really bound a run;
+ * `reduce_tasks` removes them.
+ */
+
+#pragma once
+
+#include "dag.hpp"
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace dagra::core {
+
+    /**
+     * @struct RedundantEdge
+     * @brief A dependency implied by the task's other dependencies, or declared twice.
+     */
+    struct RedundantEdge {
+        TaskIndex task;       ///< The task declaring the dependency.
+        TaskIndex dependency; ///< The task it depends on.
+    };
+
+    /**
+     * @struct GraphAnalysis
+     * @brief The measurements of one graph.
+     *
+     * A task's level is the length of the longest chain of dependencies
+     * below it, so tasks without dependencies are on level 0 and every
+     * level only depends on lower ones.
+     */
+    struct GraphAnalysis {
+        std::size_t tasks = 0; ///< Number of tasks.
+        std::size_t edges = 0; ///< Number of dependency edges, duplicates included.
+
+        /// @brief The number of tasks on each level; its size is the depth of the graph.
+        std::vector<std::size_t> level_widths;
+
+        std::size_t max_width = 0;    ///< The largest entry of `level_widths`.
+        std::size_t widest_level = 0; ///< The first level with `max_width` tasks.
+
+        double total_work = 0.0; ///< The sum of all task weights: the run time on one worker.
+
+        /// @brief The weight of the heaviest dependency chain: the run time with unlimited workers.
+        double critical_path_cost = 0.0;
+
+        /// @brief The heaviest chain, from its first task to its last.
+        std::vector<TaskIndex> critical_path;
+
+        /// @brief Every redundant edge, ordered by task and then by declaration.
+        std::vector<RedundantEdge> redundant_edges;
+
+        /// @brief The number of levels.
+        std::size_t depth() const { return level_widths.size(); }
+
+        /**
+         * @brief The best speedup over one worker that `jobs` workers can reach.
+         *
+         * A run takes at least the critical path and at least `1/jobs` of
+         * the total work, so the ceiling is `total_work / max(critical_path_cost,
+         * total_work / jobs)`.
+         *
+         * @param jobs The number of workers, at least 1.
+         * @return The ceiling, 1 for an empty or weightless graph.
+         */
+        double speedup_ceiling(std::size_t jobs) const;
+    };
+
+    /**
+     * @brief Measures a validated graph.
+     *
+     * Levels and the critical path come from one pass in topological order.
+     * A dependency `d` of task `t` is redundant if another dependency of `t`
+     * reaches `d`. Only a dependency on a higher level can reach it, so each
+     * task's search starts from its higher-level dependencies and never
+     * descends below its lowest dependency's level. Tasks with a single
+     * dependency cannot have redundant edges and are skipped. The search is
+     * split across threads for large graphs, with one visit stamp array per
+     * thread, so nothing is cleared between tasks.
+     *
+     * @param dag A graph that passed `validate()`.
+     * @param weights One weight (estimated duration) per task, indexed by `TaskIndex`.
+     * @return The analysis.
+     */
+    GraphAnalysis analyze_graph(const Dag& dag, const std::vector<double>& weights);
+
+    /**
+     * @brief Copies the tasks of a graph with the given redundant edges removed.
+     *
+     * Dependencies that are not listed keep their declaration order; a
+     * dependency declared twice is kept once. Removing every redundant edge
+     * of `analyze_graph` yields the transitive reduction: the same order
+     * constraints with the fewest edges.
+     *
+     * @param dag The analysed graph.
+     * @param redundant The edges to remove, as returned by `analyze_graph`.
+     * @return The tasks in index order.
+     */
+    std::vector<Task> reduce_tasks(const Dag& dag, const std::vector<RedundantEdge>& redundant);
+
+    /**
+     * @brief Prints the analysis as text.
+     * @param dag The analysed graph, used for task IDs.
+     * @param analysis The analysis.
+     * @param jobs The worker count the speedup ceiling is computed for.
+     * @param limit The most critical path tasks and redundant edges to list (0 = all).
+     * @param out The stream to write to.
+     */
+    void write_analysis(const Dag& dag, const GraphAnalysis& analysis, std::size_t jobs, std::size_t limit,
+                        std::ostream& out);
+
+} // namespace dagra::core
@@ -11,24 +11,82 @@
 #pragma once
 
 #include "task.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace dagra::core {
 
+    /// @brief A dense index identifying a task inside a Dag.
+    using TaskIndex = std::uint32_t;
+
+    /**
+     * @struct IndexRange
+     * @brief A read-only view over a contiguous run of task indices.
+     */
+    struct IndexRange {
+        const TaskIndex* first = nullptr;
+        const TaskIndex* last = nullptr;
+
+        const TaskIndex* begin() const { return first; }
+        const TaskIndex* end() const { return last; }
+        std::size_t size() const { return static_cast<std::size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    /**
+     * @struct MissingDependency
+     * @brief A dependency that does not name any task in the graph.
+     */
+    struct MissingDependency {
+        TaskIndex task;   ///< The task declaring the dependency.
+        std::string name; ///< The unknown dependency ID.
+    };
+
+    /**
+     * @struct ValidationReport
+     * @brief Every integrity problem found in a DAG by a single validation pass.
+     */
+    struct ValidationReport {
+        /// @brief Dependencies that do not name a task in the graph.
+        std::vector<MissingDependency> missing;
+
+        /**
+         * @brief One closed dependency path per cycle-containing component.
+         *
+         * Each path starts and ends with the same task; every task in it
+         * depends on the next one.
+         */
+        std::vector<std::vector<TaskIndex>> cycles;
+
+        /// @brief True if no problems were found.
+        bool ok() const { return missing.empty() && cycles.empty(); }
+    };
+
     /**
      * @class Dag
      * @brief Represents a Directed Acyclic Graph of tasks.
      *
-     * The Dag stores tasks using a map for quick lookup by ID. It provides
-     * methods for adding tasks and for validating the graph's structure to
-     * ensure it is runnable.
+     * Task IDs are interned to dense `TaskIndex` values in insertion order and
+     * the tasks themselves are stored contiguously. Dependency (forward) and
+     * dependent (reverse) edges are kept in compressed sparse row (CSR) arrays,
+     * so graph traversals never hash strings. The string-keyed methods remain
+     * available as a thin façade over the index-based API.
+     *
+     * The edge arrays are built lazily on first use after the last `add_task`.
+     * Build them (e.g. by calling `validate()` or any edge accessor) before
+     * sharing a Dag between threads.
      */
     class Dag {
     public:
+        /**
+         * @brief Reserves storage for the given number of tasks.
+         * @param count The expected number of tasks.
+         */
+        void reserve(std::size_t count);
+
         /**
          * @brief Adds a new task to the graph.
          * @param task The task object to add. If a task with the same ID already
@@ -36,6 +94,28 @@ namespace dagra::core {
          */
         void add_task(const Task& task);
 
+        /**
+         * @brief Adds a new task to the graph, taking ownership of its contents.
+         * @param task The task object to move in. If a task with the same ID
+         *             already exists, it will be overwritten.
+         */
+        void add_task(Task&& task);
+
+        /**
+         * @brief Replaces the graph with tasks whose dependency edges are already resolved.
+         *
+         * Used to load a compiled plan. The ID table is rebuilt from the task
+         * IDs, but dependency names are not looked up again and no validation
+         * is performed, so the edges must come from a graph that passed
+         * `validate()`.
+         *
+         * @param tasks The tasks in index order, with IDs unique.
+         * @param offsets CSR offsets into `targets`: one per task plus the final end offset.
+         * @param targets The dependency indices of every task, in declaration order.
+         */
+        void assign_resolved(std::vector<Task> tasks, std::vector<std::uint32_t> offsets,
+                             std::vector<TaskIndex> targets);
+
         /**
          * @brief Retrieves a task by its ID.
          * @param id The unique identifier of the task to retrieve.
@@ -46,9 +126,113 @@ namespace dagra::core {
 
         /**
          * @brief Retrieves all tasks stored in the graph.
-         * @return A constant reference to the map of all tasks.
+         * @return A constant reference to the tasks, ordered by their index.
+         */
+        const std::vector<Task>& get_all_tasks() const;
+
+        /// @brief The number of tasks in the graph.
+        std::size_t size() const;
+
+        /**
+         * @brief Looks up the index of a task.
+         * @param id The task ID.
+         * @param index Receives the index if the task exists.
+         * @return True if a task with the given ID exists.
+         */
+        bool find(const std::string& id, TaskIndex& index) const;
+
+        /**
+         * @brief Retrieves a task by its index.
+         * @param index A valid task index (less than `size()`).
+         * @return A constant reference to the task.
+         */
+        const Task& task(TaskIndex index) const;
+
+        /**
+         * @brief The indices of the tasks that the given task depends on.
+         *
+         * Dependencies naming unknown tasks are omitted here and reported by
+         * `missing_dependencies()` instead.
+         *
+         * @param index A valid task index.
+         * @return The dependency indices, in declaration order.
+         */
+        IndexRange dependencies(TaskIndex index) const;
+
+        /**
+         * @brief The indices of the tasks that depend on the given task.
+         * @param index A valid task index.
+         * @return The dependent indices, in ascending order.
+         */
+        IndexRange dependents(TaskIndex index) const;
+
+        /**
+         * @brief Lists every dependency that does not name a task in the graph.
+         * @return The unresolved dependencies, ordered by declaring task.
+         */
+        const std::vector<MissingDependency>& missing_dependencies() const;
+
+        /**
+         * @brief Orders tasks so that every task comes after all of its dependencies.
+         *
+         * Uses Kahn's algorithm in O(V+E). Tasks that are part of, or depend
+         * on, a cycle are left out, so the result is shorter than `size()`
+         * exactly when the graph is cyclic.
+         *
+         * @return The task indices in a valid execution order.
+         */
+        std::vector<TaskIndex> topological_order() const;
+
+        /**
+         * @brief Collects the given tasks and everything they transitively depend on.
+         *
+         * An iterative walk over the forward CSR edges with a visited bitset,
+         * so the cost is proportional to the size of the closure rather than
+         * to the graph.
+         *
+         * @param targets The tasks to start from; duplicates are allowed.
+         * @return The indices of the closure, in ascending (declaration) order.
+         */
+        std::vector<TaskIndex> dependency_closure(const std::vector<TaskIndex>& targets) const;
+
+        /**
+         * @brief Collects the given tasks and everything that transitively depends on them.
+         *
+         * The mirror image of `dependency_closure`, walking the reverse edges.
+         *
+         * @param sources The tasks to start from; duplicates are allowed.
+         * @return The indices of the closure, in ascending (declaration) order.
+         */
+        std::vector<TaskIndex> dependent_closure(const std::vector<TaskIndex>& sources) const;
+
+        /**
+         * @brief Copies a set of tasks into a new graph.
+         *
+         * The tasks keep their relative order, and their edges are remapped
+         * and installed with `assign_resolved`, so nothing is looked up by
+         * name and the result needs no validation if this graph passed it.
+         *
+         * @param selected Ascending task indices, normally closed under
+         *        dependencies (e.g. the result of `dependency_closure`).
+         * @param drop_external If true, edges to unselected tasks are dropped,
+         *        i.e. those dependencies count as already satisfied.
+         * @return The induced subgraph.
+         * @throw std::runtime_error If a selected task depends on an unselected
+         *        one and `drop_external` is false.
+         */
+        Dag subgraph(const std::vector<TaskIndex>& selected, bool drop_external = false) const;
+
+        /**
+         * @brief Collects every missing dependency and cycle without throwing.
+         *
+         * Runs in O(V+E) with no recursion: a Kahn pass removes all acyclic
+         * tasks, and an iterative Tarjan pass over the remainder finds the
+         * strongly connected components, from each of which one full cycle
+         * path is extracted.
+         *
+         * @return The validation report.
          */
-        const std::unordered_map<std::string, Task>& get_all_tasks() const;
+        ValidationReport check() const;
 
         /**
          * @brief Validates the integrity of the DAG.
@@ -57,22 +241,54 @@ namespace dagra::core {
          * 1. Ensures that all task dependencies point to existing tasks.
          * 2. Detects any circular dependencies (cycles) within the graph.
          *
+         * Every problem found is logged before the exception is thrown.
+         *
          * @throw std::runtime_error If a validation check fails.
          */
         void validate() const;
 
     private:
         /**
-         * @brief A helper function for performing depth-first search to detect cycles.
-         * @param task_id The ID of the current task being visited.
-         * @param visited A set of nodes that have been visited in the current DFS path.
-         * @param recursion_stack A set of nodes currently in the recursion stack.
+         * @brief Extracts the cycles from the tasks left over by a Kahn pass.
+         * @param leftover Per-task flag, true for tasks not in the topological order.
+         * @return One closed dependency path per strongly connected component with a cycle.
          */
-        void detect_cycle_util(const std::string& task_id, 
-                               std::unordered_set<std::string>& visited, 
-                               std::unordered_set<std::string>& recursion_stack) const;
+        std::vector<std::vector<TaskIndex>> find_cycles(const std::vector<bool>& leftover) const;
+
+        /// @brief Inserts a new task or overwrites an existing one with the same ID.
+        template <typename T>
+        void insert(T&& task);
+
+        /// @brief Finds the hash slot holding the given ID, or the empty slot where it belongs.
+        std::size_t probe(const std::string& id, std::uint64_t hash) const;
+
+        /// @brief Doubles the ID hash table and reinserts every task.
+        void grow_table();
+
+        /// @brief Resizes the ID hash table to `capacity` slots (a power of two) and reinserts every task.
+        void rehash(std::size_t capacity);
+
+        /// @brief Builds the CSR edge arrays if they are out of date.
+        void build_edges() const;
+
+        /// @brief Derives the reverse (dependent) CSR arrays from the forward ones.
+        void build_reverse_edges() const;
+
+        /// @brief Task count above which dependency resolution is split across threads.
+        static constexpr std::size_t PARALLEL_RESOLVE_THRESHOLD = 1u << 16;
+
+        static constexpr TaskIndex EMPTY_SLOT = 0xFFFFFFFFu;
+
+        std::vector<Task> tasks_;
+        std::vector<std::uint64_t> hashes_;
+        std::vector<TaskIndex> slots_;
 
-        std::unordered_map<std::string, Task> tasks_;
+        mutable bool edges_built_ = false;
+        mutable std::vector<std::uint32_t> dependency_offsets_;
+        mutable std::vector<TaskIndex> dependency_targets_;
+        mutable std::vector<std::uint32_t> dependent_offsets_;
+        mutable std::vector<TaskIndex> dependent_targets_;
+        mutable std::vector<MissingDependency> missing_;
     };
 
 } // namespace dagra::core
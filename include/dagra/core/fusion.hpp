@@ -0,0 +1,83 @@
+/**
+ * @file fusion.hpp
+ * @brief Declares task fusion: running chains and batches of tiny tasks in one process.
+ * @version 1.1.0
+ *
+ * This file contains the planning pass behind `--fuse`. It groups tasks so
+ * that each group can run as a single shell invocation, and builds the
+ * coarser graph of groups that the runner schedules instead of the tasks.
+ */
+
+#pragma once
+
+#include "dag.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dagra::core {
+
+    /**
+     * @struct FusionOptions
+     * @brief Limits on the groups formed by task fusion.
+     */
+    struct FusionOptions {
+        /// @brief Maximum number of tasks run by one shell invocation.
+        std::size_t max_group = 32;
+
+        /// @brief Maximum combined length of a group's commands, which are passed as a single argument.
+        std::size_t max_script_bytes = 64 * 1024;
+    };
+
+    /// @brief How the tasks of a fused group are related.
+    enum class FusionKind : std::uint8_t {
+        Single, ///< One task, run as usual.
+        Chain,  ///< A linear chain; a failure stops the remaining tasks.
+        Batch   ///< Independent siblings; every task runs regardless of the others.
+    };
+
+    /**
+     * @struct FusedGraph
+     * @brief The result of task fusion.
+     *
+     * `graph` has one task per group. A single task is copied unchanged; a
+     * fused group is named `<first ID>..<last ID>`, shows its commands joined
+     * by `&&` (chain) or `;` (batch), holds the largest amount of each
+     * resource any member needs and depends on the groups of its members'
+     * dependencies.
+     */
+    struct FusedGraph {
+        /// @brief The graph of groups, scheduled instead of the original tasks.
+        Dag graph;
+
+        /// @brief The original task indices of every group, in execution order.
+        std::vector<std::vector<TaskIndex>> members;
+
+        /// @brief The kind of every group.
+        std::vector<FusionKind> kinds;
+    };
+
+    /**
+     * @brief Groups tasks that can share one shell invocation.
+     *
+     * A **chain** is a path `a -> b -> c` on which every task but the last
+     * has exactly one dependent and every task but the first has exactly one
+     * dependency; contracting it loses no parallelism. A **batch** collects
+     * tasks marked `batchable` that have exactly the same dependencies; its
+     * members run one after another, so batches trade a little parallelism
+     * for far fewer processes.
+     *
+     * Only tasks without a timeout or a persistent worker are fused, and only with tasks that have
+     * the same environment variables, since those apply to the whole process.
+     * Neither transformation can create a cycle: a chain member other than
+     * the head has no edge from outside the chain, and a path between two
+     * siblings with equal dependencies would pass through one of their own
+     * dependencies.
+     *
+     * @param dag A validated graph.
+     * @param options Limits on the group size.
+     * @return The fused graph; with nothing to fuse, every group is a single task.
+     */
+    FusedGraph fuse_tasks(const Dag& dag, const FusionOptions& options);
+
+} // namespace dagra::core
@@ -0,0 +1,65 @@
+/**
+ * @file matrix.hpp
+ * @brief Declares the expansion of matrix tasks into concrete tasks.
+ * @version 1.1.0
+ *
+ * This file contains the functions behind the `matrix:` task field. A
+ * matrix task is a template: its string fields may contain `{name}`
+ * placeholders for the matrix axes, and it stands for one task per
+ * combination of axis values. A configuration can thus describe the same
+ * command across 500 shards and 4 platforms in a few lines instead of
+ * 2000 explicit tasks. The expanded tasks own their strings, so they take
+ * as much memory as explicit ones.
+ */
+
+#pragma once
+
+#include "task.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dagra::core {
+
+    /**
+     * @struct MatrixAxis
+     * @brief One dimension of a matrix: a placeholder name and the values it takes.
+     */
+    struct MatrixAxis {
+        std::string name;
+        std::vector<std::string> values;
+    };
+
+    /// @brief The largest number of tasks a single matrix may expand to.
+    constexpr std::size_t MAX_MATRIX_TASKS = 10000000;
+
+    /**
+     * @brief Expands an integer range such as `0..499` (both ends included).
+     * @param text The scalar given as an axis.
+     * @param values Receives the values on success.
+     * @return False if the text is not of the form `FIRST..LAST`.
+     * @throw std::runtime_error If the range is empty (`FIRST > LAST`) or too large.
+     */
+    bool parse_matrix_range(const std::string& text, std::vector<std::string>& values);
+
+    /**
+     * @brief Appends one task per combination of axis values.
+     *
+     * The `id`, `command`, `worker`, `dependencies`, `env_vars`, `inputs`,
+     * `outputs` and `tags` of the prototype are templates. Each is split
+     * into literal text and placeholders once; expansion then only
+     * concatenates, so its cost is proportional to the size of the output.
+     * A `{name}` that is not an axis, such as a shell `${HOME}`, is kept as
+     * it is. The other fields are copied unchanged. Combinations are
+     * enumerated like nested loops over the axes in declaration order, the
+     * last axis varying fastest.
+     *
+     * @param prototype The task template.
+     * @param axes The matrix axes, in declaration order.
+     * @param out Receives the expanded tasks.
+     * @throw std::runtime_error If an axis is unnamed, repeated or empty, the
+     *        `id` does not use every axis, or the matrix exceeds `MAX_MATRIX_TASKS`.
+     */
+    void expand_matrix(const Task& prototype, const std::vector<MatrixAxis>& axes, std::vector<Task>& out);
+
+} // namespace dagra::core
@@ -0,0 +1,44 @@
+/**
+ * @file selection.hpp
+ * @brief Declares the resolution of command-line targets to tasks.
+ * @version 1.1.0
+ *
+ * This file contains the functions that turn the targets named on the
+ * command line (exact task IDs or glob patterns) and `--tag` filters into
+ * task indices. Combined with `Dag::dependency_closure` and `Dag::subgraph`,
+ * they let a run cover a single target and its dependencies instead of the
+ * whole configuration.
+ */
+
+#pragma once
+
+#include "dag.hpp"
+#include <string>
+#include <vector>
+
+namespace dagra::core {
+
+    /**
+     * @brief Checks whether a target contains glob metacharacters (`*`, `?` or `[`).
+     * @param pattern The target as given on the command line.
+     * @return True if the target is matched as a pattern rather than looked up as an ID.
+     */
+    bool is_glob(const std::string& pattern);
+
+    /**
+     * @brief Resolves targets and tags to the tasks they name.
+     *
+     * An exact ID is a hash lookup; a glob is matched against every task ID
+     * with `fnmatch`, and a tag selects every task carrying it. The result is
+     * the union of all three, without dependencies.
+     *
+     * @param dag The graph to select from.
+     * @param targets Task IDs or glob patterns.
+     * @param tags Tag names.
+     * @return The selected task indices, each once, in ascending order.
+     * @throw std::runtime_error If an ID names no task, or a pattern or tag matches none.
+     */
+    std::vector<TaskIndex> select_targets(const Dag& dag, const std::vector<std::string>& targets,
+                                          const std::vector<std::string>& tags);
+
+} // namespace dagra::core
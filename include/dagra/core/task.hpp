@@ -4,25 +4,33 @@
  * @version 1.1.0
  *
  * This file contains the definition of the `Task` struct, which is the
- * fundamental unit of work in the Dagra application. Each task has a unique
- * identifier, a shell command to execute, a list of dependencies on other
- * tasks, an optional timeout, and optional environment variables.
+ * fundamental unit of work in the Dagra application: a uniquely identified
+ * shell command and the tasks it depends on. The optional fields are
+ * documented on the struct.
  */
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
 namespace dagra::core {
 
+    /// @brief Resource name for CPU cores; its capacity defaults to the hardware concurrency.
+    constexpr const char* RESOURCE_CPU = "cpu";
+
+    /// @brief Resource name for memory in MiB; its capacity defaults to the physical memory.
+    constexpr const char* RESOURCE_MEMORY_MB = "memory_mb";
+
     /**
      * @struct Task
      * @brief Represents a single unit of work in the DAG.
      *
      * A Task is defined by its ID, the command it executes, the IDs of
      * any other tasks that must be completed before this one can start,
-     * an optional timeout in seconds, and optional environment variables.
+     * an optional timeout in seconds, optional environment variables, and
+     * optional input and output files.
      */
     struct Task {
         /// @brief A unique identifier for the task (e.g., "build", "test").
@@ -39,6 +47,38 @@ namespace dagra::core {
         
         /// @brief Environment variables for this task (format: "KEY=value").
         std::vector<std::string> env_vars;
+
+        /// @brief Files whose contents feed into the task's cache key.
+        std::vector<std::string> inputs;
+
+        /// @brief Files the task produces; all must exist for a cache hit.
+        std::vector<std::string> outputs;
+
+        /// @brief Estimated duration in seconds, used to prioritise scheduling (0 = unknown).
+        double cost = 0.0;
+
+        /// @brief If true, a failure of this task is reported but does not fail the run or block its dependents.
+        bool allow_failure = false;
+
+        /// @brief Amounts of named resources held while the task runs (e.g. `cpu`, `memory_mb`, `db`).
+        std::map<std::string, double> resources;
+
+        /// @brief Labels used to select groups of tasks on the command line (`--tag`).
+        std::vector<std::string> tags;
+
+        /// @brief If true, task fusion may run the task in one shell together with siblings that have the same dependencies.
+        bool batchable = false;
+
+        /**
+         * @brief Command line of a persistent worker that runs this task, or empty.
+         *
+         * When set, `command` is not spawned; it is sent as a request to a
+         * long-lived worker process started from this command line.
+         */
+        std::string worker;
+
+        /// @brief True if the task declares inputs or outputs and may be skipped by the cache.
+        bool is_cacheable() const { return !inputs.empty() || !outputs.empty(); }
     };
 
 } // namespace dagra::core
@@ -0,0 +1,147 @@
+/**
+ * @file event_loop.hpp
+ * @brief Declares the event loop that waits for many child processes on one thread.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `EventLoop` class. The thread
+ * pool dedicates a thread to every running command, which blocks in `poll`
+ * until the command exits; with thousands of short, I/O-bound commands the
+ * threads' stacks and context switches cost more than the commands. The
+ * event loop instead registers each child's pidfd with one `epoll`
+ * instance, enforces every deadline from a single timer heap, and runs the
+ * completion handlers on the thread that calls `run_once`.
+ */
+
+#pragma once
+
+#include "process.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @class EventLoop
+     * @brief Waits for child processes and runs a handler for each one that exits.
+     *
+     * Deadlines and cancellation are enforced like `Process::wait_with_timeout`:
+     * the process group receives SIGTERM, then SIGKILL after the kill grace.
+     * Where pidfds are unavailable, watched processes are checked every 10 ms
+     * instead. Only `post` may be called from other threads.
+     */
+    class EventLoop {
+    public:
+        /// @brief Called on the loop thread with the status of a reaped process.
+        using ExitHandler = std::function<void(ExitStatus)>;
+
+        /**
+         * @brief Creates the epoll instance.
+         * @param kill_grace Time a terminated process group gets between SIGTERM and SIGKILL.
+         * @param cancel_fd A descriptor that becomes readable to cancel every watched process, or -1.
+         * @throw std::runtime_error If the epoll instance cannot be created.
+         */
+        explicit EventLoop(std::chrono::milliseconds kill_grace, int cancel_fd = -1);
+
+        /// @brief Kills and reaps any process still watched, without running its handler.
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * @brief Takes ownership of a started process and waits for it.
+         *
+         * A process that failed to start is reported on the next `run_once`.
+         *
+         * @param process The process, possibly not running.
+         * @param timeout The maximum run time; zero or negative means no limit.
+         * @param on_exit Called with the exit status once the process has been reaped.
+         */
+        void watch(Process process, std::chrono::milliseconds timeout, ExitHandler on_exit);
+
+        /**
+         * @brief Queues a callback to run on the loop thread and wakes the loop.
+         * @param callback The callable to run. It must not throw.
+         */
+        void post(std::function<void()> callback);
+
+        /**
+         * @brief Blocks until at least one exit handler or posted callback has run.
+         *
+         * The caller must know that something is pending: a watched process
+         * or a callback another thread will post.
+         *
+         * @return The number of handlers and callbacks run.
+         */
+        std::size_t run_once();
+
+        /// @brief The number of processes being waited for.
+        std::size_t watched() const;
+
+    private:
+        /// @brief How far a watched process has been taken towards termination.
+        enum class Stage { Running, Terminating, Killed };
+
+        /// @brief A watched process.
+        struct Child {
+            Process process;
+            ExitHandler on_exit;
+            std::chrono::steady_clock::time_point deadline;
+            Stage stage = Stage::Running;
+            bool timed_out = false;
+            bool cancelled = false;
+        };
+
+        /// @brief A pending deadline; stale entries are skipped when they come due.
+        using Deadline = std::pair<std::chrono::steady_clock::time_point, std::uint64_t>;
+
+        /// @brief Sends SIGTERM to a child's group and arms its SIGKILL deadline.
+        void terminate(std::uint64_t id, Child& child);
+
+        /// @brief Acts on every deadline that has passed.
+        void expire_deadlines();
+
+        /// @brief Reaps a child that has exited and runs its handler.
+        void reap(std::uint64_t id);
+
+        /// @brief Runs the queued callbacks; returns how many ran.
+        std::size_t run_posted();
+
+        /// @brief Milliseconds until the next deadline or fallback check, or -1 to wait indefinitely.
+        int next_timeout() const;
+
+        std::chrono::milliseconds kill_grace_;
+        int cancel_fd_ = -1;
+        bool cancelled_ = false;
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+
+        std::uint64_t next_id_;
+        std::unordered_map<std::uint64_t, Child> children_;
+        std::unordered_set<std::uint64_t> polled_;
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+
+        mutable std::mutex mtx_;
+        std::vector<std::function<void()>> posted_;
+    };
+
+    /**
+     * @brief Raises the soft limit on open descriptors to the hard limit.
+     *
+     * Every running command holds a pidfd and two pipe read ends, so
+     * thousands of concurrent commands need more than the usual soft limit
+     * of 1024 descriptors.
+     *
+     * @return The new soft limit.
+     */
+    std::size_t raise_descriptor_limit();
+
+} // namespace dagra::execution
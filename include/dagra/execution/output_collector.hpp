@@ -0,0 +1,200 @@
+/**
+ * @file output_collector.hpp
+ * @brief Declares the epoll-based multiplexer that captures task output.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `OutputCollector` class and the
+ * per-task `TaskOutput` handle. Every task's stdout and stderr are connected
+ * to pipes that a single background thread drains with `epoll`, so parallel
+ * tasks never interleave mid-line and a chatty task never blocks on a full
+ * pipe.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @struct OutputOptions
+     * @brief Controls where captured task output goes.
+     */
+    struct OutputOptions {
+        /// @brief If true, complete lines are echoed to dagra's stdout/stderr prefixed with the task ID.
+        bool echo = true;
+
+        /// @brief Directory receiving one `<task-id>.log` file per task; empty disables log files.
+        std::string log_dir;
+
+        /// @brief Size of the per-task ring buffer of recent output shown when a task fails.
+        std::size_t tail_bytes = 16 * 1024;
+
+        /// @brief If set, receives the complete lines that `echo` would print, instead of the logger.
+        std::function<void(const std::string& task_id, bool is_stderr, std::string lines)> sink;
+    };
+
+    /**
+     * @class TaskOutput
+     * @brief The captured output of one task run.
+     *
+     * Created by `OutputCollector::attach`. The collector thread feeds it;
+     * the worker running the task calls `finish` (or `finish_async`) after
+     * the process has been reaped and may then read `tail()`.
+     */
+    class TaskOutput {
+    public:
+        ~TaskOutput();
+        TaskOutput(const TaskOutput&) = delete;
+        TaskOutput& operator=(const TaskOutput&) = delete;
+
+        /**
+         * @brief Waits until both pipes reach end-of-file.
+         *
+         * A command may leave a background process holding the pipes open.
+         * After `limit` the collector stops reading them and flushes what it
+         * has, so a run never hangs on a stray descendant.
+         *
+         * @param limit How long to wait for end-of-file.
+         */
+        void finish(std::chrono::milliseconds limit);
+
+        /**
+         * @brief Like `finish`, but returns at once and reports end-of-file through a callback.
+         *
+         * `on_closed` runs on the calling thread if both pipes are already
+         * closed, and otherwise on the collector thread once they are, at
+         * most about `limit` later. It must not call back into the collector.
+         *
+         * @param limit How long to wait for end-of-file.
+         * @param on_closed Called once when the output is complete.
+         */
+        void finish_async(std::chrono::milliseconds limit, std::function<void()> on_closed);
+
+        /**
+         * @brief The most recent output of both streams, in arrival order.
+         * @return Up to `OutputOptions::tail_bytes` bytes, starting at a line boundary where possible.
+         */
+        std::string tail() const;
+
+        /// @brief The path of the task's log file, or an empty string if there is none.
+        const std::string& log_path() const;
+
+    private:
+        friend class OutputCollector;
+
+        TaskOutput(std::string task_id, std::size_t tail_capacity);
+
+        /// @brief Appends bytes to the ring buffer (collector thread only).
+        void append_tail(const char* data, std::size_t size);
+
+        std::string task_id_;
+        std::string log_path_;
+        int log_fd_ = -1;
+
+        std::vector<char> ring_;
+        std::size_t ring_start_ = 0;
+        std::size_t ring_size_ = 0;
+
+        mutable std::mutex mtx_;
+        std::condition_variable closed_cv_;
+        int open_streams_ = 0;
+        bool abandoned_ = false;
+
+        /// @brief Set by `finish_async`: the callback and when the pipes are abandoned.
+        std::function<void()> on_closed_;
+        std::chrono::steady_clock::time_point drain_deadline_;
+        bool draining_ = false;
+    };
+
+    /**
+     * @class OutputCollector
+     * @brief Drains the output pipes of every running task on one background thread.
+     *
+     * The pipes are non-blocking and registered with a single `epoll`
+     * instance. Each readiness event reads a stream until `EAGAIN`, or at most
+     * four chunks, so a task that floods its pipe cannot starve the others; the bytes are
+     * appended to the task's log file and ring buffer, and the complete lines
+     * are handed to `Logger::output`, which prefixes them with `[task-id] `
+     * and writes them as one block. A partial last line is held back until it is completed or the
+     * stream closes. Registration is thread-safe.
+     */
+    class OutputCollector {
+    public:
+        /**
+         * @brief Starts the collector thread.
+         * @param options Where captured output goes.
+         * @throw std::runtime_error If the epoll instance cannot be created.
+         */
+        explicit OutputCollector(const OutputOptions& options);
+
+        /// @brief Stops the collector thread and closes any pipes still registered.
+        ~OutputCollector();
+
+        OutputCollector(const OutputCollector&) = delete;
+        OutputCollector& operator=(const OutputCollector&) = delete;
+
+        /**
+         * @brief Takes ownership of a task's pipe read ends and starts draining them.
+         * @param task_id The task ID, used as line prefix and log file name.
+         * @param stdout_fd The read end of the task's stdout pipe.
+         * @param stderr_fd The read end of the task's stderr pipe.
+         * @return The handle through which the task's output is finished and inspected.
+         */
+        std::shared_ptr<TaskOutput> attach(const std::string& task_id, int stdout_fd, int stderr_fd);
+
+    private:
+        /// @brief One registered pipe.
+        struct Stream {
+            std::shared_ptr<TaskOutput> owner;
+            int fd;
+            bool is_stderr;
+            std::string partial;
+        };
+
+        /// @brief The collector thread: waits on epoll and dispatches readiness events.
+        void loop();
+
+        /// @brief Reads a stream until it would block or its per-event budget is spent; returns false at end-of-file or error.
+        bool drain(Stream& stream);
+
+        /// @brief Logs and echoes a chunk of output, keeping a trailing partial line for later.
+        void consume(Stream& stream, const char* data, std::size_t size, bool final);
+
+        /// @brief Flushes, unregisters and closes a stream (collector thread only).
+        void close_stream(int fd);
+
+        /// @brief Closes every stream of tasks whose `finish` or `finish_async` timed out (collector thread only).
+        void close_abandoned();
+
+        /// @brief Wakes the collector thread through its eventfd.
+        void wake();
+
+        OutputOptions options_;
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+
+        std::mutex mtx_;
+        std::unordered_map<int, std::unique_ptr<Stream>> streams_;
+        bool stopping_ = false;
+
+        std::thread thread_;
+    };
+
+    /**
+     * @brief Turns a task ID into a safe log file name.
+     * @param task_id The task ID.
+     * @return The ID with path separators and other unsafe characters replaced by '_'.
+     */
+    std::string log_file_name(const std::string& task_id);
+
+} // namespace dagra::execution
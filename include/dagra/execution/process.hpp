@@ -0,0 +1,260 @@
+/**
+ * @file process.hpp
+ * @brief Declares the process launcher used to run task commands.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `Process` class and its helpers.
+ * Commands are started with `posix_spawn`: simple commands are executed
+ * directly, and only commands that need shell features are run through
+ * `/bin/sh -c`. Task environment variables are passed as a native envp array
+ * merged with the parent environment. Every child leads its own process group
+ * so that a timeout can terminate the whole subtree it started. Children are
+ * reaped with `wait4`, so their resource usage is reported with their status.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @struct ResourceUsage
+     * @brief What a finished child process (and the descendants it waited for) consumed.
+     */
+    struct ResourceUsage {
+        double wall_seconds = 0.0;              ///< Time from spawn to exit.
+        double user_seconds = 0.0;              ///< User-mode CPU time.
+        double system_seconds = 0.0;            ///< Kernel-mode CPU time.
+        std::int64_t max_rss_kb = 0;            ///< Peak resident set size of the largest process, in KiB.
+        std::int64_t voluntary_switches = 0;    ///< Context switches while waiting (I/O, sleeps, ...).
+        std::int64_t involuntary_switches = 0;  ///< Context switches due to preemption.
+        std::int64_t read_bytes = -1;           ///< Bytes fetched from storage, or -1 if `/proc/<pid>/io` was unavailable.
+        std::int64_t write_bytes = -1;          ///< Bytes sent to storage, or -1 if `/proc/<pid>/io` was unavailable.
+    };
+
+    /**
+     * @struct ExitStatus
+     * @brief The decoded outcome of a finished child process.
+     */
+    struct ExitStatus {
+        /// @brief How the process ended.
+        enum class Kind {
+            Exited,      ///< The process called exit(); `code` holds the exit code.
+            Signaled,    ///< The process was killed; `signal` holds the signal number.
+            SpawnFailed  ///< The process could not be started; `error` holds the errno.
+        };
+
+        Kind kind = Kind::Exited;
+        int code = 0;
+        int signal = 0;
+        int error = 0;
+
+        /// @brief True if the process group was terminated because its deadline passed.
+        bool timed_out = false;
+
+        /// @brief True if the process group was terminated because the run was cancelled.
+        bool cancelled = false;
+
+        /// @brief Resource usage collected when the process was reaped.
+        ResourceUsage usage;
+
+        /// @brief True if the process exited normally with code 0.
+        bool success() const;
+
+        /// @brief A short human-readable description, e.g. "Exit code: 2".
+        std::string describe() const;
+
+        /**
+         * @brief Decodes a status word as returned by `waitpid`.
+         * @param status The raw wait status.
+         * @return The decoded exit status.
+         */
+        static ExitStatus from_wait_status(int status);
+    };
+
+    /**
+     * @class Process
+     * @brief A child process started for a task.
+     *
+     * The child is placed in a new process group whose ID equals its PID. On
+     * Linux a pidfd is opened for it so that waiting with a deadline is a
+     * single `poll` call. A Process should be waited on exactly once; one
+     * destroyed or overwritten before that kills its process group and reaps
+     * the child, so an early return or exception leaves nothing running.
+     */
+    class Process {
+    public:
+        Process() = default;
+        ~Process();
+        Process(Process&& other) noexcept;
+        Process& operator=(Process&& other) noexcept;
+        Process(const Process&) = delete;
+        Process& operator=(const Process&) = delete;
+
+        /**
+         * @brief Starts the command of a task.
+         *
+         * On failure to start, the returned Process is not running and
+         * `wait()` reports `ExitStatus::Kind::SpawnFailed`.
+         *
+         * @param task The task whose command and environment are used.
+         * @param stdout_fd If non-negative, becomes the child's stdout (e.g. a pipe's write end).
+         * @param stderr_fd If non-negative, becomes the child's stderr.
+         * @param status_fd If non-negative, becomes the child's descriptor `STATUS_FD`, on which a
+         *        fused script reports its members' exit codes.
+         * @param stdin_fd If non-negative, becomes the child's stdin; otherwise stdin is `/dev/null`,
+         *        since a task in its own process group cannot read dagra's terminal.
+         * @return The started process.
+         */
+        static Process spawn(const core::Task& task, int stdout_fd = -1, int stderr_fd = -1, int status_fd = -1,
+                             int stdin_fd = -1);
+
+        /**
+         * @brief Blocks until the process exits and reaps it.
+         *
+         * The exited child's `/proc/<pid>/io` counters are read before it is
+         * reaped with `wait4`, which supplies the rest of `ExitStatus::usage`.
+         *
+         * @return The decoded exit status.
+         */
+        ExitStatus wait();
+
+        /**
+         * @brief Waits for the process, terminating its process group at the deadline.
+         *
+         * When `timeout` elapses, SIGTERM is sent to the whole process group.
+         * If the process has not exited after `grace`, the group receives
+         * SIGKILL. Either way the returned status has `timed_out` set.
+         *
+         * If `cancel_fd` becomes readable first, the group is terminated the
+         * same way and the status has `cancelled` set instead.
+         *
+         * @param timeout The maximum run time; zero or negative means no limit.
+         * @param grace How long to wait between SIGTERM and SIGKILL.
+         * @param cancel_fd A descriptor that becomes readable to cancel the task, or -1.
+         * @return The decoded exit status.
+         */
+        ExitStatus wait_with_timeout(std::chrono::milliseconds timeout, std::chrono::milliseconds grace,
+                                     int cancel_fd = -1);
+
+        /**
+         * @brief Terminates the process group and reaps the process.
+         *
+         * SIGTERM is sent to the whole group; if the process has not exited
+         * after `grace`, the group receives SIGKILL.
+         *
+         * @param grace How long to wait between SIGTERM and SIGKILL.
+         * @return The decoded exit status.
+         */
+        ExitStatus terminate(std::chrono::milliseconds grace);
+
+        /// @brief The process ID, or -1 if the process could not be started.
+        pid_t pid() const;
+
+        /**
+         * @brief The pidfd of the process, which becomes readable when it exits.
+         * @return The descriptor, or -1 if the process is not running or pidfds are unsupported.
+         */
+        int pidfd() const;
+
+        /**
+         * @brief Checks without blocking whether the process has exited.
+         *
+         * The process is not reaped, so `wait()` must still be called.
+         *
+         * @return True if the process has exited or was never started.
+         */
+        bool has_exited();
+
+        /**
+         * @brief Sends a signal to the process group without waiting.
+         *
+         * The group ID cannot be reused before `wait()` reaps the leader, so
+         * this is safe until then.
+         *
+         * @param signal The signal number.
+         */
+        void signal_group(int signal);
+
+    private:
+        /**
+         * @brief Waits up to `limit` for the process to exit, without reaping it.
+         * @param limit The maximum time to wait.
+         * @param cancel_fd If non-negative, the wait also ends when it becomes readable.
+         * @return True if the process has exited.
+         */
+        bool wait_exit_for(std::chrono::milliseconds limit, int cancel_fd = -1);
+
+        /// @brief Kills the process group of a child that was never waited for, reaps it and closes the pidfd.
+        void discard();
+
+        pid_t pid_ = -1;
+        int pidfd_ = -1;
+        int spawn_error_ = 0;
+        std::chrono::steady_clock::time_point started_;
+    };
+
+    /**
+     * @brief Checks whether a command needs `/bin/sh` to be interpreted correctly.
+     *
+     * Commands containing quoting, expansion, redirection, control operators,
+     * glob characters, leading variable assignments or shell builtins need a shell.
+     *
+     * @param command The command string of a task.
+     * @return True if the command must be run through `/bin/sh -c`.
+     */
+    bool needs_shell(const std::string& command);
+
+    /**
+     * @brief Builds the argument vector used to start a command.
+     * @param command The command string of a task.
+     * @param use_shell Whether to wrap the command in `/bin/sh -c`.
+     * @return The argument vector; the first element is the program to run.
+     */
+    std::vector<std::string> build_argv(const std::string& command, bool use_shell);
+
+    /// @brief The descriptor on which a fused script writes one `<position> <exit code>` line per member.
+    constexpr int STATUS_FD = 3;
+
+    /**
+     * @brief Builds one shell script running several task commands in order.
+     *
+     * Each command runs in its own subshell, so `cd`, `exit` or variable
+     * assignments in one command do not leak into the next, and `STATUS_FD`
+     * is closed for it. After each command the script writes the command's
+     * position and exit code to `STATUS_FD`. With `stop_on_failure`, a failed
+     * command ends the script unless its task has `allow_failure` set, like
+     * `a && b && c`; otherwise every command runs.
+     *
+     * @param tasks The tasks whose commands are run, in order.
+     * @param stop_on_failure Whether a failure skips the remaining commands.
+     * @return The script, to be run with `/bin/sh -c`.
+     */
+    std::string build_fused_script(const std::vector<const core::Task*>& tasks, bool stop_on_failure);
+
+    /**
+     * @brief Decodes the exit codes a fused script wrote to `STATUS_FD`.
+     * @param report The bytes read from the status pipe.
+     * @param count The number of commands in the script.
+     * @return One exit code per command; -1 for commands that reported none.
+     */
+    std::vector<int> parse_fused_status(const std::string& report, std::size_t count);
+
+    /**
+     * @brief Merges task environment variables into the parent environment.
+     *
+     * Entries are `KEY=value` strings; task variables replace parent variables
+     * with the same key. Values are passed literally, without shell expansion.
+     *
+     * @param overrides The task's environment variables.
+     * @return The full environment for the child process.
+     */
+    std::vector<std::string> build_environment(const std::vector<std::string>& overrides);
+
+} // namespace dagra::execution
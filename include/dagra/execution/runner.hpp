@@ -13,16 +13,136 @@
 #pragma once
 
 #include "dagra/core/dag.hpp"
+#include "dagra/core/fusion.hpp"
+#include "dagra/history/history.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace dagra::execution {
 
+    /// @brief Runs a task in-process instead of spawning its command; returns true on success.
+    using TaskExecutor = std::function<bool(const core::Task&)>;
+
+    /**
+     * @struct RunnerOptions
+     * @brief Tunables that control how the Runner executes a DAG.
+     */
+    struct RunnerOptions {
+        /// @brief If true, the runner only prints the execution plan.
+        bool dry_run = false;
+
+        /// @brief Maximum number of tasks running at once (0 = hardware concurrency).
+        std::size_t jobs = 0;
+
+        /**
+         * @brief If true, task commands are spawned and waited for on one thread (see `EventLoop`).
+         *
+         * No thread is tied up per running command, so `jobs` can be in the
+         * thousands for I/O-bound tasks; it is capped to what the open
+         * descriptor limit allows. Fused groups and persistent worker tasks
+         * still run on the thread pool. Ignored with `listen_address`.
+         */
+        bool event_loop = false;
+
+        /// @brief If true, a failed task only skips its transitive dependents; independent tasks keep running.
+        bool keep_going = false;
+
+        /// @brief If true, chains and batches of tasks are fused into single shell invocations (see `core::fuse_tasks`).
+        bool fuse = false;
+
+        /// @brief Limits on the groups formed when `fuse` is set.
+        core::FusionOptions fusion;
+
+        /**
+         * @brief Capacities of the resource pools tasks are admitted against.
+         *
+         * `cpu` and `memory_mb` default to the machine's core count and
+         * physical memory; any other resource a task requests must be
+         * declared here.
+         */
+        std::map<std::string, double> resource_pools;
+
+        /// @brief Number of tasks a persistent worker runs before it is replaced (0 = never).
+        std::size_t worker_max_requests = 1000;
+
+        /// @brief Time a timed-out task's process group gets between SIGTERM and SIGKILL.
+        std::chrono::milliseconds kill_grace{5000};
+
+        /// @brief Path of the execution cache file; empty disables the cache.
+        std::string cache_path;
+
+        /// @brief Path of the run journal recording completed tasks; empty disables it.
+        std::string journal_path;
+
+        /// @brief If true, tasks the journal records as completed with unchanged definitions are not run again.
+        bool resume = false;
+
+        /// @brief Path of the task history file used to weight scheduling; empty disables it.
+        std::string history_path;
+
+        /// @brief Directory receiving each task's full output as `<task-id>.log`; empty disables log files.
+        std::string log_dir;
+
+        /// @brief How much of a task's most recent output is kept and shown if it fails.
+        std::size_t output_tail_bytes = 16 * 1024;
+
+        /// @brief File receiving a Chrome trace-event timeline of the run; empty disables tracing.
+        std::string trace_path;
+
+        /**
+         * @brief Address on which `dagra-worker` agents connect; empty runs tasks locally.
+         *
+         * When set, task commands run on remote agents instead of being
+         * spawned, `fuse` is ignored, and `jobs` bounds the number of remote
+         * tasks in flight (0 selects `REMOTE_JOBS`). Persistent worker tasks
+         * still run locally.
+         */
+        std::string listen_address;
+
+        /**
+         * @brief A descriptor that becomes readable to cancel the run, or -1.
+         *
+         * Once it is readable no further task is dispatched, running
+         * process groups are terminated as on a timeout, and `execute_all`
+         * throws after the running tasks have been reaped. The runner never
+         * reads from it, so an eventfd stays signalled.
+         */
+        int cancel_fd = -1;
+
+        /**
+         * @brief If set, called on the worker instead of spawning each task's command.
+         *
+         * Used by benchmarks and tests to measure or exercise scheduling
+         * without process overhead. Output capture and the task history are
+         * bypassed; the cache and tracing behave as for real commands.
+         */
+        TaskExecutor executor;
+    };
+
+    /**
+     * @brief Estimates the cost of every task for critical-path scheduling.
+     *
+     * A task's `cost` hint wins over its recorded average duration. Tasks
+     * with neither are assumed to take as long as the average of the
+     * known estimates, or 1 if there are none.
+     *
+     * @param dag The graph being scheduled.
+     * @param history Past durations, possibly empty.
+     * @return One weight per task, indexed by `core::TaskIndex`.
+     */
+    std::vector<double> estimate_weights(const core::Dag& dag, const history::History& history);
+
     /**
      * @class Runner
      * @brief Manages the execution of a task DAG.
      *
      * The Runner is responsible for traversing the DAG and executing tasks
-     * as their dependencies are met. It uses a thread pool to run tasks in
-     * parallel and ensures that the entire process is thread-safe.
+     * as their dependencies are met. It uses a fixed-size thread pool to run
+     * tasks in parallel and ensures that the entire process is thread-safe.
      */
     class Runner {
     public:
@@ -33,6 +153,13 @@ namespace dagra::execution {
          */
         explicit Runner(const core::Dag& dag, bool dry_run = false);
 
+        /**
+         * @brief Constructs a new Runner with explicit options.
+         * @param dag The validated Directed Acyclic Graph of tasks to execute.
+         * @param options The execution options, such as the job limit.
+         */
+        Runner(const core::Dag& dag, const RunnerOptions& options);
+
         /**
          * @brief Executes all tasks in the DAG.
          *
@@ -46,7 +173,7 @@ namespace dagra::execution {
 
     private:
         const core::Dag& dag_;
-        const bool dry_run_;
+        const RunnerOptions options_;
     };
 
 } // namespace dagra::execution
@@ -0,0 +1,201 @@
+/**
+ * @file scheduler.hpp
+ * @brief Declares the dependency-tracking ready queue used by the Runner.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `Scheduler` class, which keeps a
+ * remaining-dependency counter for every task and walks the DAG's reverse
+ * edges, so that a task becomes ready the moment its last dependency finishes.
+ * Ready tasks are handed out in critical-path order, subject to the
+ * capacity of the resource pools they draw from.
+ */
+
+#pragma once
+
+#include "dagra/core/dag.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @brief The default capacity of the built-in resource pools on this machine.
+     * @return `cpu` set to the hardware concurrency and `memory_mb` to the physical memory in MiB.
+     */
+    std::map<std::string, double> machine_capacity();
+
+    /**
+     * @class Scheduler
+     * @brief Tracks task readiness for a DAG and hands out tasks as they become runnable.
+     *
+     * Tasks are referred to by their `core::TaskIndex` in the DAG.
+     * Completing a task costs O(out-degree): only its direct dependents have
+     * their counters decremented, and those reaching zero are pushed onto the
+     * ready queue. The Scheduler is not thread-safe; the Runner drives it from
+     * a single thread.
+     *
+     * Each task's priority is its bottom level: its own weight plus the
+     * heaviest chain of dependents below it, i.e. the least amount of work
+     * that must still happen after it starts. The ready queue is a binary
+     * heap on that priority, so when there are more ready tasks than free
+     * workers, the ones heading the longest remaining chains start first.
+     * Ties are broken by task index (declaration order), which keeps the
+     * dispatch order deterministic.
+     *
+     * Once `set_capacity` has been called, `pop_admissible` only hands out a
+     * task whose declared resources fit into what is left of every pool, and
+     * holds them until the task completes or fails. If the highest-priority
+     * ready task does not fit, the best task that does is backfilled into
+     * the leftover capacity; after `MAX_BACKFILL_BYPASSES` such bypasses the
+     * blocked task is waited for, so a large task cannot be starved by a
+     * stream of small ones.
+     */
+    class Scheduler {
+    public:
+        /**
+         * @brief Builds the dependency counters and priorities for a DAG.
+         * @param dag The graph to schedule. It must outlive the Scheduler.
+         * @param weights The estimated cost of each task, indexed by `core::TaskIndex`.
+         *                If empty, every task weighs 1 and priorities are chain lengths.
+         */
+        explicit Scheduler(const core::Dag& dag, const std::vector<double>& weights = {});
+
+        /// @brief How many times a blocked ready task may be overtaken by backfilled tasks.
+        static constexpr std::size_t MAX_BACKFILL_BYPASSES = 16;
+
+        /**
+         * @brief Declares the resource pools tasks are admitted against.
+         * @param capacity The capacity of each pool by name.
+         * @throw std::runtime_error If a task requests a resource that has no pool,
+         *        or more of it than the pool holds.
+         */
+        void set_capacity(const std::map<std::string, double>& capacity);
+
+        /**
+         * @brief Removes the best ready task whose resources fit and acquires them.
+         *
+         * Without declared pools, or if no task requests resources, this is
+         * the same as `pop_ready`.
+         *
+         * @param index Receives the index of the task to dispatch.
+         * @return False if no ready task may be admitted right now.
+         */
+        bool pop_admissible(std::size_t& index);
+
+        /**
+         * @brief Checks whether at least one task is waiting to be dispatched.
+         * @return True if the ready queue is not empty.
+         */
+        bool has_ready() const;
+
+        /**
+         * @brief Removes the highest-priority task from the ready queue.
+         * @return The index of the task to dispatch.
+         * @pre `has_ready()` is true.
+         */
+        std::size_t pop_ready();
+
+        /**
+         * @brief Records a successful completion and releases its dependents and resources.
+         * @param index The index of the completed task.
+         */
+        void mark_completed(std::size_t index);
+
+        /**
+         * @brief Marks tasks completed by an earlier run before anything is dispatched.
+         *
+         * The dependents of the given tasks have their counters decremented
+         * and the ready queue is rebuilt, in O(tasks + edges).
+         *
+         * @param done Per-task flag, true for tasks that need not run.
+         * @pre No task has been popped yet, and every dependency of a done task is done.
+         */
+        void mark_resumed(const std::vector<std::uint8_t>& done);
+
+        /**
+         * @brief Records a failure and gives up on everything that depends on the task.
+         *
+         * Every transitive dependent that has not already been given up on is
+         * marked as skipped. They can never become ready, because the failed
+         * task never completes. Independent tasks are unaffected.
+         *
+         * @param index The index of the failed task.
+         * @return The newly skipped tasks, nearest dependents first.
+         */
+        std::vector<core::TaskIndex> mark_failed(std::size_t index);
+
+        /**
+         * @brief Retrieves the task stored at the given index.
+         * @param index A task index handed out by this Scheduler.
+         * @return A constant reference to the task.
+         */
+        const core::Task& task(std::size_t index) const;
+
+        /**
+         * @brief Reports whether the task at the given index has completed.
+         * @param index A task index handed out by this Scheduler.
+         * @return True if `mark_completed` was called for the task.
+         */
+        bool is_completed(std::size_t index) const;
+
+        /**
+         * @brief The priority (bottom level) of a task.
+         * @param index A valid task index.
+         * @return The task's weight plus the heaviest chain of its dependents.
+         */
+        double priority(std::size_t index) const;
+
+        /// @brief The total number of tasks being scheduled.
+        std::size_t size() const;
+
+        /// @brief The number of tasks that have completed so far.
+        std::size_t completed_count() const;
+
+        /// @brief True once every task has completed, failed or been skipped.
+        bool finished() const;
+
+    private:
+        /// @brief Adds a task to the ready heap.
+        void push_ready(core::TaskIndex index);
+
+        /// @brief Heap ordering: true if `a` should be dispatched after `b`.
+        bool lower_priority(core::TaskIndex a, core::TaskIndex b) const;
+
+        /// @brief True if the task's demands fit into the free capacity.
+        bool fits(core::TaskIndex index) const;
+
+        /// @brief Takes the task's demands out of the free capacity.
+        void acquire(core::TaskIndex index);
+
+        /// @brief Returns the resources held by a task, if any.
+        void release(std::size_t index);
+
+        const core::Dag& dag_;
+        std::vector<std::uint32_t> remaining_;
+        std::vector<bool> completed_;
+        std::vector<bool> abandoned_;
+        std::vector<double> priority_;
+        std::vector<core::TaskIndex> ready_;
+        std::size_t completed_count_ = 0;
+        std::size_t abandoned_count_ = 0;
+
+        /// @brief One task's demand on one pool.
+        struct Demand {
+            std::uint32_t pool;
+            double amount;
+        };
+
+        std::vector<double> capacity_;
+        std::vector<double> free_;
+        std::vector<std::uint32_t> demand_offsets_;
+        std::vector<Demand> demands_;
+        std::vector<bool> holding_;
+        std::size_t holding_count_ = 0;
+        core::TaskIndex blocked_head_ = static_cast<core::TaskIndex>(-1);
+        std::size_t bypasses_ = 0;
+    };
+
+} // namespace dagra::execution
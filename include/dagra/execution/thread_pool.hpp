@@ -0,0 +1,91 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Declares a fixed-size, work-stealing thread pool.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `ThreadPool` class used by the
+ * Runner to bound the number of tasks executing at the same time. Every
+ * worker owns a job deque; idle workers steal from the others so that no
+ * thread sits idle while work is queued elsewhere.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @class ThreadPool
+     * @brief A fixed set of worker threads executing submitted jobs.
+     *
+     * Jobs are distributed round-robin across the per-worker deques. A worker
+     * takes jobs from the front of its own deque and, when that is empty,
+     * steals from the back of another worker's deque. The destructor waits
+     * for every queued job to finish before joining the workers.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @brief Starts the worker threads.
+         * @param threads The number of workers. Zero selects `default_concurrency()`.
+         */
+        explicit ThreadPool(std::size_t threads);
+
+        /// @brief Finishes all queued jobs and joins the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Queues a job for execution on one of the workers.
+         * @param job The callable to run. It must not throw.
+         */
+        void submit(std::function<void()> job);
+
+        /// @brief The number of worker threads in the pool.
+        std::size_t size() const;
+
+        /**
+         * @brief The default worker count, based on the hardware concurrency.
+         * @return `std::thread::hardware_concurrency()`, or 1 if it is unknown.
+         */
+        static std::size_t default_concurrency();
+
+        /**
+         * @brief The index of the calling worker thread.
+         * @return The worker's index in its pool, or `NOT_A_WORKER` on any other thread.
+         */
+        static std::size_t current_worker();
+
+        /// @brief Returned by `current_worker()` outside of pool threads.
+        static constexpr std::size_t NOT_A_WORKER = static_cast<std::size_t>(-1);
+
+    private:
+        /// @brief A worker-owned job deque.
+        struct Queue {
+            std::mutex mtx;
+            std::deque<std::function<void()>> jobs;
+        };
+
+        void worker_loop(std::size_t index);
+        bool try_take(std::size_t index, std::function<void()>& job);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        std::ptrdiff_t pending_ = 0;
+        std::size_t next_queue_ = 0;
+        bool stopping_ = false;
+    };
+
+} // namespace dagra::execution
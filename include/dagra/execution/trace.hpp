@@ -0,0 +1,105 @@
+/**
+ * @file trace.hpp
+ * @brief Declares the recorder behind `--trace`, which exports the execution timeline.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `TraceRecorder` class. It records
+ * when every task became ready, was dispatched, was picked up by a worker,
+ * and when its process started and exited, and writes the result in the
+ * Chrome trace-event format understood by Perfetto and chrome://tracing.
+ */
+
+#pragma once
+
+#include "dagra/core/dag.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @class TraceRecorder
+     * @brief Collects per-task timestamps of one run into preallocated storage.
+     *
+     * Storage for every task is allocated up front, one fixed-size slot per
+     * task, so recording is a clock read and a store with no allocation or
+     * locking. Each field of a slot is written by exactly one thread: the
+     * scheduling thread records readiness and dispatch, and the worker
+     * running the task records the rest. The dispatch itself (a mutex
+     * hand-off through the thread pool) orders the two.
+     */
+    class TraceRecorder {
+    public:
+        /// @brief How a traced task ended.
+        enum class Outcome : std::uint8_t { Pending, Succeeded, Failed, Cached };
+
+        /**
+         * @brief Allocates a slot for every task and starts the clock.
+         * @param dag The graph being run.
+         */
+        explicit TraceRecorder(const core::Dag& dag);
+
+        /// @brief Records that a task's dependencies have all completed.
+        void ready(core::TaskIndex task);
+
+        /// @brief Records that a task was submitted to the thread pool.
+        void dispatched(core::TaskIndex task);
+
+        /**
+         * @brief Records that a worker started working on a task.
+         * @param task The task.
+         * @param worker The index of the worker thread.
+         */
+        void started(core::TaskIndex task, std::size_t worker);
+
+        /// @brief Records that the task's process is about to be spawned.
+        void spawned(core::TaskIndex task);
+
+        /// @brief Records that the task's process has been reaped.
+        void exited(core::TaskIndex task);
+
+        /**
+         * @brief Records that the worker finished the task.
+         * @param task The task.
+         * @param outcome How the task ended.
+         */
+        void finished(core::TaskIndex task, Outcome outcome);
+
+        /**
+         * @brief Writes the trace as Chrome trace-event JSON.
+         *
+         * Each worker slot is a thread track holding one slice per task
+         * (with a nested `process` slice while its process ran). The time a
+         * task spent ready but not yet dispatched, and dispatched but not yet
+         * picked up, appear as async slices on a separate `scheduler` track.
+         *
+         * @param path The output file.
+         * @throw std::runtime_error If the file cannot be written.
+         */
+        void write(const std::string& path) const;
+
+    private:
+        /// @brief The timestamps of one task, in nanoseconds since the recorder was created (-1 = never).
+        struct Slot {
+            std::int64_t ready = -1;
+            std::int64_t dispatched = -1;
+            std::int64_t started = -1;
+            std::int64_t spawned = -1;
+            std::int64_t exited = -1;
+            std::int64_t finished = -1;
+            std::uint32_t worker = 0;
+            Outcome outcome = Outcome::Pending;
+        };
+
+        /// @brief Nanoseconds elapsed since the recorder was created.
+        std::int64_t now() const;
+
+        const core::Dag& dag_;
+        std::chrono::steady_clock::time_point origin_;
+        std::vector<Slot> slots_;
+    };
+
+} // namespace dagra::execution
@@ -0,0 +1,129 @@
+/**
+ * @file worker_pool.hpp
+ * @brief Declares the pool of persistent worker processes.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `WorkerPool` class and the
+ * helpers implementing the worker protocol. Tasks with a `worker` are not
+ * spawned one process each; their requests are sent to long-lived worker
+ * processes, so tools with an expensive startup (compilers, linters, JVM
+ * tools) pay for it once per worker instead of once per task.
+ *
+ * A worker reads requests from its stdin and writes replies to its stdout.
+ * Every message is a JSON object preceded by its length in bytes as a
+ * decimal number and a newline, e.g. `17\n{"exit_code": 0}`. A request
+ * holds the task's `id`, `command`, `inputs` and `outputs`; a reply holds
+ * the task's `exit_code` and, optionally, its `output`.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include "dagra/execution/process.hpp"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dagra::execution {
+
+    /**
+     * @struct WorkerOptions
+     * @brief Controls how long workers live.
+     */
+    struct WorkerOptions {
+        /// @brief Number of requests after which a worker is replaced; 0 means never.
+        std::size_t max_requests = 1000;
+
+        /// @brief Time a worker being stopped gets between SIGTERM and SIGKILL.
+        std::chrono::milliseconds kill_grace{5000};
+    };
+
+    /**
+     * @struct WorkerReply
+     * @brief The outcome of one request sent to a worker.
+     */
+    struct WorkerReply {
+        /// @brief The task's exit code, or `timed_out`/`cancelled` if the worker was stopped.
+        ExitStatus status;
+
+        /// @brief The output the worker reported for the task.
+        std::string output;
+
+        /// @brief Why no valid reply was received, or empty.
+        std::string error;
+
+        /// @brief True if a reply was received in time and reports exit code 0.
+        bool success() const { return error.empty() && !status.timed_out && !status.cancelled && status.success(); }
+    };
+
+    /**
+     * @brief Builds the framed request for a task.
+     * @param task The task to run.
+     * @return The length line followed by the JSON request.
+     */
+    std::string encode_worker_request(const core::Task& task);
+
+    /**
+     * @brief Decodes the JSON body of a reply.
+     * @param body The JSON object, without its length line.
+     * @param exit_code Receives the reported exit code.
+     * @param output Receives the reported output, or an empty string.
+     * @return False if the body is not an object with an integer `exit_code`.
+     */
+    bool decode_worker_reply(const std::string& body, int& exit_code, std::string& output);
+
+    /**
+     * @class WorkerPool
+     * @brief Keeps persistent worker processes and dispatches requests to them.
+     *
+     * Workers are grouped by their command line and environment. A request
+     * takes an idle worker of its group or starts a new one, so at most as
+     * many workers run as requests are in flight. A worker is replaced after
+     * `max_requests` requests and after any failure: a non-zero exit code, a
+     * malformed reply, a timeout or a cancellation. Worker stderr is not
+     * captured, since it outlives any single task; it goes to dagra's stderr.
+     * All methods are thread-safe.
+     */
+    class WorkerPool {
+    public:
+        /**
+         * @brief Creates an empty pool; workers are started on demand.
+         * @param options How long workers live.
+         */
+        explicit WorkerPool(const WorkerOptions& options = WorkerOptions());
+
+        /// @brief Closes every idle worker's stdin and reaps it.
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /**
+         * @brief Runs a task on a worker started from its `worker` command line.
+         * @param task The task; `worker` must be set.
+         * @param timeout The maximum time to wait for the reply; zero or negative means no limit.
+         * @param cancel_fd A descriptor that becomes readable to cancel the request, or -1.
+         * @return The reply, or the reason none was received.
+         */
+        WorkerReply run(const core::Task& task, std::chrono::milliseconds timeout, int cancel_fd = -1);
+
+        /// @brief The number of worker processes started so far.
+        std::size_t started() const;
+
+    private:
+        struct Worker;
+
+        /// @brief Stops a worker: closes its stdin and reaps it, killing it if it does not exit.
+        void retire(std::unique_ptr<Worker> worker) const;
+
+        const WorkerOptions options_;
+        mutable std::mutex mutex_;
+        std::map<std::string, std::vector<std::unique_ptr<Worker>>> idle_;
+        std::size_t started_ = 0;
+    };
+
+} // namespace dagra::execution
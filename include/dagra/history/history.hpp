@@ -0,0 +1,114 @@
+/**
+ * @file history.hpp
+ * @brief Declares the persistent record of past task runs.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `History` class, which keeps the
+ * resource usage of the most recent successful runs of every task. The
+ * Scheduler uses the smoothed durations to prioritise tasks on the critical
+ * path, and `dagra report` ranks tasks and flags regressions from it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dagra::history {
+
+    /**
+     * @struct RunSample
+     * @brief The measured cost of one successful run of a task.
+     */
+    struct RunSample {
+        std::int64_t timestamp = 0;             ///< When the run finished, in seconds since the Unix epoch.
+        double wall_seconds = 0.0;              ///< Wall-clock duration.
+        double user_seconds = 0.0;              ///< User-mode CPU time.
+        double system_seconds = 0.0;            ///< Kernel-mode CPU time.
+        std::int64_t max_rss_kb = 0;            ///< Peak resident set size, in KiB.
+        std::int64_t voluntary_switches = 0;    ///< Voluntary context switches.
+        std::int64_t involuntary_switches = 0;  ///< Involuntary context switches.
+        std::int64_t read_bytes = -1;           ///< Bytes read from storage, or -1 if unknown.
+        std::int64_t write_bytes = -1;          ///< Bytes written to storage, or -1 if unknown.
+
+        /// @brief Total CPU time (user + system).
+        double cpu_seconds() const { return user_seconds + system_seconds; }
+    };
+
+    /**
+     * @struct TaskRecord
+     * @brief What is known about past successful runs of one task.
+     */
+    struct TaskRecord {
+        /// @brief Exponentially weighted moving average of the wall-clock duration, in seconds.
+        double duration_seconds = 0.0;
+
+        /// @brief The retained runs, oldest first (at most `History::MAX_SAMPLES`).
+        std::vector<RunSample> samples;
+    };
+
+    /**
+     * @class History
+     * @brief A table from task ID to `TaskRecord`, stored as a tab-separated text file.
+     *
+     * Each line of the file is one run: the task ID followed by the fields of
+     * a `RunSample`. Only the newest `MAX_SAMPLES` runs of each task are kept,
+     * so the file stays small however many runs accumulate. `record` is
+     * thread-safe so worker threads can report runs directly; `find` and
+     * `records` must not race with `record`.
+     */
+    class History {
+    public:
+        /// @brief Weight of the newest run in the moving average.
+        static constexpr double SMOOTHING = 0.5;
+
+        /// @brief The number of runs kept per task.
+        static constexpr std::size_t MAX_SAMPLES = 20;
+
+        /**
+         * @brief Loads a history file. A missing file or malformed lines yield an empty history.
+         * @param path The history file path.
+         */
+        void load(const std::string& path);
+
+        /**
+         * @brief Looks up the record of a task.
+         * @param task_id The task ID.
+         * @return The record, or nullptr if the task has never completed.
+         */
+        const TaskRecord* find(const std::string& task_id) const;
+
+        /// @brief Every task record, keyed by task ID.
+        const std::unordered_map<std::string, TaskRecord>& records() const;
+
+        /**
+         * @brief Records a successful run. Thread-safe.
+         * @param task_id The task ID.
+         * @param sample The measured cost of the run.
+         */
+        void record(const std::string& task_id, const RunSample& sample);
+
+        /**
+         * @brief Writes the history back to the path it was loaded from, replacing the file atomically.
+         * @throw std::runtime_error If the file cannot be written.
+         */
+        void save();
+
+        /// @brief The number of tasks with a record.
+        std::size_t size() const;
+
+    private:
+        /// @brief Appends a sample to a record and updates its moving average.
+        static void add_sample(TaskRecord& record, const RunSample& sample);
+
+        std::string path_;
+        mutable std::mutex mtx_;
+        std::unordered_map<std::string, TaskRecord> records_;
+        bool dirty_ = false;
+    };
+
+} // namespace dagra::history
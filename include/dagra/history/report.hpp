@@ -0,0 +1,78 @@
+/**
+ * @file report.hpp
+ * @brief Declares the `dagra report` cost ranking and regression check.
+ * @version 1.1.0
+ *
+ * This file contains the functions that turn a `History` into a table of
+ * tasks ranked by the cost of their latest run, followed by the tasks whose
+ * latest run was markedly more expensive than the runs before it.
+ */
+
+#pragma once
+
+#include "dagra/history/history.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dagra::history {
+
+    /// @brief The metric tasks are ranked by.
+    enum class SortKey {
+        Wall,   ///< Wall-clock time.
+        Cpu,    ///< User + system CPU time.
+        Memory, ///< Peak resident set size.
+        Io      ///< Storage bytes read + written.
+    };
+
+    /**
+     * @brief Parses a sort key name ("wall", "cpu", "memory" or "io").
+     * @param name The name to parse.
+     * @param key Receives the key on success.
+     * @return False if the name is unknown.
+     */
+    bool parse_sort_key(const std::string& name, SortKey& key);
+
+    /**
+     * @struct ReportOptions
+     * @brief Controls what `write_report` prints.
+     */
+    struct ReportOptions {
+        SortKey sort = SortKey::Wall;      ///< The ranking metric.
+        std::size_t limit = 20;            ///< Maximum number of ranked tasks (0 = all).
+        double regression_threshold = 0.25; ///< Relative growth above which a metric is a regression.
+    };
+
+    /**
+     * @struct Regression
+     * @brief A metric whose latest value grew past the threshold.
+     */
+    struct Regression {
+        std::string task;   ///< The task ID.
+        std::string metric; ///< "wall", "cpu" or "memory".
+        double before;      ///< Median of the earlier runs.
+        double after;       ///< Value in the latest run.
+    };
+
+    /**
+     * @brief Compares each task's latest run against the median of its earlier runs.
+     *
+     * Wall and CPU growth below 0.1 s is ignored as noise. Tasks with a single
+     * recorded run cannot regress.
+     *
+     * @param history The recorded runs.
+     * @param threshold The relative growth that counts as a regression (0.25 = 25%).
+     * @return The regressions, largest relative growth first.
+     */
+    std::vector<Regression> find_regressions(const History& history, double threshold);
+
+    /**
+     * @brief Prints the ranked cost table and the regressions.
+     * @param history The recorded runs.
+     * @param options What to print.
+     * @param out The stream to write to.
+     */
+    void write_report(const History& history, const ReportOptions& options, std::ostream& out);
+
+} // namespace dagra::history
@@ -0,0 +1,85 @@
+/**
+ * @file agent.hpp
+ * @brief Declares the agent run by the `dagra-worker` executable.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `Agent` class. An agent
+ * connects to a coordinator (`dagra config.yaml --listen ADDRESS`),
+ * announces how many tasks it runs at once, and then runs every task it is
+ * sent as a local process, streaming the output back and reporting the exit
+ * status and resource usage when the task ends.
+ */
+
+#pragma once
+
+#include "dagra/remote/protocol.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace dagra::remote {
+
+    /**
+     * @struct AgentOptions
+     * @brief Controls where an agent connects and how much work it takes.
+     */
+    struct AgentOptions {
+        /// @brief The coordinator's address: `HOST:PORT` or `unix:PATH`.
+        std::string address;
+
+        /// @brief How many tasks run at once; 0 selects the hardware concurrency.
+        std::size_t slots = 0;
+
+        /// @brief The name reported to the coordinator; empty selects `<hostname>:<pid>`.
+        std::string name;
+
+        /// @brief If true, `serve` returns after the first coordinator disconnects instead of reconnecting.
+        bool once = false;
+
+        /// @brief Time between attempts to reach the coordinator.
+        std::chrono::milliseconds retry_delay{1000};
+    };
+
+    /**
+     * @class Agent
+     * @brief Runs the tasks a coordinator sends, up to a fixed number at once.
+     *
+     * Tasks run in the agent's working directory with the task's environment
+     * merged into the agent's, exactly as `dagra` would run them locally: in
+     * their own process group, with their timeout enforced and their output
+     * captured through pipes. A cancel request, or losing the coordinator,
+     * terminates the running tasks' process groups.
+     */
+    class Agent {
+    public:
+        /**
+         * @brief Prepares an agent; nothing is connected yet.
+         * @param options Where to connect and how much work to take.
+         * @throw std::runtime_error If the address is malformed.
+         */
+        explicit Agent(const AgentOptions& options);
+
+        /**
+         * @brief Connects to the coordinator and serves it.
+         *
+         * Connection attempts are retried every `retry_delay`, so agents may
+         * be started before the coordinator. When the coordinator goes away,
+         * the agent reconnects, unless `once` is set.
+         */
+        void serve();
+
+        /// @brief The name reported to the coordinator.
+        const std::string& name() const;
+
+        /// @brief The number of tasks run at once.
+        std::size_t slots() const;
+
+    private:
+        /// @brief Serves one connection until it closes.
+        void serve_connection(int fd);
+
+        Address address_;
+        AgentOptions options_;
+    };
+
+} // namespace dagra::remote
@@ -0,0 +1,159 @@
+/**
+ * @file coordinator.hpp
+ * @brief Declares the coordinator that dispatches tasks to remote `dagra-worker` agents.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `Coordinator` class. With
+ * `--listen ADDRESS`, the runner does not spawn task commands itself: it
+ * accepts connections from `dagra-worker` agents, each of which announces
+ * how many tasks it runs at once, and sends every ready task to a free
+ * remote slot. Output is streamed back while the task runs.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include "dagra/execution/process.hpp"
+#include "dagra/remote/protocol.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace dagra::remote {
+
+    /**
+     * @struct CoordinatorOptions
+     * @brief Controls where the coordinator listens and how it handles lost agents.
+     */
+    struct CoordinatorOptions {
+        /// @brief The address to listen on: `HOST:PORT`, `:PORT` or `unix:PATH`.
+        std::string address;
+
+        /// @brief How many agents may be lost while running one task before it fails.
+        std::size_t max_attempts = 3;
+
+        /// @brief Time a timed-out or cancelled task gets between SIGTERM and SIGKILL on its agent.
+        std::chrono::milliseconds kill_grace{5000};
+
+        /// @brief A descriptor that cancels every remote task when it becomes readable, or -1.
+        int cancel_fd = -1;
+    };
+
+    /**
+     * @struct RemoteResult
+     * @brief The outcome of a task run on an agent.
+     */
+    struct RemoteResult {
+        /// @brief How the task ended, with the resource usage measured by the agent.
+        execution::ExitStatus status;
+
+        /// @brief The name of the agent that ran the task to completion.
+        std::string agent;
+
+        /// @brief Why the task could not be run to completion, or empty.
+        std::string error;
+
+        /// @brief True if the task ran and exited with code 0.
+        bool success() const { return error.empty() && !status.timed_out && !status.cancelled && status.success(); }
+    };
+
+    /**
+     * @class Coordinator
+     * @brief Accepts agents and runs tasks on their slots.
+     *
+     * A background thread accepts connections, reads every agent's messages
+     * and writes streamed output into the pipes of the tasks it belongs to.
+     * `run` blocks the calling thread until a slot is free, so no agent is
+     * ever sent more tasks than it announced; this is the backpressure that
+     * keeps a large graph from flooding the fleet. A task goes to the agent
+     * with the most free slots.
+     *
+     * An agent whose connection breaks is dropped, and every task it was
+     * running is sent to another agent, up to `max_attempts` times. Output
+     * that the lost agent streamed before it disappeared stays in the task's
+     * log. All methods are thread-safe.
+     */
+    class Coordinator {
+    public:
+        /**
+         * @brief Starts listening and starts the background thread.
+         * @param options Where to listen and how to handle lost agents.
+         * @throw std::runtime_error If the address is invalid or cannot be bound.
+         */
+        explicit Coordinator(const CoordinatorOptions& options);
+
+        /// @brief Disconnects every agent, stops the background thread and closes the socket.
+        ~Coordinator();
+
+        Coordinator(const Coordinator&) = delete;
+        Coordinator& operator=(const Coordinator&) = delete;
+
+        /**
+         * @brief Runs a task on a free remote slot, waiting for one if necessary.
+         *
+         * The task's command, environment and timeout are sent to the agent,
+         * which enforces the timeout itself. If the cancel descriptor fires,
+         * running tasks are cancelled on their agents and waiting ones return
+         * at once; both report `status.cancelled`.
+         *
+         * @param task The task to run.
+         * @param stdout_fd Receives the task's stdout lines as they arrive, or -1 to discard them.
+         * @param stderr_fd Receives the task's stderr lines as they arrive, or -1 to discard them.
+         * @return How the task ended.
+         */
+        RemoteResult run(const core::Task& task, int stdout_fd, int stderr_fd);
+
+        /// @brief The address actually bound, with an ephemeral port resolved.
+        std::string address() const;
+
+        /// @brief The number of agents connected and announced.
+        std::size_t agents() const;
+
+        /// @brief The total number of slots of the connected agents.
+        std::size_t slots() const;
+
+        /// @brief The number of agents lost so far.
+        std::size_t lost() const;
+
+    private:
+        struct Agent;
+        struct Request;
+
+        /// @brief The background thread: accepts agents and reads their messages.
+        void loop();
+
+        /// @brief Handles one message from an agent (lock held).
+        void handle(Agent& agent, const Message& message);
+
+        /// @brief Drops an agent, handing its tasks back to their callers (lock held).
+        void drop(int fd, const std::string& reason);
+
+        /// @brief Sends a cancel request for every running task (lock held).
+        void cancel_all();
+
+        /// @brief Wakes the background thread through its eventfd.
+        void wake() const;
+
+        const CoordinatorOptions options_;
+        Address bound_;
+        int listen_fd_ = -1;
+        int wake_fd_ = -1;
+
+        mutable std::mutex mutex_;
+        std::condition_variable changed_;
+        std::map<int, std::unique_ptr<Agent>> agents_;
+        std::map<std::uint64_t, Request*> requests_;
+        std::uint64_t next_seq_ = 1;
+        std::size_t lost_ = 0;
+        bool cancelled_ = false;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+
+} // namespace dagra::remote
@@ -0,0 +1,143 @@
+/**
+ * @file protocol.hpp
+ * @brief Declares the wire protocol between the coordinator and `dagra-worker` agents.
+ * @version 1.1.0
+ *
+ * This file contains the address helpers and the message codec used for
+ * distributed execution. Coordinator and agents talk over one stream
+ * socket, either TCP (`HOST:PORT`) or a Unix socket (`unix:PATH`). Every
+ * message is a JSON object framed like the persistent worker protocol: its
+ * length in bytes as a decimal number, a newline, then the object.
+ *
+ * | Type     | Direction           | Fields                                                         |
+ * | -------- | ------------------- | -------------------------------------------------------------- |
+ * | `hello`  | agent → coordinator | `name`, `slots`                                                |
+ * | `run`    | coordinator → agent | `seq`, `id`, `command`, `env`, `timeout`, `kill_grace_ms`      |
+ * | `cancel` | coordinator → agent | `seq`                                                          |
+ * | `output` | agent → coordinator | `seq`, `stderr`, `data` (complete lines)                       |
+ * | `exit`   | agent → coordinator | `seq`, `code`, `signal`, `spawn_error`, `timed_out`, `cancelled`, resource usage |
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include "dagra/execution/process.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dagra::remote {
+
+    /**
+     * @struct Address
+     * @brief Where the coordinator listens and agents connect.
+     */
+    struct Address {
+        /// @brief The socket family.
+        enum class Kind {
+            Tcp,  ///< `host` and `port` are set.
+            Unix  ///< `path` is set.
+        };
+
+        Kind kind = Kind::Tcp;
+        std::string host;
+        std::string port;
+        std::string path;
+
+        /// @brief The address in the form it was given, e.g. "10.0.0.5:7420" or "unix:/tmp/dagra.sock".
+        std::string describe() const;
+    };
+
+    /**
+     * @brief Parses `HOST:PORT`, `:PORT` (all interfaces) or `unix:PATH`.
+     * @param text The address.
+     * @return The parsed address.
+     * @throw std::runtime_error If the address is malformed.
+     */
+    Address parse_address(const std::string& text);
+
+    /**
+     * @brief Creates a listening socket.
+     *
+     * A Unix socket path that already exists is replaced. Port `0` binds an
+     * ephemeral port; `bound` then reports the port actually chosen.
+     *
+     * @param address The address to listen on.
+     * @param bound Receives the bound address.
+     * @return The listening descriptor, close-on-exec.
+     * @throw std::runtime_error If the address cannot be resolved or bound.
+     */
+    int listen_on(const Address& address, Address& bound);
+
+    /**
+     * @brief Connects to a listening coordinator.
+     * @param address The coordinator's address.
+     * @return The connected descriptor, or -1 with `errno` set.
+     */
+    int connect_to(const Address& address);
+
+    /// @brief Prefixes a JSON body with its length line.
+    std::string frame(const std::string& body);
+
+    /// @brief The result of looking for a complete frame in a receive buffer.
+    enum class FrameStatus {
+        Complete,    ///< A frame was removed from the buffer.
+        Incomplete,  ///< More bytes are needed.
+        Malformed    ///< The buffer does not start with a valid length line.
+    };
+
+    /**
+     * @brief Removes the first complete frame from a receive buffer.
+     * @param buffer Bytes received so far.
+     * @param body Receives the frame's JSON body on `Complete`.
+     * @return Whether a frame was found.
+     */
+    FrameStatus take_frame(std::string& buffer, std::string& body);
+
+    /**
+     * @struct Message
+     * @brief A decoded message; only the fields of its `type` are meaningful.
+     */
+    struct Message {
+        std::string type;
+        std::uint64_t seq = 0;
+
+        std::string name;           ///< `hello`: the agent's name.
+        std::size_t slots = 0;      ///< `hello`: how many tasks the agent runs at once.
+
+        core::Task task;            ///< `run`: ID, command, environment and timeout.
+        std::chrono::milliseconds kill_grace{0}; ///< `run`: time between SIGTERM and SIGKILL on timeout.
+
+        bool is_stderr = false;     ///< `output`: which stream the lines came from.
+        std::string data;           ///< `output`: complete lines of output.
+
+        execution::ExitStatus status; ///< `exit`: how the task ended.
+    };
+
+    // The encoders below return complete frames, ready for `utils::send_all`.
+
+    /// @brief Encodes an agent's announcement of its capacity.
+    std::string encode_hello(const std::string& name, std::size_t slots);
+
+    /// @brief Encodes a request to run a task.
+    std::string encode_run(std::uint64_t seq, const core::Task& task, std::chrono::milliseconds kill_grace);
+
+    /// @brief Encodes a request to cancel a running task.
+    std::string encode_cancel(std::uint64_t seq);
+
+    /// @brief Encodes lines of a task's output.
+    std::string encode_output(std::uint64_t seq, bool is_stderr, const std::string& data);
+
+    /// @brief Encodes the end of a task.
+    std::string encode_exit(std::uint64_t seq, const execution::ExitStatus& status);
+
+    /**
+     * @brief Decodes a message body.
+     * @param body The JSON object, without its length line.
+     * @param message Receives the message.
+     * @return False if the body is not a valid message.
+     */
+    bool decode_message(const std::string& body, Message& message);
+
+} // namespace dagra::remote
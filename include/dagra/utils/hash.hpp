@@ -0,0 +1,89 @@
+/**
+ * @file hash.hpp
+ * @brief Small, dependency-free 64-bit hashing helpers.
+ * @version 1.1.0
+ *
+ * Provides the FNV-1a hash used to intern task IDs and to build cache keys.
+ * The hash is stable across runs and platforms, which makes it suitable for
+ * keys that are persisted.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace dagra::utils {
+
+    /// @brief The FNV-1a 64-bit offset basis.
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+    /// @brief The FNV-1a 64-bit prime.
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * @brief Hashes a byte sequence with 64-bit FNV-1a.
+     * @param data The bytes to hash.
+     * @param seed The starting state; pass a previous result to chain hashes.
+     * @return The 64-bit hash value.
+     */
+    inline std::uint64_t fnv1a(std::string_view data, std::uint64_t seed = FNV_OFFSET_BASIS) {
+        std::uint64_t hash = seed;
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @class Hasher
+     * @brief Incrementally hashes a sequence of fields with FNV-1a.
+     *
+     * Every field is followed by its length, so that ("ab", "c") and
+     * ("a", "bc") produce different hashes.
+     */
+    class Hasher {
+    public:
+        /**
+         * @brief Adds a string field.
+         * @param data The field contents.
+         * @return A reference to this hasher, for chaining.
+         */
+        Hasher& add(std::string_view data) {
+            state_ = fnv1a(data, state_);
+            return add(static_cast<std::uint64_t>(data.size()));
+        }
+
+        /**
+         * @brief Adds a 64-bit integer field.
+         * @param value The value, hashed in little-endian byte order.
+         * @return A reference to this hasher, for chaining.
+         */
+        Hasher& add(std::uint64_t value) {
+            for (int shift = 0; shift < 64; shift += 8) {
+                state_ ^= (value >> shift) & 0xFFu;
+                state_ *= FNV_PRIME;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Adds raw bytes without a length suffix (e.g. one chunk of a file).
+         * @param data The bytes to mix in.
+         * @return A reference to this hasher, for chaining.
+         */
+        Hasher& add_bytes(std::string_view data) {
+            state_ = fnv1a(data, state_);
+            return *this;
+        }
+
+        /// @brief The hash of everything added so far.
+        std::uint64_t digest() const { return state_; }
+
+    private:
+        std::uint64_t state_ = FNV_OFFSET_BASIS;
+    };
+
+} // namespace dagra::utils
@@ -0,0 +1,124 @@
+/**
+ * @file io.hpp
+ * @brief Small file and descriptor helpers.
+ * @version 1.1.0
+ *
+ * Provides the loops that write a whole buffer to a descriptor or socket, and the
+ * uniquely named temporary files through which the cache, the compiled plan
+ * and the history are replaced atomically. Several dagra runs may share one
+ * state directory, so a fixed temporary name would let one run overwrite
+ * another's half-written file before it is renamed into place.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dagra::utils {
+
+    /**
+     * @brief Writes a whole buffer to a blocking descriptor, retrying short and interrupted writes.
+     * @param fd The descriptor.
+     * @param data The bytes to write.
+     * @param size The number of bytes.
+     * @return False if a write failed; the buffer may then be partly written.
+     */
+    inline bool write_all(int fd, const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t n = ::write(fd, bytes, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    /// @brief Writes a whole string to a blocking descriptor; see the overload above.
+    inline bool write_all(int fd, std::string_view data) {
+        return write_all(fd, data.data(), data.size());
+    }
+
+    /**
+     * @brief Sends a whole buffer on a blocking socket without raising SIGPIPE.
+     * @param fd The connected socket.
+     * @param data The bytes to send.
+     * @return False if the peer is gone or a send failed.
+     */
+    inline bool send_all(int fd, std::string_view data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns the process's file mode creation mask without changing it.
+     *
+     * `umask` can only be read by setting it, which would race with files
+     * created on other threads, so Linux's `/proc/self/status` is read
+     * instead. Only if that fails is the mask set and restored.
+     */
+    inline mode_t current_umask() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("Umask:", 0) == 0) {
+                return static_cast<mode_t>(std::strtoul(line.c_str() + 6, nullptr, 8));
+            }
+        }
+        const mode_t mask = ::umask(022);
+        ::umask(mask);
+        return mask;
+    }
+
+    /**
+     * @brief Creates an empty, uniquely named file next to `path`.
+     *
+     * The file is created with `mkstemp` as `<path>.XXXXXX`, so it lives in
+     * the same directory, and therefore on the same file system, as `path`
+     * and can be renamed over it. `mkstemp` creates it owner-only, so its
+     * mode is then set to that of the existing `path`, or to 0666 minus the
+     * umask, as a plain `open` would have created it.
+     *
+     * @param path The file that the temporary will replace.
+     * @return The name of the created file.
+     * @throw std::runtime_error If the file cannot be created.
+     */
+    inline std::string create_temporary(const std::string& path) {
+        std::string name = path + ".XXXXXX";
+        const int fd = mkstemp(name.data());
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create a temporary file for '" + path + "': " + std::strerror(errno));
+        }
+        struct stat target{};
+        const mode_t mode = ::stat(path.c_str(), &target) == 0 ? target.st_mode & 07777 : 0666 & ~current_umask();
+        fchmod(fd, mode);
+        close(fd);
+        return name;
+    }
+
+} // namespace dagra::utils
@@ -0,0 +1,150 @@
+/**
+ * @file json.hpp
+ * @brief Minimal helpers for emitting JSON text.
+ * @version 1.1.0
+ *
+ * Dagra only ever writes JSON (structured logs, traces), so instead of a
+ * full library it needs a correct string escaper and a timestamp formatter.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace dagra::utils {
+
+    namespace detail {
+
+        /**
+         * @brief Returns the length of the well-formed UTF-8 sequence starting at `pos`, or 0.
+         * @param text The string.
+         * @param pos The index of a byte of 0x80 or above.
+         */
+        inline std::size_t utf8_sequence_length(std::string_view text, std::size_t pos) {
+            const auto byte = [&](std::size_t i) { return static_cast<unsigned char>(text[i]); };
+            const unsigned char lead = byte(pos);
+            std::size_t length = 0;
+            unsigned char low = 0x80;
+            unsigned char high = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                length = 3;
+                low = lead == 0xE0 ? 0xA0 : 0x80;
+                high = lead == 0xED ? 0x9F : 0xBF;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                low = lead == 0xF0 ? 0x90 : 0x80;
+                high = lead == 0xF4 ? 0x8F : 0xBF;
+            } else {
+                return 0;
+            }
+            if (text.size() - pos < length || byte(pos + 1) < low || byte(pos + 1) > high) {
+                return 0;
+            }
+            for (std::size_t i = 2; i < length; ++i) {
+                if (byte(pos + i) < 0x80 || byte(pos + i) > 0xBF) {
+                    return 0;
+                }
+            }
+            return length;
+        }
+
+        /// @brief Appends a JSON string literal; see `append_json_string` and `append_json_bytes`.
+        inline void append_json_literal(std::string& out, std::string_view text, bool check_utf8) {
+            static const char* hex = "0123456789abcdef";
+            out += '"';
+            for (std::size_t pos = 0; pos < text.size(); ++pos) {
+                const char c = text[pos];
+                if (check_utf8 && static_cast<unsigned char>(c) >= 0x80) {
+                    const std::size_t length = utf8_sequence_length(text, pos);
+                    if (length == 0) {
+                        out += "\\ufffd";
+                    } else {
+                        out.append(text.data() + pos, length);
+                        pos += length - 1;
+                    }
+                    continue;
+                }
+                switch (c) {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out += hex[(c >> 4) & 0xF];
+                        out += hex[c & 0xF];
+                    } else {
+                        out += c;
+                    }
+                }
+            }
+            out += '"';
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Appends a JSON string literal, including the surrounding quotes.
+     *
+     * Quotes, backslashes and control characters are escaped and valid UTF-8
+     * sequences are copied unchanged. Each byte that does not start a valid
+     * sequence is replaced with U+FFFD, so task output in any encoding still
+     * yields parseable JSON.
+     *
+     * @param out The buffer to append to.
+     * @param text The raw string.
+     */
+    inline void append_json_string(std::string& out, std::string_view text) {
+        detail::append_json_literal(out, text, true);
+    }
+
+    /**
+     * @brief Appends a JSON-style string literal that keeps every byte, valid UTF-8 or not.
+     *
+     * Only for messages read back with yaml-cpp, which accepts any bytes in
+     * a quoted scalar, such as the remote protocol's task output.
+     *
+     * @param out The buffer to append to.
+     * @param text The raw bytes.
+     */
+    inline void append_json_bytes(std::string& out, std::string_view text) {
+        detail::append_json_literal(out, text, false);
+    }
+
+    /**
+     * @brief Formats a time point as an RFC 3339 UTC timestamp with microseconds.
+     * @param time The time point.
+     * @return A string such as "2026-04-08T12:34:56.789012Z".
+     */
+    inline std::string format_timestamp(std::chrono::system_clock::time_point time) {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+        const std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+        std::tm utc{};
+        gmtime_r(&seconds, &utc);
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ", utc.tm_year + 1900,
+                      utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                      static_cast<int>(micros % 1000000));
+        return buffer;
+    }
+
+} // namespace dagra::utils
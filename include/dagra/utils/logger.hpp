@@ -1,17 +1,17 @@
 /**
  * @file logger.hpp
- * @brief A thread-safe, colorful logging utility for the Dagra application.
+ * @brief A thread-safe, colorful, asynchronous logging utility for the Dagra application.
  * @version 1.1.0
  *
  * Provides static methods for logging messages at different levels (INFO, SUCCESS,
  * WARN, ERROR, DRY-RUN), each with a distinct color for better readability in
- * the console.
+ * the console. Messages are queued without locking and written by a background
+ * thread, so callers never wait on terminal I/O. A JSON mode emits one
+ * machine-parseable event per line instead.
  */
 
 #pragma once
 
-#include <iostream>
-#include <mutex>
 #include <string>
 #include <string_view>
 
@@ -32,75 +32,85 @@ namespace dagra::utils {
     /**
      * @class Logger
      * @brief A static class providing thread-safe logging functionalities.
+     *
+     * Every call captures a timestamp and pushes the message onto a bounded,
+     * lock-free multi-producer queue. A single writer thread drains it and
+     * writes batches to `std::cout`/`std::cerr`, flushing once per batch
+     * rather than once per line. When the queue is full, INFO and DRY-RUN
+     * messages are dropped (and the number dropped is reported), while
+     * successes, warnings, errors and task output wait for space, so no
+     * task's outcome is ever lost.
      */
     class Logger {
     public:
+        /// @brief The output format.
+        enum class Format {
+            Text, ///< Colored, human-readable lines.
+            Json  ///< One JSON object per line (`--log-format=json`).
+        };
+
+        /**
+         * @brief Selects the output format for subsequent messages.
+         * @param format The format to use.
+         */
+        static void set_format(Format format);
+
         /**
          * @brief Logs an informational message.
          * @param message The message to log.
          */
-        static void info(const std::string& message) {
-            log(std::cout, "[INFO]    ", message);
-        }
+        static void info(const std::string& message);
 
         /**
          * @brief Logs a success message in green.
          * @param message The message to log.
          */
-        static void success(const std::string& message) {
-            log(std::cout, colors::GREEN, "[SUCCESS] ", message);
-        }
-        
+        static void success(const std::string& message);
+
         /**
          * @brief Logs a warning message in yellow.
          * @param message The message to log.
          */
-        static void warn(const std::string& message) {
-            log(std::cout, colors::YELLOW, "[WARN]    ", message);
-        }
+        static void warn(const std::string& message);
 
         /**
          * @brief Logs an error message in red to the standard error stream.
          * @param message The message to log.
          */
-        static void error(const std::string& message) {
-            log(std::cerr, colors::RED, "[ERROR]   ", message);
-        }
-        
+        static void error(const std::string& message);
+
         /**
-         * @brief Logs a dry-run message in cyan.
+         * @brief Logs an error message followed by a block of supporting text.
+         *
+         * In text mode every line of `detail` is printed indented below the
+         * message; in JSON mode it becomes the event's `detail` field.
+         *
          * @param message The message to log.
+         * @param detail Additional lines, e.g. the last output of a failed task.
          */
-        static void dry_run(const std::string& message) {
-            log(std::cout, colors::CYAN, "[DRY-RUN] ", message);
-        }
+        static void error(const std::string& message, const std::string& detail);
 
-    private:
         /**
-         * @brief Retrieves a singleton instance of a mutex for thread safety.
-         * @return A reference to the static mutex.
+         * @brief Logs a dry-run message in cyan.
+         * @param message The message to log.
          */
-        static std::mutex& get_mutex() {
-            static std::mutex mtx;
-            return mtx;
-        }
+        static void dry_run(const std::string& message);
 
         /**
-         * @brief A generic, thread-safe logging function.
+         * @brief Logs complete lines of a task's output.
          *
-         * Acquires a lock and prints a series of arguments to the specified
-         * output stream, resetting the color at the end.
+         * In text mode each line is printed with a `[task-id] ` prefix, and the
+         * whole block is written in one piece so it never interleaves with
+         * other messages. In JSON mode each line becomes an `output` event.
          *
-         * @tparam Args Variadic template for message parts.
-         * @param stream The output stream (e.g., std::cout, std::cerr).
-         * @param args The parts of the message to log.
+         * @param task_id The task that produced the output.
+         * @param is_stderr True if the lines came from the task's stderr.
+         * @param lines One or more lines, each ending with a newline.
          */
-        template<typename... Args>
-        static void log(std::ostream& stream, Args&&... args) {
-            std::lock_guard<std::mutex> lock(get_mutex());
-            (stream << ... << std::forward<Args>(args));
-            stream << colors::RESET << std::endl;
-        }
+        static void output(const std::string& task_id, bool is_stderr, std::string lines);
+
+        /// @brief Blocks until every message logged before the call has been written.
+        static void flush();
     };
 
 } // namespace dagra::utils
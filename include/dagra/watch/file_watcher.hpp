@@ -0,0 +1,72 @@
+/**
+ * @file file_watcher.hpp
+ * @brief Declares the inotify-based watcher for task input files.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `FileWatcher` class, which
+ * reports changes to a set of paths through a single inotify descriptor.
+ * Files are watched through their parent directory, so editors that save by
+ * writing a new file and renaming it over the old one are still noticed.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dagra::watch {
+
+    /**
+     * @class FileWatcher
+     * @brief Watches files and directories for changes with inotify.
+     *
+     * Each watched file adds a watch on its parent directory (shared by all
+     * files in it); a watched directory is watched itself, and any change to
+     * an entry in it counts as a change to the directory. The descriptor is
+     * non-blocking, so callers can `poll` it together with other descriptors
+     * and then call `read_changes`.
+     */
+    class FileWatcher {
+    public:
+        /**
+         * @brief Creates the inotify instance.
+         * @throw std::runtime_error If inotify is unavailable.
+         */
+        FileWatcher();
+
+        /// @brief Closes the inotify descriptor and with it every watch.
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        /**
+         * @brief Starts watching a path.
+         * @param path A file or directory, as declared by a task.
+         * @return False if the directory to watch does not exist or the watch limit was hit.
+         */
+        bool add(const std::string& path);
+
+        /// @brief The inotify descriptor, readable when changes are pending.
+        int fd() const;
+
+        /**
+         * @brief Drains the pending events.
+         * @return The watched paths that changed, each once, as given to `add`.
+         */
+        std::vector<std::string> read_changes();
+
+    private:
+        /// @brief One watched directory.
+        struct Directory {
+            std::string path;
+            std::vector<std::string> whole; ///< Watched paths that are this directory itself.
+        };
+
+        int fd_ = -1;
+        std::unordered_map<int, Directory> directories_;
+        std::unordered_map<std::string, std::string> files_; ///< Absolute path to the path given to `add`.
+    };
+
+} // namespace dagra::watch
@@ -0,0 +1,73 @@
+/**
+ * @file watch_session.hpp
+ * @brief Declares watch mode: incremental re-execution when task inputs change.
+ * @version 1.1.0
+ *
+ * This file contains the declaration of the `WatchSession` class, which
+ * keeps a validated graph in memory, watches the tasks' declared inputs and
+ * reruns only the tasks affected by a change together with their dependents.
+ */
+
+#pragma once
+
+#include "dagra/core/dag.hpp"
+#include "dagra/execution/runner.hpp"
+#include <chrono>
+
+namespace dagra::watch {
+
+    /**
+     * @struct WatchOptions
+     * @brief Tunables for a watch session.
+     */
+    struct WatchOptions {
+        /// @brief Options for every run; `cancel_fd` is managed by the session.
+        execution::RunnerOptions runner;
+
+        /// @brief Quiet period after the last file event before a run starts.
+        std::chrono::milliseconds debounce{200};
+
+        /// @brief A descriptor that becomes readable to end the session (e.g. a signalfd), or -1.
+        int stop_fd = -1;
+    };
+
+    /**
+     * @class WatchSession
+     * @brief Reruns the subgraph affected by input changes until stopped.
+     *
+     * The session first runs the whole graph. It then waits for changes to
+     * any task's `inputs`, except paths that another task declares as an
+     * output, since those are rewritten by dagra itself. A burst of events is
+     * collected until it has been quiet for `debounce`; the tasks reading the
+     * changed paths and all of their transitive dependents then run as a
+     * subgraph whose edges to unaffected tasks are dropped.
+     *
+     * Runs happen on a background thread, so the session keeps watching
+     * while one is in flight. If a change affects a task of the running
+     * subgraph, that run is cancelled and restarted together with the new
+     * changes; other changes are queued for the next run.
+     */
+    class WatchSession {
+    public:
+        /**
+         * @brief Prepares a session.
+         * @param dag The validated graph. It must outlive the session.
+         * @param options The session options.
+         */
+        WatchSession(const core::Dag& dag, const WatchOptions& options);
+
+        /**
+         * @brief Runs and watches until `stop_fd` becomes readable.
+         *
+         * Failed runs are reported and the session keeps watching.
+         *
+         * @throw std::runtime_error If no task declares a watchable input.
+         */
+        void run();
+
+    private:
+        const core::Dag& dag_;
+        const WatchOptions options_;
+    };
+
+} // namespace dagra::watch
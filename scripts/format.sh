@@ -2,14 +2,14 @@
 #
 # format.sh - A script to format the C++ source code using clang-format.
 #
-# This script finds all .cpp and .hpp files in the src/, include/, and tests/
+# This script finds all .cpp and .hpp files in the src/, include/, tests/ and bench/
 # directories and applies the formatting rules defined in the .clang-format file.
 #
 
 set -e
 
 # Find all C++ source and header files
-files=$(find src/ include/ tests/ -type f \( -name "*.cpp" -o -name "*.hpp" \))
+files=$(find src/ include/ tests/ bench/ -type f \( -name "*.cpp" -o -name "*.hpp" \))
 
 # Run clang-format on the files
 echo "Formatting C++ files..."
@@ -17,7 +17,7 @@ if [ ! -f "build/compile_commands.json" ]; then
 fi
 
 # Find all C++ source files
-files=$(find src/ tests/ -type f -name "*.cpp")
+files=$(find src/ tests/ bench/ -type f -name "*.cpp")
 
 # Run clang-tidy
 echo "Running clang-tidy..."
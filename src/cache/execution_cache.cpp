@@ -0,0 +1,270 @@
+/**
+ * @file execution_cache.cpp
+ * @brief Implements the persistent, content-hash keyed execution cache.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the ExecutionCache class and the
+ * cache key helpers. The cache file is read through `mmap` and replaced with
+ * an atomic rename when it is saved.
+ */
+
+#include "dagra/cache/execution_cache.hpp"
+#include "dagra/utils/hash.hpp"
+#include "dagra/utils/io.hpp"
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace dagra::cache {
+
+    namespace {
+
+        constexpr char MAGIC[4] = {'D', 'G', 'C', '1'};
+        constexpr std::uint32_t FORMAT_VERSION = 1;
+
+        /// @brief The fixed header at the start of the cache file.
+        struct FileHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t capacity;
+            std::uint32_t count;
+        };
+
+        /// @brief Hashes a task ID, reserving 0 for empty slots.
+        std::uint64_t id_hash(const std::string& task_id) {
+            std::uint64_t hash = utils::fnv1a(task_id);
+            return hash == 0 ? 1 : hash;
+        }
+
+        /**
+         * @brief Mixes the full contents of a file into a hasher.
+         * @param path The file to read.
+         * @param hasher The hasher to update.
+         * @return False if the file could not be opened or read.
+         */
+        bool hash_file(const std::string& path, utils::Hasher& hasher) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+
+            std::array<char, 1 << 16> buffer;
+            std::uint64_t total = 0;
+            while (true) {
+                ssize_t n = ::read(fd, buffer.data(), buffer.size());
+                if (n < 0) {
+                    ::close(fd);
+                    return false;
+                }
+                if (n == 0) {
+                    break;
+                }
+                hasher.add_bytes(std::string_view(buffer.data(), static_cast<std::size_t>(n)));
+                total += static_cast<std::uint64_t>(n);
+            }
+            ::close(fd);
+            hasher.add(total);
+            return true;
+        }
+
+    } // namespace
+
+    bool compute_key(const core::Task& task, const std::vector<std::uint64_t>& dependency_keys, std::uint64_t& key) {
+        utils::Hasher hasher;
+        hasher.add(task.command);
+        // Only mixed in when set, so the keys of ordinary tasks stay unchanged.
+        if (!task.worker.empty()) {
+            hasher.add(task.worker);
+        }
+        hasher.add(static_cast<std::uint64_t>(task.env_vars.size()));
+        for (const auto& env : task.env_vars) {
+            hasher.add(env);
+        }
+        hasher.add(static_cast<std::uint64_t>(task.inputs.size()));
+        for (const auto& input : task.inputs) {
+            hasher.add(input);
+            if (!hash_file(input, hasher)) {
+                return false;
+            }
+        }
+        hasher.add(static_cast<std::uint64_t>(task.outputs.size()));
+        for (const auto& output : task.outputs) {
+            hasher.add(output);
+        }
+        for (std::uint64_t dependency_key : dependency_keys) {
+            hasher.add(dependency_key);
+        }
+        key = hasher.digest();
+        return true;
+    }
+
+    bool outputs_exist(const core::Task& task) {
+        for (const auto& output : task.outputs) {
+            std::error_code ec;
+            if (!fs::exists(output, ec)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ExecutionCache::~ExecutionCache() {
+        unmap();
+    }
+
+    /**
+     * @brief Maps the cache file read-only and checks its header.
+     * @param path The cache file path.
+     */
+    void ExecutionCache::open(const std::string& path) {
+        unmap();
+        path_ = path;
+        open_ = true;
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(FileHeader)) {
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                mapping_ = mapping;
+                mapping_size_ = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+
+        if (mapping_ == nullptr) {
+            return;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == FORMAT_VERSION &&
+                     header.capacity != 0 && (header.capacity & (header.capacity - 1)) == 0 &&
+                     mapping_size_ >= sizeof(FileHeader) + header.capacity * sizeof(Slot);
+        if (!valid) {
+            unmap();
+            return;
+        }
+
+        slots_ = reinterpret_cast<const Slot*>(static_cast<const char*>(mapping_) + sizeof(FileHeader));
+        capacity_ = header.capacity;
+    }
+
+    bool ExecutionCache::is_open() const {
+        return open_;
+    }
+
+    /**
+     * @brief Probes the mapped table for a task.
+     *
+     * Entries stored during the current run are not visible here; each task
+     * is looked up at most once per run, before it would be stored.
+     */
+    bool ExecutionCache::lookup(const std::string& task_id, std::uint64_t& key) const {
+        if (slots_ == nullptr) {
+            return false;
+        }
+
+        const std::uint64_t hash = id_hash(task_id);
+        const std::uint32_t mask = capacity_ - 1;
+        for (std::uint32_t probe = 0, slot = static_cast<std::uint32_t>(hash) & mask; probe < capacity_;
+             ++probe, slot = (slot + 1) & mask) {
+            if (slots_[slot].id_hash == 0) {
+                return false;
+            }
+            if (slots_[slot].id_hash == hash) {
+                key = slots_[slot].key;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ExecutionCache::store(const std::string& task_id, std::uint64_t key) {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+        pending_[id_hash(task_id)] = key;
+    }
+
+    /**
+     * @brief Merges the mapped entries with the new ones and atomically replaces the file.
+     */
+    void ExecutionCache::save() {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+        if (!open_ || pending_.empty()) {
+            return;
+        }
+
+        std::unordered_map<std::uint64_t, std::uint64_t> entries;
+        for (std::uint32_t i = 0; slots_ != nullptr && i < capacity_; ++i) {
+            if (slots_[i].id_hash != 0) {
+                entries.emplace(slots_[i].id_hash, slots_[i].key);
+            }
+        }
+        for (const auto& [hash, key] : pending_) {
+            entries[hash] = key;
+        }
+
+        std::uint32_t capacity = 16;
+        while (capacity < entries.size() * 2) {
+            capacity *= 2;
+        }
+        std::vector<Slot> table(capacity, Slot{0, 0});
+        for (const auto& [hash, key] : entries) {
+            std::uint32_t slot = static_cast<std::uint32_t>(hash) & (capacity - 1);
+            while (table[slot].id_hash != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            table[slot] = {hash, key};
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.capacity = capacity;
+        header.count = static_cast<std::uint32_t>(entries.size());
+
+        fs::path target(path_);
+        if (target.has_parent_path()) {
+            fs::create_directories(target.parent_path());
+        }
+        const std::string temporary = utils::create_temporary(path_);
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(table.data()),
+                      static_cast<std::streamsize>(table.size() * sizeof(Slot)));
+            out.close();
+            if (!out) {
+                fs::remove(temporary);
+                throw std::runtime_error("Failed to write execution cache '" + temporary + "'.");
+            }
+        }
+        fs::rename(temporary, target);
+
+        pending_.clear();
+        open(path_);
+    }
+
+    void ExecutionCache::unmap() {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+        }
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        slots_ = nullptr;
+        capacity_ = 0;
+    }
+
+} // namespace dagra::cache
@@ -0,0 +1,233 @@
+/**
+ * @file journal.cpp
+ * @brief Implements the append-only journal of completed tasks.
+ * @version 1.1.0
+ *
+ * This file contains the journal file format, its loader and the group
+ * commit flusher. Records are fixed-size and self-checking, so recovering
+ * from a crash never needs more than dropping the damaged tail.
+ */
+
+#include "dagra/cache/journal.hpp"
+#include "dagra/utils/hash.hpp"
+#include "dagra/utils/io.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace dagra::cache {
+
+    namespace {
+
+        constexpr char MAGIC[4] = {'D', 'G', 'J', '1'};
+        constexpr std::uint32_t FORMAT_VERSION = 1;
+
+        /// @brief The fixed header at the start of a journal file.
+        struct JournalHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint64_t reserved;
+        };
+
+        /// @brief The hash a task ID is stored under; never 0.
+        std::uint64_t id_hash(const std::string& task_id) {
+            std::uint64_t hash = utils::fnv1a(task_id);
+            return hash == 0 ? 1 : hash;
+        }
+
+        /// @brief The checksum of a record, which detects torn and garbled writes.
+        std::uint64_t record_check(std::uint64_t id, std::uint64_t key) {
+            return utils::Hasher().add(std::string_view(MAGIC, sizeof(MAGIC))).add(id).add(key).digest();
+        }
+
+    } // namespace
+
+    std::vector<std::uint64_t> compute_journal_keys(const core::Dag& dag) {
+        std::vector<std::uint64_t> keys(dag.size(), 0);
+        for (core::TaskIndex index : dag.topological_order()) {
+            const core::Task& task = dag.task(index);
+            utils::Hasher hasher;
+            hasher.add(task.id).add(task.command).add(task.worker);
+            hasher.add(static_cast<std::uint64_t>(task.env_vars.size()));
+            for (const auto& env : task.env_vars) {
+                hasher.add(env);
+            }
+            for (core::TaskIndex dep : dag.dependencies(index)) {
+                hasher.add(keys[dep]);
+            }
+            keys[index] = hasher.digest();
+        }
+        return keys;
+    }
+
+    RunJournal::~RunJournal() {
+        try {
+            close();
+        } catch (const std::exception&) {
+            // Only records of completed tasks are lost; they run again on resume.
+        }
+    }
+
+    void RunJournal::load(const std::string& path) {
+        entries_.clear();
+        loaded_path_ = path;
+        loaded_bytes_ = 0;
+
+        std::ifstream in(path, std::ios::binary);
+        const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        JournalHeader header{};
+        if (data.size() < sizeof(header)) {
+            return;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION) {
+            return;
+        }
+
+        std::size_t offset = sizeof(header);
+        for (; offset + sizeof(Record) <= data.size(); offset += sizeof(Record)) {
+            Record record{};
+            std::memcpy(&record, data.data() + offset, sizeof(record));
+            if (record.check != record_check(record.id_hash, record.key)) {
+                break;
+            }
+            entries_[record.id_hash] = record.key;
+        }
+        loaded_bytes_ = offset;
+    }
+
+    /**
+     * @brief Opens the journal file for appending and starts the flusher thread.
+     *
+     * The header (or the truncation of a damaged tail) is synced before the
+     * first record is queued, so the file is valid from the start.
+     *
+     * @param path The journal file.
+     */
+    void RunJournal::open(const std::string& path) {
+        close();
+        fs::path target(path);
+        if (target.has_parent_path()) {
+            fs::create_directories(target.parent_path());
+        }
+        path_ = path;
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("Could not open the run journal '" + path + "': " + std::strerror(errno));
+        }
+
+        const bool keep = path == loaded_path_ && loaded_bytes_ > 0;
+        bool ok = ftruncate(fd_, static_cast<off_t>(keep ? loaded_bytes_ : 0)) == 0 &&
+                  lseek(fd_, 0, SEEK_END) >= 0;
+        if (ok && !keep) {
+            JournalHeader header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = FORMAT_VERSION;
+            ok = utils::write_all(fd_, &header, sizeof(header));
+        }
+        if (!ok || fdatasync(fd_) != 0) {
+            const int error = errno;
+            ::close(fd_);
+            fd_ = -1;
+            throw std::runtime_error("Could not write the run journal '" + path + "': " + std::strerror(error));
+        }
+        if (!keep) {
+            entries_.clear();
+        }
+
+        stopping_ = false;
+        flusher_ = std::thread(&RunJournal::flush_loop, this);
+    }
+
+    bool RunJournal::contains(const std::string& task_id, std::uint64_t key) const {
+        auto entry = entries_.find(id_hash(task_id));
+        return entry != entries_.end() && entry->second == key;
+    }
+
+    std::size_t RunJournal::loaded() const {
+        return entries_.size();
+    }
+
+    void RunJournal::append(const std::string& task_id, std::uint64_t key) {
+        const std::uint64_t id = id_hash(task_id);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back({id, key, record_check(id, key)});
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief Drains the queue, stops the flusher thread and closes the file.
+     * @throw std::runtime_error If a batch could not be written or synced.
+     */
+    void RunJournal::close() {
+        if (!flusher_.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        flusher_.join();
+        const bool failed = fd_ < 0;
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (failed) {
+            throw std::runtime_error("Could not write the run journal '" + path_ + "'");
+        }
+    }
+
+    std::size_t RunJournal::batches() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+    /**
+     * @brief Writes every batch queued while the previous one was being synced.
+     *
+     * The lock is released during the write and the sync, so `append` is
+     * never held up by the disk. On a write error the file is closed (its
+     * descriptor set to -1) and later records are discarded.
+     */
+    void RunJournal::flush_loop() {
+        std::vector<Record> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            batch.clear();
+            batch.swap(pending_);
+            const int fd = fd_;
+            lock.unlock();
+
+            bool ok = fd >= 0;
+            if (ok) {
+                ok = utils::write_all(fd, batch.data(), batch.size() * sizeof(Record)) &&
+                     fdatasync(fd) == 0;
+            }
+
+            lock.lock();
+            if (fd >= 0) {
+                ++batches_;
+                if (!ok) {
+                    ::close(fd_);
+                    fd_ = -1;
+                }
+            }
+        }
+    }
+
+} // namespace dagra::cache
@@ -0,0 +1,378 @@
+/**
+ * @file plan_cache.cpp
+ * @brief Implements the compiled, memory-mapped execution plan cache.
+ * @version 1.1.0
+ *
+ * This file contains the plan file format and its reader and writer. The
+ * layout is a header followed by the task records, the resource entries
+ * (declared pools first, then every task's demands), the dependency offsets
+ * and targets, the string lists (environment, inputs, outputs, tags) and finally
+ * the string table. All sections are naturally aligned, so the reader uses
+ * them in place through the mapping.
+ */
+
+#include "dagra/cache/plan_cache.hpp"
+#include "dagra/utils/hash.hpp"
+#include "dagra/utils/io.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace dagra::cache {
+
+    namespace {
+
+        constexpr char MAGIC[4] = {'D', 'G', 'P', '1'};
+
+        /// @brief Bump whenever `core::Task` or the meaning of a configuration changes.
+        constexpr std::uint32_t FORMAT_VERSION = 6;
+
+        /// @brief `TaskRecord::flags` bit for `core::Task::allow_failure`.
+        constexpr std::uint32_t FLAG_ALLOW_FAILURE = 1u << 0;
+
+        /// @brief `TaskRecord::flags` bit for `core::Task::batchable`.
+        constexpr std::uint32_t FLAG_BATCHABLE = 1u << 1;
+
+        /// @brief A string in the string table.
+        struct StringRef {
+            std::uint32_t offset;
+            std::uint32_t length;
+        };
+
+        /// @brief A range of entries in the string-list section.
+        struct ListRef {
+            std::uint32_t begin;
+            std::uint32_t count;
+        };
+
+        /// @brief The fixed header at the start of a plan file.
+        struct PlanHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint64_t config_hash;
+            std::uint32_t task_count;
+            std::uint32_t edge_count;
+            std::uint32_t list_count;
+            std::uint32_t resource_count;
+            std::uint64_t strings_size;
+            std::uint32_t pool_count;
+            std::uint32_t reserved;
+        };
+
+        /// @brief A named amount: a pool capacity or a task's demand.
+        struct ResourceEntry {
+            StringRef name;
+            double amount;
+        };
+
+        /// @brief One task; its dependencies live in the CSR arrays.
+        struct TaskRecord {
+            StringRef id;
+            StringRef command;
+            StringRef worker;
+            ListRef env_vars;
+            ListRef inputs;
+            ListRef outputs;
+            ListRef resources;
+            ListRef tags;
+            std::int32_t timeout_seconds;
+            std::uint32_t flags;
+            double cost;
+        };
+
+        static_assert(sizeof(PlanHeader) % 8 == 0, "sections after the header must stay 8-byte aligned");
+        static_assert(sizeof(TaskRecord) % 8 == 0, "task records must stay 8-byte aligned");
+        static_assert(sizeof(ResourceEntry) % 8 == 0, "resource entries must stay 8-byte aligned");
+
+        /// @brief Collects the variable-length sections while a plan is written.
+        struct PlanBuilder {
+            std::vector<StringRef> lists;
+            std::vector<ResourceEntry> resources;
+            std::string strings;
+            std::unordered_map<std::string, StringRef> interned;
+
+            /// @brief Stores each distinct string once; matrix tasks repeat most of theirs.
+            StringRef add_string(const std::string& value) {
+                const auto [it, inserted] = interned.try_emplace(
+                    value, StringRef{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(value.size())});
+                if (inserted) {
+                    strings += value;
+                }
+                return it->second;
+            }
+
+            ListRef add_list(const std::vector<std::string>& values) {
+                ListRef ref{static_cast<std::uint32_t>(lists.size()), static_cast<std::uint32_t>(values.size())};
+                for (const auto& value : values) {
+                    lists.push_back(add_string(value));
+                }
+                return ref;
+            }
+
+            ListRef add_resources(const std::map<std::string, double>& amounts) {
+                ListRef ref{static_cast<std::uint32_t>(resources.size()), static_cast<std::uint32_t>(amounts.size())};
+                for (const auto& [name, amount] : amounts) {
+                    resources.push_back({add_string(name), amount});
+                }
+                return ref;
+            }
+        };
+
+        /// @brief A read-only mapping of a whole file, unmapped on destruction.
+        class Mapping {
+        public:
+            explicit Mapping(const std::string& path) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    return;
+                }
+                struct stat info {};
+                if (fstat(fd, &info) == 0 && info.st_size > 0) {
+                    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data != MAP_FAILED) {
+                        data_ = static_cast<const char*>(data);
+                        size_ = static_cast<std::size_t>(info.st_size);
+                    }
+                } else if (info.st_size == 0) {
+                    empty_ = true;
+                }
+                ::close(fd);
+            }
+
+            ~Mapping() {
+                if (data_ != nullptr) {
+                    munmap(const_cast<char*>(data_), size_);
+                }
+            }
+
+            Mapping(const Mapping&) = delete;
+            Mapping& operator=(const Mapping&) = delete;
+
+            bool valid() const { return data_ != nullptr || empty_; }
+            const char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            const char* data_ = nullptr;
+            std::size_t size_ = 0;
+            bool empty_ = false;
+        };
+
+    } // namespace
+
+    bool hash_config(const std::string& path, std::uint64_t& hash) {
+        Mapping file(path);
+        if (!file.valid()) {
+            return false;
+        }
+        hash = utils::Hasher().add(std::string_view(file.data(), file.size())).digest();
+        return true;
+    }
+
+    /**
+     * @brief Validates the section sizes and string references of a mapped plan, then builds the graph.
+     */
+    bool load_plan(const std::string& path, std::uint64_t config_hash, core::Dag& dag,
+                   std::map<std::string, double>& resource_pools) {
+        Mapping file(path);
+        if (file.data() == nullptr || file.size() < sizeof(PlanHeader)) {
+            return false;
+        }
+
+        PlanHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION ||
+            header.config_hash != config_hash) {
+            return false;
+        }
+
+        const std::uint64_t records_size = std::uint64_t{header.task_count} * sizeof(TaskRecord);
+        const std::uint64_t resources_size = std::uint64_t{header.resource_count} * sizeof(ResourceEntry);
+        const std::uint64_t offsets_size = (std::uint64_t{header.task_count} + 1) * sizeof(std::uint32_t);
+        const std::uint64_t targets_size = std::uint64_t{header.edge_count} * sizeof(core::TaskIndex);
+        const std::uint64_t lists_size = std::uint64_t{header.list_count} * sizeof(StringRef);
+        if (header.pool_count > header.resource_count ||
+            sizeof(PlanHeader) + records_size + resources_size + offsets_size + targets_size + lists_size + header.strings_size !=
+            file.size()) {
+            return false;
+        }
+
+        const char* cursor = file.data() + sizeof(PlanHeader);
+        const auto* records = reinterpret_cast<const TaskRecord*>(cursor);
+        cursor += records_size;
+        const auto* resources = reinterpret_cast<const ResourceEntry*>(cursor);
+        cursor += resources_size;
+        const auto* offsets = reinterpret_cast<const std::uint32_t*>(cursor);
+        cursor += offsets_size;
+        const auto* targets = reinterpret_cast<const core::TaskIndex*>(cursor);
+        cursor += targets_size;
+        const auto* lists = reinterpret_cast<const StringRef*>(cursor);
+        cursor += lists_size;
+        const char* strings = cursor;
+
+        auto string_ok = [&](const StringRef& ref) {
+            return std::uint64_t{ref.offset} + ref.length <= header.strings_size;
+        };
+        auto list_ok = [&](const ListRef& ref) {
+            if (std::uint64_t{ref.begin} + ref.count > header.list_count) {
+                return false;
+            }
+            for (std::uint32_t i = 0; i < ref.count; ++i) {
+                if (!string_ok(lists[ref.begin + i])) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto resources_ok = [&](const ListRef& ref) {
+            if (std::uint64_t{ref.begin} + ref.count > header.resource_count) {
+                return false;
+            }
+            for (std::uint32_t i = 0; i < ref.count; ++i) {
+                if (!string_ok(resources[ref.begin + i].name)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (!resources_ok(ListRef{0, header.pool_count}) || offsets[0] != 0 || offsets[header.task_count] != header.edge_count) {
+            return false;
+        }
+        for (std::uint32_t e = 0; e < header.edge_count; ++e) {
+            if (targets[e] >= header.task_count) {
+                return false;
+            }
+        }
+
+        auto text = [&](const StringRef& ref) { return std::string(strings + ref.offset, ref.length); };
+        auto list = [&](const ListRef& ref) {
+            std::vector<std::string> values;
+            values.reserve(ref.count);
+            for (std::uint32_t i = 0; i < ref.count; ++i) {
+                values.push_back(text(lists[ref.begin + i]));
+            }
+            return values;
+        };
+        auto amounts = [&](const ListRef& ref) {
+            std::map<std::string, double> values;
+            for (std::uint32_t i = 0; i < ref.count; ++i) {
+                values.emplace(text(resources[ref.begin + i].name), resources[ref.begin + i].amount);
+            }
+            return values;
+        };
+
+        std::vector<core::Task> tasks(header.task_count);
+        for (std::uint32_t i = 0; i < header.task_count; ++i) {
+            const TaskRecord& record = records[i];
+            if (!string_ok(record.id) || !string_ok(record.command) || !string_ok(record.worker) || !list_ok(record.env_vars) ||
+                !list_ok(record.inputs) || !list_ok(record.outputs) || !list_ok(record.tags) ||
+                !resources_ok(record.resources) ||
+                offsets[i] > offsets[i + 1]) {
+                return false;
+            }
+            core::Task& task = tasks[i];
+            task.id = text(record.id);
+            task.command = text(record.command);
+            task.worker = text(record.worker);
+            task.timeout_seconds = record.timeout_seconds;
+            task.env_vars = list(record.env_vars);
+            task.inputs = list(record.inputs);
+            task.outputs = list(record.outputs);
+            task.resources = amounts(record.resources);
+            task.tags = list(record.tags);
+            task.cost = record.cost;
+            task.allow_failure = (record.flags & FLAG_ALLOW_FAILURE) != 0;
+            task.batchable = (record.flags & FLAG_BATCHABLE) != 0;
+        }
+        // Dependency names are the IDs of the already-resolved targets.
+        for (std::uint32_t i = 0; i < header.task_count; ++i) {
+            tasks[i].dependencies.reserve(offsets[i + 1] - offsets[i]);
+            for (std::uint32_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+                tasks[i].dependencies.push_back(tasks[targets[e]].id);
+            }
+        }
+
+        dag.assign_resolved(std::move(tasks), std::vector<std::uint32_t>(offsets, offsets + header.task_count + 1),
+                            std::vector<core::TaskIndex>(targets, targets + header.edge_count));
+        resource_pools = amounts(ListRef{0, header.pool_count});
+        return true;
+    }
+
+    void save_plan(const core::Dag& dag, const std::map<std::string, double>& resource_pools, const std::string& path,
+                   std::uint64_t config_hash) {
+        const std::size_t count = dag.size();
+        PlanBuilder builder;
+        builder.add_resources(resource_pools);
+        std::vector<TaskRecord> records(count);
+        std::vector<std::uint32_t> offsets(count + 1, 0);
+        std::vector<core::TaskIndex> targets;
+
+        for (core::TaskIndex i = 0; i < count; ++i) {
+            const core::Task& task = dag.task(i);
+            TaskRecord& record = records[i];
+            record.id = builder.add_string(task.id);
+            record.command = builder.add_string(task.command);
+            record.worker = builder.add_string(task.worker);
+            record.env_vars = builder.add_list(task.env_vars);
+            record.inputs = builder.add_list(task.inputs);
+            record.outputs = builder.add_list(task.outputs);
+            record.resources = builder.add_resources(task.resources);
+            record.tags = builder.add_list(task.tags);
+            record.timeout_seconds = task.timeout_seconds;
+            record.flags = (task.allow_failure ? FLAG_ALLOW_FAILURE : 0) | (task.batchable ? FLAG_BATCHABLE : 0);
+            record.cost = task.cost;
+
+            for (core::TaskIndex dep : dag.dependencies(i)) {
+                targets.push_back(dep);
+            }
+            offsets[i + 1] = static_cast<std::uint32_t>(targets.size());
+        }
+
+        PlanHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.config_hash = config_hash;
+        header.task_count = static_cast<std::uint32_t>(count);
+        header.edge_count = static_cast<std::uint32_t>(targets.size());
+        header.list_count = static_cast<std::uint32_t>(builder.lists.size());
+        header.resource_count = static_cast<std::uint32_t>(builder.resources.size());
+        header.strings_size = builder.strings.size();
+        header.pool_count = static_cast<std::uint32_t>(resource_pools.size());
+
+        fs::path target(path);
+        if (target.has_parent_path()) {
+            fs::create_directories(target.parent_path());
+        }
+        const std::string temporary = utils::create_temporary(path);
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            auto write = [&](const void* data, std::size_t size) {
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            };
+            write(&header, sizeof(header));
+            write(records.data(), records.size() * sizeof(TaskRecord));
+            write(builder.resources.data(), builder.resources.size() * sizeof(ResourceEntry));
+            write(offsets.data(), offsets.size() * sizeof(std::uint32_t));
+            write(targets.data(), targets.size() * sizeof(core::TaskIndex));
+            write(builder.lists.data(), builder.lists.size() * sizeof(StringRef));
+            write(builder.strings.data(), builder.strings.size());
+            out.close();
+            if (!out) {
+                fs::remove(temporary);
+                throw std::runtime_error("Failed to write execution plan '" + temporary + "'.");
+            }
+        }
+        fs::rename(temporary, target);
+    }
+
+} // namespace dagra::cache
@@ -9,21 +9,180 @@
  */
 
 #include "dagra/cli/parser.hpp"
+#include "dagra/core/matrix.hpp"
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include <filesystem>
+#include <fstream>
 #include <yaml-cpp/yaml.h>
 
 namespace fs = std::filesystem;
 
 namespace dagra::cli {
 
+    namespace {
+
+        constexpr const char* USAGE =
+            "Usage: dagra <config.yaml> [TARGET...] [--tag TAG] [--dry-run] [-j N | --jobs N] [-k | --keep-going] [--fuse] [--event-loop] [--kill-grace SECONDS] [--worker-requests N] [--resume] "
+            "[--no-cache] [--cache-dir DIR] [--log-format text|json] [--trace FILE] [--watch [--debounce MS]] "
+            "[--listen HOST:PORT|unix:PATH]\n"
+            "       dagra report [config.yaml] [--sort wall|cpu|memory|io] [--top N] [--cache-dir DIR]\n"
+            "       dagra analyze <config.yaml> [TARGET...] [--tag TAG] [-j N] [--top N] [--reduce FILE] [--cache-dir DIR]";
+
+        constexpr const char* WORKER_USAGE =
+            "Usage: dagra-worker <HOST:PORT | unix:PATH> [--slots N] [--name NAME] [--once]";
+
+        /**
+         * @brief Matches an option that takes a value and extracts that value.
+         *
+         * Accepts `--name value` and `--name=value`, and when a short name is
+         * given also `-x value` and `-xvalue`. On a match that consumes the next
+         * argument, `index` is advanced past it.
+         *
+         * @param args All command-line arguments (without the program name).
+         * @param index The position of the current argument.
+         * @param long_name The long option name, including the leading dashes.
+         * @param short_name The short option name (e.g. "-j"), or an empty string.
+         * @param value Receives the option value on a match.
+         * @return True if the current argument is this option.
+         * @throw std::runtime_error If the option is present without a value.
+         */
+        bool take_option(const std::vector<std::string>& args, size_t& index, const std::string& long_name,
+                         const std::string& short_name, std::string& value) {
+            const std::string& arg = args[index];
+            if (arg == long_name || (!short_name.empty() && arg == short_name)) {
+                if (index + 1 >= args.size()) {
+                    throw std::runtime_error("Option '" + arg + "' requires a value. " + USAGE);
+                }
+                value = args[++index];
+                return true;
+            }
+            if (arg.rfind(long_name + "=", 0) == 0) {
+                value = arg.substr(long_name.size() + 1);
+                return true;
+            }
+            if (!short_name.empty() && arg.rfind(short_name, 0) == 0 && arg.rfind("--", 0) != 0) {
+                value = arg.substr(short_name.size());
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Converts an option value to a non-negative integer.
+         * @param value The raw option value.
+         * @param option The option name, used in error messages.
+         * @param allow_zero Whether zero is an acceptable value.
+         * @return The parsed number.
+         * @throw std::runtime_error If the value is not a valid number.
+         */
+        std::size_t parse_count(const std::string& value, const std::string& option, bool allow_zero) {
+            std::size_t consumed = 0;
+            unsigned long number = 0;
+            try {
+                number = std::stoul(value, &consumed);
+            } catch (const std::exception&) {
+                consumed = 0;
+            }
+            if (consumed == 0 || consumed != value.size() || value[0] == '-' || (!allow_zero && number == 0)) {
+                throw std::runtime_error("Invalid value '" + value + "' for " + option + " (must be a " +
+                                         (allow_zero ? "non-negative" : "positive") + " integer).");
+            }
+            return static_cast<std::size_t>(number);
+        }
+
+        /**
+         * @brief Parses a mapping of resource names to amounts.
+         * @param node The `resources` node.
+         * @param owner Describes where the mapping appears, used in error messages.
+         * @param allow_zero Whether zero amounts are accepted (requests) or not (capacities).
+         * @return The amounts by resource name.
+         * @throw std::runtime_error If the node is not a mapping or an amount is not a valid number.
+         */
+        std::map<std::string, double> parse_resources(const YAML::Node& node, const std::string& owner, bool allow_zero) {
+            if (!node.IsMap()) {
+                throw std::runtime_error(owner + " has invalid resources (must be a mapping of names to amounts).");
+            }
+            std::map<std::string, double> amounts;
+            for (const auto& entry : node) {
+                const std::string name = entry.first.as<std::string>();
+                double amount = 0.0;
+                try {
+                    amount = entry.second.as<double>();
+                } catch (const YAML::BadConversion&) {
+                    throw std::runtime_error(owner + " has invalid amount for resource '" + name + "' (must be a number).");
+                }
+                if (!(amount > 0.0 || (allow_zero && amount == 0.0))) {
+                    throw std::runtime_error(owner + " has invalid amount for resource '" + name + "' (must be " +
+                                             (allow_zero ? ">= 0" : "> 0") + ").");
+                }
+                amounts[name] = amount;
+            }
+            return amounts;
+        }
+
+        /**
+         * @brief Parses a `matrix` mapping of axis names to values.
+         *
+         * Each axis is either a sequence of scalars or an inclusive integer
+         * range written as `FIRST..LAST`. Axes keep their order in the file.
+         *
+         * @param node The `matrix` node.
+         * @param owner Describes where the mapping appears, used in error messages.
+         * @return The axes in declaration order.
+         * @throw std::runtime_error If the node is not a mapping or an axis is malformed.
+         */
+        std::vector<core::MatrixAxis> parse_matrix(const YAML::Node& node, const std::string& owner) {
+            if (!node.IsMap() || node.size() == 0) {
+                throw std::runtime_error(owner + " has invalid matrix (must be a mapping of names to values).");
+            }
+            std::vector<core::MatrixAxis> axes;
+            for (const auto& entry : node) {
+                core::MatrixAxis axis;
+                axis.name = entry.first.as<std::string>();
+                const YAML::Node& values = entry.second;
+                if (values.IsSequence()) {
+                    axis.values.reserve(values.size());
+                    for (const auto& value : values) {
+                        if (!value.IsScalar()) {
+                            throw std::runtime_error(owner + " has invalid value for matrix axis '" + axis.name +
+                                                     "' (must be a scalar).");
+                        }
+                        axis.values.push_back(value.as<std::string>());
+                    }
+                } else if (!values.IsScalar() || !core::parse_matrix_range(values.as<std::string>(), axis.values)) {
+                    throw std::runtime_error(owner + " has invalid matrix axis '" + axis.name +
+                                             "' (must be a sequence or a range such as 0..9).");
+                }
+                axes.push_back(std::move(axis));
+            }
+            return axes;
+        }
+
+    } // namespace
+
+    fs::path state_directory(const AppOptions& options) {
+        if (!options.cache_dir.empty()) {
+            return fs::path(options.cache_dir);
+        }
+        return fs::path(options.config_filepath).parent_path() / ".dagra";
+    }
+
     /**
      * @brief Parses command-line arguments to extract options.
      *
      * Iterates through the command-line arguments to find the configuration
-     * file path and the `--dry-run` flag.
+     * file path, the `--dry-run`, `-k`/`--keep-going`, `--fuse`, `--event-loop` and `--resume` flags, the
+     * `-j`/`--jobs` limit (given as `-j N`, `-jN`, `--jobs N` or `--jobs=N`),
+     * the `--kill-grace` period, the `--worker-requests` limit, the execution cache options, `--log-format`,
+     * `--trace`, `--tag`, `--watch` with its `--debounce` period and `--listen`. Positional arguments after the configuration
+     * file are targets. A leading `report` selects the report subcommand, for
+     * which the configuration file is optional and only locates the state
+     * directory. A leading `analyze` selects the graph analysis, the only
+     * command that accepts `--reduce`.
      *
      * @param argc The argument count.
      * @param argv The argument vector.
@@ -31,44 +190,167 @@ namespace dagra::cli {
      */
     AppOptions Parser::parse_args(int argc, char* argv[]) {
         if (argc < 2) {
-            throw std::runtime_error("Usage: dagra <config.yaml> [--dry-run]");
+            throw std::runtime_error(USAGE);
         }
 
         AppOptions options;
         std::vector<std::string> args(argv + 1, argv + argc);
 
+        size_t first = 0;
+        if (args[0] == "report") {
+            options.command = Command::Report;
+            first = 1;
+        } else if (args[0] == "analyze") {
+            options.command = Command::Analyze;
+            first = 1;
+        }
+
         bool config_found = false;
-        for (const auto& arg : args) {
+        for (size_t i = first; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            std::string value;
             if (arg == "--dry-run") {
                 options.dry_run = true;
-            } else if (!config_found && !arg.empty() && arg.rfind("--", 0) != 0) {
+            } else if (arg == "-k" || arg == "--keep-going") {
+                options.keep_going = true;
+            } else if (arg == "--fuse") {
+                options.fuse = true;
+            } else if (arg == "--event-loop") {
+                options.event_loop = true;
+            } else if (arg == "--resume") {
+                options.resume = true;
+            } else if (arg == "--watch") {
+                options.watch = true;
+            } else if (take_option(args, i, "--debounce", "", value)) {
+                options.watch_debounce_ms = parse_count(value, "--debounce", true);
+            } else if (arg == "--no-cache") {
+                options.use_cache = false;
+            } else if (take_option(args, i, "--cache-dir", "", value)) {
+                options.cache_dir = value;
+            } else if (take_option(args, i, "--jobs", "-j", value)) {
+                options.jobs = parse_count(value, "--jobs", false);
+            } else if (take_option(args, i, "--kill-grace", "", value)) {
+                options.kill_grace_seconds = static_cast<int>(parse_count(value, "--kill-grace", true));
+            } else if (take_option(args, i, "--worker-requests", "", value)) {
+                options.worker_max_requests = parse_count(value, "--worker-requests", true);
+            } else if (take_option(args, i, "--log-format", "", value)) {
+                if (value == "text") {
+                    options.log_format = utils::Logger::Format::Text;
+                } else if (value == "json") {
+                    options.log_format = utils::Logger::Format::Json;
+                } else {
+                    throw std::runtime_error("Invalid value '" + value + "' for --log-format (must be text or json).");
+                }
+            } else if (take_option(args, i, "--trace", "", value)) {
+                options.trace_path = value;
+            } else if (take_option(args, i, "--listen", "", value)) {
+                remote::parse_address(value);
+                options.listen_address = value;
+            } else if (take_option(args, i, "--tag", "", value)) {
+                options.tags.push_back(value);
+            } else if (take_option(args, i, "--sort", "", value)) {
+                if (!history::parse_sort_key(value, options.report_sort)) {
+                    throw std::runtime_error("Invalid value '" + value + "' for --sort (must be wall, cpu, memory or io).");
+                }
+            } else if (take_option(args, i, "--top", "", value)) {
+                options.report_limit = parse_count(value, "--top", true);
+            } else if (take_option(args, i, "--reduce", "", value)) {
+                options.reduce_path = value;
+            } else if (!config_found && !arg.empty() && arg[0] != '-') {
                 // Treat the first non-flag argument as the config file path.
                 options.config_filepath = arg;
                 config_found = true;
+            } else if (options.command != Command::Report && !arg.empty() && arg[0] != '-') {
+                // Every later one names a target to run.
+                options.targets.push_back(arg);
             }
         }
 
-        if (options.config_filepath.empty()) {
-            throw std::runtime_error("Configuration file path is missing. Usage: dagra <config.yaml> [--dry-run]");
+        if (options.config_filepath.empty() && options.command != Command::Report) {
+            throw std::runtime_error(std::string("Configuration file path is missing. ") + USAGE);
+        }
+        if (options.watch && options.dry_run) {
+            throw std::runtime_error("--watch cannot be combined with --dry-run.");
+        }
+        if (options.watch && options.resume) {
+            throw std::runtime_error("--watch cannot be combined with --resume.");
+        }
+        if (!options.listen_address.empty() && options.watch) {
+            throw std::runtime_error("--listen cannot be combined with --watch.");
+        }
+        if (!options.listen_address.empty() && options.fuse) {
+            throw std::runtime_error("--listen cannot be combined with --fuse.");
+        }
+        if (!options.listen_address.empty() && options.event_loop) {
+            throw std::runtime_error("--listen cannot be combined with --event-loop.");
+        }
+        if (!options.reduce_path.empty() && options.command != Command::Analyze) {
+            throw std::runtime_error("--reduce is only valid with dagra analyze.");
         }
 
         return options;
     }
 
+    /**
+     * @brief Parses the command line of `dagra-worker`.
+     *
+     * The first positional argument is the coordinator's address; `--slots`,
+     * `--name` and `--once` set the matching `AgentOptions` fields.
+     *
+     * @param argc The argument count.
+     * @param argv The argument vector.
+     * @return The agent's options.
+     */
+    remote::AgentOptions Parser::parse_worker_args(int argc, char* argv[]) {
+        remote::AgentOptions options;
+        std::vector<std::string> args(argv + 1, argv + argc);
+        for (size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            std::string value;
+            if (arg == "--once") {
+                options.once = true;
+            } else if (take_option(args, i, "--slots", "", value)) {
+                options.slots = parse_count(value, "--slots", false);
+            } else if (take_option(args, i, "--name", "", value)) {
+                options.name = value;
+            } else if (options.address.empty() && !arg.empty() && arg[0] != '-') {
+                options.address = arg;
+            } else {
+                throw std::runtime_error("Unknown argument '" + arg + "'. " + WORKER_USAGE);
+            }
+        }
+        if (options.address.empty()) {
+            throw std::runtime_error(std::string("Coordinator address is missing. ") + WORKER_USAGE);
+        }
+        remote::parse_address(options.address);
+        return options;
+    }
+
     /**
      * @brief Parses a YAML file to create a list of tasks.
+     * @param filepath The path to the YAML configuration file.
+     * @return A vector of tasks.
+     * @throw std::runtime_error If the file format is invalid or a task is malformed.
+     */
+    std::vector<core::Task> Parser::parse_yaml(const std::string& filepath) {
+        return parse_config(filepath).tasks;
+    }
+
+    /**
+     * @brief Parses a YAML configuration file.
      *
      * Loads a YAML file from the given path and validates its structure. It expects
      * a top-level `tasks` sequence, where each item defines a task with at least
-     * an `id` and a `command`.
+     * an `id` and a `command`, and accepts an optional top-level `resources`
+     * mapping of pool names to capacities.
      *
      * @param filepath The path to the YAML configuration file.
-     * @return A vector of tasks.
+     * @return The parsed configuration.
      * @throw std::runtime_error If the file format is invalid or a task is malformed.
-     * @throw YAML::Exception If the file cannot be parsed.
      */
-    std::vector<core::Task> Parser::parse_yaml(const std::string& filepath) {
-        std::vector<core::Task> parsed_tasks;
+    Config Parser::parse_config(const std::string& filepath) {
+        Config parsed;
+        std::vector<core::Task>& parsed_tasks = parsed.tasks;
 
         // Validate file existence
         if (!fs::exists(filepath)) {
@@ -86,6 +368,11 @@ namespace dagra::cli {
                 throw std::runtime_error("Invalid YAML: The 'tasks' sequence is missing or not a sequence.");
             }
 
+            // Parse optional resource pool capacities
+            if (config["resources"]) {
+                parsed.resource_pools = parse_resources(config["resources"], "The top-level 'resources'", false);
+            }
+
             for (const auto& node : config["tasks"]) {
                 if (!node["id"] || !node["command"]) {
                     throw std::runtime_error("Invalid YAML: A task is missing the required 'id' or 'command' field.");
@@ -95,6 +382,14 @@ namespace dagra::cli {
                 task.id = node["id"].as<std::string>();
                 task.command = node["command"].as<std::string>();
 
+                // Parse optional persistent worker
+                if (node["worker"]) {
+                    if (!node["worker"].IsScalar() || node["worker"].as<std::string>().empty()) {
+                        throw std::runtime_error("Task '" + task.id + "' has invalid worker (must be a command line).");
+                    }
+                    task.worker = node["worker"].as<std::string>();
+                }
+
                 if (node["depends_on"] && node["depends_on"].IsSequence()) {
                     for (const auto& dep : node["depends_on"]) {
                         task.dependencies.push_back(dep.as<std::string>());
@@ -113,21 +408,151 @@ namespace dagra::cli {
                     }
                 }
                 
+                // Parse optional scheduling cost hint (in seconds)
+                if (node["cost"] && node["cost"].IsScalar()) {
+                    try {
+                        task.cost = node["cost"].as<double>();
+                    } catch (const YAML::BadConversion&) {
+                        throw std::runtime_error("Task '" + task.id + "' has invalid cost value (must be a number).");
+                    }
+                    if (!(task.cost >= 0.0)) {
+                        throw std::runtime_error("Task '" + task.id + "' has invalid cost (must be >= 0).");
+                    }
+                }
+
+                // Parse optional failure tolerance
+                if (node["allow_failure"] && node["allow_failure"].IsScalar()) {
+                    try {
+                        task.allow_failure = node["allow_failure"].as<bool>();
+                    } catch (const YAML::BadConversion&) {
+                        throw std::runtime_error("Task '" + task.id + "' has invalid allow_failure value (must be true or false).");
+                    }
+                }
+
+                // Parse optional fusion batching
+                if (node["batchable"] && node["batchable"].IsScalar()) {
+                    try {
+                        task.batchable = node["batchable"].as<bool>();
+                    } catch (const YAML::BadConversion&) {
+                        throw std::runtime_error("Task '" + task.id + "' has invalid batchable value (must be true or false).");
+                    }
+                }
+
                 // Parse optional environment variables
                 if (node["env"] && node["env"].IsSequence()) {
                     for (const auto& env : node["env"]) {
                         task.env_vars.push_back(env.as<std::string>());
                     }
                 }
+
+                // Parse optional cache inputs and outputs
+                if (node["inputs"] && node["inputs"].IsSequence()) {
+                    for (const auto& input : node["inputs"]) {
+                        task.inputs.push_back(input.as<std::string>());
+                    }
+                }
+                if (node["outputs"] && node["outputs"].IsSequence()) {
+                    for (const auto& output : node["outputs"]) {
+                        task.outputs.push_back(output.as<std::string>());
+                    }
+                }
+
+                // Parse optional selection tags
+                if (node["tags"] && node["tags"].IsSequence()) {
+                    for (const auto& tag : node["tags"]) {
+                        task.tags.push_back(tag.as<std::string>());
+                    }
+                }
+
+                // Parse optional resource requests
+                if (node["resources"]) {
+                    task.resources = parse_resources(node["resources"], "Task '" + task.id + "'", true);
+                }
+
+                // Expand an optional matrix into one task per combination
+                if (node["matrix"]) {
+                    core::expand_matrix(task, parse_matrix(node["matrix"], "Task '" + task.id + "'"), parsed_tasks);
+                    continue;
+                }
                 
-                parsed_tasks.push_back(task);
+                parsed_tasks.push_back(std::move(task));
             }
         } catch (const YAML::Exception& e) {
             // Re-throw with a more descriptive error message.
             throw std::runtime_error("Failed to parse YAML file '" + filepath + "': " + e.what());
         }
 
-        return parsed_tasks;
+        return parsed;
+    }
+
+    /**
+     * @brief Writes a configuration file.
+     *
+     * Every task is written out in full, with only the fields that differ
+     * from their defaults. Matrix tasks are written as the tasks they
+     * expanded to.
+     *
+     * @param config The tasks and pool capacities to write.
+     * @param filepath The file to create or replace.
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    void Parser::write_config(const Config& config, const std::string& filepath) {
+        YAML::Emitter out;
+        out << YAML::BeginMap;
+        if (!config.resource_pools.empty()) {
+            out << YAML::Key << "resources" << YAML::Value << YAML::BeginMap;
+            for (const auto& [name, capacity] : config.resource_pools) {
+                out << YAML::Key << name << YAML::Value << capacity;
+            }
+            out << YAML::EndMap;
+        }
+
+        auto write_list = [&out](const char* key, const std::vector<std::string>& values) {
+            if (!values.empty()) {
+                out << YAML::Key << key << YAML::Value << YAML::Flow << values;
+            }
+        };
+        out << YAML::Key << "tasks" << YAML::Value << YAML::BeginSeq;
+        for (const auto& task : config.tasks) {
+            out << YAML::BeginMap;
+            out << YAML::Key << "id" << YAML::Value << task.id;
+            out << YAML::Key << "command" << YAML::Value << task.command;
+            if (!task.worker.empty()) {
+                out << YAML::Key << "worker" << YAML::Value << task.worker;
+            }
+            write_list("depends_on", task.dependencies);
+            if (task.timeout_seconds > 0) {
+                out << YAML::Key << "timeout" << YAML::Value << task.timeout_seconds;
+            }
+            if (task.cost > 0.0) {
+                out << YAML::Key << "cost" << YAML::Value << task.cost;
+            }
+            if (task.allow_failure) {
+                out << YAML::Key << "allow_failure" << YAML::Value << true;
+            }
+            if (task.batchable) {
+                out << YAML::Key << "batchable" << YAML::Value << true;
+            }
+            write_list("env", task.env_vars);
+            write_list("inputs", task.inputs);
+            write_list("outputs", task.outputs);
+            write_list("tags", task.tags);
+            if (!task.resources.empty()) {
+                out << YAML::Key << "resources" << YAML::Value << YAML::Flow << YAML::BeginMap;
+                for (const auto& [name, amount] : task.resources) {
+                    out << YAML::Key << name << YAML::Value << amount;
+                }
+                out << YAML::EndMap;
+            }
+            out << YAML::EndMap;
+        }
+        out << YAML::EndSeq << YAML::EndMap;
+
+        std::ofstream file(filepath, std::ios::trunc);
+        file << out.c_str() << "\n";
+        if (!file) {
+            throw std::runtime_error("Failed to write configuration file '" + filepath + "'.");
+        }
     }
 
 } // namespace dagra::cli
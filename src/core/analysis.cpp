@@ -0,0 +1,299 @@
+/**
+ * @file analysis.cpp
+ * @brief Implements the structural analysis behind `dagra analyze`.
+ * @version 1.1.0
+ *
+ * This file contains the level and critical path pass, the redundant edge
+ * search and the text output. Every pass works on the CSR edge arrays by
+ * index, so a graph of a million tasks is analysed without hashing a
+ * single ID.
+ */
+
+#include "dagra/core/analysis.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace dagra::core {
+
+    namespace {
+
+        /// @brief Task count above which the redundant edge search is split across threads.
+        constexpr std::size_t PARALLEL_ANALYSIS_THRESHOLD = 1u << 16;
+
+        /// @brief Tasks claimed at a time by each search thread.
+        constexpr std::size_t SEARCH_BLOCK = 1024;
+
+        /// @brief Formats a weight in seconds, e.g. "0.42s".
+        std::string format_seconds(double seconds) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << seconds << "s";
+            return out.str();
+        }
+
+        /**
+         * @class RedundancySearch
+         * @brief Finds the redundant edges of a block of tasks, reusing its stamp arrays.
+         */
+        class RedundancySearch {
+        public:
+            RedundancySearch(const Dag& dag, const std::vector<std::uint32_t>& levels)
+                : dag_(dag), levels_(levels), declared_(dag.size(), 0), reached_(dag.size(), 0) {}
+
+            /// @brief Appends the redundant edges of `task`, in declaration order.
+            void search(TaskIndex task, std::vector<RedundantEdge>& out) {
+                const IndexRange dependencies = dag_.dependencies(task);
+                if (dependencies.size() < 2) {
+                    return;
+                }
+                ++stamp_;
+                std::uint32_t floor = levels_[*dependencies.begin()];
+                for (TaskIndex dependency : dependencies) {
+                    floor = std::min(floor, levels_[dependency]);
+                }
+
+                // Walk down from every dependency above the lowest one, never below that level.
+                stack_.clear();
+                for (TaskIndex dependency : dependencies) {
+                    if (declared_[dependency] == stamp_ || reached_[dependency] == stamp_ ||
+                        levels_[dependency] == floor) {
+                        continue;
+                    }
+                    declared_[dependency] = stamp_;
+                    visit(dependency, floor);
+                    while (!stack_.empty()) {
+                        const TaskIndex current = stack_.back();
+                        stack_.pop_back();
+                        visit(current, floor);
+                    }
+                }
+
+                ++stamp_;
+                for (TaskIndex dependency : dependencies) {
+                    if (reached_[dependency] == stamp_ - 1 || declared_[dependency] == stamp_) {
+                        out.push_back({task, dependency});
+                    }
+                    declared_[dependency] = stamp_;
+                }
+            }
+
+        private:
+            /// @brief Marks the dependencies of `task` as reached and queues those above `floor`.
+            void visit(TaskIndex task, std::uint32_t floor) {
+                for (TaskIndex next : dag_.dependencies(task)) {
+                    if (levels_[next] < floor || reached_[next] == stamp_) {
+                        continue;
+                    }
+                    reached_[next] = stamp_;
+                    if (levels_[next] > floor) {
+                        stack_.push_back(next);
+                    }
+                }
+            }
+
+            const Dag& dag_;
+            const std::vector<std::uint32_t>& levels_;
+            std::vector<std::uint32_t> declared_;
+            std::vector<std::uint32_t> reached_;
+            std::vector<TaskIndex> stack_;
+            std::uint32_t stamp_ = 0;
+        };
+
+        /**
+         * @brief Finds every redundant edge, on several threads for large graphs.
+         *
+         * Threads claim blocks of consecutive tasks from a shared counter, so
+         * a few expensive tasks do not leave the other threads idle, and the
+         * blocks' results are concatenated in task order.
+         */
+        std::vector<RedundantEdge> find_redundant_edges(const Dag& dag, const std::vector<std::uint32_t>& levels) {
+            const std::size_t count = dag.size();
+            const std::size_t block_count = (count + SEARCH_BLOCK - 1) / SEARCH_BLOCK;
+            std::vector<std::vector<RedundantEdge>> blocks(block_count);
+            std::atomic<std::size_t> next_block{0};
+            auto work = [&]() {
+                RedundancySearch search(dag, levels);
+                for (std::size_t block = next_block++; block < block_count; block = next_block++) {
+                    const std::size_t end = std::min(count, (block + 1) * SEARCH_BLOCK);
+                    for (std::size_t task = block * SEARCH_BLOCK; task < end; ++task) {
+                        search.search(static_cast<TaskIndex>(task), blocks[block]);
+                    }
+                }
+            };
+
+            std::size_t thread_count = 1;
+            if (count >= PARALLEL_ANALYSIS_THRESHOLD) {
+                thread_count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            }
+            std::vector<std::thread> workers;
+            for (std::size_t t = 1; t < thread_count; ++t) {
+                workers.emplace_back(work);
+            }
+            work();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            std::vector<RedundantEdge> redundant;
+            for (auto& block : blocks) {
+                redundant.insert(redundant.end(), block.begin(), block.end());
+            }
+            return redundant;
+        }
+
+    } // namespace
+
+    double GraphAnalysis::speedup_ceiling(std::size_t jobs) const {
+        if (total_work <= 0.0 || jobs == 0) {
+            return 1.0;
+        }
+        return total_work / std::max(critical_path_cost, total_work / static_cast<double>(jobs));
+    }
+
+    GraphAnalysis analyze_graph(const Dag& dag, const std::vector<double>& weights) {
+        GraphAnalysis analysis;
+        const std::size_t count = dag.size();
+        analysis.tasks = count;
+
+        std::vector<std::uint32_t> levels(count, 0);
+        std::vector<double> finish(count, 0.0);
+        std::vector<TaskIndex> heaviest(count, 0);
+        TaskIndex last = 0;
+        for (TaskIndex task : dag.topological_order()) {
+            const IndexRange dependencies = dag.dependencies(task);
+            analysis.edges += dependencies.size();
+            double start = 0.0;
+            TaskIndex from = task;
+            for (TaskIndex dependency : dependencies) {
+                levels[task] = std::max(levels[task], levels[dependency] + 1);
+                if (from == task || finish[dependency] > start) {
+                    start = finish[dependency];
+                    from = dependency;
+                }
+            }
+            heaviest[task] = from;
+            finish[task] = start + weights[task];
+            analysis.total_work += weights[task];
+            if (finish[task] > finish[last]) {
+                last = task;
+            }
+
+            if (levels[task] >= analysis.level_widths.size()) {
+                analysis.level_widths.resize(levels[task] + 1, 0);
+            }
+            ++analysis.level_widths[levels[task]];
+        }
+
+        for (std::size_t level = 0; level < analysis.level_widths.size(); ++level) {
+            if (analysis.level_widths[level] > analysis.max_width) {
+                analysis.max_width = analysis.level_widths[level];
+                analysis.widest_level = level;
+            }
+        }
+
+        if (count > 0) {
+            analysis.critical_path_cost = finish[last];
+            for (TaskIndex task = last;; task = heaviest[task]) {
+                analysis.critical_path.push_back(task);
+                if (heaviest[task] == task) {
+                    break;
+                }
+            }
+            std::reverse(analysis.critical_path.begin(), analysis.critical_path.end());
+        }
+
+        analysis.redundant_edges = find_redundant_edges(dag, levels);
+        return analysis;
+    }
+
+    std::vector<Task> reduce_tasks(const Dag& dag, const std::vector<RedundantEdge>& redundant) {
+        std::vector<Task> tasks = dag.get_all_tasks();
+        std::vector<std::uint32_t> flagged(dag.size(), 0);
+        std::vector<std::uint32_t> declared(dag.size(), 0);
+        std::size_t next = 0;
+        for (TaskIndex task = 0; task < dag.size(); ++task) {
+            // Redundant edges are ordered by task, so each task's entries are contiguous.
+            const std::size_t first = next;
+            while (next < redundant.size() && redundant[next].task == task) {
+                ++next;
+            }
+            if (first == next) {
+                continue;
+            }
+
+            // A dependency flagged as often as it is declared is implied; otherwise only its repeats are.
+            const IndexRange dependencies = dag.dependencies(task);
+            for (std::size_t i = first; i < next; ++i) {
+                ++flagged[redundant[i].dependency];
+            }
+            for (TaskIndex dependency : dependencies) {
+                ++declared[dependency];
+            }
+            std::vector<std::string> kept;
+            kept.reserve(dependencies.size());
+            std::size_t position = 0;
+            for (TaskIndex dependency : dependencies) {
+                if (flagged[dependency] < declared[dependency]) {
+                    kept.push_back(tasks[task].dependencies[position]);
+                    flagged[dependency] = declared[dependency];
+                }
+                ++position;
+            }
+            for (TaskIndex dependency : dependencies) {
+                flagged[dependency] = 0;
+                declared[dependency] = 0;
+            }
+            tasks[task].dependencies = std::move(kept);
+        }
+        return tasks;
+    }
+
+    void write_analysis(const Dag& dag, const GraphAnalysis& analysis, std::size_t jobs, std::size_t limit,
+                        std::ostream& out) {
+        auto shown = [limit](std::size_t size) { return limit == 0 ? size : std::min(limit, size); };
+
+        out << "Graph: " << analysis.tasks << " tasks, " << analysis.edges << " edges, depth " << analysis.depth()
+            << ", max width " << analysis.max_width << " (level " << analysis.widest_level << ")\n";
+        out << "Level widths:";
+        for (std::size_t level = 0; level < shown(analysis.level_widths.size()); ++level) {
+            out << " " << analysis.level_widths[level];
+        }
+        if (shown(analysis.level_widths.size()) < analysis.level_widths.size()) {
+            out << " ... " << analysis.level_widths.size() - shown(analysis.level_widths.size()) << " more";
+        }
+        out << "\n\n";
+
+        out << "Total work: " << format_seconds(analysis.total_work) << "\n";
+        out << "Critical path: " << format_seconds(analysis.critical_path_cost) << " over "
+            << analysis.critical_path.size() << " tasks\n";
+        out << "Speedup ceiling with " << jobs << " jobs: " << std::fixed << std::setprecision(2)
+            << analysis.speedup_ceiling(jobs) << "x (" << analysis.speedup_ceiling(analysis.tasks)
+            << "x with unlimited jobs)\n";
+        for (std::size_t i = 0; i < shown(analysis.critical_path.size()); ++i) {
+            out << "  " << dag.task(analysis.critical_path[i]).id << "\n";
+        }
+        if (shown(analysis.critical_path.size()) < analysis.critical_path.size()) {
+            out << "  ... " << analysis.critical_path.size() - shown(analysis.critical_path.size()) << " more\n";
+        }
+        out << "\n";
+
+        if (analysis.redundant_edges.empty()) {
+            out << "No redundant edges: every dependency is needed.\n";
+            return;
+        }
+        out << "Redundant edges: " << analysis.redundant_edges.size() << " of " << analysis.edges
+            << " (implied by other dependencies)\n";
+        for (std::size_t i = 0; i < shown(analysis.redundant_edges.size()); ++i) {
+            const RedundantEdge& edge = analysis.redundant_edges[i];
+            out << "  " << dag.task(edge.task).id << " -> " << dag.task(edge.dependency).id << "\n";
+        }
+        if (shown(analysis.redundant_edges.size()) < analysis.redundant_edges.size()) {
+            out << "  ... " << analysis.redundant_edges.size() - shown(analysis.redundant_edges.size()) << " more\n";
+        }
+    }
+
+} // namespace dagra::core
@@ -4,24 +4,134 @@
  * @version 1.1.0
  *
  * This file contains the implementation for the Dag class. It provides the
- * logic for adding tasks and, most importantly, for validating the graph to
- * ensure it is well-formed (i.e., contains no missing dependencies and no
- * circular references).
+ * logic for interning task IDs, building the CSR edge arrays and, most
+ * importantly, for validating the graph to ensure it is well-formed (i.e.,
+ * contains no missing dependencies and no circular references).
  */
 
 #include "dagra/core/dag.hpp"
+#include "dagra/utils/hash.hpp"
 #include "dagra/utils/logger.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <stdexcept>
-#include <unordered_set>
+#include <thread>
+#include <utility>
 
 namespace dagra::core {
 
+    void Dag::reserve(std::size_t count) {
+        tasks_.reserve(count);
+        hashes_.reserve(count);
+        while (slots_.size() < count * 2) {
+            grow_table();
+        }
+    }
+
     /**
      * @brief Adds a task to the DAG.
      * @param task The task to be added.
      */
     void Dag::add_task(const Task& task) {
-        tasks_[task.id] = task;
+        insert(task);
+    }
+
+    /**
+     * @brief Adds a task to the DAG without copying its strings.
+     * @param task The task to be moved in.
+     */
+    void Dag::add_task(Task&& task) {
+        insert(std::move(task));
+    }
+
+    /**
+     * @brief Installs pre-resolved tasks and edges, skipping name resolution.
+     */
+    void Dag::assign_resolved(std::vector<Task> tasks, std::vector<std::uint32_t> offsets,
+                              std::vector<TaskIndex> targets) {
+        tasks_ = std::move(tasks);
+        hashes_.clear();
+        hashes_.reserve(tasks_.size());
+        for (const auto& task : tasks_) {
+            hashes_.push_back(utils::fnv1a(task.id));
+        }
+        std::size_t capacity = 16;
+        while (capacity < tasks_.size() * 2) {
+            capacity *= 2;
+        }
+        rehash(capacity);
+
+        dependency_offsets_ = std::move(offsets);
+        dependency_targets_ = std::move(targets);
+        missing_.clear();
+        build_reverse_edges();
+        edges_built_ = true;
+    }
+
+    /**
+     * @brief Stores a task, reusing the index of an existing task with the same ID.
+     * @param task The task to store.
+     */
+    template <typename T>
+    void Dag::insert(T&& task) {
+        edges_built_ = false;
+
+        if (slots_.empty() || (tasks_.size() + 1) * 2 > slots_.size()) {
+            grow_table();
+        }
+
+        std::uint64_t hash = utils::fnv1a(task.id);
+        std::size_t slot = probe(task.id, hash);
+        if (slots_[slot] != EMPTY_SLOT) {
+            tasks_[slots_[slot]] = std::forward<T>(task);
+            return;
+        }
+
+        slots_[slot] = static_cast<TaskIndex>(tasks_.size());
+        hashes_.push_back(hash);
+        tasks_.push_back(std::forward<T>(task));
+    }
+
+    /**
+     * @brief Linear-probes the open-addressing ID table.
+     * @param id The task ID to look for.
+     * @param hash The precomputed hash of `id`.
+     * @return The slot holding the ID, or the first empty slot in its probe sequence.
+     */
+    std::size_t Dag::probe(const std::string& id, std::uint64_t hash) const {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t slot = static_cast<std::size_t>(hash) & mask;
+        while (slots_[slot] != EMPTY_SLOT) {
+            TaskIndex candidate = slots_[slot];
+            if (hashes_[candidate] == hash && tasks_[candidate].id == id) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    /**
+     * @brief Doubles the hash table (keeping a power-of-two size) and rehashes.
+     *
+     * Hashes are cached per task, so rehashing never touches the ID strings.
+     */
+    void Dag::grow_table() {
+        rehash(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+
+    void Dag::rehash(std::size_t capacity) {
+        slots_.assign(capacity, EMPTY_SLOT);
+
+        const std::size_t mask = capacity - 1;
+        for (TaskIndex index = 0; index < tasks_.size(); ++index) {
+            std::size_t slot = static_cast<std::size_t>(hashes_[index]) & mask;
+            while (slots_[slot] != EMPTY_SLOT) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = index;
+        }
     }
 
     /**
@@ -30,66 +140,436 @@ namespace dagra::core {
      * @return A const reference to the task.
      */
     const Task& Dag::get_task(const std::string& id) const {
-        auto it = tasks_.find(id);
-        if (it == tasks_.end()) {
+        TaskIndex index;
+        if (!find(id, index)) {
             throw std::runtime_error("Task with ID '" + id + "' not found in the DAG.");
         }
-        return it->second;
+        return tasks_[index];
     }
 
     /**
      * @brief Returns all tasks in the DAG.
-     * @return A const reference to the map of tasks.
+     * @return A const reference to the tasks, in index order.
      */
-    const std::unordered_map<std::string, Task>& Dag::get_all_tasks() const {
+    const std::vector<Task>& Dag::get_all_tasks() const {
         return tasks_;
     }
 
+    std::size_t Dag::size() const {
+        return tasks_.size();
+    }
+
+    bool Dag::find(const std::string& id, TaskIndex& index) const {
+        if (slots_.empty()) {
+            return false;
+        }
+        std::size_t slot = probe(id, utils::fnv1a(id));
+        if (slots_[slot] == EMPTY_SLOT) {
+            return false;
+        }
+        index = slots_[slot];
+        return true;
+    }
+
+    const Task& Dag::task(TaskIndex index) const {
+        return tasks_[index];
+    }
+
+    IndexRange Dag::dependencies(TaskIndex index) const {
+        build_edges();
+        const TaskIndex* base = dependency_targets_.data();
+        return {base + dependency_offsets_[index], base + dependency_offsets_[index + 1]};
+    }
+
+    IndexRange Dag::dependents(TaskIndex index) const {
+        build_edges();
+        const TaskIndex* base = dependent_targets_.data();
+        return {base + dependent_offsets_[index], base + dependent_offsets_[index + 1]};
+    }
+
+    const std::vector<MissingDependency>& Dag::missing_dependencies() const {
+        build_edges();
+        return missing_;
+    }
+
     /**
-     * @brief Validates the DAG for missing dependencies and cycles.
-     * @throw std::runtime_error if validation fails.
+     * @brief Resolves dependency names once and lays the edges out in CSR form.
+     *
+     * The forward arrays are filled from per-task dependency lists; for very
+     * large graphs the name lookups are split into contiguous chunks that are
+     * resolved on separate threads and then concatenated in order. The
+     * reverse arrays are derived from the forward ones with a counting sort,
+     * which keeps every task's dependents in ascending index order.
      */
-    void Dag::validate() const {
-        std::unordered_set<std::string> visited;
-        std::unordered_set<std::string> recursion_stack;
-
-        // 1. Check for missing dependencies and cycles.
-        for (const auto& [id, task] : tasks_) {
-            for (const auto& dep : task.dependencies) {
-                if (tasks_.find(dep) == tasks_.end()) {
-                    throw std::runtime_error("Validation failed: Task '" + id + "' has an unknown dependency '" + dep + "'.");
+    void Dag::build_edges() const {
+        if (edges_built_) {
+            return;
+        }
+
+        const std::size_t count = tasks_.size();
+        dependency_offsets_.assign(count + 1, 0);
+        dependency_targets_.clear();
+        missing_.clear();
+
+        struct Chunk {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            std::vector<TaskIndex> targets;
+            std::vector<MissingDependency> missing;
+        };
+
+        std::size_t chunk_count = 1;
+        if (count >= PARALLEL_RESOLVE_THRESHOLD) {
+            std::size_t hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            chunk_count = std::min(hardware, count / (PARALLEL_RESOLVE_THRESHOLD / 4));
+        }
+
+        std::vector<Chunk> chunks(chunk_count);
+        auto resolve = [this](Chunk& chunk) {
+            for (std::size_t index = chunk.begin; index < chunk.end; ++index) {
+                std::uint32_t resolved = 0;
+                for (const auto& dep : tasks_[index].dependencies) {
+                    TaskIndex target;
+                    if (find(dep, target)) {
+                        chunk.targets.push_back(target);
+                        ++resolved;
+                    } else {
+                        chunk.missing.push_back({static_cast<TaskIndex>(index), dep});
+                    }
+                }
+                // Each chunk writes a disjoint range of counts; they become offsets below.
+                dependency_offsets_[index + 1] = resolved;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t c = 0; c < chunk_count; ++c) {
+            chunks[c].begin = count * c / chunk_count;
+            chunks[c].end = count * (c + 1) / chunk_count;
+            if (c > 0) {
+                workers.emplace_back(resolve, std::ref(chunks[c]));
+            }
+        }
+        resolve(chunks[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            dependency_offsets_[i + 1] += dependency_offsets_[i];
+        }
+        dependency_targets_.reserve(dependency_offsets_[count]);
+        for (auto& chunk : chunks) {
+            dependency_targets_.insert(dependency_targets_.end(), chunk.targets.begin(), chunk.targets.end());
+            std::move(chunk.missing.begin(), chunk.missing.end(), std::back_inserter(missing_));
+        }
+
+        build_reverse_edges();
+        edges_built_ = true;
+    }
+
+    /**
+     * @brief Fills the reverse arrays with a counting sort over the forward edges.
+     *
+     * Every task's dependents end up in ascending index order.
+     */
+    void Dag::build_reverse_edges() const {
+        const std::size_t count = tasks_.size();
+        dependent_offsets_.assign(count + 1, 0);
+        for (TaskIndex target : dependency_targets_) {
+            ++dependent_offsets_[target + 1];
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            dependent_offsets_[i + 1] += dependent_offsets_[i];
+        }
+
+        dependent_targets_.assign(dependency_targets_.size(), 0);
+        std::vector<std::uint32_t> cursor(dependent_offsets_.begin(), dependent_offsets_.end() - 1);
+        for (TaskIndex index = 0; index < count; ++index) {
+            for (std::uint32_t e = dependency_offsets_[index]; e < dependency_offsets_[index + 1]; ++e) {
+                dependent_targets_[cursor[dependency_targets_[e]]++] = index;
+            }
+        }
+    }
+
+    /**
+     * @brief Computes a topological order with Kahn's algorithm.
+     * @return The acyclic part of the graph in dependency order.
+     */
+    std::vector<TaskIndex> Dag::topological_order() const {
+        build_edges();
+
+        const std::size_t count = tasks_.size();
+        std::vector<std::uint32_t> pending(count);
+        std::vector<TaskIndex> order;
+        order.reserve(count);
+
+        for (TaskIndex index = 0; index < count; ++index) {
+            pending[index] = dependency_offsets_[index + 1] - dependency_offsets_[index];
+            if (pending[index] == 0) {
+                order.push_back(index);
+            }
+        }
+
+        // The order vector doubles as the work queue.
+        for (std::size_t head = 0; head < order.size(); ++head) {
+            for (TaskIndex dependent : dependents(order[head])) {
+                if (--pending[dependent] == 0) {
+                    order.push_back(dependent);
+                }
+            }
+        }
+        return order;
+    }
+
+    std::vector<TaskIndex> Dag::dependency_closure(const std::vector<TaskIndex>& targets) const {
+        build_edges();
+
+        std::vector<bool> visited(tasks_.size(), false);
+        std::vector<TaskIndex> closure;
+        for (TaskIndex target : targets) {
+            if (!visited[target]) {
+                visited[target] = true;
+                closure.push_back(target);
+            }
+        }
+        // The closure vector doubles as the work queue.
+        for (std::size_t head = 0; head < closure.size(); ++head) {
+            for (TaskIndex dep : dependencies(closure[head])) {
+                if (!visited[dep]) {
+                    visited[dep] = true;
+                    closure.push_back(dep);
                 }
             }
-            if (visited.find(id) == visited.end()) {
-                detect_cycle_util(id, visited, recursion_stack);
+        }
+        std::sort(closure.begin(), closure.end());
+        return closure;
+    }
+
+    std::vector<TaskIndex> Dag::dependent_closure(const std::vector<TaskIndex>& sources) const {
+        build_edges();
+
+        std::vector<bool> visited(tasks_.size(), false);
+        std::vector<TaskIndex> closure;
+        for (TaskIndex source : sources) {
+            if (!visited[source]) {
+                visited[source] = true;
+                closure.push_back(source);
+            }
+        }
+        for (std::size_t head = 0; head < closure.size(); ++head) {
+            for (TaskIndex dependent : dependents(closure[head])) {
+                if (!visited[dependent]) {
+                    visited[dependent] = true;
+                    closure.push_back(dependent);
+                }
             }
         }
+        std::sort(closure.begin(), closure.end());
+        return closure;
+    }
 
-        utils::Logger::info("DAG validated successfully. No missing dependencies or cycles found.");
+    /**
+     * @brief Copies the selected tasks and remaps their edges by binary search in the selection.
+     */
+    Dag Dag::subgraph(const std::vector<TaskIndex>& selected, bool drop_external) const {
+        build_edges();
+
+        std::vector<Task> tasks;
+        tasks.reserve(selected.size());
+        std::vector<std::uint32_t> offsets(selected.size() + 1, 0);
+        std::vector<TaskIndex> targets;
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+            tasks.push_back(tasks_[selected[i]]);
+            for (TaskIndex dep : dependencies(selected[i])) {
+                auto position = std::lower_bound(selected.begin(), selected.end(), dep);
+                if (position == selected.end() || *position != dep) {
+                    if (drop_external) {
+                        continue;
+                    }
+                    throw std::runtime_error("Task '" + tasks_[selected[i]].id + "' depends on '" + tasks_[dep].id +
+                                             "', which is not part of the selection.");
+                }
+                targets.push_back(static_cast<TaskIndex>(position - selected.begin()));
+            }
+            offsets[i + 1] = static_cast<std::uint32_t>(targets.size());
+        }
+
+        Dag result;
+        result.assign_resolved(std::move(tasks), std::move(offsets), std::move(targets));
+        return result;
     }
 
     /**
-     * @brief A recursive utility to detect cycles using DFS.
-     * @param task_id The current task ID to visit.
-     * @param visited A set of all visited nodes so far.
-     * @param recursion_stack A set of nodes in the current recursion path.
-     * @throw std::runtime_error if a cycle is detected.
+     * @brief Collects all missing dependencies and cycles in one O(V+E) pass.
+     * @return The validation report.
      */
-    void Dag::detect_cycle_util(const std::string& task_id, std::unordered_set<std::string>& visited, std::unordered_set<std::string>& recursion_stack) const {
-        visited.insert(task_id);
-        recursion_stack.insert(task_id);
+    ValidationReport Dag::check() const {
+        ValidationReport report;
+        report.missing = missing_dependencies();
 
-        const auto& task = get_task(task_id);
-        for (const auto& dep_id : task.dependencies) {
-            if (recursion_stack.count(dep_id)) {
-                throw std::runtime_error("Cycle detected in dependency graph involving task '" + dep_id + "'.");
+        std::vector<TaskIndex> order = topological_order();
+        if (order.size() < tasks_.size()) {
+            std::vector<bool> leftover(tasks_.size(), true);
+            for (TaskIndex index : order) {
+                leftover[index] = false;
+            }
+            report.cycles = find_cycles(leftover);
+        }
+        return report;
+    }
+
+    /**
+     * @brief Finds the strongly connected components of the leftover tasks with an
+     *        iterative Tarjan traversal and extracts one cycle from each.
+     *
+     * Tasks left over by Kahn's algorithm either lie on a cycle or depend on
+     * one; only components with more than one task, or with a self-dependency,
+     * contain a cycle. Within such a component every task has a dependency in
+     * the same component, so walking those edges must revisit a task, and the
+     * walk from that task's first visit is a complete cycle.
+     *
+     * @param leftover Per-task flag, true for tasks not in the topological order.
+     * @return One closed dependency path per cyclic component.
+     */
+    std::vector<std::vector<TaskIndex>> Dag::find_cycles(const std::vector<bool>& leftover) const {
+        constexpr std::uint32_t UNVISITED = 0xFFFFFFFFu;
+        const std::size_t count = tasks_.size();
+
+        std::vector<std::uint32_t> visit_order(count, UNVISITED);
+        std::vector<std::uint32_t> lowlink(count, 0);
+        std::vector<std::uint32_t> component(count, UNVISITED);
+        std::vector<bool> on_stack(count, false);
+        std::vector<TaskIndex> stack;
+
+        struct Frame {
+            TaskIndex task;
+            std::uint32_t next_edge;
+        };
+        std::vector<Frame> frames;
+
+        std::vector<std::vector<TaskIndex>> cycles;
+        std::vector<std::uint32_t> walk_position(count, UNVISITED);
+        std::uint32_t counter = 0;
+        std::uint32_t component_count = 0;
+
+        auto enter = [&](TaskIndex task) {
+            visit_order[task] = lowlink[task] = counter++;
+            stack.push_back(task);
+            on_stack[task] = true;
+            frames.push_back({task, 0});
+        };
+
+        auto extract_cycle = [&](TaskIndex start, std::uint32_t id) {
+            std::vector<TaskIndex> walk;
+            TaskIndex current = start;
+            while (walk_position[current] == UNVISITED) {
+                walk_position[current] = static_cast<std::uint32_t>(walk.size());
+                walk.push_back(current);
+                for (TaskIndex dep : dependencies(current)) {
+                    if (component[dep] == id) {
+                        current = dep;
+                        break;
+                    }
+                }
+            }
+            std::vector<TaskIndex> cycle(walk.begin() + walk_position[current], walk.end());
+            cycle.push_back(current);
+            for (TaskIndex task : walk) {
+                walk_position[task] = UNVISITED;
+            }
+            cycles.push_back(std::move(cycle));
+        };
+
+        for (TaskIndex root = 0; root < count; ++root) {
+            if (!leftover[root] || visit_order[root] != UNVISITED) {
+                continue;
+            }
+            enter(root);
+
+            while (!frames.empty()) {
+                TaskIndex task = frames.back().task;
+                IndexRange deps = dependencies(task);
+
+                if (frames.back().next_edge < deps.size()) {
+                    TaskIndex dep = deps.begin()[frames.back().next_edge++];
+                    if (!leftover[dep]) {
+                        continue;
+                    }
+                    if (visit_order[dep] == UNVISITED) {
+                        enter(dep);
+                    } else if (on_stack[dep]) {
+                        lowlink[task] = std::min(lowlink[task], visit_order[dep]);
+                    }
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    TaskIndex parent = frames.back().task;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[task]);
+                }
+                if (lowlink[task] != visit_order[task]) {
+                    continue;
+                }
+
+                std::uint32_t id = component_count++;
+                std::size_t members = 0;
+                TaskIndex member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    component[member] = id;
+                    ++members;
+                } while (member != task);
+
+                bool self_dependency = std::find(deps.begin(), deps.end(), task) != deps.end();
+                if (members > 1 || self_dependency) {
+                    extract_cycle(task, id);
+                }
+            }
+        }
+        return cycles;
+    }
+
+    /**
+     * @brief Validates the DAG for missing dependencies and cycles.
+     *
+     * Every problem is logged individually; the exception message summarises them.
+     *
+     * @throw std::runtime_error if validation fails.
+     */
+    void Dag::validate() const {
+        ValidationReport report = check();
+        if (report.ok()) {
+            utils::Logger::info("DAG validated successfully. No missing dependencies or cycles found.");
+            return;
+        }
+
+        std::string first_problem;
+        for (const auto& missing : report.missing) {
+            std::string problem = "Task '" + tasks_[missing.task].id + "' has an unknown dependency '" + missing.name + "'.";
+            utils::Logger::error("Validation: " + problem);
+            if (first_problem.empty()) {
+                first_problem = problem;
+            }
+        }
+        for (const auto& cycle : report.cycles) {
+            std::string path;
+            for (TaskIndex index : cycle) {
+                path += (path.empty() ? "" : " -> ") + tasks_[index].id;
             }
-            if (visited.find(dep_id) == visited.end()) {
-                detect_cycle_util(dep_id, visited, recursion_stack);
+            std::string problem = "Cycle detected in dependency graph: " + path + ".";
+            utils::Logger::error("Validation: " + problem);
+            if (first_problem.empty()) {
+                first_problem = problem;
             }
         }
 
-        recursion_stack.erase(task_id);
+        throw std::runtime_error("Validation failed with " + std::to_string(report.missing.size()) +
+                                 " unknown dependencies and " + std::to_string(report.cycles.size()) +
+                                 " cycles. First: " + first_problem);
     }
 
 } // namespace dagra::core
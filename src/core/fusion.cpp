@@ -0,0 +1,172 @@
+/**
+ * @file fusion.cpp
+ * @brief Implements task fusion.
+ * @version 1.1.0
+ *
+ * This file contains the grouping of chains and batches and the
+ * construction of the graph of groups. Chains are grown from their heads in
+ * dependency order, batches are collected per distinct dependency list, and
+ * every task left over becomes a group of its own.
+ */
+
+#include "dagra/core/fusion.hpp"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace dagra::core {
+
+    namespace {
+
+        constexpr std::uint32_t UNASSIGNED = 0xFFFFFFFFu;
+
+        /// @brief True if the task may share a process with others.
+        bool fusable(const Task& task) {
+            return task.timeout_seconds == 0 && task.worker.empty();
+        }
+
+        /// @brief A batch being filled, keyed by its members' dependencies and environment.
+        struct OpenBatch {
+            std::vector<TaskIndex> members;
+            std::size_t bytes = 0;
+        };
+
+    } // namespace
+
+    FusedGraph fuse_tasks(const Dag& dag, const FusionOptions& options) {
+        const std::size_t count = dag.size();
+        std::vector<std::uint32_t> group_of(count, UNASSIGNED);
+        std::vector<std::vector<TaskIndex>> groups;
+        std::vector<FusionKind> kinds;
+        auto add_group = [&](std::vector<TaskIndex> members, FusionKind kind) {
+            for (TaskIndex member : members) {
+                group_of[member] = static_cast<std::uint32_t>(groups.size());
+            }
+            groups.push_back(std::move(members));
+            kinds.push_back(kind);
+        };
+        auto fits = [&](std::size_t members, std::size_t bytes, const Task& next) {
+            return members < options.max_group && bytes + next.command.size() <= options.max_script_bytes;
+        };
+
+        // A task's predecessors come first in topological order, so every chain is found from its head.
+        for (TaskIndex head : dag.topological_order()) {
+            const Task& first = dag.task(head);
+            if (group_of[head] != UNASSIGNED || !fusable(first)) {
+                continue;
+            }
+            std::vector<TaskIndex> chain{head};
+            std::size_t bytes = first.command.size();
+            while (dag.dependents(chain.back()).size() == 1) {
+                const TaskIndex next = *dag.dependents(chain.back()).begin();
+                const Task& task = dag.task(next);
+                if (dag.dependencies(next).size() != 1 || !fusable(task) || task.env_vars != first.env_vars ||
+                    !fits(chain.size(), bytes, task)) {
+                    break;
+                }
+                chain.push_back(next);
+                bytes += task.command.size();
+            }
+            if (chain.size() > 1) {
+                add_group(std::move(chain), FusionKind::Chain);
+            }
+        }
+
+        std::map<std::pair<std::vector<TaskIndex>, std::vector<std::string>>, OpenBatch> batches;
+        auto close_batch = [&](OpenBatch& batch) {
+            if (batch.members.size() > 1) {
+                add_group(std::move(batch.members), FusionKind::Batch);
+            }
+            batch = OpenBatch{};
+        };
+        for (TaskIndex i = 0; i < count; ++i) {
+            const Task& task = dag.task(i);
+            if (group_of[i] != UNASSIGNED || !task.batchable || !fusable(task)) {
+                continue;
+            }
+            std::vector<TaskIndex> dependencies(dag.dependencies(i).begin(), dag.dependencies(i).end());
+            std::sort(dependencies.begin(), dependencies.end());
+            OpenBatch& batch = batches[{std::move(dependencies), task.env_vars}];
+            if (!batch.members.empty() && !fits(batch.members.size(), batch.bytes, task)) {
+                close_batch(batch);
+            }
+            batch.members.push_back(i);
+            batch.bytes += task.command.size();
+        }
+        for (auto& [key, batch] : batches) {
+            close_batch(batch);
+        }
+
+        for (TaskIndex i = 0; i < count; ++i) {
+            if (group_of[i] == UNASSIGNED) {
+                add_group({i}, FusionKind::Single);
+            }
+        }
+
+        // Number the groups by their first member, so the fused graph follows declaration order.
+        std::vector<std::uint32_t> order(groups.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](std::uint32_t a, std::uint32_t b) { return groups[a].front() < groups[b].front(); });
+        std::vector<TaskIndex> position(groups.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            position[order[i]] = static_cast<TaskIndex>(i);
+        }
+
+        FusedGraph result;
+        std::vector<Task> tasks;
+        tasks.reserve(groups.size());
+        std::vector<std::uint32_t> offsets(groups.size() + 1, 0);
+        std::vector<TaskIndex> targets;
+        // The last group that recorded an edge to each group, to drop duplicate edges in O(1).
+        std::vector<std::uint32_t> linked_from(groups.size(), UNASSIGNED);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            std::vector<TaskIndex>& members = groups[order[i]];
+            const FusionKind kind = kinds[order[i]];
+
+            Task task;
+            if (kind == FusionKind::Single) {
+                task = dag.task(members.front());
+                task.dependencies.clear();
+            } else {
+                const Task& first = dag.task(members.front());
+                task.id = first.id + ".." + dag.task(members.back()).id;
+                task.env_vars = first.env_vars;
+                for (TaskIndex member : members) {
+                    const Task& part = dag.task(member);
+                    task.command += (task.command.empty() ? "" : kind == FusionKind::Chain ? " && " : "; ") +
+                                    part.command;
+                    task.cost += part.cost;
+                    for (const auto& [name, amount] : part.resources) {
+                        task.resources[name] = std::max(task.resources[name], amount);
+                    }
+                }
+            }
+
+            for (TaskIndex member : members) {
+                for (TaskIndex dep : dag.dependencies(member)) {
+                    const TaskIndex target = position[group_of[dep]];
+                    if (target != i && linked_from[target] != i) {
+                        linked_from[target] = static_cast<std::uint32_t>(i);
+                        targets.push_back(target);
+                    }
+                }
+            }
+            offsets[i + 1] = static_cast<std::uint32_t>(targets.size());
+            tasks.push_back(std::move(task));
+            result.members.push_back(std::move(members));
+            result.kinds.push_back(kind);
+        }
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            for (std::uint32_t edge = offsets[i]; edge < offsets[i + 1]; ++edge) {
+                tasks[i].dependencies.push_back(tasks[targets[edge]].id);
+            }
+        }
+
+        result.graph.assign_resolved(std::move(tasks), std::move(offsets), std::move(targets));
+        return result;
+    }
+
+} // namespace dagra::core
@@ -0,0 +1,223 @@
+/**
+ * @file matrix.cpp
+ * @brief Implements the expansion of matrix tasks.
+ * @version 1.1.0
+ *
+ * This file contains the template compiler and the expansion loop. Every
+ * templated field is compiled once per matrix into literal and placeholder
+ * segments, and each combination is rendered by appending segments into a
+ * string reserved to its final size.
+ */
+
+#include "dagra/core/matrix.hpp"
+#include <set>
+#include <stdexcept>
+
+namespace dagra::core {
+
+    namespace {
+
+        /**
+         * @class Template
+         * @brief A string field split into literal text and axis placeholders.
+         */
+        class Template {
+        public:
+            Template(const std::string& text, const std::vector<MatrixAxis>& axes) {
+                std::size_t literal_start = 0;
+                std::size_t open = text.find('{');
+                while (open != std::string::npos) {
+                    const std::size_t close = text.find('}', open + 1);
+                    if (close == std::string::npos) {
+                        break;
+                    }
+                    const std::string name = text.substr(open + 1, close - open - 1);
+                    int axis = -1;
+                    for (std::size_t i = 0; i < axes.size(); ++i) {
+                        if (axes[i].name == name) {
+                            axis = static_cast<int>(i);
+                        }
+                    }
+                    if (axis < 0) {
+                        open = text.find('{', open + 1);
+                        continue;
+                    }
+                    if (open > literal_start) {
+                        segments_.push_back({text.substr(literal_start, open - literal_start), -1});
+                    }
+                    segments_.push_back({std::string(), axis});
+                    literal_start = close + 1;
+                    open = text.find('{', literal_start);
+                }
+                if (literal_start < text.size() || segments_.empty()) {
+                    segments_.push_back({text.substr(literal_start), -1});
+                }
+            }
+
+            /// @brief True if the template contains a placeholder for the axis.
+            bool uses(std::size_t axis) const {
+                for (const Segment& segment : segments_) {
+                    if (segment.axis == static_cast<int>(axis)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /// @brief Renders the template for the current value of every axis.
+            std::string render(const std::vector<const std::string*>& current) const {
+                if (segments_.size() == 1 && segments_[0].axis < 0) {
+                    return segments_[0].literal;
+                }
+                std::size_t size = 0;
+                for (const Segment& segment : segments_) {
+                    size += segment.axis < 0 ? segment.literal.size() : current[segment.axis]->size();
+                }
+                std::string out;
+                out.reserve(size);
+                for (const Segment& segment : segments_) {
+                    out += segment.axis < 0 ? segment.literal : *current[segment.axis];
+                }
+                return out;
+            }
+
+        private:
+            /// @brief Literal text, or the placeholder of an axis (`axis >= 0`).
+            struct Segment {
+                std::string literal;
+                int axis;
+            };
+
+            std::vector<Segment> segments_;
+        };
+
+        /// @brief Compiles every element of a templated list.
+        std::vector<Template> compile_list(const std::vector<std::string>& texts, const std::vector<MatrixAxis>& axes) {
+            std::vector<Template> templates;
+            templates.reserve(texts.size());
+            for (const auto& text : texts) {
+                templates.emplace_back(text, axes);
+            }
+            return templates;
+        }
+
+        /// @brief Renders every element of a templated list.
+        std::vector<std::string> render_list(const std::vector<Template>& templates,
+                                             const std::vector<const std::string*>& current) {
+            std::vector<std::string> rendered;
+            rendered.reserve(templates.size());
+            for (const Template& item : templates) {
+                rendered.push_back(item.render(current));
+            }
+            return rendered;
+        }
+
+        /// @brief Parses a whole string as a signed integer.
+        bool parse_integer(const std::string& text, long long& value) {
+            std::size_t consumed = 0;
+            try {
+                value = std::stoll(text, &consumed);
+            } catch (const std::exception&) {
+                return false;
+            }
+            return consumed == text.size() && !text.empty() && text[0] != '+' && text[0] != ' ';
+        }
+
+    } // namespace
+
+    bool parse_matrix_range(const std::string& text, std::vector<std::string>& values) {
+        const std::size_t dots = text.find("..");
+        long long first = 0;
+        long long last = 0;
+        if (dots == std::string::npos || !parse_integer(text.substr(0, dots), first) ||
+            !parse_integer(text.substr(dots + 2), last)) {
+            return false;
+        }
+        if (first > last) {
+            throw std::runtime_error("Matrix range '" + text + "' is empty.");
+        }
+        if (static_cast<unsigned long long>(last - first) >= MAX_MATRIX_TASKS) {
+            throw std::runtime_error("Matrix range '" + text + "' is too large.");
+        }
+        values.clear();
+        values.reserve(static_cast<std::size_t>(last - first + 1));
+        for (long long value = first; value <= last; ++value) {
+            values.push_back(std::to_string(value));
+        }
+        return true;
+    }
+
+    void expand_matrix(const Task& prototype, const std::vector<MatrixAxis>& axes, std::vector<Task>& out) {
+        const std::string owner = "Task '" + prototype.id + "'";
+        if (axes.empty()) {
+            throw std::runtime_error(owner + " has an empty matrix.");
+        }
+        std::set<std::string> names;
+        std::size_t total = 1;
+        for (const MatrixAxis& axis : axes) {
+            if (axis.name.empty() || !names.insert(axis.name).second) {
+                throw std::runtime_error(owner + " has an unnamed or repeated matrix axis '" + axis.name + "'.");
+            }
+            if (axis.values.empty()) {
+                throw std::runtime_error(owner + " has no values for matrix axis '" + axis.name + "'.");
+            }
+            if (total > MAX_MATRIX_TASKS / axis.values.size()) {
+                throw std::runtime_error(owner + " has a matrix of more than " + std::to_string(MAX_MATRIX_TASKS) +
+                                         " tasks.");
+            }
+            total *= axis.values.size();
+        }
+
+        const Template id(prototype.id, axes);
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            if (!id.uses(i)) {
+                throw std::runtime_error(owner + " has a matrix, but its id does not use '{" + axes[i].name + "}'.");
+            }
+        }
+        const Template command(prototype.command, axes);
+        const Template worker(prototype.worker, axes);
+        const std::vector<Template> dependencies = compile_list(prototype.dependencies, axes);
+        const std::vector<Template> env_vars = compile_list(prototype.env_vars, axes);
+        const std::vector<Template> inputs = compile_list(prototype.inputs, axes);
+        const std::vector<Template> outputs = compile_list(prototype.outputs, axes);
+        const std::vector<Template> tags = compile_list(prototype.tags, axes);
+
+        // Copying the untemplated fields from a prototype without strings avoids copying the templates.
+        Task base;
+        base.timeout_seconds = prototype.timeout_seconds;
+        base.cost = prototype.cost;
+        base.allow_failure = prototype.allow_failure;
+        base.resources = prototype.resources;
+        base.batchable = prototype.batchable;
+
+        std::vector<std::size_t> position(axes.size(), 0);
+        std::vector<const std::string*> current(axes.size());
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            current[i] = &axes[i].values[0];
+        }
+        for (std::size_t n = 0; n < total; ++n) {
+            Task task = base;
+            task.id = id.render(current);
+            task.command = command.render(current);
+            task.worker = worker.render(current);
+            task.dependencies = render_list(dependencies, current);
+            task.env_vars = render_list(env_vars, current);
+            task.inputs = render_list(inputs, current);
+            task.outputs = render_list(outputs, current);
+            task.tags = render_list(tags, current);
+            out.push_back(std::move(task));
+
+            // Advance like an odometer, the last axis fastest.
+            for (std::size_t i = axes.size(); i > 0; --i) {
+                const std::size_t axis = i - 1;
+                if (++position[axis] < axes[axis].values.size()) {
+                    current[axis] = &axes[axis].values[position[axis]];
+                    break;
+                }
+                position[axis] = 0;
+                current[axis] = &axes[axis].values[0];
+            }
+        }
+    }
+
+} // namespace dagra::core
@@ -0,0 +1,75 @@
+/**
+ * @file selection.cpp
+ * @brief Implements the resolution of command-line targets to tasks.
+ * @version 1.1.0
+ *
+ * This file contains the implementation of target and tag matching. Matches
+ * are collected in a bitset indexed by `TaskIndex`, so overlapping targets
+ * never produce duplicates.
+ */
+
+#include "dagra/core/selection.hpp"
+#include <algorithm>
+#include <fnmatch.h>
+#include <stdexcept>
+
+namespace dagra::core {
+
+    bool is_glob(const std::string& pattern) {
+        return pattern.find_first_of("*?[") != std::string::npos;
+    }
+
+    /**
+     * @brief Resolves exact IDs by lookup, and globs and tags by one scan over the tasks each.
+     */
+    std::vector<TaskIndex> select_targets(const Dag& dag, const std::vector<std::string>& targets,
+                                          const std::vector<std::string>& tags) {
+        std::vector<bool> chosen(dag.size(), false);
+        std::vector<TaskIndex> selected;
+        auto choose = [&](TaskIndex index) {
+            if (!chosen[index]) {
+                chosen[index] = true;
+                selected.push_back(index);
+            }
+        };
+
+        for (const auto& target : targets) {
+            if (!is_glob(target)) {
+                TaskIndex index;
+                if (!dag.find(target, index)) {
+                    throw std::runtime_error("Unknown target '" + target + "': no task has this ID.");
+                }
+                choose(index);
+                continue;
+            }
+            bool matched = false;
+            for (TaskIndex i = 0; i < dag.size(); ++i) {
+                if (fnmatch(target.c_str(), dag.task(i).id.c_str(), 0) == 0) {
+                    choose(i);
+                    matched = true;
+                }
+            }
+            if (!matched) {
+                throw std::runtime_error("No task matches the pattern '" + target + "'.");
+            }
+        }
+
+        for (const auto& tag : tags) {
+            bool matched = false;
+            for (TaskIndex i = 0; i < dag.size(); ++i) {
+                const auto& task_tags = dag.task(i).tags;
+                if (std::find(task_tags.begin(), task_tags.end(), tag) != task_tags.end()) {
+                    choose(i);
+                    matched = true;
+                }
+            }
+            if (!matched) {
+                throw std::runtime_error("No task has the tag '" + tag + "'.");
+            }
+        }
+
+        std::sort(selected.begin(), selected.end());
+        return selected;
+    }
+
+} // namespace dagra::core
@@ -0,0 +1,278 @@
+/**
+ * @file event_loop.cpp
+ * @brief Implements the event loop that waits for many child processes on one thread.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the EventLoop class. Each
+ * epoll registration carries an ID: the wake-up eventfd and the cancel
+ * descriptor have fixed IDs, and every watched child gets the next free
+ * one, so a readiness event is routed without a descriptor lookup and a
+ * reused descriptor number can never be mistaken for an earlier child.
+ */
+
+#include "dagra/execution/event_loop.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Registration ID of the wake-up eventfd.
+        constexpr std::uint64_t WAKE_ID = 0;
+
+        /// @brief Registration ID of the cancel descriptor.
+        constexpr std::uint64_t CANCEL_ID = 1;
+
+        /// @brief Registration ID of the first watched child.
+        constexpr std::uint64_t FIRST_CHILD_ID = 2;
+
+        /// @brief Maximum number of readiness events handled per `epoll_wait`.
+        constexpr int MAX_EVENTS = 256;
+
+        /// @brief Interval at which children without a pidfd are checked.
+        constexpr std::chrono::milliseconds FALLBACK_POLL_INTERVAL{10};
+
+    } // namespace
+
+    EventLoop::EventLoop(std::chrono::milliseconds kill_grace, int cancel_fd) :
+        kill_grace_(kill_grace), cancel_fd_(cancel_fd), next_id_(FIRST_CHILD_ID) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            if (epoll_fd_ >= 0) {
+                close(epoll_fd_);
+            }
+            if (wake_fd_ >= 0) {
+                close(wake_fd_);
+            }
+            throw std::runtime_error(std::string("Failed to set up the event loop: ") + std::strerror(errno));
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = WAKE_ID;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+        if (cancel_fd_ >= 0) {
+            event.data.u64 = CANCEL_ID;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, cancel_fd_, &event) != 0) {
+                cancel_fd_ = -1;
+            }
+        }
+    }
+
+    EventLoop::~EventLoop() {
+        for (auto& [id, child] : children_) {
+            child.process.signal_group(SIGKILL);
+            child.process.wait();
+        }
+        close(wake_fd_);
+        close(epoll_fd_);
+    }
+
+    /**
+     * @brief Registers the child's pidfd, or falls back to periodic checks, and arms its deadline.
+     */
+    void EventLoop::watch(Process process, std::chrono::milliseconds timeout, ExitHandler on_exit) {
+        if (process.pid() < 0) {
+            post([on_exit = std::move(on_exit), status = process.wait()]() { on_exit(status); });
+            return;
+        }
+
+        const std::uint64_t id = next_id_++;
+        Child& child = children_[id];
+        child.process = std::move(process);
+        child.on_exit = std::move(on_exit);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (child.process.pidfd() < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, child.process.pidfd(), &event) != 0) {
+            polled_.insert(id);
+        }
+
+        if (cancelled_) {
+            child.cancelled = true;
+            terminate(id, child);
+        } else if (timeout.count() > 0) {
+            child.deadline = std::chrono::steady_clock::now() + timeout;
+            deadlines_.emplace(child.deadline, id);
+        }
+    }
+
+    void EventLoop::post(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            posted_.push_back(std::move(callback));
+        }
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    /**
+     * @brief Waits on epoll with the nearest deadline as timeout and dispatches what became ready.
+     *
+     * Handlers may watch new processes or post callbacks; callbacks posted
+     * by a handler run in the same call.
+     */
+    std::size_t EventLoop::run_once() {
+        std::array<epoll_event, MAX_EVENTS> events;
+        std::vector<std::uint64_t> exited;
+        std::size_t dispatched = 0;
+        while (dispatched == 0) {
+            const int count = epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, next_timeout());
+            if (count < 0 && errno != EINTR) {
+                throw std::runtime_error(std::string("Event loop wait failed: ") + std::strerror(errno));
+            }
+
+            exited.clear();
+            for (int i = 0; i < count; ++i) {
+                const std::uint64_t id = events[i].data.u64;
+                if (id == WAKE_ID) {
+                    std::uint64_t drained = 0;
+                    ssize_t ignored = ::read(wake_fd_, &drained, sizeof(drained));
+                    (void)ignored;
+                } else if (id == CANCEL_ID) {
+                    // The loop never reads the descriptor, so it is unregistered to stop it firing again.
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, cancel_fd_, nullptr);
+                    cancelled_ = true;
+                    for (auto& [child_id, child] : children_) {
+                        if (child.stage == Stage::Running) {
+                            child.cancelled = true;
+                            terminate(child_id, child);
+                        }
+                    }
+                } else {
+                    exited.push_back(id);
+                }
+            }
+            for (std::uint64_t id : polled_) {
+                if (children_.at(id).process.has_exited()) {
+                    exited.push_back(id);
+                }
+            }
+            for (std::uint64_t id : exited) {
+                reap(id);
+                ++dispatched;
+            }
+
+            expire_deadlines();
+            dispatched += run_posted();
+        }
+        return dispatched;
+    }
+
+    std::size_t EventLoop::watched() const {
+        return children_.size();
+    }
+
+    void EventLoop::terminate(std::uint64_t id, Child& child) {
+        child.process.signal_group(SIGTERM);
+        child.stage = Stage::Terminating;
+        child.deadline = std::chrono::steady_clock::now() + kill_grace_;
+        deadlines_.emplace(child.deadline, id);
+    }
+
+    void EventLoop::expire_deadlines() {
+        const auto now = std::chrono::steady_clock::now();
+        while (!deadlines_.empty() && deadlines_.top().first <= now) {
+            const auto [deadline, id] = deadlines_.top();
+            deadlines_.pop();
+            auto it = children_.find(id);
+            if (it == children_.end() || it->second.deadline != deadline) {
+                continue;
+            }
+            Child& child = it->second;
+            if (child.stage == Stage::Running) {
+                child.timed_out = true;
+                terminate(id, child);
+            } else if (child.stage == Stage::Terminating) {
+                child.process.signal_group(SIGKILL);
+                child.stage = Stage::Killed;
+            }
+        }
+    }
+
+    /**
+     * @brief Unregisters the child and reaps it with `Process::wait`, which no longer blocks.
+     */
+    void EventLoop::reap(std::uint64_t id) {
+        auto it = children_.find(id);
+        Child child = std::move(it->second);
+        children_.erase(it);
+        if (polled_.erase(id) == 0) {
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, child.process.pidfd(), nullptr);
+        }
+        if (child.stage != Stage::Running) {
+            // Sent even if the leader already exited, so nothing it left behind in the group survives.
+            child.process.signal_group(SIGKILL);
+        }
+        ExitStatus status = child.process.wait();
+        status.timed_out = child.timed_out;
+        status.cancelled = child.cancelled;
+        child.on_exit(std::move(status));
+    }
+
+    std::size_t EventLoop::run_posted() {
+        std::size_t ran = 0;
+        while (true) {
+            std::vector<std::function<void()>> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                callbacks.swap(posted_);
+            }
+            if (callbacks.empty()) {
+                return ran;
+            }
+            for (auto& callback : callbacks) {
+                callback();
+            }
+            ran += callbacks.size();
+        }
+    }
+
+    int EventLoop::next_timeout() const {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (!posted_.empty()) {
+                return 0;
+            }
+        }
+        std::chrono::milliseconds timeout(-1);
+        if (!deadlines_.empty()) {
+            const auto remaining = deadlines_.top().first - std::chrono::steady_clock::now();
+            // Rounded up, so the loop does not wake just before the deadline and spin.
+            timeout = std::max(std::chrono::milliseconds(0),
+                               std::chrono::ceil<std::chrono::milliseconds>(remaining));
+        }
+        if (!polled_.empty() && (timeout.count() < 0 || timeout > FALLBACK_POLL_INTERVAL)) {
+            timeout = FALLBACK_POLL_INTERVAL;
+        }
+        return static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), 1 << 30));
+    }
+
+    std::size_t raise_descriptor_limit() {
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+            return 1024;
+        }
+        if (limit.rlim_cur < limit.rlim_max) {
+            rlimit raised{limit.rlim_max, limit.rlim_max};
+            if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+                limit = raised;
+            }
+        }
+        return limit.rlim_cur == RLIM_INFINITY ? static_cast<std::size_t>(-1) : static_cast<std::size_t>(limit.rlim_cur);
+    }
+
+} // namespace dagra::execution
@@ -0,0 +1,399 @@
+/**
+ * @file output_collector.cpp
+ * @brief Implements the epoll-based multiplexer that captures task output.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the OutputCollector and
+ * TaskOutput classes. The collector thread is the only code that reads the
+ * pipes, writes the log files and touches the partial-line buffers; the ring
+ * buffer is shared with the worker thread under the TaskOutput's mutex.
+ */
+
+#include "dagra/execution/output_collector.hpp"
+#include "dagra/utils/io.hpp"
+#include "dagra/utils/logger.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Size of the buffer each read drains into.
+        constexpr std::size_t READ_CHUNK = 64 * 1024;
+
+        /// @brief Maximum number of reads from one stream per readiness event.
+        constexpr int READS_PER_EVENT = 4;
+
+        /// @brief Maximum number of readiness events handled per `epoll_wait`.
+        constexpr int MAX_EVENTS = 64;
+
+    } // namespace
+
+    std::string log_file_name(const std::string& task_id) {
+        std::string name = task_id;
+        for (char& c : name) {
+            const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                              c == '-' || c == '_' || c == '.';
+            if (!safe) {
+                c = '_';
+            }
+        }
+        if (name.empty() || name == "." || name == "..") {
+            name = "_" + name;
+        }
+        return name + ".log";
+    }
+
+    TaskOutput::TaskOutput(std::string task_id, std::size_t tail_capacity) :
+        task_id_(std::move(task_id)), ring_(tail_capacity) {}
+
+    TaskOutput::~TaskOutput() {
+        if (log_fd_ >= 0) {
+            close(log_fd_);
+        }
+    }
+
+    void TaskOutput::append_tail(const char* data, std::size_t size) {
+        const std::size_t capacity = ring_.size();
+        if (capacity == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (size >= capacity) {
+            std::memcpy(ring_.data(), data + size - capacity, capacity);
+            ring_start_ = 0;
+            ring_size_ = capacity;
+            return;
+        }
+        std::size_t end = (ring_start_ + ring_size_) % capacity;
+        for (std::size_t copied = 0; copied < size;) {
+            const std::size_t run = std::min(size - copied, capacity - end);
+            std::memcpy(ring_.data() + end, data + copied, run);
+            copied += run;
+            end = (end + run) % capacity;
+        }
+        const std::size_t total = ring_size_ + size;
+        if (total > capacity) {
+            ring_start_ = (ring_start_ + total - capacity) % capacity;
+            ring_size_ = capacity;
+        } else {
+            ring_size_ = total;
+        }
+    }
+
+    std::string TaskOutput::tail() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::string text;
+        text.reserve(ring_size_);
+        for (std::size_t i = 0; i < ring_size_; ++i) {
+            text += ring_[(ring_start_ + i) % ring_.size()];
+        }
+        // If the buffer wrapped, drop the leading partial line.
+        if (ring_size_ == ring_.size()) {
+            std::size_t newline = text.find('\n');
+            if (newline != std::string::npos && newline + 1 < text.size()) {
+                text.erase(0, newline + 1);
+            }
+        }
+        return text;
+    }
+
+    const std::string& TaskOutput::log_path() const {
+        return log_path_;
+    }
+
+    void TaskOutput::finish(std::chrono::milliseconds limit) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_cv_.wait_for(lock, limit, [this]() { return open_streams_ == 0; })) {
+            return;
+        }
+        abandoned_ = true;
+        closed_cv_.wait(lock, [this]() { return open_streams_ == 0; });
+    }
+
+    void TaskOutput::finish_async(std::chrono::milliseconds limit, std::function<void()> on_closed) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (open_streams_ > 0) {
+                on_closed_ = std::move(on_closed);
+                drain_deadline_ = std::chrono::steady_clock::now() + limit;
+                draining_ = true;
+                return;
+            }
+        }
+        on_closed();
+    }
+
+    /**
+     * @brief Creates the epoll instance and wake-up eventfd, then starts the collector thread.
+     * @param options Where captured output goes.
+     */
+    OutputCollector::OutputCollector(const OutputOptions& options) : options_(options) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            if (epoll_fd_ >= 0) {
+                close(epoll_fd_);
+            }
+            if (wake_fd_ >= 0) {
+                close(wake_fd_);
+            }
+            throw std::runtime_error(std::string("Failed to set up output capture: ") + std::strerror(errno));
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+        if (!options_.log_dir.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(options_.log_dir, ec);
+        }
+
+        thread_ = std::thread([this]() { loop(); });
+    }
+
+    OutputCollector::~OutputCollector() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        wake();
+        thread_.join();
+
+        std::vector<int> remaining;
+        for (const auto& [fd, stream] : streams_) {
+            remaining.push_back(fd);
+        }
+        for (int fd : remaining) {
+            close_stream(fd);
+        }
+        close(wake_fd_);
+        close(epoll_fd_);
+    }
+
+    /**
+     * @brief Opens the task's log file, makes its pipes non-blocking and registers them with epoll.
+     */
+    std::shared_ptr<TaskOutput> OutputCollector::attach(const std::string& task_id, int stdout_fd, int stderr_fd) {
+        std::shared_ptr<TaskOutput> output(new TaskOutput(task_id, options_.tail_bytes));
+        if (!options_.log_dir.empty()) {
+            output->log_path_ = (std::filesystem::path(options_.log_dir) / log_file_name(task_id)).string();
+            output->log_fd_ = ::open(output->log_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (output->log_fd_ < 0) {
+                output->log_path_.clear();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (int fd : {stdout_fd, stderr_fd}) {
+            if (fd < 0) {
+                continue;
+            }
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            auto stream = std::make_unique<Stream>(Stream{output, fd, fd == stderr_fd, {}});
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = stream.get();
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close(fd);
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> output_lock(output->mtx_);
+                ++output->open_streams_;
+            }
+            streams_.emplace(fd, std::move(stream));
+        }
+        return output;
+    }
+
+    void OutputCollector::wake() {
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    /**
+     * @brief Waits for readiness events until the collector is stopped.
+     *
+     * Abandoned tasks are checked every 100 ms, which bounds how long a
+     * `finish` or `finish_async` timeout can overshoot.
+     */
+    void OutputCollector::loop() {
+        std::array<epoll_event, MAX_EVENTS> events;
+        while (true) {
+            int count = epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, 100);
+            if (count < 0 && errno != EINTR) {
+                break;
+            }
+            for (int i = 0; i < count; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    std::uint64_t drained = 0;
+                    ssize_t ignored = ::read(wake_fd_, &drained, sizeof(drained));
+                    (void)ignored;
+                    continue;
+                }
+                Stream& stream = *static_cast<Stream*>(events[i].data.ptr);
+                if (!drain(stream)) {
+                    close_stream(stream.fd);
+                }
+            }
+            close_abandoned();
+
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (stopping_) {
+                break;
+            }
+        }
+    }
+
+    bool OutputCollector::drain(Stream& stream) {
+        std::array<char, READ_CHUNK> buffer;
+        int reads = 0;
+        while (true) {
+            // The epoll registration is level-triggered, so a stream left readable is reported again on the next wait.
+            if (reads == READS_PER_EVENT) {
+                return true;
+            }
+            ssize_t n = ::read(stream.fd, buffer.data(), buffer.size());
+            if (n > 0) {
+                consume(stream, buffer.data(), static_cast<std::size_t>(n), false);
+                ++reads;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+
+    /**
+     * @brief Writes a chunk to the log file and ring buffer and echoes its complete lines.
+     * @param stream The stream the chunk was read from.
+     * @param data The bytes read (may be null when `final` is set).
+     * @param size The number of bytes.
+     * @param final If true, a held-back partial line is flushed with a newline appended.
+     */
+    void OutputCollector::consume(Stream& stream, const char* data, std::size_t size, bool final) {
+        TaskOutput& output = *stream.owner;
+        if (size > 0) {
+            if (output.log_fd_ >= 0) {
+                utils::write_all(output.log_fd_, data, size);
+            }
+            output.append_tail(data, size);
+        }
+        if (!options_.echo) {
+            return;
+        }
+
+        // Hand over everything up to the last newline; keep the rest for the next chunk.
+        std::size_t last_newline = size;
+        for (std::size_t i = size; i > 0; --i) {
+            if (data[i - 1] == '\n') {
+                last_newline = i - 1;
+                break;
+            }
+        }
+        std::string lines;
+        if (last_newline < size) {
+            lines = std::move(stream.partial);
+            lines.append(data, last_newline + 1);
+            stream.partial.assign(data + last_newline + 1, size - last_newline - 1);
+        } else {
+            stream.partial.append(data, size);
+        }
+        if (final && !stream.partial.empty()) {
+            lines += stream.partial;
+            lines += '\n';
+            stream.partial.clear();
+        }
+        if (lines.empty()) {
+            return;
+        }
+        if (options_.sink) {
+            options_.sink(output.task_id_, stream.is_stderr, std::move(lines));
+        } else {
+            utils::Logger::output(output.task_id_, stream.is_stderr, std::move(lines));
+        }
+    }
+
+    void OutputCollector::close_stream(int fd) {
+        std::unique_ptr<Stream> stream;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = streams_.find(fd);
+            if (it == streams_.end()) {
+                return;
+            }
+            stream = std::move(it->second);
+            streams_.erase(it);
+        }
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        consume(*stream, nullptr, 0, true);
+
+        TaskOutput& output = *stream->owner;
+        std::function<void()> on_closed;
+        {
+            std::lock_guard<std::mutex> lock(output.mtx_);
+            if (--output.open_streams_ == 0) {
+                if (output.log_fd_ >= 0) {
+                    close(output.log_fd_);
+                    output.log_fd_ = -1;
+                }
+                // Moved out so the callback, which may own the output, does not keep itself alive.
+                on_closed = std::move(output.on_closed_);
+                output.on_closed_ = nullptr;
+            }
+            output.closed_cv_.notify_all();
+        }
+        if (on_closed) {
+            on_closed();
+        }
+    }
+
+    void OutputCollector::close_abandoned() {
+        std::vector<int> abandoned;
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (const auto& [fd, stream] : streams_) {
+                TaskOutput& owner = *stream->owner;
+                std::lock_guard<std::mutex> output_lock(owner.mtx_);
+                if (owner.draining_ && now >= owner.drain_deadline_) {
+                    owner.abandoned_ = true;
+                }
+                if (owner.abandoned_) {
+                    abandoned.push_back(fd);
+                }
+            }
+        }
+        for (int fd : abandoned) {
+            Stream* stream = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = streams_.find(fd);
+                stream = it == streams_.end() ? nullptr : it->second.get();
+            }
+            // Pick up whatever is already buffered before giving up on the pipe.
+            if (stream != nullptr) {
+                drain(*stream);
+            }
+            close_stream(fd);
+        }
+    }
+
+} // namespace dagra::execution
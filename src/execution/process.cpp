@@ -0,0 +1,660 @@
+/**
+ * @file process.cpp
+ * @brief Implements the posix_spawn-based process launcher.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the Process class. Spawning does
+ * not fork the dagra address space: `posix_spawn` starts the program directly,
+ * so launch cost stays flat no matter how large the in-memory task graph is.
+ * Only tasks with a memory limit are forked, to set the limit before exec.
+ * Deadlines are enforced in-process by polling the child's pidfd and
+ * signalling its process group, so no `timeout` wrapper is exec'd per task.
+ */
+
+#include "dagra/execution/process.hpp"
+#include "dagra/utils/logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_set>
+
+extern char** environ;
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Characters that make a command depend on shell interpretation.
+        constexpr const char* SHELL_METACHARACTERS = "|&;<>()$`\\\"'*?[]#~%!{}\n";
+
+        /**
+         * @brief Splits a command on spaces and tabs.
+         * @param command A command that does not need a shell.
+         * @return The whitespace-separated words.
+         */
+        std::vector<std::string> split_words(const std::string& command) {
+            std::vector<std::string> words;
+            std::string current;
+            for (char c : command) {
+                if (c == ' ' || c == '\t') {
+                    if (!current.empty()) {
+                        words.push_back(std::move(current));
+                        current.clear();
+                    }
+                } else {
+                    current += c;
+                }
+            }
+            if (!current.empty()) {
+                words.push_back(std::move(current));
+            }
+            return words;
+        }
+
+        /**
+         * @brief Checks whether a word is a shell builtin or keyword with no standalone binary
+         *        equivalent (or whose effect would be lost outside the shell).
+         * @param word The first word of a command.
+         * @return True if the word must be interpreted by the shell.
+         */
+        bool is_shell_builtin(const std::string& word) {
+            static const std::unordered_set<std::string> builtins = {
+                ".",     ":",     "alias", "break",  "case",     "cd",    "continue", "do",
+                "done",  "elif",  "else",  "esac",   "eval",     "exec",  "exit",     "export",
+                "fi",    "for",   "function", "if",  "local",    "read",  "readonly", "return",
+                "set",   "shift", "source", "then",  "trap",     "ulimit", "umask",   "unset",
+                "until", "wait",  "while"};
+            return builtins.count(word) > 0;
+        }
+
+        /// @brief Poll interval used when pidfds are not available.
+        constexpr std::chrono::milliseconds FALLBACK_POLL_INTERVAL{10};
+
+        /// @brief The wait limit used for tasks without a timeout that can still be cancelled.
+        constexpr std::chrono::milliseconds NO_DEADLINE = std::chrono::hours(24 * 365);
+
+        /// @brief Largest timeout a single `poll` call accepts.
+        constexpr std::chrono::milliseconds MAX_POLL_SLICE{1 << 30};
+
+        /**
+         * @brief Opens a pidfd for a child process.
+         * @param pid The child's process ID.
+         * @return The file descriptor, or -1 if the kernel does not support pidfds.
+         */
+        int open_pidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+            return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+            (void)pid;
+            return -1;
+#endif
+        }
+
+        /**
+         * @brief Reads the storage I/O counters of an exited, not yet reaped child.
+         *
+         * The counters include every descendant the child has reaped. Fields
+         * are left at -1 if the file is missing (e.g. no task I/O accounting).
+         *
+         * @param pid The child's process ID.
+         * @param usage Receives `read_bytes` and `write_bytes`.
+         */
+        void read_proc_io(pid_t pid, ResourceUsage& usage) {
+            std::ifstream io("/proc/" + std::to_string(pid) + "/io");
+            std::string key;
+            std::int64_t value = 0;
+            while (io >> key >> value) {
+                if (key == "read_bytes:") {
+                    usage.read_bytes = value;
+                } else if (key == "write_bytes:") {
+                    usage.write_bytes = value;
+                }
+            }
+        }
+
+        /// @brief Converts a `timeval` to seconds.
+        double to_seconds(const timeval& time) {
+            return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) / 1e6;
+        }
+
+        /**
+         * @brief Converts a vector of strings into a null-terminated pointer array.
+         * @param strings The backing strings, which must outlive the returned array.
+         * @return The pointer array suitable for `posix_spawn`.
+         */
+        std::vector<char*> to_pointer_array(std::vector<std::string>& strings) {
+            std::vector<char*> pointers;
+            pointers.reserve(strings.size() + 1);
+            for (auto& value : strings) {
+                pointers.push_back(value.data());
+            }
+            pointers.push_back(nullptr);
+            return pointers;
+        }
+
+        /// @brief The descriptors a spawned child receives; -1 leaves the slot at its default.
+        struct ChildDescriptors {
+            int stdin_fd;
+            int stdout_fd;
+            int stderr_fd;
+            int status_fd;
+        };
+
+        /// @brief What a forked child reports on its error pipe before exec.
+        struct ChildFailure {
+            enum Step : int { Limit, Exec } step;
+            int error;
+        };
+
+        /**
+         * @brief Starts a program with `fork`, lowering the child's `RLIMIT_DATA` before it execs.
+         *
+         * Sets up the child like `posix_spawnp` with the same attributes would,
+         * using only async-signal-safe calls between `fork` and exec. Failures
+         * in the child are sent back on a close-on-exec pipe, which reaches
+         * end of file once the exec has succeeded.
+         *
+         * @param argv The argument vector.
+         * @param envp The environment.
+         * @param fds The descriptors to install.
+         * @param limit The data limit to set.
+         * @param pid Receives the child's process ID.
+         * @param limited Set to false if the limit could not be set; the program runs regardless.
+         * @return 0, or the `errno` of a failed fork or exec.
+         */
+        int fork_limited(char* const argv[], char* const envp[], ChildDescriptors fds, const rlimit& limit,
+                         pid_t& pid, bool& limited) {
+            int report[2];
+            if (pipe2(report, O_CLOEXEC) != 0) {
+                return errno;
+            }
+            sigset_t empty_mask;
+            sigemptyset(&empty_mask);
+
+            pid = fork();
+            if (pid == 0) {
+                auto fail = [&](ChildFailure::Step step) {
+                    const ChildFailure failure{step, errno};
+                    ssize_t ignored = ::write(report[1], &failure, sizeof(failure));
+                    (void)ignored;
+                };
+                sigprocmask(SIG_SETMASK, &empty_mask, nullptr);
+                setpgid(0, 0);
+                if (fds.stdin_fd >= 0) {
+                    dup2(fds.stdin_fd, STDIN_FILENO);
+                } else {
+                    const int null_fd = open("/dev/null", O_RDONLY);
+                    if (null_fd >= 0 && null_fd != STDIN_FILENO) {
+                        dup2(null_fd, STDIN_FILENO);
+                        close(null_fd);
+                    }
+                }
+                if (fds.stdout_fd >= 0) {
+                    dup2(fds.stdout_fd, STDOUT_FILENO);
+                }
+                if (fds.stderr_fd >= 0) {
+                    dup2(fds.stderr_fd, STDERR_FILENO);
+                }
+                if (fds.status_fd >= 0) {
+                    dup2(fds.status_fd, STATUS_FD);
+                }
+                if (setrlimit(RLIMIT_DATA, &limit) != 0) {
+                    fail(ChildFailure::Limit);
+                }
+                execvpe(argv[0], argv, envp);
+                fail(ChildFailure::Exec);
+                _exit(127);
+            }
+
+            const int fork_error = errno;
+            close(report[1]);
+            if (pid < 0) {
+                close(report[0]);
+                return fork_error;
+            }
+            // Also set here, so the group exists even if the parent signals it before the child ran.
+            setpgid(pid, pid);
+
+            limited = true;
+            int exec_error = 0;
+            ChildFailure failure{};
+            ssize_t n = 0;
+            while ((n = ::read(report[0], &failure, sizeof(failure))) != 0) {
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    break;
+                }
+                if (failure.step == ChildFailure::Limit) {
+                    limited = false;
+                } else {
+                    exec_error = failure.error;
+                }
+            }
+            close(report[0]);
+            if (exec_error != 0) {
+                while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+                }
+                pid = -1;
+            }
+            return exec_error;
+        }
+
+    } // namespace
+
+    bool ExitStatus::success() const {
+        return kind == Kind::Exited && code == 0;
+    }
+
+    std::string ExitStatus::describe() const {
+        if (cancelled) {
+            return "Cancelled";
+        }
+        if (timed_out) {
+            return "Timed out" + (kind == Kind::Signaled ? ", killed by signal " + std::to_string(signal) : "");
+        }
+        switch (kind) {
+        case Kind::Exited:
+            return "Exit code: " + std::to_string(code);
+        case Kind::Signaled:
+            return "Killed by signal " + std::to_string(signal) + " (" + strsignal(signal) + ")";
+        case Kind::SpawnFailed:
+            return std::string("Failed to start: ") + std::strerror(error);
+        }
+        return "Unknown status";
+    }
+
+    ExitStatus ExitStatus::from_wait_status(int status) {
+        ExitStatus result;
+        if (WIFSIGNALED(status)) {
+            result.kind = Kind::Signaled;
+            result.signal = WTERMSIG(status);
+        } else {
+            result.kind = Kind::Exited;
+            result.code = WIFEXITED(status) ? WEXITSTATUS(status) : status;
+        }
+        return result;
+    }
+
+    bool needs_shell(const std::string& command) {
+        if (command.find_first_of(SHELL_METACHARACTERS) != std::string::npos) {
+            return true;
+        }
+
+        std::vector<std::string> words = split_words(command);
+        if (words.empty()) {
+            return true;
+        }
+        // A leading `KEY=value` word is a variable assignment, not a program name.
+        return words.front().find('=') != std::string::npos || is_shell_builtin(words.front());
+    }
+
+    std::vector<std::string> build_argv(const std::string& command, bool use_shell) {
+        if (use_shell) {
+            return {"/bin/sh", "-c", command};
+        }
+        return split_words(command);
+    }
+
+    std::vector<std::string> build_environment(const std::vector<std::string>& overrides) {
+        std::unordered_set<std::string> overridden_keys;
+        for (const auto& entry : overrides) {
+            overridden_keys.insert(entry.substr(0, entry.find('=')));
+        }
+
+        std::vector<std::string> environment;
+        for (char** entry = environ; entry != nullptr && *entry != nullptr; ++entry) {
+            std::string value(*entry);
+            if (overridden_keys.count(value.substr(0, value.find('='))) == 0) {
+                environment.push_back(std::move(value));
+            }
+        }
+        environment.insert(environment.end(), overrides.begin(), overrides.end());
+        return environment;
+    }
+
+    std::string build_fused_script(const std::vector<const core::Task*>& tasks, bool stop_on_failure) {
+        const std::string status_fd = std::to_string(STATUS_FD);
+        std::string script;
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            // The newline before ')' keeps a trailing comment in the command from swallowing it.
+            script += "(\n" + tasks[i]->command + "\n) " + status_fd + ">&-\n";
+            script += "s=$?\necho \"" + std::to_string(i) + " $s\" >&" + status_fd + "\n";
+            if (stop_on_failure && !tasks[i]->allow_failure && i + 1 < tasks.size()) {
+                script += "[ \"$s\" -eq 0 ] || exit \"$s\"\n";
+            }
+        }
+        return script;
+    }
+
+    std::vector<int> parse_fused_status(const std::string& report, std::size_t count) {
+        std::vector<int> codes(count, -1);
+        std::size_t start = 0;
+        while (start < report.size()) {
+            std::size_t end = report.find('\n', start);
+            if (end == std::string::npos) {
+                break;
+            }
+            unsigned long position = 0;
+            int code = 0;
+            if (std::sscanf(report.c_str() + start, "%lu %d", &position, &code) == 2 && position < count) {
+                codes[position] = code;
+            }
+            start = end + 1;
+        }
+        return codes;
+    }
+
+    /**
+     * @brief Starts a task's command with `posix_spawnp`.
+     *
+     * The command is executed directly unless `needs_shell` says otherwise.
+     * When the task overrides `PATH`, the shell is used as well so that the
+     * program is resolved against the task's `PATH` rather than dagra's. The
+     * child starts in a new process group and, where supported, a pidfd is
+     * opened for it.
+     *
+     * If the task requests `memory_mb`, the child's `RLIMIT_DATA` is set to
+     * that amount before it execs, so allocations beyond it fail from the
+     * first one. `posix_spawn` offers no hook to set limits in the child, so
+     * such tasks are started with `fork` instead and pay for copying dagra's
+     * page tables; a limit that cannot be set is logged and the task runs
+     * without it. The data limit is used rather than `RLIMIT_AS` so that
+     * runtimes which reserve large virtual address ranges up front still
+     * start.
+     *
+     * @param task The task to start.
+     * @param stdout_fd If non-negative, duplicated onto the child's stdout.
+     * @param stderr_fd If non-negative, duplicated onto the child's stderr.
+     * @param status_fd If non-negative, duplicated onto the child's `STATUS_FD`.
+     * @param stdin_fd If non-negative, duplicated onto the child's stdin; otherwise stdin is `/dev/null`.
+     * @return The started process, or a non-running Process on failure.
+     */
+    Process Process::spawn(const core::Task& task, int stdout_fd, int stderr_fd, int status_fd, int stdin_fd) {
+        bool overrides_path = false;
+        for (const auto& entry : task.env_vars) {
+            if (entry.rfind("PATH=", 0) == 0) {
+                overrides_path = true;
+                break;
+            }
+        }
+
+        std::vector<std::string> args = build_argv(task.command, overrides_path || needs_shell(task.command));
+        std::vector<std::string> env = task.env_vars.empty() ? std::vector<std::string>{}
+                                                             : build_environment(task.env_vars);
+
+        std::vector<char*> argv = to_pointer_array(args);
+        std::vector<char*> envp = to_pointer_array(env);
+        char* const* child_env = task.env_vars.empty() ? environ : envp.data();
+
+        Process process;
+        process.started_ = std::chrono::steady_clock::now();
+        auto memory = task.resources.find(core::RESOURCE_MEMORY_MB);
+        if (memory != task.resources.end() && memory->second > 0.0) {
+            // Clamped to the current hard limit, which an unprivileged process cannot raise.
+            rlimit current{};
+            getrlimit(RLIMIT_DATA, &current);
+            const rlim_t bytes = std::min(static_cast<rlim_t>(memory->second * 1024.0 * 1024.0), current.rlim_max);
+            bool limited = false;
+            const int rc = fork_limited(argv.data(), child_env, {stdin_fd, stdout_fd, stderr_fd, status_fd},
+                                        rlimit{bytes, bytes}, process.pid_, limited);
+            if (rc != 0) {
+                process.pid_ = -1;
+                process.spawn_error_ = rc;
+                return process;
+            }
+            if (!limited) {
+                utils::Logger::warn("Could not apply the memory limit of task '" + task.id + "'; it runs without one.");
+            }
+            process.pidfd_ = open_pidfd(process.pid_);
+            return process;
+        }
+
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t empty_mask;
+        sigemptyset(&empty_mask);
+        posix_spawnattr_setsigmask(&attr, &empty_mask);
+        posix_spawnattr_setpgroup(&attr, 0);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (stdin_fd >= 0) {
+            posix_spawn_file_actions_adddup2(&actions, stdin_fd, STDIN_FILENO);
+        } else {
+            // A background process group reading dagra's terminal would be stopped by SIGTTIN.
+            posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        }
+        if (stdout_fd >= 0) {
+            posix_spawn_file_actions_adddup2(&actions, stdout_fd, STDOUT_FILENO);
+        }
+        if (stderr_fd >= 0) {
+            posix_spawn_file_actions_adddup2(&actions, stderr_fd, STDERR_FILENO);
+        }
+        if (status_fd >= 0) {
+            posix_spawn_file_actions_adddup2(&actions, status_fd, STATUS_FD);
+        }
+
+        int rc = posix_spawnp(&process.pid_, argv[0], &actions, &attr, argv.data(), child_env);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+
+        if (rc != 0) {
+            process.pid_ = -1;
+            process.spawn_error_ = rc;
+        } else {
+            process.pidfd_ = open_pidfd(process.pid_);
+        }
+        return process;
+    }
+
+    Process::~Process() {
+        discard();
+    }
+
+    Process::Process(Process&& other) noexcept :
+        pid_(other.pid_), pidfd_(other.pidfd_), spawn_error_(other.spawn_error_), started_(other.started_) {
+        other.pid_ = -1;
+        other.pidfd_ = -1;
+    }
+
+    Process& Process::operator=(Process&& other) noexcept {
+        if (this != &other) {
+            discard();
+            pid_ = other.pid_;
+            pidfd_ = other.pidfd_;
+            spawn_error_ = other.spawn_error_;
+            started_ = other.started_;
+            other.pid_ = -1;
+            other.pidfd_ = -1;
+        }
+        return *this;
+    }
+
+    void Process::discard() {
+        if (pid_ >= 0) {
+            kill(-pid_, SIGKILL);
+            while (waitpid(pid_, nullptr, 0) < 0 && errno == EINTR) {
+            }
+            pid_ = -1;
+        }
+        if (pidfd_ >= 0) {
+            close(pidfd_);
+            pidfd_ = -1;
+        }
+    }
+
+    /**
+     * @brief Waits for the process to exit, collects its resource usage and reaps it.
+     * @return The decoded exit status.
+     */
+    ExitStatus Process::wait() {
+        if (pid_ < 0) {
+            ExitStatus failed;
+            failed.kind = ExitStatus::Kind::SpawnFailed;
+            failed.error = spawn_error_;
+            return failed;
+        }
+
+        // Wait without reaping first: /proc/<pid>/io disappears once the child is reaped.
+        siginfo_t info{};
+        while (waitid(P_PID, static_cast<id_t>(pid_), &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+        }
+        ResourceUsage usage;
+        read_proc_io(pid_, usage);
+
+        int status = 0;
+        rusage resources{};
+        while (wait4(pid_, &status, 0, &resources) < 0) {
+            if (errno != EINTR) {
+                ExitStatus failed;
+                failed.kind = ExitStatus::Kind::SpawnFailed;
+                failed.error = errno;
+                return failed;
+            }
+        }
+        pid_ = -1;
+        if (pidfd_ >= 0) {
+            close(pidfd_);
+            pidfd_ = -1;
+        }
+
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - started_;
+        usage.wall_seconds = wall.count();
+        usage.user_seconds = to_seconds(resources.ru_utime);
+        usage.system_seconds = to_seconds(resources.ru_stime);
+        usage.max_rss_kb = resources.ru_maxrss;
+        usage.voluntary_switches = resources.ru_nvcsw;
+        usage.involuntary_switches = resources.ru_nivcsw;
+
+        ExitStatus result = ExitStatus::from_wait_status(status);
+        result.usage = usage;
+        return result;
+    }
+
+    /**
+     * @brief Waits for the process and enforces its deadline on the whole process group.
+     *
+     * The child is not reaped until the group has been signalled, so its PID
+     * (and therefore the process group ID) cannot be reused in the meantime.
+     *
+     * @param timeout The maximum run time; zero or negative means no limit.
+     * @param grace How long to wait between SIGTERM and SIGKILL.
+     * @param cancel_fd A descriptor that becomes readable to cancel the task, or -1.
+     * @return The decoded exit status.
+     */
+    ExitStatus Process::wait_with_timeout(std::chrono::milliseconds timeout, std::chrono::milliseconds grace,
+                                          int cancel_fd) {
+        if (pid_ < 0 || (timeout.count() <= 0 && cancel_fd < 0) ||
+            wait_exit_for(timeout.count() > 0 ? timeout : NO_DEADLINE, cancel_fd)) {
+            return wait();
+        }
+        pollfd cancel{cancel_fd, POLLIN, 0};
+        const bool cancelled = cancel_fd >= 0 && poll(&cancel, 1, 0) > 0;
+
+        ExitStatus status = terminate(grace);
+        status.timed_out = !cancelled;
+        status.cancelled = cancelled;
+        return status;
+    }
+
+    /**
+     * @brief Sends SIGTERM and then SIGKILL to the process group and reaps the process.
+     * @param grace How long to wait between SIGTERM and SIGKILL.
+     * @return The decoded exit status.
+     */
+    ExitStatus Process::terminate(std::chrono::milliseconds grace) {
+        if (pid_ < 0) {
+            return wait();
+        }
+        kill(-pid_, SIGTERM);
+        wait_exit_for(grace);
+        // Sent even if the leader already exited, so nothing it left behind in the group survives.
+        kill(-pid_, SIGKILL);
+        return wait();
+    }
+
+    /**
+     * @brief Waits for the process to exit without reaping it.
+     *
+     * Uses `poll` on the pidfd when available and otherwise falls back to
+     * periodic `waitid(..., WNOWAIT)` checks.
+     *
+     * @param limit The maximum time to wait.
+     * @param cancel_fd If non-negative, polled alongside the process; readiness ends the wait.
+     * @return True if the process has exited within the limit.
+     */
+    bool Process::wait_exit_for(std::chrono::milliseconds limit, int cancel_fd) {
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + limit;
+
+        while (true) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+            if (remaining.count() < 0) {
+                remaining = std::chrono::milliseconds(0);
+            }
+
+            if (pidfd_ >= 0) {
+                pollfd fds[2] = {{pidfd_, POLLIN, 0}, {cancel_fd, POLLIN, 0}};
+                int rc = poll(fds, cancel_fd >= 0 ? 2 : 1, static_cast<int>(std::min(remaining, MAX_POLL_SLICE).count()));
+                if (rc > 0) {
+                    return fds[0].revents != 0;
+                }
+                if (rc == 0) {
+                    if (remaining <= MAX_POLL_SLICE) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (errno != EINTR) {
+                    return true;
+                }
+                continue;
+            }
+
+            siginfo_t info{};
+            if (waitid(P_PID, static_cast<id_t>(pid_), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == pid_) {
+                return true;
+            }
+            if (remaining.count() == 0) {
+                return false;
+            }
+            // Sleep on the cancel descriptor, if any, so cancellation is noticed at once.
+            pollfd cancel{cancel_fd, POLLIN, 0};
+            if (poll(&cancel, cancel_fd >= 0 ? 1 : 0, static_cast<int>(std::min(remaining, FALLBACK_POLL_INTERVAL).count())) > 0) {
+                return false;
+            }
+        }
+    }
+
+    pid_t Process::pid() const {
+        return pid_;
+    }
+
+    int Process::pidfd() const {
+        return pidfd_;
+    }
+
+    bool Process::has_exited() {
+        return pid_ < 0 || wait_exit_for(std::chrono::milliseconds(0));
+    }
+
+    void Process::signal_group(int signal) {
+        if (pid_ >= 0) {
+            kill(-pid_, signal);
+        }
+    }
+
+} // namespace dagra::execution
@@ -9,24 +9,886 @@
  */
 
 #include "dagra/execution/runner.hpp"
+#include "dagra/cache/execution_cache.hpp"
+#include "dagra/cache/journal.hpp"
+#include "dagra/execution/event_loop.hpp"
+#include "dagra/execution/output_collector.hpp"
+#include "dagra/execution/process.hpp"
+#include "dagra/execution/scheduler.hpp"
+#include "dagra/execution/thread_pool.hpp"
+#include "dagra/execution/trace.hpp"
+#include "dagra/execution/worker_pool.hpp"
+#include "dagra/history/history.hpp"
+#include "dagra/remote/coordinator.hpp"
+#include "dagra/utils/io.hpp"
 #include "dagra/utils/logger.hpp"
-#include <atomic>
+#include <algorithm>
 #include <chrono>
+#include <cerrno>
 #include <condition_variable>
-#include <cstdlib>
+#include <cstdint>
+#include <deque>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <unordered_set>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <utility>
 #include <vector>
 
 namespace dagra::execution {
 
+    namespace {
+
+        /// @brief How long a finished task's pipes may stay open (held by stray descendants) before being abandoned.
+        constexpr std::chrono::milliseconds OUTPUT_DRAIN_LIMIT{2000};
+
+        /// @brief Default bound on remote tasks in flight; each waits on its own thread, which costs little.
+        constexpr std::size_t REMOTE_JOBS = 256;
+
+        /// @brief Descriptors each task on the event loop holds: a pidfd and two pipe read ends.
+        constexpr std::size_t DESCRIPTORS_PER_TASK = 3;
+
+        /// @brief Descriptors left for everything else when the event loop's job limit is capped.
+        constexpr std::size_t RESERVED_DESCRIPTORS = 64;
+
+        /// @brief Builds default options with only the dry-run flag set.
+        RunnerOptions make_options(bool dry_run) {
+            RunnerOptions options;
+            options.dry_run = dry_run;
+            return options;
+        }
+
+        /// @brief Converts the resource usage of a finished task into a history sample.
+        history::RunSample to_sample(const ResourceUsage& usage) {
+            history::RunSample sample;
+            sample.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            sample.wall_seconds = usage.wall_seconds;
+            sample.user_seconds = usage.user_seconds;
+            sample.system_seconds = usage.system_seconds;
+            sample.max_rss_kb = usage.max_rss_kb;
+            sample.voluntary_switches = usage.voluntary_switches;
+            sample.involuntary_switches = usage.involuntary_switches;
+            sample.read_bytes = usage.read_bytes;
+            sample.write_bytes = usage.write_bytes;
+            return sample;
+        }
+
+        /**
+         * @brief Records the dependents of a completed task that it made ready.
+         * @param dag The graph being run.
+         * @param scheduler The scheduler, with `task` already marked completed.
+         * @param trace The trace recorder.
+         * @param task The task that just completed.
+         */
+        void trace_released(const core::Dag& dag, const Scheduler& scheduler, TraceRecorder& trace,
+                            core::TaskIndex task) {
+            for (core::TaskIndex dependent : dag.dependents(task)) {
+                bool ready = true;
+                for (core::TaskIndex dep : dag.dependencies(dependent)) {
+                    ready = ready && scheduler.is_completed(dep);
+                }
+                if (ready) {
+                    trace.ready(dependent);
+                }
+            }
+        }
+
+        /// @brief How a task ended.
+        enum class TaskResult {
+            Pending,       ///< The task did not run because the run stopped first.
+            Succeeded,     ///< The command ran and succeeded.
+            Cached,        ///< The task was up to date and not run.
+            Failed,        ///< The command failed; its dependents cannot run.
+            FailedAllowed, ///< The command failed, but the task has `allow_failure` set.
+            Skipped,       ///< A dependency failed, so the task was never run.
+            Resumed,       ///< The journal shows an earlier run completed the task.
+            Cancelled      ///< The run was cancelled before or while the task ran.
+        };
+
+        /// @brief True if the cancel descriptor is set and readable.
+        bool is_cancelled(int cancel_fd) {
+            pollfd fd{cancel_fd, POLLIN, 0};
+            return cancel_fd >= 0 && poll(&fd, 1, 0) > 0;
+        }
+
+        /**
+         * @struct RunContext
+         * @brief State shared by the worker jobs of a single `execute_all` call.
+         *
+         * Jobs are dispatched per scheduling slot: a task, or a fused group
+         * when `fusion` is set. Everything else is indexed by task. Each
+         * task's cache key and result are written only by the job running
+         * that task; its key is read only by jobs of its dependents and its
+         * result only by the main loop, both after its completion has passed
+         * through the runner's mutex.
+         */
+        struct RunContext {
+            const core::Dag& dag;
+            const RunnerOptions& options;
+            cache::ExecutionCache cache;
+            history::History& history;
+            OutputCollector& output;
+            WorkerPool& workers;
+            remote::Coordinator* coordinator;
+            TraceRecorder* trace;
+            const core::FusedGraph* fusion;
+            std::vector<std::uint64_t> keys;
+            std::vector<std::uint8_t> key_valid;
+            std::vector<TaskResult> results;
+        };
+
+        /// @brief The tasks run by a scheduling slot.
+        core::IndexRange slot_members(const core::FusedGraph* fusion, const core::TaskIndex& slot) {
+            if (fusion == nullptr) {
+                return {&slot, &slot + 1};
+            }
+            const std::vector<core::TaskIndex>& members = fusion->members[slot];
+            return {members.data(), members.data() + members.size()};
+        }
+
+        /**
+         * @brief Prints the captured tail of a failed task's output.
+         * @param task The failed task.
+         * @param output The task's captured output.
+         */
+        void report_failure_output(const core::Task& task, const TaskOutput& output) {
+            const std::string tail = output.tail();
+            if (tail.empty()) {
+                return;
+            }
+            std::string header = "Last output of [" + task.id + "]";
+            if (!output.log_path().empty()) {
+                header += " (full log: " + output.log_path() + ")";
+            }
+            utils::Logger::error(header + ":", tail);
+        }
+
+        /**
+         * @brief Classifies the end of a task that was run.
+         * @param task The task.
+         * @param ok Whether the command succeeded.
+         * @return The task's result, taking `allow_failure` into account.
+         */
+        TaskResult classify(const core::Task& task, bool ok) {
+            if (ok) {
+                return TaskResult::Succeeded;
+            }
+            if (task.allow_failure) {
+                utils::Logger::warn("Continuing: [" + task.id + "] is allowed to fail.");
+                return TaskResult::FailedAllowed;
+            }
+            return TaskResult::Failed;
+        }
+
+        /**
+         * @brief Records the end of a task that was run and classifies the result.
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task.
+         * @param ok Whether the command succeeded.
+         * @return The task's result, taking `allow_failure` into account.
+         */
+        TaskResult finish_task(RunContext& context, core::TaskIndex slot, core::TaskIndex index, bool ok) {
+            if (context.trace != nullptr) {
+                context.trace->finished(slot, ok ? TraceRecorder::Outcome::Succeeded : TraceRecorder::Outcome::Failed);
+            }
+            return classify(context.dag.task(index), ok);
+        }
+
+        /**
+         * @brief Computes a task's cache key and keeps it for the task's dependents.
+         * @param context The shared run state, with the cache open.
+         * @param index The index of the task.
+         * @param key Receives the key.
+         * @return False if a dependency has no key or an input cannot be read.
+         */
+        bool compute_task_key(RunContext& context, core::TaskIndex index, std::uint64_t& key) {
+            std::vector<std::uint64_t> dependency_keys;
+            bool dependencies_keyed = true;
+            for (core::TaskIndex dep : context.dag.dependencies(index)) {
+                dependencies_keyed = dependencies_keyed && context.key_valid[dep];
+                dependency_keys.push_back(context.keys[dep]);
+            }
+            if (!dependencies_keyed || !cache::compute_key(context.dag.task(index), dependency_keys, key)) {
+                return false;
+            }
+            context.keys[index] = key;
+            context.key_valid[index] = 1;
+            return true;
+        }
+
+        /**
+         * @brief Checks whether a task can be skipped, logging it as cached if so.
+         * @param context The shared run state.
+         * @param index The index of the task.
+         * @param have_key Receives whether the task's key could be computed.
+         * @param key Receives the key.
+         * @return True if the task is cacheable, its key matches the recorded one and its outputs exist.
+         */
+        bool is_up_to_date(RunContext& context, core::TaskIndex index, bool& have_key, std::uint64_t& key) {
+            have_key = context.cache.is_open() && compute_task_key(context, index, key);
+            const core::Task& task = context.dag.task(index);
+            std::uint64_t recorded = 0;
+            if (have_key && task.is_cacheable() && context.cache.lookup(task.id, recorded) && recorded == key &&
+                cache::outputs_exist(task)) {
+                utils::Logger::success("Cached: [" + task.id + "] (up to date, not run)");
+                return true;
+            }
+            return false;
+        }
+
+        /// @brief Reads what is buffered in a pipe whose writers have exited.
+        std::string read_available(int fd) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            std::string data;
+            char buffer[4096];
+            while (true) {
+                const ssize_t n = ::read(fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    data.append(buffer, static_cast<std::size_t>(n));
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    return data;
+                }
+            }
+        }
+
+        /**
+         * @brief Creates the stdout and stderr pipes of a task.
+         * @param out_pipe Receives the stdout pipe, or -1s on failure.
+         * @param err_pipe Receives the stderr pipe, or -1s on failure.
+         */
+        void open_output_pipes(int out_pipe[2], int err_pipe[2]) {
+            if (pipe2(out_pipe, O_CLOEXEC) != 0 || pipe2(err_pipe, O_CLOEXEC) != 0) {
+                for (int fd : {out_pipe[0], out_pipe[1]}) {
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                }
+                out_pipe[0] = out_pipe[1] = -1;
+                err_pipe[0] = err_pipe[1] = -1;
+            }
+        }
+
+        /**
+         * @brief Logs the tasks skipped because a dependency failed.
+         * @param dag The graph being run.
+         * @param failed The task that failed.
+         * @param skipped Its transitive dependents that will not run.
+         */
+        void report_skipped(const core::Dag& dag, core::TaskIndex failed, const std::vector<core::TaskIndex>& skipped) {
+            if (skipped.empty()) {
+                return;
+            }
+            constexpr std::size_t MAX_LISTED = 10;
+            std::string names;
+            for (std::size_t i = 0; i < skipped.size() && i < MAX_LISTED; ++i) {
+                names += (i == 0 ? "" : ", ") + dag.task(skipped[i]).id;
+            }
+            if (skipped.size() > MAX_LISTED) {
+                names += " and " + std::to_string(skipped.size() - MAX_LISTED) + " more";
+            }
+            utils::Logger::warn("Skipping " + std::to_string(skipped.size()) + " task(s) that depend on [" +
+                                dag.task(failed).id + "]: " + names);
+        }
+
+        /**
+         * @brief Sends a task to a persistent worker and reports its reply.
+         *
+         * The reply's output is written into a pipe drained by the output
+         * collector, so it is prefixed, logged and kept for failure reports
+         * like the output of a spawned command. A worker serves many tasks,
+         * so no resource usage is recorded in the task history.
+         *
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task to run.
+         * @param have_key Whether the task's cache key was computed.
+         * @param key The task's cache key.
+         * @return How the task ended.
+         */
+        TaskResult run_on_worker(RunContext& context, core::TaskIndex slot, core::TaskIndex index, bool have_key,
+                                 std::uint64_t key) {
+            const core::Task& task = context.dag.task(index);
+            if (context.trace != nullptr) {
+                context.trace->spawned(slot);
+            }
+            WorkerReply reply = context.workers.run(task, std::chrono::seconds(task.timeout_seconds),
+                                                    context.options.cancel_fd);
+            if (context.trace != nullptr) {
+                context.trace->exited(slot);
+            }
+
+            int out_pipe[2] = {-1, -1};
+            int err_pipe[2] = {-1, -1};
+            open_output_pipes(out_pipe, err_pipe);
+            std::shared_ptr<TaskOutput> output;
+            if (out_pipe[0] >= 0) {
+                output = context.output.attach(task.id, out_pipe[0], err_pipe[0]);
+                utils::write_all(out_pipe[1], reply.output);
+                close(out_pipe[1]);
+                close(err_pipe[1]);
+                output->finish(OUTPUT_DRAIN_LIMIT);
+            }
+
+            if (reply.status.cancelled) {
+                utils::Logger::warn("Cancelled: [" + task.id + "]");
+                if (context.trace != nullptr) {
+                    context.trace->finished(slot, TraceRecorder::Outcome::Failed);
+                }
+                return TaskResult::Cancelled;
+            }
+
+            const bool ok = reply.success();
+            if (ok) {
+                utils::Logger::success("Success: [" + task.id + "]");
+                if (have_key && task.is_cacheable()) {
+                    context.cache.store(task.id, key);
+                }
+            } else if (!reply.error.empty()) {
+                utils::Logger::error("Failed: [" + task.id + "] (Worker error: " + reply.error + ")");
+            } else if (reply.status.timed_out) {
+                utils::Logger::error("Timeout: [" + task.id + "] exceeded " + std::to_string(task.timeout_seconds) + " seconds");
+            } else {
+                utils::Logger::error("Failed: [" + task.id + "] (" + reply.status.describe() + ")");
+            }
+            if (!ok && output) {
+                report_failure_output(task, *output);
+            }
+            return finish_task(context, slot, index, ok);
+        }
+
+        /**
+         * @brief Runs a task on a remote agent and reports how it ended.
+         *
+         * The agent streams the task's output into the same pipes a local
+         * process would write, so it is prefixed, logged and kept for failure
+         * reports as it arrives. The resource usage measured by the agent is
+         * recorded in the task history.
+         *
+         * @param context The shared run state, with a coordinator.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task to run.
+         * @param have_key Whether the task's cache key was computed.
+         * @param key The task's cache key.
+         * @return How the task ended.
+         */
+        TaskResult run_remote(RunContext& context, core::TaskIndex slot, core::TaskIndex index, bool have_key,
+                              std::uint64_t key) {
+            const core::Task& task = context.dag.task(index);
+            int out_pipe[2] = {-1, -1};
+            int err_pipe[2] = {-1, -1};
+            open_output_pipes(out_pipe, err_pipe);
+            std::shared_ptr<TaskOutput> output;
+            if (out_pipe[0] >= 0) {
+                output = context.output.attach(task.id, out_pipe[0], err_pipe[0]);
+            }
+
+            if (context.trace != nullptr) {
+                context.trace->spawned(slot);
+            }
+            remote::RemoteResult result = context.coordinator->run(task, out_pipe[1], err_pipe[1]);
+            if (context.trace != nullptr) {
+                context.trace->exited(slot);
+            }
+            for (int fd : {out_pipe[1], err_pipe[1]}) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+            if (output) {
+                output->finish(OUTPUT_DRAIN_LIMIT);
+            }
+
+            if (result.status.cancelled) {
+                utils::Logger::warn("Cancelled: [" + task.id + "]");
+                if (context.trace != nullptr) {
+                    context.trace->finished(slot, TraceRecorder::Outcome::Failed);
+                }
+                return TaskResult::Cancelled;
+            }
+
+            const bool ok = result.success();
+            if (ok) {
+                utils::Logger::success("Success: [" + task.id + "] on " + result.agent);
+                context.history.record(task.id, to_sample(result.status.usage));
+                if (have_key && task.is_cacheable()) {
+                    context.cache.store(task.id, key);
+                }
+            } else if (!result.error.empty()) {
+                utils::Logger::error("Failed: [" + task.id + "] (Remote error: " + result.error + ")");
+            } else if (result.status.timed_out) {
+                utils::Logger::error("Timeout: [" + task.id + "] exceeded " + std::to_string(task.timeout_seconds) +
+                                     " seconds on " + result.agent);
+            } else {
+                utils::Logger::error("Failed: [" + task.id + "] on " + result.agent + " (" +
+                                     result.status.describe() + ")");
+            }
+            if (!ok && output) {
+                report_failure_output(task, *output);
+            }
+            return finish_task(context, slot, index, ok);
+        }
+
+        /**
+         * @brief Records that a task started and checks whether it still has to run.
+         *
+         * If the cache is enabled, the task's key is computed first. A
+         * cacheable task whose key matches the recorded one and whose outputs
+         * exist is reported as cached without being run.
+         *
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task.
+         * @param worker The index of the worker running it, for the trace.
+         * @param have_key Receives whether the task's cache key was computed.
+         * @param key Receives the task's cache key.
+         * @param result Receives how the task ended if it does not have to run.
+         * @return True if the task has to run.
+         */
+        bool begin_task(RunContext& context, core::TaskIndex slot, core::TaskIndex index, std::size_t worker,
+                        bool& have_key, std::uint64_t& key, TaskResult& result) {
+            const core::Task& task = context.dag.task(index);
+            if (context.trace != nullptr) {
+                context.trace->started(slot, worker);
+            }
+
+            if (is_up_to_date(context, index, have_key, key)) {
+                if (context.trace != nullptr) {
+                    context.trace->finished(slot, TraceRecorder::Outcome::Cached);
+                }
+                result = TaskResult::Cached;
+                return false;
+            }
+
+            if (is_cancelled(context.options.cancel_fd)) {
+                result = TaskResult::Cancelled;
+                return false;
+            }
+            utils::Logger::info("Running: [" + task.id + "] -> " + task.command);
+            return true;
+        }
+
+        /// @brief A spawned task command and the handle of its captured output.
+        struct LocalRun {
+            Process process;
+            std::shared_ptr<TaskOutput> output;
+        };
+
+        /**
+         * @brief Spawns a task's command with stdout and stderr drained by the output collector.
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param task The task.
+         * @return The process, and its output unless the pipes could not be created.
+         */
+        LocalRun spawn_local(RunContext& context, core::TaskIndex slot, const core::Task& task) {
+            int out_pipe[2] = {-1, -1};
+            int err_pipe[2] = {-1, -1};
+            open_output_pipes(out_pipe, err_pipe);
+            if (context.trace != nullptr) {
+                context.trace->spawned(slot);
+            }
+            LocalRun run{Process::spawn(task, out_pipe[1], err_pipe[1]), nullptr};
+            for (int fd : {out_pipe[1], err_pipe[1]}) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+            if (out_pipe[0] >= 0) {
+                run.output = context.output.attach(task.id, out_pipe[0], err_pipe[0]);
+            }
+            return run;
+        }
+
+        /**
+         * @brief Reports how a spawned command ended, once its output is complete.
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task.
+         * @param status The reaped process's status.
+         * @param output The task's finished output, or null.
+         * @param have_key Whether the task's cache key was computed.
+         * @param key The task's cache key.
+         * @return How the task ended.
+         */
+        TaskResult finish_local(RunContext& context, core::TaskIndex slot, core::TaskIndex index,
+                                const ExitStatus& status, const TaskOutput* output, bool have_key, std::uint64_t key) {
+            const core::Task& task = context.dag.task(index);
+            const bool ok = status.success();
+            if (status.cancelled) {
+                utils::Logger::warn("Cancelled: [" + task.id + "]");
+                if (context.trace != nullptr) {
+                    context.trace->finished(slot, TraceRecorder::Outcome::Failed);
+                }
+                return TaskResult::Cancelled;
+            }
+
+            if (ok) {
+                utils::Logger::success("Success: [" + task.id + "]");
+                context.history.record(task.id, to_sample(status.usage));
+                if (have_key && task.is_cacheable()) {
+                    context.cache.store(task.id, key);
+                }
+            } else if (status.timed_out) {
+                utils::Logger::error("Timeout: [" + task.id + "] exceeded " + std::to_string(task.timeout_seconds) + " seconds");
+            } else {
+                utils::Logger::error("Failed: [" + task.id + "] (" + status.describe() + ")");
+            }
+            if (!ok && output != nullptr) {
+                report_failure_output(task, *output);
+            }
+            return finish_task(context, slot, index, ok);
+        }
+
+        /**
+         * @brief Runs a single task on the calling worker thread.
+         *
+         * A task that is up to date is reported as cached without being run
+         * (see `begin_task`). A task with a `worker` is sent to a persistent
+         * worker instead of being spawned, and with a coordinator any other
+         * task is sent to a remote agent.
+         *
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the task.
+         * @param index The index of the task to run.
+         * @param worker The index of the calling worker, for the trace.
+         * @return How the task ended.
+         */
+        TaskResult run_single(RunContext& context, core::TaskIndex slot, core::TaskIndex index, std::size_t worker) {
+            const core::Task& task = context.dag.task(index);
+            bool have_key = false;
+            std::uint64_t key = 0;
+            TaskResult result = TaskResult::Pending;
+            if (!begin_task(context, slot, index, worker, have_key, key, result)) {
+                return result;
+            }
+
+            if (context.options.executor) {
+                const bool ok = context.options.executor(task);
+                if (ok) {
+                    utils::Logger::success("Success: [" + task.id + "]");
+                    if (have_key && task.is_cacheable()) {
+                        context.cache.store(task.id, key);
+                    }
+                } else {
+                    utils::Logger::error("Failed: [" + task.id + "]");
+                }
+                return finish_task(context, slot, index, ok);
+            }
+            if (!task.worker.empty()) {
+                return run_on_worker(context, slot, index, have_key, key);
+            }
+            if (context.coordinator != nullptr) {
+                return run_remote(context, slot, index, have_key, key);
+            }
+
+            LocalRun run = spawn_local(context, slot, task);
+            ExitStatus status = run.process.wait_with_timeout(std::chrono::seconds(task.timeout_seconds),
+                                                              context.options.kill_grace, context.options.cancel_fd);
+            if (context.trace != nullptr) {
+                context.trace->exited(slot);
+            }
+            if (run.output) {
+                run.output->finish(OUTPUT_DRAIN_LIMIT);
+            }
+            return finish_local(context, slot, index, status, run.output.get(), have_key, key);
+        }
+
+        /**
+         * @brief Runs a fused group of tasks in one shell on the calling worker thread.
+         *
+         * Members that are up to date are skipped first. In a chain only a
+         * leading run of members can be, since a member that runs may change
+         * what the next one reads. The other commands run as one script that
+         * reports each exit code on a status pipe, and every member is then
+         * reported, cached and classified on its own. Their cache keys are
+         * computed after the script, once the files written by earlier
+         * members exist. The group's resource usage is not split between the
+         * members, so fused tasks add no task history.
+         *
+         * @param context The shared run state.
+         * @param slot The scheduling slot of the group.
+         * @param worker The index of the calling worker, for the trace.
+         * @return `Failed` if a member failed without `allow_failure`, `Cached` if no member had to run.
+         */
+        TaskResult run_fused(RunContext& context, core::TaskIndex slot, std::size_t worker) {
+            const core::Task& group = context.fusion->graph.task(slot);
+            const std::vector<core::TaskIndex>& members = context.fusion->members[slot];
+            const bool chain = context.fusion->kinds[slot] == core::FusionKind::Chain;
+            if (context.trace != nullptr) {
+                context.trace->started(slot, worker);
+            }
+
+            std::vector<core::TaskIndex> pending;
+            for (core::TaskIndex member : members) {
+                bool have_key = false;
+                std::uint64_t key = 0;
+                if ((!chain || pending.empty()) && is_up_to_date(context, member, have_key, key)) {
+                    context.results[member] = TaskResult::Cached;
+                } else {
+                    pending.push_back(member);
+                }
+            }
+            if (pending.empty()) {
+                if (context.trace != nullptr) {
+                    context.trace->finished(slot, TraceRecorder::Outcome::Cached);
+                }
+                return TaskResult::Cached;
+            }
+
+            if (is_cancelled(context.options.cancel_fd)) {
+                return TaskResult::Cancelled;
+            }
+            utils::Logger::info("Running: [" + group.id + "] -> " + std::to_string(pending.size()) + " fused tasks");
+
+            std::vector<int> codes(pending.size(), -1);
+            std::string failure = "not run";
+            bool cancelled = false;
+            std::shared_ptr<TaskOutput> output;
+            if (context.options.executor) {
+                for (std::size_t i = 0; i < pending.size(); ++i) {
+                    const core::Task& task = context.dag.task(pending[i]);
+                    codes[i] = context.options.executor(task) ? 0 : 1;
+                    if (chain && codes[i] != 0 && !task.allow_failure) {
+                        break;
+                    }
+                }
+            } else {
+                std::vector<const core::Task*> tasks;
+                for (core::TaskIndex member : pending) {
+                    tasks.push_back(&context.dag.task(member));
+                }
+                core::Task shell = group;
+                shell.command = build_fused_script(tasks, chain);
+
+                int out_pipe[2] = {-1, -1};
+                int err_pipe[2] = {-1, -1};
+                int status_pipe[2] = {-1, -1};
+                open_output_pipes(out_pipe, err_pipe);
+                if (pipe2(status_pipe, O_CLOEXEC) != 0) {
+                    status_pipe[0] = status_pipe[1] = -1;
+                }
+                if (context.trace != nullptr) {
+                    context.trace->spawned(slot);
+                }
+                Process process = Process::spawn(shell, out_pipe[1], err_pipe[1], status_pipe[1]);
+                for (int fd : {out_pipe[1], err_pipe[1], status_pipe[1]}) {
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                }
+                if (out_pipe[0] >= 0) {
+                    output = context.output.attach(group.id, out_pipe[0], err_pipe[0]);
+                }
+
+                ExitStatus status = process.wait_with_timeout(std::chrono::milliseconds(0), context.options.kill_grace,
+                                                              context.options.cancel_fd);
+                if (context.trace != nullptr) {
+                    context.trace->exited(slot);
+                }
+                if (output) {
+                    output->finish(OUTPUT_DRAIN_LIMIT);
+                }
+                if (status_pipe[0] >= 0) {
+                    codes = parse_fused_status(read_available(status_pipe[0]), pending.size());
+                    close(status_pipe[0]);
+                }
+                cancelled = status.cancelled;
+                failure = status.describe();
+            }
+
+            TaskResult result = TaskResult::Succeeded;
+            core::TaskIndex stopped_by = 0;
+            bool stopped = false;
+            std::vector<core::TaskIndex> skipped;
+            for (std::size_t i = 0; i < pending.size(); ++i) {
+                const core::TaskIndex member = pending[i];
+                const core::Task& task = context.dag.task(member);
+                if (codes[i] == 0) {
+                    utils::Logger::success("Success: [" + task.id + "]");
+                    context.results[member] = TaskResult::Succeeded;
+                    std::uint64_t key = 0;
+                    if (context.cache.is_open() && compute_task_key(context, member, key) && task.is_cacheable()) {
+                        context.cache.store(task.id, key);
+                    }
+                    continue;
+                }
+                if (codes[i] < 0 && (cancelled || stopped)) {
+                    if (stopped && context.options.keep_going) {
+                        context.results[member] = TaskResult::Skipped;
+                        skipped.push_back(member);
+                    }
+                    continue;
+                }
+                utils::Logger::error("Failed: [" + task.id + "] (" +
+                                     (codes[i] < 0 ? failure : "Exit code: " + std::to_string(codes[i])) + ")");
+                context.results[member] = classify(task, false);
+                if (context.results[member] == TaskResult::Failed) {
+                    result = TaskResult::Failed;
+                    if (chain && !stopped) {
+                        stopped = true;
+                        stopped_by = member;
+                    }
+                }
+            }
+            report_skipped(context.dag, stopped_by, skipped);
+
+            if (cancelled) {
+                utils::Logger::warn("Cancelled: [" + group.id + "]");
+                result = TaskResult::Cancelled;
+            } else if (result != TaskResult::Succeeded && output) {
+                report_failure_output(group, *output);
+            }
+            if (context.trace != nullptr) {
+                context.trace->finished(slot, result == TaskResult::Succeeded ? TraceRecorder::Outcome::Succeeded
+                                                                              : TraceRecorder::Outcome::Failed);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Runs the task or fused group of a scheduling slot and records each task's result.
+         * @param context The shared run state.
+         * @param slot The scheduling slot.
+         * @param worker The index of the calling worker, for the trace.
+         * @return How the slot ended; `Failed` if any of its tasks failed.
+         */
+        TaskResult run_task(RunContext& context, core::TaskIndex slot, std::size_t worker) {
+            if (context.fusion != nullptr && context.fusion->members[slot].size() > 1) {
+                return run_fused(context, slot, worker);
+            }
+            const core::TaskIndex index = context.fusion != nullptr ? context.fusion->members[slot].front() : slot;
+            const TaskResult result = run_single(context, slot, index, worker);
+            if (result != TaskResult::Cancelled) {
+                context.results[index] = result;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Checks whether a slot is a single task whose command `start_on_loop` can spawn.
+         *
+         * Fused groups, persistent worker tasks and runs with an executor
+         * block while they run and stay on the thread pool.
+         */
+        bool runs_on_loop(const RunContext& context, core::TaskIndex slot) {
+            if (context.options.executor || context.coordinator != nullptr) {
+                return false;
+            }
+            if (context.fusion != nullptr && context.fusion->members[slot].size() > 1) {
+                return false;
+            }
+            const core::TaskIndex index = context.fusion != nullptr ? context.fusion->members[slot].front() : slot;
+            return context.dag.task(index).worker.empty();
+        }
+
+        /**
+         * @brief Starts the task of a slot on the calling thread and lets the event loop wait for it.
+         *
+         * Does what `run_task` does for a spawned command, but returns once
+         * the process has started. The loop enforces the task's timeout and
+         * the run's cancellation; when the process has been reaped and its
+         * output is complete, the task is reported and `on_done` runs on the
+         * loop thread. A task that does not have to run is reported at once.
+         *
+         * @param context The shared run state.
+         * @param loop The event loop, run by the calling thread.
+         * @param slot The scheduling slot, for which `runs_on_loop` holds.
+         * @param worker The lane the task occupies, for the trace.
+         * @param on_done Called with how the slot ended.
+         */
+        void start_on_loop(RunContext& context, EventLoop& loop, core::TaskIndex slot, std::size_t worker,
+                           std::function<void(TaskResult)> on_done) {
+            const core::TaskIndex index = context.fusion != nullptr ? context.fusion->members[slot].front() : slot;
+            auto done = [&context, index, on_done = std::move(on_done)](TaskResult result) {
+                if (result != TaskResult::Cancelled) {
+                    context.results[index] = result;
+                }
+                on_done(result);
+            };
+
+            bool have_key = false;
+            std::uint64_t key = 0;
+            TaskResult result = TaskResult::Pending;
+            if (!begin_task(context, slot, index, worker, have_key, key, result)) {
+                done(result);
+                return;
+            }
+
+            const core::Task& task = context.dag.task(index);
+            LocalRun run = spawn_local(context, slot, task);
+            std::shared_ptr<TaskOutput> output = std::move(run.output);
+            auto on_exit = [&context, &loop, slot, index, output, have_key, key, done](ExitStatus status) {
+                if (context.trace != nullptr) {
+                    context.trace->exited(slot);
+                }
+                auto report = [&context, slot, index, output, have_key, key, done, status]() {
+                    done(finish_local(context, slot, index, status, output.get(), have_key, key));
+                };
+                if (output) {
+                    // The output may complete on the collector thread, so the report is posted back.
+                    output->finish_async(OUTPUT_DRAIN_LIMIT, [&loop, report]() { loop.post(report); });
+                } else {
+                    report();
+                }
+            };
+            loop.watch(std::move(run.process), std::chrono::seconds(task.timeout_seconds), std::move(on_exit));
+        }
+
+    } // namespace
+
+    /**
+     * @brief Makes two passes: the known estimates first, then the fallback for the rest.
+     */
+    std::vector<double> estimate_weights(const core::Dag& dag, const history::History& history) {
+        std::vector<double> weights(dag.size(), 0.0);
+        double known_total = 0.0;
+        std::size_t known_count = 0;
+        for (core::TaskIndex i = 0; i < dag.size(); ++i) {
+            const core::Task& task = dag.task(i);
+            if (task.cost > 0.0) {
+                weights[i] = task.cost;
+            } else if (const history::TaskRecord* record = history.find(task.id)) {
+                weights[i] = record->duration_seconds;
+            } else {
+                continue;
+            }
+            known_total += weights[i];
+            ++known_count;
+        }
+
+        const double fallback = known_count > 0 ? known_total / static_cast<double>(known_count) : 1.0;
+        for (core::TaskIndex i = 0; i < dag.size(); ++i) {
+            const core::Task& task = dag.task(i);
+            if (task.cost <= 0.0 && history.find(task.id) == nullptr) {
+                weights[i] = fallback;
+            }
+        }
+        return weights;
+    }
+
     /**
      * @brief Constructs a Runner.
      * @param dag The task graph to execute.
      * @param dry_run Whether to simulate or execute.
      */
-    Runner::Runner(const core::Dag& dag, bool dry_run) : dag_(dag), dry_run_(dry_run) {}
+    Runner::Runner(const core::Dag& dag, bool dry_run) : dag_(dag), options_(make_options(dry_run)) {}
+
+    /**
+     * @brief Constructs a Runner with explicit options.
+     * @param dag The task graph to execute.
+     * @param options The execution options.
+     */
+    Runner::Runner(const core::Dag& dag, const RunnerOptions& options) : dag_(dag), options_(options) {}
 
     /**
      * @brief Performs a simulated run, printing the execution plan.
@@ -43,163 +905,440 @@ namespace dagra::execution {
     /**
      * @brief Executes all tasks in the DAG.
      *
-     * This method orchestrates the execution. If `dry_run_` is true, it will
+     * This method orchestrates the execution. If `dry_run` is set, it will
      * print the intended execution order without running commands. Otherwise, it
-     * launches tasks in separate threads as soon as their dependencies are met.
-     * The main loop waits on a condition variable and dispatches new tasks as
-     * others complete.
+     * submits tasks to a pool of at most `jobs` worker threads as soon as their
+     * dependencies are met.
+     * Each finished task is handed back to the main loop through a completion
+     * queue; the Scheduler then releases exactly the dependents it unblocks, so
+     * a slow task never holds back unrelated work.
+     * A ready task is only dispatched once the resources it declares fit
+     * into the remaining pool capacity; smaller tasks are backfilled around
+     * one that does not fit yet.
+     * By default the first failure stops dispatching. With `keep_going`, a
+     * failure only skips the failed task's transitive dependents. A task with
+     * `allow_failure` counts as completed either way. The run ends with a
+     * summary of succeeded, failed and skipped tasks.
+     * With `fuse`, the scheduler works on the graph of fused groups, and
+     * each group is one job; results are still recorded per task. Tasks with
+     * a `worker` share persistent worker processes for the length of the run.
+     * With a `journal_path`, every completed task, including one that failed
+     * with `allow_failure`, is appended to the run journal, and with `resume` the tasks it records are marked completed
+     * before the first dispatch.
      *
      * @throw std::runtime_error If a task fails, a deadlock is detected, or the
      *      execution is halted for any other reason.
      */
     void Runner::execute_all() {
-        const auto& all_tasks = dag_.get_all_tasks();
-        const size_t total_tasks = all_tasks.size();
+        history::History history;
+        if (!options_.history_path.empty()) {
+            history.load(options_.history_path);
+        }
+        std::vector<double> weights = estimate_weights(dag_, history);
+        std::unique_ptr<core::FusedGraph> fusion;
+        if (options_.fuse && options_.listen_address.empty()) {
+            fusion = std::make_unique<core::FusedGraph>(core::fuse_tasks(dag_, options_.fusion));
+            std::vector<double> group_weights(fusion->members.size(), 0.0);
+            for (std::size_t i = 0; i < group_weights.size(); ++i) {
+                for (core::TaskIndex member : fusion->members[i]) {
+                    group_weights[i] += weights[member];
+                }
+            }
+            weights = std::move(group_weights);
+            utils::Logger::info("Task fusion: " + std::to_string(dag_.size()) + " tasks run as " +
+                                std::to_string(fusion->members.size()) + " invocations.");
+        }
+        const core::Dag& graph = fusion ? fusion->graph : dag_;
+        Scheduler scheduler(graph, std::move(weights));
+        const size_t total_tasks = dag_.size();
+        const size_t total_slots = scheduler.size();
+
+        std::map<std::string, double> capacity = machine_capacity();
+        for (const auto& [name, amount] : options_.resource_pools) {
+            capacity[name] = amount;
+        }
+        scheduler.set_capacity(capacity);
 
         if (total_tasks == 0) {
             utils::Logger::info("No tasks to execute.");
             return;
         }
 
-        if (dry_run_) {
-            utils::Logger::dry_run("Starting dry run. Tasks will be listed in a possible execution order.");
-            std::unordered_set<std::string> completed_dry;
+        // A slot is resumed only if all its members and all its dependencies are, so nothing
+        // that completes later can release it again.
+        cache::RunJournal journal;
+        std::vector<std::uint64_t> journal_keys;
+        std::vector<std::uint8_t> resumed(total_slots, 0);
+        if (!options_.journal_path.empty()) {
+            journal_keys = cache::compute_journal_keys(dag_);
+        }
+        if (!journal_keys.empty() && options_.resume) {
+            journal.load(options_.journal_path);
+            std::size_t resumed_tasks = 0;
+            for (core::TaskIndex slot : graph.topological_order()) {
+                bool done = true;
+                for (core::TaskIndex member : slot_members(fusion.get(), slot)) {
+                    done = done && journal.contains(dag_.task(member).id, journal_keys[member]);
+                }
+                for (core::TaskIndex dep : graph.dependencies(slot)) {
+                    done = done && resumed[dep];
+                }
+                if (done) {
+                    resumed[slot] = 1;
+                    resumed_tasks += slot_members(fusion.get(), slot).size();
+                }
+            }
+            scheduler.mark_resumed(resumed);
+            utils::Logger::info("Resuming: " + std::to_string(resumed_tasks) + " of " + std::to_string(total_tasks) +
+                                " tasks were completed by an earlier run.");
+        }
 
-            while (completed_dry.size() < total_tasks) {
-                std::vector<core::Task> ready_tasks;
-                for (const auto& [id, task] : all_tasks) {
-                    if (completed_dry.count(id)) {
-                        continue;
-                    }
+        if (options_.dry_run) {
+            utils::Logger::dry_run("Starting dry run. Tasks will be listed in a possible execution order.");
 
-                    bool dependencies_met = true;
-                    for (const auto& dep : task.dependencies) {
-                        if (completed_dry.find(dep) == completed_dry.end()) {
-                            dependencies_met = false;
-                            break;
-                        }
-                    }
+            while (scheduler.has_ready()) {
+                size_t index = scheduler.pop_ready();
+                const auto& task = scheduler.task(index);
 
-                    if (dependencies_met) {
-                        ready_tasks.push_back(task);
-                    }
+                std::string info = "Execute Task '" + task.id + "' (Command: " + task.command + ")";
+                if (task.timeout_seconds > 0) {
+                    info += " [Timeout: " + std::to_string(task.timeout_seconds) + "s]";
                 }
-
-                if (ready_tasks.empty()) {
-                    if (completed_dry.size() < total_tasks) {
-                        utils::Logger::error("Deadlock detected in dry run. The following tasks form a cycle or have missing dependencies:");
-                        for (const auto& [id, task] : all_tasks) {
-                            if(completed_dry.find(id) == completed_dry.end()) {
-                                utils::Logger::error(" - Task: " + id);
-                            }
-                        }
-                    }
-                    break;
+                if (!task.env_vars.empty()) {
+                    info += " [Env vars: " + std::to_string(task.env_vars.size()) + "]";
+                }
+                if (!task.worker.empty()) {
+                    info += " [Worker: " + task.worker + "]";
                 }
+                utils::Logger::dry_run(info);
+                scheduler.mark_completed(index);
+            }
 
-                for (const auto& task : ready_tasks) {
-                    std::string info = "Execute Task '" + task.id + "' (Command: " + task.command + ")";
-                    if (task.timeout_seconds > 0) {
-                        info += " [Timeout: " + std::to_string(task.timeout_seconds) + "s]";
-                    }
-                    if (!task.env_vars.empty()) {
-                        info += " [Env vars: " + std::to_string(task.env_vars.size()) + "]";
+            if (!scheduler.finished()) {
+                utils::Logger::error("Deadlock detected in dry run. The following tasks form a cycle or have missing dependencies:");
+                for (size_t i = 0; i < total_slots; ++i) {
+                    if (!scheduler.is_completed(i)) {
+                        utils::Logger::error(" - Task: " + scheduler.task(i).id);
                     }
-                    utils::Logger::dry_run(info);
-                    completed_dry.insert(task.id);
                 }
             }
             utils::Logger::dry_run("Dry run finished.");
             return;
         }
 
+        // Declared before the collector and the pool, whose callbacks post to it.
+        std::unique_ptr<EventLoop> loop;
+        std::size_t jobs = options_.jobs > 0 ? options_.jobs : ThreadPool::default_concurrency();
+        if (options_.event_loop && options_.listen_address.empty()) {
+            loop = std::make_unique<EventLoop>(options_.kill_grace, options_.cancel_fd);
+            const std::size_t descriptors = raise_descriptor_limit();
+            const std::size_t fitting = descriptors > RESERVED_DESCRIPTORS
+                                            ? (descriptors - RESERVED_DESCRIPTORS) / DESCRIPTORS_PER_TASK
+                                            : 1;
+            if (jobs > fitting) {
+                utils::Logger::warn("Limiting the event loop to " + std::to_string(fitting) +
+                                    " parallel jobs: only " + std::to_string(descriptors) +
+                                    " file descriptors may be open.");
+                jobs = fitting;
+            }
+        }
+
+        OutputOptions output_options;
+        output_options.log_dir = options_.log_dir;
+        output_options.tail_bytes = options_.output_tail_bytes;
+        OutputCollector output(output_options);
+
+        WorkerOptions worker_options;
+        worker_options.max_requests = options_.worker_max_requests;
+        worker_options.kill_grace = options_.kill_grace;
+        WorkerPool workers(worker_options);
+
+        std::unique_ptr<remote::Coordinator> coordinator;
+        if (!options_.listen_address.empty()) {
+            remote::CoordinatorOptions coordinator_options;
+            coordinator_options.address = options_.listen_address;
+            coordinator_options.kill_grace = options_.kill_grace;
+            coordinator_options.cancel_fd = options_.cancel_fd;
+            coordinator = std::make_unique<remote::Coordinator>(coordinator_options);
+            utils::Logger::info("Waiting for dagra-worker agents on " + coordinator->address() + ".");
+        }
+
+        std::unique_ptr<TraceRecorder> trace;
+        if (!options_.trace_path.empty()) {
+            trace = std::make_unique<TraceRecorder>(graph);
+            for (core::TaskIndex i = 0; i < total_slots; ++i) {
+                if (graph.dependencies(i).begin() == graph.dependencies(i).end()) {
+                    trace->ready(i);
+                }
+            }
+        }
+
+        RunContext context{dag_,
+                           options_,
+                           {},
+                           history,
+                           output,
+                           workers,
+                           coordinator.get(),
+                           trace.get(),
+                           fusion.get(),
+                           std::vector<std::uint64_t>(total_tasks, 0),
+                           std::vector<std::uint8_t>(total_tasks, 0),
+                           std::vector<TaskResult>(total_tasks, TaskResult::Pending)};
+        if (!options_.cache_path.empty()) {
+            context.cache.open(options_.cache_path);
+        }
+        for (core::TaskIndex slot = 0; slot < total_slots; ++slot) {
+            if (resumed[slot]) {
+                for (core::TaskIndex member : slot_members(fusion.get(), slot)) {
+                    context.results[member] = TaskResult::Resumed;
+                }
+            }
+        }
+        bool journaling = !journal_keys.empty();
+        if (journaling) {
+            try {
+                journal.open(options_.journal_path);
+            } catch (const std::exception& e) {
+                utils::Logger::warn(std::string("Running without a journal: ") + e.what());
+                journaling = false;
+            }
+        }
+
         std::mutex mtx;
         std::condition_variable cv;
-        std::unordered_set<std::string> completed;
-        std::unordered_set<std::string> running;
-        std::atomic<bool> has_error = false;
-
-        while (completed.size() < total_tasks && !has_error) {
-            std::vector<core::Task> ready_to_start;
-            
-            {
-                std::unique_lock<std::mutex> lock(mtx);
-                for (const auto& [id, task] : all_tasks) {
-                    if (completed.count(id) || running.count(id)) {
-                        continue;
-                    }
+        std::deque<std::pair<size_t, TaskResult>> finished;
+        size_t running = 0;
+        bool has_error = false;
+        bool cancelled = false;
 
-                    bool can_run = true;
-                    for (const auto& dep : task.dependencies) {
-                        if (completed.find(dep) == completed.end()) {
-                            can_run = false;
-                            break;
-                        }
-                    }
+        // With the event loop, `finished` is only touched on this thread; pool jobs post their results.
+        auto report = [&](size_t index, TaskResult result) {
+            if (loop) {
+                loop->post([&finished, index, result]() { finished.emplace_back(index, result); });
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            finished.emplace_back(index, result);
+            cv.notify_one();
+        };
 
-                    if (can_run) {
-                        ready_to_start.push_back(task);
-                        running.insert(id);
-                    }
+        // The event loop bounds running tasks itself and hands each a lane, the trace's worker track.
+        // The pool then only runs the slots that block, so it needs no more threads than cores.
+        // Without the loop, a slot is submitted only when a pool worker is free to start it, so the
+        // priority heap rather than the pool's FIFO deques picks every next slot, and no slot holds
+        // its resources while it waits for a thread.
+        std::vector<std::size_t> idle_lanes;
+        std::vector<std::size_t> lanes;
+        if (loop) {
+            for (std::size_t lane = jobs; lane > 0; --lane) {
+                idle_lanes.push_back(lane - 1);
+            }
+            lanes.resize(total_slots, 0);
+        }
+
+        // Declared last so that it is joined before the state its jobs refer to is destroyed.
+        ThreadPool pool(loop ? std::min(jobs, ThreadPool::default_concurrency())
+                             : (coordinator && options_.jobs == 0 ? REMOTE_JOBS : options_.jobs));
+        utils::Logger::info("Executing " + std::to_string(total_tasks) + " tasks with up to " +
+                            std::to_string(loop ? jobs : pool.size()) + " parallel jobs" +
+                            (loop ? " on an event loop." : "."));
+
+        while (!scheduler.finished()) {
+            if (!cancelled && is_cancelled(options_.cancel_fd)) {
+                utils::Logger::warn("Run cancelled; waiting for running tasks to stop.");
+                cancelled = true;
+            }
+            size_t index = 0;
+            while (!has_error && !cancelled && (loop ? !idle_lanes.empty() : running < pool.size()) &&
+                   scheduler.pop_admissible(index)) {
+                ++running;
+                const auto slot = static_cast<core::TaskIndex>(index);
+                if (trace) {
+                    trace->dispatched(slot);
                 }
 
-                if (ready_to_start.empty() && running.empty() && completed.size() < total_tasks) {
+                if (!loop) {
+                    pool.submit([&, index, slot]() { report(index, run_task(context, slot, ThreadPool::current_worker())); });
+                    continue;
+                }
+                const std::size_t lane = idle_lanes.back();
+                idle_lanes.pop_back();
+                lanes[slot] = lane;
+                if (runs_on_loop(context, slot)) {
+                    start_on_loop(context, *loop, slot, lane,
+                                  [&finished, index](TaskResult result) { finished.emplace_back(index, result); });
+                } else {
+                    pool.submit([&, index, slot, lane]() { report(index, run_task(context, slot, lane)); });
+                }
+            }
+
+            if (running == 0) {
+                if (!has_error && !cancelled) {
                     utils::Logger::error("Deadlock detected! No tasks can be started.");
                     has_error = true;
-                    break;
                 }
+                break;
+            }
+
+            std::deque<std::pair<size_t, TaskResult>> batch;
+            if (loop) {
+                while (finished.empty()) {
+                    loop->run_once();
+                }
+                batch.swap(finished);
+            } else {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]() { return !finished.empty(); });
+                batch.swap(finished);
             }
 
-            for (const auto& task : ready_to_start) {
-                std::thread([&, task]() {
-                    utils::Logger::info("Running: [" + task.id + "] -> " + task.command);
-                    
-                    // Build command with environment variables if present
-                    std::string full_command = task.command;
-                    if (!task.env_vars.empty()) {
-                        full_command = "export ";
-                        for (const auto& env : task.env_vars) {
-                            full_command += env + " ";
+            for (const auto& [index, result] : batch) {
+                --running;
+                const auto slot = static_cast<core::TaskIndex>(index);
+                if (loop) {
+                    idle_lanes.push_back(lanes[slot]);
+                }
+                if (journaling) {
+                    for (core::TaskIndex member : slot_members(fusion.get(), slot)) {
+                        const TaskResult member_result = context.results[member];
+                        if (member_result == TaskResult::Succeeded || member_result == TaskResult::Cached ||
+                            member_result == TaskResult::FailedAllowed) {
+                            journal.append(dag_.task(member).id, journal_keys[member]);
                         }
-                        full_command += "&& " + task.command;
-                    }
-                    
-                    // Apply timeout if specified
-                    if (task.timeout_seconds > 0) {
-                        full_command = "timeout " + std::to_string(task.timeout_seconds) + " " + full_command;
                     }
-                    
-                    int result = std::system(full_command.c_str());
-
-                    std::lock_guard<std::mutex> lock(mtx);
-                    running.erase(task.id);
-
-                    if (result == 0) {
-                        completed.insert(task.id);
-                        utils::Logger::success("Success: [" + task.id + "]");
-                    } else if (result == 124 * 256) {
-                        // Timeout exit code (124 from timeout command)
-                        utils::Logger::error("Timeout: [" + task.id + "] exceeded " + std::to_string(task.timeout_seconds) + " seconds");
-                        has_error = true;
+                }
+                if (result == TaskResult::Cancelled) {
+                    cancelled = true;
+                    continue;
+                }
+                if (result == TaskResult::Failed) {
+                    if (options_.keep_going) {
+                        core::TaskIndex culprit = *slot_members(fusion.get(), slot).begin();
+                        for (core::TaskIndex member : slot_members(fusion.get(), slot)) {
+                            if (context.results[member] == TaskResult::Failed) {
+                                culprit = member;
+                                break;
+                            }
+                        }
+                        std::vector<core::TaskIndex> abandoned;
+                        for (core::TaskIndex dependent : scheduler.mark_failed(index)) {
+                            for (core::TaskIndex member : slot_members(fusion.get(), dependent)) {
+                                context.results[member] = TaskResult::Skipped;
+                                abandoned.push_back(member);
+                            }
+                        }
+                        report_skipped(dag_, culprit, abandoned);
                     } else {
-                        utils::Logger::error("Failed: [" + task.id + "] (Exit code: " + std::to_string(result) + ")");
                         has_error = true;
                     }
-                    
-                    cv.notify_one();
-                }).detach();
+                    continue;
+                }
+
+                scheduler.mark_completed(index);
+                if (trace) {
+                    trace_released(graph, scheduler, *trace, slot);
+                }
+            }
+        }
+
+        if (journaling) {
+            try {
+                journal.close();
+            } catch (const std::exception& e) {
+                utils::Logger::warn(e.what());
+            }
+        }
+
+        if (context.cache.is_open()) {
+            try {
+                context.cache.save();
+            } catch (const std::exception& e) {
+                utils::Logger::warn(std::string("Could not update the execution cache: ") + e.what());
             }
+        }
 
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [&]() {
-                // Wait if there is no error, and there are still tasks running or no tasks are ready to be processed yet.
-                return has_error.load() || (running.empty() && completed.size() < total_tasks) || completed.size() == total_tasks;
-            });
+        try {
+            context.history.save();
+        } catch (const std::exception& e) {
+            utils::Logger::warn(std::string("Could not update the task history: ") + e.what());
+        }
+
+        if (trace) {
+            try {
+                trace->write(options_.trace_path);
+                utils::Logger::info("Wrote execution trace to " + options_.trace_path);
+            } catch (const std::exception& e) {
+                utils::Logger::warn(std::string("Could not write the execution trace: ") + e.what());
+            }
         }
 
+        std::size_t succeeded = 0;
+        std::size_t cached = 0;
+        std::size_t resumed_count = 0;
+        std::size_t allowed_failures = 0;
+        std::size_t skipped = 0;
+        std::vector<core::TaskIndex> failed;
+        for (core::TaskIndex i = 0; i < total_tasks; ++i) {
+            switch (context.results[i]) {
+            case TaskResult::Succeeded:
+                ++succeeded;
+                break;
+            case TaskResult::Cached:
+                ++cached;
+                break;
+            case TaskResult::Resumed:
+                ++resumed_count;
+                break;
+            case TaskResult::FailedAllowed:
+                ++allowed_failures;
+                break;
+            case TaskResult::Failed:
+                failed.push_back(i);
+                break;
+            case TaskResult::Skipped:
+                ++skipped;
+                break;
+            default:
+                break;
+            }
+        }
+
+        std::string summary = "Summary: " + std::to_string(succeeded) + " succeeded";
+        if (cached > 0) {
+            summary += ", " + std::to_string(cached) + " cached";
+        }
+        if (resumed_count > 0) {
+            summary += ", " + std::to_string(resumed_count) + " resumed";
+        }
+        summary += ", " + std::to_string(failed.size()) + " failed";
+        if (allowed_failures > 0) {
+            summary += ", " + std::to_string(allowed_failures) + " failed (allowed)";
+        }
+        summary += ", " + std::to_string(skipped) + " skipped";
+        const std::size_t not_run = total_tasks - succeeded - cached - resumed_count - failed.size() - allowed_failures - skipped;
+        if (not_run > 0) {
+            summary += ", " + std::to_string(not_run) + " not run";
+        }
+        utils::Logger::info(summary + ".");
+        if (!failed.empty()) {
+            std::string names;
+            for (core::TaskIndex index : failed) {
+                names += (names.empty() ? "" : ", ") + dag_.task(index).id;
+            }
+            utils::Logger::error("Failed tasks: " + names);
+        }
+
+        if (cancelled) {
+            throw std::runtime_error("Execution cancelled.");
+        }
         if (has_error) {
             throw std::runtime_error("Execution halted due to task failure or deadlock.");
         }
+        if (!failed.empty()) {
+            throw std::runtime_error(std::to_string(failed.size()) + " task(s) failed; " + std::to_string(skipped) +
+                                     " dependent task(s) were skipped.");
+        }
     }
 
 } // namespace dagra::execution
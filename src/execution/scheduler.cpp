@@ -0,0 +1,352 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implements the dependency-tracking ready queue.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the Scheduler class. Counters are
+ * initialised once from the DAG's CSR edges; afterwards every completion only
+ * touches the completed task's direct dependents. Resource demands are kept
+ * in a CSR array of (pool, amount) pairs so admission never looks at names.
+ */
+
+#include "dagra/execution/scheduler.hpp"
+#include "dagra/core/task.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Slack allowed when comparing demands against free capacity, absorbing rounding in releases.
+        constexpr double CAPACITY_EPSILON = 1e-9;
+
+        /// @brief Formats an amount without trailing zeros.
+        std::string format_amount(double amount) {
+            std::ostringstream out;
+            out << amount;
+            return out.str();
+        }
+
+    } // namespace
+
+    std::map<std::string, double> machine_capacity() {
+        std::map<std::string, double> capacity;
+        const unsigned cpus = std::thread::hardware_concurrency();
+        capacity[core::RESOURCE_CPU] = cpus > 0 ? static_cast<double>(cpus) : 1.0;
+        const long pages = sysconf(_SC_PHYS_PAGES);
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && page_size > 0) {
+            capacity[core::RESOURCE_MEMORY_MB] = static_cast<double>(pages) * static_cast<double>(page_size) /
+                                                 (1024.0 * 1024.0);
+        }
+        return capacity;
+    }
+
+    /**
+     * @brief Computes priorities, counts each task's dependencies and seeds the ready queue.
+     *
+     * Bottom levels are computed in one O(V+E) sweep over the reverse
+     * topological order. Tasks on a cycle are not in that order and keep
+     * their own weight; they never become ready anyway.
+     *
+     * Dependencies that do not name a known task are still counted, so such
+     * tasks never become ready and the Runner reports them as a deadlock.
+     *
+     * @param dag The graph to schedule.
+     * @param weights The estimated cost of each task, or empty for unit weights.
+     */
+    Scheduler::Scheduler(const core::Dag& dag, const std::vector<double>& weights) : dag_(dag) {
+        const std::size_t count = dag_.size();
+        remaining_.assign(count, 0);
+        completed_.assign(count, false);
+        abandoned_.assign(count, false);
+        ready_.reserve(count);
+
+        if (weights.size() == count) {
+            priority_ = weights;
+        } else {
+            priority_.assign(count, 1.0);
+        }
+        const std::vector<core::TaskIndex> order = dag_.topological_order();
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            double heaviest = 0.0;
+            for (core::TaskIndex dependent : dag_.dependents(*it)) {
+                heaviest = std::max(heaviest, priority_[dependent]);
+            }
+            priority_[*it] += heaviest;
+        }
+
+        for (const auto& missing : dag_.missing_dependencies()) {
+            ++remaining_[missing.task];
+        }
+        for (core::TaskIndex i = 0; i < count; ++i) {
+            remaining_[i] += static_cast<std::uint32_t>(dag_.dependencies(i).size());
+            if (remaining_[i] == 0) {
+                push_ready(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Resolves every task's resource names to pool indices and checks them against the capacities.
+     * @param capacity The capacity of each pool by name.
+     */
+    void Scheduler::set_capacity(const std::map<std::string, double>& capacity) {
+        std::map<std::string, std::uint32_t> pool_ids;
+        capacity_.clear();
+        for (const auto& [name, amount] : capacity) {
+            pool_ids.emplace(name, static_cast<std::uint32_t>(capacity_.size()));
+            capacity_.push_back(amount);
+        }
+        free_ = capacity_;
+
+        const std::size_t count = dag_.size();
+        demand_offsets_.assign(count + 1, 0);
+        demands_.clear();
+        for (core::TaskIndex i = 0; i < count; ++i) {
+            const core::Task& task = dag_.task(i);
+            for (const auto& [name, amount] : task.resources) {
+                if (amount <= 0.0) {
+                    continue;
+                }
+                auto pool = pool_ids.find(name);
+                if (pool == pool_ids.end()) {
+                    throw std::runtime_error("Task '" + task.id + "' requests resource '" + name +
+                                             "', but no pool named '" + name + "' is declared.");
+                }
+                if (amount > capacity_[pool->second] + CAPACITY_EPSILON) {
+                    throw std::runtime_error("Task '" + task.id + "' requests " + format_amount(amount) + " of '" +
+                                             name + "', but the pool only holds " +
+                                             format_amount(capacity_[pool->second]) + ".");
+                }
+                demands_.push_back({pool->second, amount});
+            }
+            demand_offsets_[i + 1] = static_cast<std::uint32_t>(demands_.size());
+        }
+        holding_.assign(count, false);
+        holding_count_ = 0;
+        bypasses_ = 0;
+    }
+
+    bool Scheduler::has_ready() const {
+        return !ready_.empty();
+    }
+
+    std::size_t Scheduler::pop_ready() {
+        auto lower = [this](core::TaskIndex a, core::TaskIndex b) { return lower_priority(a, b); };
+        std::pop_heap(ready_.begin(), ready_.end(), lower);
+        core::TaskIndex index = ready_.back();
+        ready_.pop_back();
+        return index;
+    }
+
+    /**
+     * @brief Takes the heap top if it fits, and otherwise backfills the best ready task that does.
+     *
+     * A backfill scans the whole ready heap, so it costs O(ready) and is
+     * only paid while the head is blocked.
+     *
+     * @param index Receives the index of the task to dispatch.
+     * @return False if the ready queue is empty or nothing fits.
+     */
+    bool Scheduler::pop_admissible(std::size_t& index) {
+        if (ready_.empty()) {
+            return false;
+        }
+        if (demands_.empty()) {
+            index = pop_ready();
+            return true;
+        }
+
+        const core::TaskIndex head = ready_.front();
+        if (fits(head)) {
+            index = pop_ready();
+            acquire(head);
+            if (head == blocked_head_) {
+                bypasses_ = 0;
+            }
+            return true;
+        }
+        if (head != blocked_head_) {
+            blocked_head_ = head;
+            bypasses_ = 0;
+        }
+        if (bypasses_ >= MAX_BACKFILL_BYPASSES) {
+            return false;
+        }
+
+        std::size_t best = ready_.size();
+        for (std::size_t slot = 1; slot < ready_.size(); ++slot) {
+            if (fits(ready_[slot]) && (best == ready_.size() || lower_priority(ready_[best], ready_[slot]))) {
+                best = slot;
+            }
+        }
+        if (best == ready_.size()) {
+            return false;
+        }
+
+        const core::TaskIndex chosen = ready_[best];
+        ready_[best] = ready_.back();
+        ready_.pop_back();
+        std::make_heap(ready_.begin(), ready_.end(),
+                       [this](core::TaskIndex a, core::TaskIndex b) { return lower_priority(a, b); });
+        ++bypasses_;
+        acquire(chosen);
+        index = chosen;
+        return true;
+    }
+
+    /**
+     * @brief Marks a task as completed, returns its resources and queues any dependents it unblocks.
+     * @param index The index of the completed task.
+     */
+    void Scheduler::mark_completed(std::size_t index) {
+        if (completed_[index]) {
+            return;
+        }
+        release(index);
+        completed_[index] = true;
+        ++completed_count_;
+
+        for (core::TaskIndex dependent : dag_.dependents(static_cast<core::TaskIndex>(index))) {
+            if (--remaining_[dependent] == 0) {
+                push_ready(dependent);
+            }
+        }
+    }
+
+    /**
+     * @brief Marks already completed tasks and rebuilds the ready heap from the remaining ones.
+     * @param done Per-task flag, true for tasks that need not run.
+     */
+    void Scheduler::mark_resumed(const std::vector<std::uint8_t>& done) {
+        for (core::TaskIndex i = 0; i < done.size() && i < completed_.size(); ++i) {
+            if (!done[i] || completed_[i]) {
+                continue;
+            }
+            completed_[i] = true;
+            ++completed_count_;
+            for (core::TaskIndex dependent : dag_.dependents(i)) {
+                --remaining_[dependent];
+            }
+        }
+
+        ready_.clear();
+        for (core::TaskIndex i = 0; i < completed_.size(); ++i) {
+            if (!completed_[i] && !abandoned_[i] && remaining_[i] == 0) {
+                ready_.push_back(i);
+            }
+        }
+        std::make_heap(ready_.begin(), ready_.end(),
+                       [this](core::TaskIndex a, core::TaskIndex b) { return lower_priority(a, b); });
+    }
+
+    /**
+     * @brief Marks a failed task and, breadth-first, all of its transitive dependents as abandoned.
+     * @param index The index of the failed task.
+     * @return The dependents that were skipped by this call.
+     */
+    std::vector<core::TaskIndex> Scheduler::mark_failed(std::size_t index) {
+        std::vector<core::TaskIndex> skipped;
+        if (completed_[index] || abandoned_[index]) {
+            return skipped;
+        }
+        release(index);
+        abandoned_[index] = true;
+        ++abandoned_count_;
+
+        // The skipped vector doubles as the work queue.
+        std::size_t head = 0;
+        core::TaskIndex current = static_cast<core::TaskIndex>(index);
+        while (true) {
+            for (core::TaskIndex dependent : dag_.dependents(current)) {
+                if (!abandoned_[dependent]) {
+                    abandoned_[dependent] = true;
+                    ++abandoned_count_;
+                    skipped.push_back(dependent);
+                }
+            }
+            if (head == skipped.size()) {
+                break;
+            }
+            current = skipped[head++];
+        }
+        return skipped;
+    }
+
+    const core::Task& Scheduler::task(std::size_t index) const {
+        return dag_.task(static_cast<core::TaskIndex>(index));
+    }
+
+    bool Scheduler::is_completed(std::size_t index) const {
+        return completed_[index];
+    }
+
+    double Scheduler::priority(std::size_t index) const {
+        return priority_[index];
+    }
+
+    void Scheduler::push_ready(core::TaskIndex index) {
+        ready_.push_back(index);
+        std::push_heap(ready_.begin(), ready_.end(),
+                       [this](core::TaskIndex a, core::TaskIndex b) { return lower_priority(a, b); });
+    }
+
+    bool Scheduler::lower_priority(core::TaskIndex a, core::TaskIndex b) const {
+        if (priority_[a] != priority_[b]) {
+            return priority_[a] < priority_[b];
+        }
+        return a > b;
+    }
+
+    bool Scheduler::fits(core::TaskIndex index) const {
+        for (std::uint32_t d = demand_offsets_[index]; d < demand_offsets_[index + 1]; ++d) {
+            if (demands_[d].amount > free_[demands_[d].pool] + CAPACITY_EPSILON) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Scheduler::acquire(core::TaskIndex index) {
+        if (demand_offsets_[index] == demand_offsets_[index + 1]) {
+            return;
+        }
+        for (std::uint32_t d = demand_offsets_[index]; d < demand_offsets_[index + 1]; ++d) {
+            free_[demands_[d].pool] -= demands_[d].amount;
+        }
+        holding_[index] = true;
+        ++holding_count_;
+    }
+
+    void Scheduler::release(std::size_t index) {
+        if (holding_.empty() || !holding_[index]) {
+            return;
+        }
+        for (std::uint32_t d = demand_offsets_[index]; d < demand_offsets_[index + 1]; ++d) {
+            free_[demands_[d].pool] += demands_[d].amount;
+        }
+        holding_[index] = false;
+        // Once nothing is held, reset exactly so rounding cannot accumulate across a long run.
+        if (--holding_count_ == 0) {
+            free_ = capacity_;
+        }
+    }
+
+    std::size_t Scheduler::size() const {
+        return dag_.size();
+    }
+
+    std::size_t Scheduler::completed_count() const {
+        return completed_count_;
+    }
+
+    bool Scheduler::finished() const {
+        return completed_count_ + abandoned_count_ == dag_.size();
+    }
+
+} // namespace dagra::execution
@@ -0,0 +1,145 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implements the fixed-size, work-stealing thread pool.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the ThreadPool class. The shared
+ * mutex guards the pending-job counter that idle workers sleep on; the jobs
+ * themselves live in per-worker deques with their own locks. A job is pushed
+ * and counted under the shared mutex, and a worker claims one count before
+ * it looks for a job, so the counter never runs ahead of the deques and a
+ * woken worker always has a job to find.
+ */
+
+#include "dagra/execution/thread_pool.hpp"
+#include <utility>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief The index of the worker running on this thread.
+        thread_local std::size_t current_worker_index = ThreadPool::NOT_A_WORKER;
+
+    } // namespace
+
+    ThreadPool::ThreadPool(std::size_t threads) {
+        if (threads == 0) {
+            threads = default_concurrency();
+        }
+
+        queues_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Pushes a job onto the next worker deque in round-robin order.
+     * @param job The callable to run.
+     */
+    void ThreadPool::submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            Queue& target = *queues_[next_queue_];
+            next_queue_ = (next_queue_ + 1) % queues_.size();
+            {
+                std::lock_guard<std::mutex> queue_lock(target.mtx);
+                target.jobs.push_back(std::move(job));
+            }
+            ++pending_;
+        }
+        cv_.notify_one();
+    }
+
+    std::size_t ThreadPool::size() const {
+        return workers_.size();
+    }
+
+    std::size_t ThreadPool::default_concurrency() {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware == 0 ? 1 : hardware;
+    }
+
+    /**
+     * @brief Takes a job from the worker's own deque, or steals one from another worker.
+     * @param index The index of the calling worker.
+     * @param job Receives the job on success.
+     * @return True if a job was taken.
+     */
+    bool ThreadPool::try_take(std::size_t index, std::function<void()>& job) {
+        {
+            Queue& own = *queues_[index];
+            std::lock_guard<std::mutex> lock(own.mtx);
+            if (!own.jobs.empty()) {
+                job = std::move(own.jobs.front());
+                own.jobs.pop_front();
+                return true;
+            }
+        }
+
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            Queue& victim = *queues_[(index + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t ThreadPool::current_worker() {
+        return current_worker_index;
+    }
+
+    /**
+     * @brief The main loop of a worker thread.
+     *
+     * Sleeps until a job is pending, claims it by decrementing the counter,
+     * and then takes a job from the deques. Every claim is backed by a queued
+     * job, so the take only has to be retried when a concurrent steal moved
+     * the job past the scan. Exits once the pool is stopping and every
+     * queued job has been claimed.
+     *
+     * @param index The index of this worker.
+     */
+    void ThreadPool::worker_loop(std::size_t index) {
+        current_worker_index = index;
+        std::function<void()> job;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                cv_.wait(lock, [this]() { return pending_ > 0 || stopping_; });
+                if (pending_ == 0) {
+                    return;
+                }
+                --pending_;
+            }
+
+            while (!try_take(index, job)) {
+                std::this_thread::yield();
+            }
+            job();
+            job = nullptr;
+        }
+    }
+
+} // namespace dagra::execution
@@ -0,0 +1,146 @@
+/**
+ * @file trace.cpp
+ * @brief Implements the Chrome trace-event export of the execution timeline.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the TraceRecorder class. The
+ * recording methods only read the clock and store into a preallocated slot;
+ * all formatting happens in `write`, after the run.
+ */
+
+#include "dagra/execution/trace.hpp"
+#include "dagra/utils/json.hpp"
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Trace process ID of the worker tracks.
+        constexpr int WORKERS_PID = 1;
+
+        /// @brief Trace process ID of the scheduler's async tracks.
+        constexpr int SCHEDULER_PID = 2;
+
+        /// @brief Formats nanoseconds as the fractional microseconds Chrome traces use.
+        std::string micros(std::int64_t nanoseconds) {
+            return std::to_string(nanoseconds / 1000) + "." + std::to_string(nanoseconds % 1000 / 100);
+        }
+
+        const char* outcome_name(TraceRecorder::Outcome outcome) {
+            switch (outcome) {
+            case TraceRecorder::Outcome::Succeeded:
+                return "succeeded";
+            case TraceRecorder::Outcome::Failed:
+                return "failed";
+            case TraceRecorder::Outcome::Cached:
+                return "cached";
+            case TraceRecorder::Outcome::Pending:
+                break;
+            }
+            return "not run";
+        }
+
+    } // namespace
+
+    TraceRecorder::TraceRecorder(const core::Dag& dag) :
+        dag_(dag), origin_(std::chrono::steady_clock::now()), slots_(dag.size()) {}
+
+    std::int64_t TraceRecorder::now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_)
+            .count();
+    }
+
+    void TraceRecorder::ready(core::TaskIndex task) {
+        slots_[task].ready = now();
+    }
+
+    void TraceRecorder::dispatched(core::TaskIndex task) {
+        slots_[task].dispatched = now();
+    }
+
+    void TraceRecorder::started(core::TaskIndex task, std::size_t worker) {
+        slots_[task].started = now();
+        slots_[task].worker = static_cast<std::uint32_t>(worker);
+    }
+
+    void TraceRecorder::spawned(core::TaskIndex task) {
+        slots_[task].spawned = now();
+    }
+
+    void TraceRecorder::exited(core::TaskIndex task) {
+        slots_[task].exited = now();
+    }
+
+    void TraceRecorder::finished(core::TaskIndex task, Outcome outcome) {
+        slots_[task].finished = now();
+        slots_[task].outcome = outcome;
+    }
+
+    void TraceRecorder::write(const std::string& path) const {
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + std::to_string(WORKERS_PID) +
+               ",\"args\":{\"name\":\"dagra workers\"}},\n";
+        out += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + std::to_string(SCHEDULER_PID) +
+               ",\"args\":{\"name\":\"dagra scheduler\"}}";
+
+        std::set<std::uint32_t> workers;
+        for (core::TaskIndex i = 0; i < slots_.size(); ++i) {
+            const Slot& slot = slots_[i];
+            std::string name;
+            utils::append_json_string(name, dag_.task(i).id);
+
+            // Waiting for a free worker, then for a worker to pick the job up.
+            const std::string async_id = std::to_string(i);
+            auto async_span = [&](const char* label, std::int64_t from, std::int64_t to) {
+                if (from < 0 || to < 0) {
+                    return;
+                }
+                out += ",\n{\"ph\":\"b\",\"cat\":\"" + std::string(label) + "\",\"name\":" + name +
+                       ",\"id\":" + async_id + ",\"pid\":" + std::to_string(SCHEDULER_PID) +
+                       ",\"tid\":0,\"ts\":" + micros(from) + "}";
+                out += ",\n{\"ph\":\"e\",\"cat\":\"" + std::string(label) + "\",\"name\":" + name +
+                       ",\"id\":" + async_id + ",\"pid\":" + std::to_string(SCHEDULER_PID) +
+                       ",\"tid\":0,\"ts\":" + micros(to) + "}";
+            };
+            async_span("ready", slot.ready, slot.dispatched);
+            async_span("dispatch", slot.dispatched, slot.started);
+
+            if (slot.started < 0 || slot.finished < 0) {
+                continue;
+            }
+            workers.insert(slot.worker);
+            const std::string tid = std::to_string(slot.worker + 1);
+            out += ",\n{\"ph\":\"X\",\"cat\":\"task\",\"name\":" + name + ",\"pid\":" + std::to_string(WORKERS_PID) +
+                   ",\"tid\":" + tid + ",\"ts\":" + micros(slot.started) +
+                   ",\"dur\":" + micros(slot.finished - slot.started) + ",\"args\":{\"outcome\":\"" +
+                   outcome_name(slot.outcome) + "\"";
+            if (slot.ready >= 0 && slot.dispatched >= 0) {
+                out += ",\"ready_wait_us\":" + micros(slot.dispatched - slot.ready) +
+                       ",\"dispatch_latency_us\":" + micros(slot.started - slot.dispatched);
+            }
+            out += "}}";
+            if (slot.spawned >= 0 && slot.exited >= 0) {
+                out += ",\n{\"ph\":\"X\",\"cat\":\"process\",\"name\":\"process\",\"pid\":" +
+                       std::to_string(WORKERS_PID) + ",\"tid\":" + tid + ",\"ts\":" + micros(slot.spawned) +
+                       ",\"dur\":" + micros(slot.exited - slot.spawned) + "}";
+            }
+        }
+        for (std::uint32_t worker : workers) {
+            out += ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + std::to_string(WORKERS_PID) +
+                   ",\"tid\":" + std::to_string(worker + 1) + ",\"args\":{\"name\":\"worker " +
+                   std::to_string(worker) + "\"}}";
+        }
+        out += "\n]}\n";
+
+        std::ofstream file(path, std::ios::trunc);
+        file << out;
+        if (!file) {
+            throw std::runtime_error("Failed to write trace file '" + path + "'.");
+        }
+    }
+
+} // namespace dagra::execution
@@ -0,0 +1,327 @@
+/**
+ * @file worker_pool.cpp
+ * @brief Implements the pool of persistent worker processes.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the WorkerPool class and the
+ * worker protocol. Each worker is connected through one Unix socket pair
+ * that serves as both its stdin and its stdout, so a worker that dies is
+ * seen as end-of-file and writes to it fail with `EPIPE` instead of raising
+ * SIGPIPE. Replies are parsed with yaml-cpp, which reads JSON as YAML flow
+ * style.
+ */
+
+#include "dagra/execution/worker_pool.hpp"
+#include "dagra/utils/io.hpp"
+#include "dagra/utils/json.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+
+namespace dagra::execution {
+
+    namespace {
+
+        /// @brief Largest reply body accepted from a worker.
+        constexpr std::size_t MAX_REPLY_BYTES = 64 * 1024 * 1024;
+
+        /// @brief Longest length line accepted before the newline, in digits.
+        constexpr std::size_t MAX_LENGTH_DIGITS = 10;
+
+        /// @brief Size of the buffer each receive drains into.
+        constexpr std::size_t READ_CHUNK = 64 * 1024;
+
+        /// @brief How waiting for a reply ended.
+        enum class Outcome {
+            Ok,        ///< The bytes arrived.
+            Error,     ///< The worker exited or broke the protocol; the error message is set.
+            TimedOut,  ///< The task's deadline passed.
+            Cancelled  ///< The cancel descriptor became readable.
+        };
+
+        /// @brief Appends a JSON array of strings.
+        void append_json_list(std::string& out, const std::vector<std::string>& values) {
+            out += '[';
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) {
+                    out += ", ";
+                }
+                utils::append_json_string(out, values[i]);
+            }
+            out += ']';
+        }
+
+        /// @brief The key grouping interchangeable workers: their command line and environment.
+        std::string pool_key(const core::Task& task) {
+            std::string key = task.worker;
+            for (const auto& env : task.env_vars) {
+                key += '\0';
+                key += env;
+            }
+            return key;
+        }
+
+    } // namespace
+
+    /**
+     * @struct WorkerPool::Worker
+     * @brief One worker process and its end of the socket pair.
+     */
+    struct WorkerPool::Worker {
+        std::string key;
+        Process process;
+        int fd = -1;
+        std::size_t served = 0;
+
+        /// @brief Bytes received but not yet consumed as part of a reply.
+        std::string buffer;
+
+        ~Worker() {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        /**
+         * @brief Receives more bytes into `buffer`.
+         * @param deadline When to give up, if set.
+         * @param cancel_fd A descriptor that cancels the wait, or -1.
+         * @param error Receives the reason on `Outcome::Error`.
+         * @return How the wait ended.
+         */
+        Outcome fill(const std::optional<std::chrono::steady_clock::time_point>& deadline, int cancel_fd,
+                     std::string& error) {
+            while (true) {
+                int wait_ms = -1;
+                if (deadline) {
+                    const auto remaining =
+                        std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+                    wait_ms = static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+                }
+                pollfd fds[2] = {{fd, POLLIN, 0}, {cancel_fd, POLLIN, 0}};
+                const int rc = poll(fds, cancel_fd >= 0 ? 2 : 1, wait_ms);
+                if (rc < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    error = std::string("poll failed: ") + std::strerror(errno);
+                    return Outcome::Error;
+                }
+                if (cancel_fd >= 0 && fds[1].revents != 0) {
+                    return Outcome::Cancelled;
+                }
+                if (rc == 0) {
+                    return Outcome::TimedOut;
+                }
+
+                char chunk[READ_CHUNK];
+                const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n > 0) {
+                    buffer.append(chunk, static_cast<std::size_t>(n));
+                    return Outcome::Ok;
+                }
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                error = n == 0 ? "worker exited before replying" : std::string("read failed: ") + std::strerror(errno);
+                return Outcome::Error;
+            }
+        }
+
+        /**
+         * @brief Receives one framed reply.
+         * @param deadline When to give up, if set.
+         * @param cancel_fd A descriptor that cancels the wait, or -1.
+         * @param body Receives the reply's JSON body.
+         * @param error Receives the reason on `Outcome::Error`.
+         * @return How the wait ended.
+         */
+        Outcome read_reply(const std::optional<std::chrono::steady_clock::time_point>& deadline, int cancel_fd,
+                           std::string& body, std::string& error) {
+            std::size_t newline = 0;
+            while ((newline = buffer.find('\n')) == std::string::npos) {
+                if (buffer.size() > MAX_LENGTH_DIGITS) {
+                    error = "malformed reply length";
+                    return Outcome::Error;
+                }
+                const Outcome outcome = fill(deadline, cancel_fd, error);
+                if (outcome != Outcome::Ok) {
+                    return outcome;
+                }
+            }
+
+            std::size_t length = 0;
+            if (newline == 0 || newline > MAX_LENGTH_DIGITS) {
+                error = "malformed reply length";
+                return Outcome::Error;
+            }
+            for (std::size_t i = 0; i < newline; ++i) {
+                if (buffer[i] < '0' || buffer[i] > '9') {
+                    error = "malformed reply length";
+                    return Outcome::Error;
+                }
+                length = length * 10 + static_cast<std::size_t>(buffer[i] - '0');
+            }
+            if (length > MAX_REPLY_BYTES) {
+                error = "reply of " + std::to_string(length) + " bytes is too large";
+                return Outcome::Error;
+            }
+            buffer.erase(0, newline + 1);
+
+            while (buffer.size() < length) {
+                const Outcome outcome = fill(deadline, cancel_fd, error);
+                if (outcome != Outcome::Ok) {
+                    return outcome;
+                }
+            }
+            body = buffer.substr(0, length);
+            buffer.erase(0, length);
+            return Outcome::Ok;
+        }
+    };
+
+    std::string encode_worker_request(const core::Task& task) {
+        std::string body = "{\"id\": ";
+        utils::append_json_string(body, task.id);
+        body += ", \"command\": ";
+        utils::append_json_string(body, task.command);
+        body += ", \"inputs\": ";
+        append_json_list(body, task.inputs);
+        body += ", \"outputs\": ";
+        append_json_list(body, task.outputs);
+        body += '}';
+        return std::to_string(body.size()) + "\n" + body;
+    }
+
+    bool decode_worker_reply(const std::string& body, int& exit_code, std::string& output) {
+        try {
+            const YAML::Node reply = YAML::Load(body);
+            if (!reply.IsMap() || !reply["exit_code"] || !reply["exit_code"].IsScalar()) {
+                return false;
+            }
+            exit_code = reply["exit_code"].as<int>();
+            output = reply["output"] && reply["output"].IsScalar() ? reply["output"].as<std::string>() : "";
+            return true;
+        } catch (const YAML::Exception&) {
+            return false;
+        }
+    }
+
+    WorkerPool::WorkerPool(const WorkerOptions& options) : options_(options) {}
+
+    WorkerPool::~WorkerPool() {
+        for (auto& [key, workers] : idle_) {
+            for (auto& worker : workers) {
+                retire(std::move(worker));
+            }
+        }
+    }
+
+    /**
+     * @brief Sends a task to an idle worker of its group, starting one if none is idle.
+     *
+     * The worker is put back into the pool only if it replied with exit
+     * code 0 and has served fewer than `max_requests` requests. A worker
+     * that timed out or was cancelled has its process group terminated.
+     *
+     * @param task The task; `worker` must be set.
+     * @param timeout The maximum time to wait for the reply; zero or negative means no limit.
+     * @param cancel_fd A descriptor that becomes readable to cancel the request, or -1.
+     * @return The reply, or the reason none was received.
+     */
+    WorkerReply WorkerPool::run(const core::Task& task, std::chrono::milliseconds timeout, int cancel_fd) {
+        const std::string key = pool_key(task);
+        std::unique_ptr<Worker> worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto idle = idle_.find(key);
+            if (idle != idle_.end() && !idle->second.empty()) {
+                worker = std::move(idle->second.back());
+                idle->second.pop_back();
+            }
+        }
+
+        WorkerReply reply;
+        if (!worker) {
+            int sockets[2] = {-1, -1};
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+                reply.error = std::string("could not create worker socket: ") + std::strerror(errno);
+                return reply;
+            }
+            core::Task command;
+            command.id = task.id;
+            command.command = task.worker;
+            command.env_vars = task.env_vars;
+
+            worker = std::make_unique<Worker>();
+            worker->key = key;
+            worker->fd = sockets[0];
+            worker->process = Process::spawn(command, sockets[1], -1, -1, sockets[1]);
+            close(sockets[1]);
+            if (worker->process.pid() < 0) {
+                reply.error = "could not start worker: " + worker->process.wait().describe();
+                return reply;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++started_;
+        }
+
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        if (timeout.count() > 0) {
+            deadline = std::chrono::steady_clock::now() + timeout;
+        }
+        std::string body;
+        Outcome outcome = Outcome::Error;
+        if (!utils::send_all(worker->fd, encode_worker_request(task))) {
+            reply.error = std::string("could not send request: ") + std::strerror(errno);
+        } else {
+            outcome = worker->read_reply(deadline, cancel_fd, body, reply.error);
+        }
+        ++worker->served;
+
+        if (outcome == Outcome::TimedOut || outcome == Outcome::Cancelled) {
+            reply.status = worker->process.terminate(options_.kill_grace);
+            reply.status.timed_out = outcome == Outcome::TimedOut;
+            reply.status.cancelled = outcome == Outcome::Cancelled;
+        } else if (outcome == Outcome::Ok && !decode_worker_reply(body, reply.status.code, reply.output)) {
+            reply.error = "malformed reply: " + body.substr(0, 200);
+        }
+
+        const bool reusable = outcome == Outcome::Ok && reply.success() &&
+                              (options_.max_requests == 0 || worker->served < options_.max_requests);
+        if (reusable) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_[key].push_back(std::move(worker));
+        } else {
+            retire(std::move(worker));
+        }
+        return reply;
+    }
+
+    std::size_t WorkerPool::started() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return started_;
+    }
+
+    /**
+     * @brief Stops a worker that is no longer needed.
+     *
+     * Closing the socket tells the worker there are no more requests. A
+     * worker that has not exited after the grace period is terminated.
+     *
+     * @param worker The worker, which must not be in the idle list.
+     */
+    void WorkerPool::retire(std::unique_ptr<Worker> worker) const {
+        if (worker->fd >= 0) {
+            close(worker->fd);
+            worker->fd = -1;
+        }
+        worker->process.wait_with_timeout(options_.kill_grace, options_.kill_grace);
+    }
+
+} // namespace dagra::execution
@@ -0,0 +1,127 @@
+/**
+ * @file history.cpp
+ * @brief Implements the persistent record of past task runs.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the History class. The file is
+ * rewritten through a temporary file and a rename, so an interrupted run
+ * never leaves a truncated history behind.
+ */
+
+#include "dagra/history/history.hpp"
+#include "dagra/utils/io.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace dagra::history {
+
+    /**
+     * @brief Reads one run per line, skipping comments and lines that do not parse.
+     * @param path The history file path.
+     */
+    void History::load(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        path_ = path;
+        records_.clear();
+        dirty_ = false;
+
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::size_t tab = line.find('\t');
+            if (tab == std::string::npos || tab == 0) {
+                continue;
+            }
+            std::istringstream fields(line.substr(tab + 1));
+            RunSample sample;
+            if (fields >> sample.timestamp >> sample.wall_seconds >> sample.user_seconds >> sample.system_seconds >>
+                    sample.max_rss_kb >> sample.voluntary_switches >> sample.involuntary_switches >>
+                    sample.read_bytes >> sample.write_bytes &&
+                sample.wall_seconds >= 0.0) {
+                add_sample(records_[line.substr(0, tab)], sample);
+            }
+        }
+    }
+
+    const TaskRecord* History::find(const std::string& task_id) const {
+        auto it = records_.find(task_id);
+        return it == records_.end() ? nullptr : &it->second;
+    }
+
+    const std::unordered_map<std::string, TaskRecord>& History::records() const {
+        return records_;
+    }
+
+    void History::record(const std::string& task_id, const RunSample& sample) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        add_sample(records_[task_id], sample);
+        dirty_ = true;
+    }
+
+    void History::add_sample(TaskRecord& record, const RunSample& sample) {
+        if (record.samples.empty()) {
+            record.duration_seconds = sample.wall_seconds;
+        } else {
+            record.duration_seconds = SMOOTHING * sample.wall_seconds + (1.0 - SMOOTHING) * record.duration_seconds;
+        }
+        if (record.samples.size() == MAX_SAMPLES) {
+            record.samples.erase(record.samples.begin());
+        }
+        record.samples.push_back(sample);
+    }
+
+    /**
+     * @brief Rewrites the file with every retained run, grouped by task in ID order.
+     */
+    void History::save() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (path_.empty() || !dirty_) {
+            return;
+        }
+
+        fs::path target(path_);
+        if (target.has_parent_path()) {
+            fs::create_directories(target.parent_path());
+        }
+        const std::string temporary = utils::create_temporary(path_);
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            out << "# dagra task history: id, timestamp, wall (s), user (s), sys (s), max RSS (KiB), "
+                   "voluntary and involuntary context switches, read and write bytes\n";
+            out << std::setprecision(9);
+            std::map<std::string, const TaskRecord*> ordered;
+            for (const auto& [id, record] : records_) {
+                ordered.emplace(id, &record);
+            }
+            for (const auto& [id, record] : ordered) {
+                for (const RunSample& s : record->samples) {
+                    out << id << '\t' << s.timestamp << '\t' << s.wall_seconds << '\t' << s.user_seconds << '\t'
+                        << s.system_seconds << '\t' << s.max_rss_kb << '\t' << s.voluntary_switches << '\t'
+                        << s.involuntary_switches << '\t' << s.read_bytes << '\t' << s.write_bytes << '\n';
+                }
+            }
+            out.close();
+            if (!out) {
+                fs::remove(temporary);
+                throw std::runtime_error("Failed to write task history '" + temporary + "'.");
+            }
+        }
+        fs::rename(temporary, target);
+        dirty_ = false;
+    }
+
+    std::size_t History::size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return records_.size();
+    }
+
+} // namespace dagra::history
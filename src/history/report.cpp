@@ -0,0 +1,203 @@
+/**
+ * @file report.cpp
+ * @brief Implements the `dagra report` cost ranking and regression check.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the report functions. All
+ * figures are taken from a task's latest run; regressions compare it with
+ * the median of the retained earlier runs, which is robust to a single
+ * outlier.
+ */
+
+#include "dagra/history/report.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+namespace dagra::history {
+
+    namespace {
+
+        /// @brief Absolute wall/CPU growth, in seconds, below which changes are ignored.
+        constexpr double NOISE_FLOOR_SECONDS = 0.1;
+
+        /// @brief The value of the ranking metric for a run.
+        double metric(const RunSample& sample, SortKey key) {
+            switch (key) {
+            case SortKey::Wall:
+                return sample.wall_seconds;
+            case SortKey::Cpu:
+                return sample.cpu_seconds();
+            case SortKey::Memory:
+                return static_cast<double>(sample.max_rss_kb);
+            case SortKey::Io:
+                return static_cast<double>(std::max<std::int64_t>(sample.read_bytes, 0) +
+                                           std::max<std::int64_t>(sample.write_bytes, 0));
+            }
+            return 0.0;
+        }
+
+        /// @brief The median of a non-empty list of values.
+        double median(std::vector<double> values) {
+            std::sort(values.begin(), values.end());
+            const std::size_t mid = values.size() / 2;
+            return values.size() % 2 == 1 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+        }
+
+        /// @brief Formats a duration, e.g. "0.42s" or "3m05s".
+        std::string format_seconds(double seconds) {
+            std::ostringstream out;
+            if (seconds < 60.0) {
+                out << std::fixed << std::setprecision(2) << seconds << "s";
+            } else {
+                const auto whole = static_cast<std::int64_t>(seconds);
+                out << whole / 60 << "m" << std::setw(2) << std::setfill('0') << whole % 60 << "s";
+            }
+            return out.str();
+        }
+
+        /// @brief Formats a byte count with a binary unit, or "-" if unknown.
+        std::string format_bytes(double bytes) {
+            if (bytes < 0) {
+                return "-";
+            }
+            static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+            std::size_t unit = 0;
+            while (bytes >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+                bytes /= 1024.0;
+                ++unit;
+            }
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+            return out.str();
+        }
+
+        /// @brief Formats a value of the given regression metric.
+        std::string format_metric(const std::string& name, double value) {
+            return name == "memory" ? format_bytes(value * 1024.0) : format_seconds(value);
+        }
+
+    } // namespace
+
+    bool parse_sort_key(const std::string& name, SortKey& key) {
+        if (name == "wall") {
+            key = SortKey::Wall;
+        } else if (name == "cpu") {
+            key = SortKey::Cpu;
+        } else if (name == "memory") {
+            key = SortKey::Memory;
+        } else if (name == "io") {
+            key = SortKey::Io;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<Regression> find_regressions(const History& history, double threshold) {
+        std::vector<Regression> regressions;
+        for (const auto& [id, record] : history.records()) {
+            if (record.samples.size() < 2) {
+                continue;
+            }
+            const RunSample& latest = record.samples.back();
+            std::vector<double> wall, cpu, memory;
+            for (std::size_t i = 0; i + 1 < record.samples.size(); ++i) {
+                wall.push_back(record.samples[i].wall_seconds);
+                cpu.push_back(record.samples[i].cpu_seconds());
+                memory.push_back(static_cast<double>(record.samples[i].max_rss_kb));
+            }
+
+            const struct {
+                const char* name;
+                double before;
+                double after;
+                double floor;
+            } checks[] = {
+                {"wall", median(wall), latest.wall_seconds, NOISE_FLOOR_SECONDS},
+                {"cpu", median(cpu), latest.cpu_seconds(), NOISE_FLOOR_SECONDS},
+                {"memory", median(memory), static_cast<double>(latest.max_rss_kb), 0.0},
+            };
+            for (const auto& check : checks) {
+                if (check.before > 0.0 && check.after - check.before > check.floor &&
+                    check.after > check.before * (1.0 + threshold)) {
+                    regressions.push_back({id, check.name, check.before, check.after});
+                }
+            }
+        }
+
+        std::sort(regressions.begin(), regressions.end(), [](const Regression& a, const Regression& b) {
+            const double growth_a = a.after / a.before;
+            const double growth_b = b.after / b.before;
+            if (growth_a != growth_b) {
+                return growth_a > growth_b;
+            }
+            return a.task != b.task ? a.task < b.task : a.metric < b.metric;
+        });
+        return regressions;
+    }
+
+    void write_report(const History& history, const ReportOptions& options, std::ostream& out) {
+        struct Row {
+            const std::string* id;
+            const TaskRecord* record;
+            double key;
+        };
+        std::vector<Row> rows;
+        for (const auto& [id, record] : history.records()) {
+            if (!record.samples.empty()) {
+                rows.push_back({&id, &record, metric(record.samples.back(), options.sort)});
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            return a.key != b.key ? a.key > b.key : *a.id < *b.id;
+        });
+
+        static const char* sort_names[] = {"wall time", "CPU time", "peak memory", "storage I/O"};
+        out << "Task history: " << rows.size() << " tasks, ranked by " << sort_names[static_cast<int>(options.sort)]
+            << " of the latest run\n\n";
+
+        std::size_t id_width = 4;
+        for (const Row& row : rows) {
+            id_width = std::max(id_width, row.id->size());
+        }
+        out << std::left << std::setw(5) << "#" << std::setw(static_cast<int>(id_width) + 2) << "Task" << std::right
+            << std::setw(6) << "Runs" << std::setw(10) << "Wall" << std::setw(10) << "Avg wall" << std::setw(10)
+            << "CPU" << std::setw(12) << "Max RSS" << std::setw(12) << "Read" << std::setw(12) << "Write"
+            << std::setw(10) << "Ctx sw" << "\n";
+
+        const std::size_t shown = options.limit == 0 ? rows.size() : std::min(options.limit, rows.size());
+        for (std::size_t i = 0; i < shown; ++i) {
+            const TaskRecord& record = *rows[i].record;
+            const RunSample& latest = record.samples.back();
+            out << std::left << std::setw(5) << i + 1 << std::setw(static_cast<int>(id_width) + 2) << *rows[i].id
+                << std::right << std::setw(6) << record.samples.size() << std::setw(10)
+                << format_seconds(latest.wall_seconds) << std::setw(10) << format_seconds(record.duration_seconds)
+                << std::setw(10) << format_seconds(latest.cpu_seconds()) << std::setw(12)
+                << format_bytes(static_cast<double>(latest.max_rss_kb) * 1024.0) << std::setw(12)
+                << format_bytes(static_cast<double>(latest.read_bytes)) << std::setw(12)
+                << format_bytes(static_cast<double>(latest.write_bytes)) << std::setw(10)
+                << latest.voluntary_switches + latest.involuntary_switches << "\n";
+        }
+        if (shown < rows.size()) {
+            out << "... " << rows.size() - shown << " more\n";
+        }
+
+        std::vector<Regression> regressions = find_regressions(history, options.regression_threshold);
+        out << "\n";
+        if (regressions.empty()) {
+            out << "No regressions: no task's latest run exceeded the median of its earlier runs by more than "
+                << static_cast<int>(options.regression_threshold * 100) << "%.\n";
+            return;
+        }
+        out << "Regressions (latest run vs. median of earlier runs):\n";
+        for (const Regression& regression : regressions) {
+            out << "  " << regression.task << ": " << regression.metric << " "
+                << format_metric(regression.metric, regression.before) << " -> "
+                << format_metric(regression.metric, regression.after) << " (+"
+                << static_cast<int>((regression.after / regression.before - 1.0) * 100.0 + 0.5) << "%)\n";
+        }
+    }
+
+} // namespace dagra::history
@@ -8,11 +8,204 @@
  * a configuration file, builds a dependency graph, and triggers the execution.
  */
 
+#include "dagra/cache/plan_cache.hpp"
 #include "dagra/cli/parser.hpp"
+#include "dagra/core/analysis.hpp"
 #include "dagra/core/dag.hpp"
+#include "dagra/core/selection.hpp"
 #include "dagra/execution/runner.hpp"
+#include "dagra/execution/thread_pool.hpp"
+#include "dagra/history/history.hpp"
+#include "dagra/history/report.hpp"
 #include "dagra/utils/logger.hpp"
+#include "dagra/watch/watch_session.hpp"
+#include <chrono>
+#include <csignal>
 #include <exception>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Loads the task graph, from the compiled plan if the configuration is unchanged.
+     *
+     * On a plan miss the YAML file is parsed and validated as usual and the
+     * result is compiled into `<state dir>/<config file name>.plan` for the
+     * next run. Failing to write the plan only costs that speed-up.
+     *
+     * @param options The parsed command-line options.
+     * @param dag Receives the validated graph.
+     * @param resource_pools Receives the declared resource pool capacities.
+     */
+    void load_graph(const dagra::cli::AppOptions& options, dagra::core::Dag& dag,
+                    std::map<std::string, double>& resource_pools) {
+        const auto plan_path = dagra::cli::state_directory(options) /
+                               (std::filesystem::path(options.config_filepath).filename().string() + ".plan");
+        std::uint64_t config_hash = 0;
+        const bool hashed = dagra::cache::hash_config(options.config_filepath, config_hash);
+        if (hashed && dagra::cache::load_plan(plan_path.string(), config_hash, dag, resource_pools)) {
+            dagra::utils::Logger::info("Loaded compiled plan of " + std::to_string(dag.size()) + " tasks.");
+            return;
+        }
+
+        dagra::utils::Logger::info("Parsing configuration file...");
+        dagra::cli::Config config = dagra::cli::Parser::parse_config(options.config_filepath);
+        std::vector<dagra::core::Task>& tasks = config.tasks;
+        resource_pools = config.resource_pools;
+
+        dagra::utils::Logger::info("Building dependency graph...");
+        dag.reserve(tasks.size());
+        for (auto& task : tasks) {
+            dag.add_task(std::move(task));
+        }
+        tasks.clear();
+
+        dagra::utils::Logger::info("Validating dependency graph...");
+        dag.validate();
+
+        if (hashed) {
+            try {
+                dagra::cache::save_plan(dag, resource_pools, plan_path.string(), config_hash);
+            } catch (const std::exception& e) {
+                dagra::utils::Logger::warn(std::string("Could not write the compiled plan: ") + e.what());
+            }
+        }
+    }
+
+    /**
+     * @brief Narrows the graph to the requested targets and everything they depend on.
+     *
+     * Does nothing if no target or tag was given. The selection is resolved
+     * by index and copied into a new graph, so the work is proportional to
+     * the selected subgraph; the rest of the configuration is never
+     * scheduled.
+     *
+     * @param options The parsed command-line options.
+     * @param dag The loaded graph; replaced by the selected subgraph.
+     * @throw std::runtime_error If a target or tag selects nothing.
+     */
+    void select_graph(const dagra::cli::AppOptions& options, dagra::core::Dag& dag) {
+        if (options.targets.empty() && options.tags.empty()) {
+            return;
+        }
+        const std::vector<dagra::core::TaskIndex> targets =
+            dagra::core::select_targets(dag, options.targets, options.tags);
+        const std::vector<dagra::core::TaskIndex> closure = dag.dependency_closure(targets);
+        dagra::utils::Logger::info("Selected " + std::to_string(targets.size()) + " target(s); running " +
+                                   std::to_string(closure.size()) + " of " + std::to_string(dag.size()) +
+                                   " tasks.");
+        dag = dag.subgraph(closure);
+    }
+
+    /**
+     * @brief Prints the analysis of the graph and writes the reduced configuration if asked.
+     *
+     * The critical path is weighted like the scheduler weighs it: `cost`
+     * hints first, then the durations recorded in the task history.
+     *
+     * @param options The parsed command-line options.
+     * @param dag The validated (and possibly narrowed) graph.
+     * @param resource_pools The declared resource pool capacities, kept in the reduced configuration.
+     */
+    void analyze_graph(const dagra::cli::AppOptions& options, const dagra::core::Dag& dag,
+                       const std::map<std::string, double>& resource_pools) {
+        dagra::history::History history;
+        history.load((dagra::cli::state_directory(options) / "history.tsv").string());
+        const dagra::core::GraphAnalysis analysis =
+            dagra::core::analyze_graph(dag, dagra::execution::estimate_weights(dag, history));
+        const std::size_t jobs =
+            options.jobs > 0 ? options.jobs : dagra::execution::ThreadPool::default_concurrency();
+        dagra::core::write_analysis(dag, analysis, jobs, options.report_limit, std::cout);
+
+        if (!options.reduce_path.empty()) {
+            dagra::cli::Config reduced;
+            reduced.tasks = dagra::core::reduce_tasks(dag, analysis.redundant_edges);
+            reduced.resource_pools = resource_pools;
+            dagra::cli::Parser::write_config(reduced, options.reduce_path);
+            dagra::utils::Logger::success("Wrote the transitively reduced configuration to " + options.reduce_path +
+                                          " (" + std::to_string(analysis.redundant_edges.size()) +
+                                          " redundant edge(s) removed).");
+        }
+    }
+
+    /**
+     * @class StopSignals
+     * @brief Blocks SIGINT and SIGTERM and receives them through a signalfd.
+     *
+     * Every task runs in its own process group, so Ctrl-C at the terminal
+     * reaches dagra but not the tasks. Instead of dying and leaving those
+     * groups orphaned, dagra reads the signal from the signalfd, which the
+     * runner uses as its cancel descriptor: running groups are terminated
+     * and reaped before dagra exits. The signals stay pending, so the
+     * descriptor stays readable once a signal has arrived.
+     */
+    class StopSignals {
+    public:
+        /**
+         * @brief Blocks the signals and opens the signalfd.
+         *
+         * Must run before the first thread starts, so that every thread
+         * inherits the mask and the signals cannot be delivered elsewhere.
+         *
+         * @throw std::runtime_error If the signalfd cannot be created.
+         */
+        StopSignals() {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+            fd_ = signalfd(-1, &signals, SFD_CLOEXEC);
+            if (fd_ < 0) {
+                throw std::runtime_error("Failed to set up signal handling.");
+            }
+        }
+
+        ~StopSignals() {
+            close(fd_);
+        }
+
+        StopSignals(const StopSignals&) = delete;
+        StopSignals& operator=(const StopSignals&) = delete;
+
+        /// @brief The signalfd; readable once SIGINT or SIGTERM has arrived.
+        int fd() const {
+            return fd_;
+        }
+
+    private:
+        int fd_ = -1;
+    };
+
+    /**
+     * @brief Runs the graph in watch mode until SIGINT or SIGTERM.
+     *
+     * Ctrl-C ends the session cleanly: the run in flight is cancelled and
+     * its process groups are terminated before dagra exits.
+     *
+     * @param options The parsed command-line options.
+     * @param dag The validated graph.
+     * @param runner_options The options for every run.
+     * @param stop_fd The signalfd of the stop signals.
+     */
+    void watch_graph(const dagra::cli::AppOptions& options, const dagra::core::Dag& dag,
+                     const dagra::execution::RunnerOptions& runner_options, int stop_fd) {
+        dagra::watch::WatchOptions watch_options;
+        watch_options.runner = runner_options;
+        watch_options.debounce = std::chrono::milliseconds(options.watch_debounce_ms);
+        watch_options.stop_fd = stop_fd;
+        dagra::watch::WatchSession(dag, watch_options).run();
+    }
+
+} // namespace
 
 /**
  * @brief The main entry point of the Dagra application.
@@ -24,26 +217,76 @@
 int main(int argc, char* argv[]) {
     try {
         dagra::cli::AppOptions options = dagra::cli::Parser::parse_args(argc, argv);
-        
+        // Only commands that start tasks need to outlive a signal; the others keep the default action.
+        std::unique_ptr<StopSignals> stop_signals;
+        if (options.command == dagra::cli::Command::Run) {
+            stop_signals = std::make_unique<StopSignals>();
+        }
+        dagra::utils::Logger::set_format(options.log_format);
+
+        if (options.command == dagra::cli::Command::Report) {
+            const auto history_path = dagra::cli::state_directory(options) / "history.tsv";
+            dagra::history::History history;
+            history.load(history_path.string());
+            if (history.size() == 0) {
+                dagra::utils::Logger::info("No task history found at " + history_path.string() + ".");
+                return 0;
+            }
+            dagra::history::ReportOptions report_options;
+            report_options.sort = options.report_sort;
+            report_options.limit = options.report_limit;
+            dagra::history::write_report(history, report_options, std::cout);
+            return 0;
+        }
+
         if (options.dry_run) {
             dagra::utils::Logger::info("Dagra running in dry-run mode.");
         }
         
         dagra::utils::Logger::info("Target config: " + options.config_filepath);
-        dagra::utils::Logger::info("Parsing configuration file...");
-        auto tasks = dagra::cli::Parser::parse_yaml(options.config_filepath);
-
-        dagra::utils::Logger::info("Building dependency graph...");
         dagra::core::Dag dag;
-        for (const auto& task : tasks) {
-            dag.add_task(task);
-        }
+        std::map<std::string, double> resource_pools;
+        load_graph(options, dag, resource_pools);
+        select_graph(options, dag);
 
-        dagra::utils::Logger::info("Validating dependency graph...");
-        dag.validate();
+        if (options.command == dagra::cli::Command::Analyze) {
+            analyze_graph(options, dag, resource_pools);
+            dagra::utils::Logger::flush();
+            return 0;
+        }
 
         dagra::utils::Logger::info("Initializing execution engine...");
-        dagra::execution::Runner runner(dag, options.dry_run);
+        dagra::execution::RunnerOptions runner_options;
+        runner_options.dry_run = options.dry_run;
+        runner_options.jobs = options.jobs;
+        runner_options.keep_going = options.keep_going;
+        runner_options.fuse = options.fuse;
+        runner_options.event_loop = options.event_loop;
+        runner_options.kill_grace = std::chrono::seconds(options.kill_grace_seconds);
+        runner_options.worker_max_requests = options.worker_max_requests;
+        runner_options.history_path = (dagra::cli::state_directory(options) / "history.tsv").string();
+        runner_options.log_dir = (dagra::cli::state_directory(options) / "logs").string();
+        runner_options.trace_path = options.trace_path;
+        runner_options.listen_address = options.listen_address;
+        runner_options.resource_pools = resource_pools;
+        if (options.use_cache) {
+            runner_options.cache_path = (dagra::cli::state_directory(options) / "cache.bin").string();
+        }
+
+        if (options.watch) {
+            // Watch reruns are partial by design, so they neither write nor replay the run journal.
+            watch_graph(options, dag, runner_options, stop_signals->fd());
+            dagra::utils::Logger::flush();
+            return 0;
+        }
+
+        runner_options.journal_path = (dagra::cli::state_directory(options) /
+                                       (std::filesystem::path(options.config_filepath).filename().string() + ".journal"))
+                                          .string();
+        runner_options.resume = options.resume;
+        runner_options.cancel_fd = stop_signals->fd();
+
+        dagra::execution::Runner runner(dag, runner_options);
         runner.execute_all();
 
         if (!options.dry_run) {
@@ -52,8 +295,10 @@ int main(int argc, char* argv[]) {
 
     } catch (const std::exception& e) {
         dagra::utils::Logger::error(std::string("Fatal error: ") + e.what());
+        dagra::utils::Logger::flush();
         return 1;
     }
 
+    dagra::utils::Logger::flush();
     return 0;
 }
@@ -0,0 +1,207 @@
+/**
+ * @file agent.cpp
+ * @brief Implements the agent run by the `dagra-worker` executable.
+ * @version 1.1.0
+ *
+ * This file contains the implementation of the Agent class. The calling
+ * thread reads the coordinator's messages; tasks run on a thread pool with
+ * one thread per slot, and their output is drained by an OutputCollector
+ * whose sink frames complete lines and sends them to the coordinator. Each
+ * task is registered with the collector under its sequence number.
+ */
+
+#include "dagra/remote/agent.hpp"
+#include "dagra/execution/output_collector.hpp"
+#include "dagra/execution/process.hpp"
+#include "dagra/execution/thread_pool.hpp"
+#include "dagra/utils/io.hpp"
+#include "dagra/utils/logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace dagra::remote {
+
+    namespace {
+
+        /// @brief How long a finished task's output pipes may stay open (held by a stray descendant).
+        constexpr std::chrono::milliseconds OUTPUT_DRAIN_LIMIT{2000};
+
+        /// @brief Size of the buffer each receive drains into.
+        constexpr std::size_t READ_CHUNK = 64 * 1024;
+
+        /// @brief The default agent name: the host name and the process ID.
+        std::string default_name() {
+            char host[256] = {};
+            if (gethostname(host, sizeof(host) - 1) != 0) {
+                std::strcpy(host, "localhost");
+            }
+            return std::string(host) + ":" + std::to_string(getpid());
+        }
+
+    } // namespace
+
+    Agent::Agent(const AgentOptions& options) : address_(parse_address(options.address)), options_(options) {
+        if (options_.slots == 0) {
+            options_.slots = execution::ThreadPool::default_concurrency();
+        }
+        if (options_.name.empty()) {
+            options_.name = default_name();
+        }
+    }
+
+    void Agent::serve() {
+        bool waiting_logged = false;
+        while (true) {
+            const int fd = connect_to(address_);
+            if (fd < 0) {
+                if (!waiting_logged) {
+                    utils::Logger::info("Waiting for the coordinator at " + address_.describe() + " (" +
+                                        std::strerror(errno) + ")...");
+                    waiting_logged = true;
+                }
+                std::this_thread::sleep_for(options_.retry_delay);
+                continue;
+            }
+            utils::Logger::info("Connected to the coordinator at " + address_.describe() + " as '" + options_.name +
+                                "' with " + std::to_string(options_.slots) + " slot(s).");
+            serve_connection(fd);
+            close(fd);
+            utils::Logger::info("Disconnected from the coordinator.");
+            if (options_.once) {
+                return;
+            }
+            waiting_logged = false;
+        }
+    }
+
+    const std::string& Agent::name() const {
+        return options_.name;
+    }
+
+    std::size_t Agent::slots() const {
+        return options_.slots;
+    }
+
+    /**
+     * @brief Serves one coordinator connection until it closes or breaks the protocol.
+     *
+     * The coordinator never sends more tasks than the announced slots, so
+     * every task submitted to the pool starts at once. When the connection
+     * ends, every running task is cancelled and the pool is joined before
+     * returning.
+     */
+    void Agent::serve_connection(int fd) {
+        std::mutex send_mutex;
+        auto send = [&](const std::string& message) {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            utils::send_all(fd, message);
+        };
+        send(encode_hello(options_.name, options_.slots));
+
+        execution::OutputOptions output_options;
+        output_options.sink = [&](const std::string& seq, bool is_stderr, std::string lines) {
+            send(encode_output(std::stoull(seq), is_stderr, lines));
+        };
+        execution::OutputCollector collector(output_options);
+
+        std::mutex running_mutex;
+        std::map<std::uint64_t, int> cancel_fds;
+        auto cancel = [&](std::uint64_t seq) {
+            std::lock_guard<std::mutex> lock(running_mutex);
+            for (const auto& [running, cancel_fd] : cancel_fds) {
+                if (seq == 0 || seq == running) {
+                    const std::uint64_t one = 1;
+                    [[maybe_unused]] const ssize_t n = write(cancel_fd, &one, sizeof(one));
+                }
+            }
+        };
+
+        execution::ThreadPool pool(options_.slots);
+        std::string buffer;
+        std::vector<char> chunk(READ_CHUNK);
+        bool open = true;
+        while (open) {
+            const ssize_t n = recv(fd, chunk.data(), chunk.size(), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<std::size_t>(n));
+
+            std::string body;
+            FrameStatus status;
+            Message message;
+            while ((status = take_frame(buffer, body)) == FrameStatus::Complete && decode_message(body, message)) {
+                if (message.type == "cancel") {
+                    cancel(message.seq);
+                    continue;
+                }
+                if (message.type != "run") {
+                    continue;
+                }
+                const int cancel_fd = eventfd(0, EFD_CLOEXEC);
+                {
+                    std::lock_guard<std::mutex> lock(running_mutex);
+                    cancel_fds[message.seq] = cancel_fd;
+                }
+                pool.submit([&, message, cancel_fd]() {
+                    const core::Task& task = message.task;
+                    utils::Logger::info("Running: [" + task.id + "] -> " + task.command);
+
+                    int out_pipe[2] = {-1, -1};
+                    int err_pipe[2] = {-1, -1};
+                    if (pipe2(out_pipe, O_CLOEXEC) != 0 || pipe2(err_pipe, O_CLOEXEC) != 0) {
+                        for (int pipe_fd : {out_pipe[0], out_pipe[1]}) {
+                            if (pipe_fd >= 0) {
+                                close(pipe_fd);
+                            }
+                        }
+                        out_pipe[0] = out_pipe[1] = err_pipe[0] = err_pipe[1] = -1;
+                    }
+                    execution::Process process = execution::Process::spawn(task, out_pipe[1], err_pipe[1]);
+                    for (int pipe_fd : {out_pipe[1], err_pipe[1]}) {
+                        if (pipe_fd >= 0) {
+                            close(pipe_fd);
+                        }
+                    }
+                    std::shared_ptr<execution::TaskOutput> output;
+                    if (out_pipe[0] >= 0) {
+                        output = collector.attach(std::to_string(message.seq), out_pipe[0], err_pipe[0]);
+                    }
+
+                    const execution::ExitStatus status = process.wait_with_timeout(
+                        std::chrono::seconds(task.timeout_seconds), message.kill_grace, cancel_fd);
+                    if (output) {
+                        output->finish(OUTPUT_DRAIN_LIMIT);
+                    }
+                    send(encode_exit(message.seq, status));
+                    utils::Logger::info("Finished: [" + task.id + "] (" + status.describe() + ")");
+
+                    std::lock_guard<std::mutex> lock(running_mutex);
+                    cancel_fds.erase(message.seq);
+                    close(cancel_fd);
+                });
+            }
+            if (status == FrameStatus::Malformed || status == FrameStatus::Complete) {
+                utils::Logger::error("Malformed message from the coordinator; disconnecting.");
+                open = false;
+            }
+        }
+
+        // Without a coordinator nobody waits for the running tasks, so stop them.
+        shutdown(fd, SHUT_RDWR);
+        cancel(0);
+    }
+
+} // namespace dagra::remote
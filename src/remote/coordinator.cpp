@@ -0,0 +1,325 @@
+/**
+ * @file coordinator.cpp
+ * @brief Implements the coordinator that dispatches tasks to remote agents.
+ * @version 1.1.0
+ *
+ * This file contains the implementation of the Coordinator class. All
+ * sockets are served by one background thread with `poll`; callers of `run`
+ * only send requests and wait on a condition variable, so the number of
+ * connected agents never costs a thread each.
+ */
+
+#include "dagra/remote/coordinator.hpp"
+#include "dagra/utils/io.hpp"
+#include "dagra/utils/logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace dagra::remote {
+
+    namespace {
+
+        /// @brief Size of the buffer each receive drains into.
+        constexpr std::size_t READ_CHUNK = 64 * 1024;
+
+    } // namespace
+
+    /**
+     * @struct Coordinator::Agent
+     * @brief One connected agent.
+     */
+    struct Coordinator::Agent {
+        int fd = -1;
+        std::string name;
+        std::size_t slots = 0;  ///< 0 until the agent's `hello` arrives.
+        std::size_t busy = 0;
+        std::string buffer;     ///< Bytes received but not yet decoded.
+    };
+
+    /**
+     * @struct Coordinator::Request
+     * @brief A task sent to an agent, owned by the `run` call waiting for it.
+     */
+    struct Coordinator::Request {
+        const Agent* agent = nullptr;
+        int stdout_fd = -1;
+        int stderr_fd = -1;
+        bool done = false;
+        bool lost = false;
+        execution::ExitStatus status;
+    };
+
+    Coordinator::Coordinator(const CoordinatorOptions& options) : options_(options) {
+        listen_fd_ = listen_on(parse_address(options_.address), bound_);
+        wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wake_fd_ < 0) {
+            close(listen_fd_);
+            throw std::runtime_error(std::string("Could not create the coordinator's eventfd: ") + std::strerror(errno));
+        }
+        thread_ = std::thread(&Coordinator::loop, this);
+    }
+
+    Coordinator::~Coordinator() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        wake();
+        thread_.join();
+        for (auto& [fd, agent] : agents_) {
+            close(fd);
+        }
+        close(listen_fd_);
+        close(wake_fd_);
+        if (bound_.kind == Address::Kind::Unix) {
+            unlink(bound_.path.c_str());
+        }
+    }
+
+    /**
+     * @brief Sends a task to the agent with the most free slots and waits for its exit.
+     *
+     * If the agent is lost before the task exits, the task is sent to
+     * another agent, until `max_attempts` agents have been lost.
+     */
+    RemoteResult Coordinator::run(const core::Task& task, int stdout_fd, int stderr_fd) {
+        RemoteResult result;
+        Request request;
+        request.stdout_fd = stdout_fd;
+        request.stderr_fd = stderr_fd;
+
+        auto free_agent = [this]() -> Agent* {
+            Agent* best = nullptr;
+            for (auto& [fd, agent] : agents_) {
+                if (agent->busy < agent->slots && (best == nullptr || agent->slots - agent->busy > best->slots - best->busy)) {
+                    best = agent.get();
+                }
+            }
+            return best;
+        };
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (std::size_t attempt = 1;; ++attempt) {
+            changed_.wait(lock, [&]() { return cancelled_ || stopping_ || free_agent() != nullptr; });
+            if (cancelled_ || stopping_) {
+                result.status.cancelled = true;
+                return result;
+            }
+
+            Agent* agent = free_agent();
+            const std::uint64_t seq = next_seq_++;
+            request.agent = agent;
+            request.done = false;
+            request.lost = false;
+            requests_[seq] = &request;
+            ++agent->busy;
+            result.agent = agent->name;
+            if (!utils::send_all(agent->fd, encode_run(seq, task, options_.kill_grace))) {
+                // The background thread sees the broken connection and drops the agent.
+                shutdown(agent->fd, SHUT_RDWR);
+                wake();
+            }
+
+            changed_.wait(lock, [&]() { return request.done || request.lost; });
+            if (request.done) {
+                result.status = request.status;
+                return result;
+            }
+            if (attempt >= options_.max_attempts) {
+                result.error = "lost " + std::to_string(attempt) + " remote worker(s) while running the task";
+                return result;
+            }
+            utils::Logger::warn("Rescheduling [" + task.id + "] after losing remote worker '" + result.agent + "'.");
+        }
+    }
+
+    std::string Coordinator::address() const {
+        return bound_.describe();
+    }
+
+    std::size_t Coordinator::agents() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t count = 0;
+        for (const auto& [fd, agent] : agents_) {
+            count += agent->slots > 0 ? 1 : 0;
+        }
+        return count;
+    }
+
+    std::size_t Coordinator::slots() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t count = 0;
+        for (const auto& [fd, agent] : agents_) {
+            count += agent->slots;
+        }
+        return count;
+    }
+
+    std::size_t Coordinator::lost() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lost_;
+    }
+
+    /**
+     * @brief Accepts agents, reads their messages and watches the cancel descriptor.
+     *
+     * The set of descriptors is rebuilt before every `poll`, under the lock,
+     * so agents dropped by another iteration are never polled again.
+     */
+    void Coordinator::loop() {
+        std::vector<pollfd> fds;
+        std::vector<char> chunk(READ_CHUNK);
+        while (true) {
+            fds.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_) {
+                    return;
+                }
+                fds.push_back({listen_fd_, POLLIN, 0});
+                fds.push_back({wake_fd_, POLLIN, 0});
+                fds.push_back({cancelled_ ? -1 : options_.cancel_fd, POLLIN, 0});
+                for (const auto& [fd, agent] : agents_) {
+                    fds.push_back({fd, POLLIN, 0});
+                }
+            }
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                utils::Logger::error(std::string("Coordinator poll failed: ") + std::strerror(errno));
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            if (fds[1].revents != 0) {
+                std::uint64_t count = 0;
+                [[maybe_unused]] const ssize_t n = read(wake_fd_, &count, sizeof(count));
+            }
+            if (fds[2].revents != 0 && !cancelled_) {
+                cancelled_ = true;
+                cancel_all();
+                changed_.notify_all();
+            }
+            if (fds[0].revents != 0) {
+                const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+                if (fd >= 0) {
+                    const int on = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+                    auto agent = std::make_unique<Agent>();
+                    agent->fd = fd;
+                    agents_[fd] = std::move(agent);
+                }
+            }
+
+            for (std::size_t i = 3; i < fds.size(); ++i) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                auto found = agents_.find(fds[i].fd);
+                if (found == agents_.end()) {
+                    continue;
+                }
+                Agent& agent = *found->second;
+                const ssize_t n = recv(agent.fd, chunk.data(), chunk.size(), MSG_DONTWAIT);
+                if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    continue;
+                }
+                if (n <= 0) {
+                    drop(agent.fd, n == 0 ? "connection closed" : std::string("read failed: ") + std::strerror(errno));
+                    continue;
+                }
+                agent.buffer.append(chunk.data(), static_cast<std::size_t>(n));
+
+                std::string body;
+                FrameStatus status;
+                Message message;
+                while ((status = take_frame(agent.buffer, body)) == FrameStatus::Complete &&
+                       decode_message(body, message)) {
+                    handle(agent, message);
+                }
+                if (status != FrameStatus::Incomplete) {
+                    drop(agent.fd, "malformed message");
+                }
+            }
+        }
+    }
+
+    void Coordinator::handle(Agent& agent, const Message& message) {
+        if (message.type == "hello") {
+            if (agent.slots == 0) {
+                agent.name = message.name.empty() ? "agent-" + std::to_string(agent.fd) : message.name;
+                agent.slots = message.slots;
+                utils::Logger::info("Remote worker '" + agent.name + "' connected with " +
+                                    std::to_string(agent.slots) + " slot(s).");
+                changed_.notify_all();
+            }
+            return;
+        }
+
+        auto found = requests_.find(message.seq);
+        if (found == requests_.end() || found->second->agent != &agent) {
+            return;
+        }
+        Request& request = *found->second;
+        if (message.type == "output") {
+            const int fd = message.is_stderr ? request.stderr_fd : request.stdout_fd;
+            if (fd >= 0) {
+                utils::write_all(fd, message.data);
+            }
+        } else if (message.type == "exit") {
+            request.status = message.status;
+            request.done = true;
+            --agent.busy;
+            requests_.erase(found);
+            changed_.notify_all();
+        }
+    }
+
+    void Coordinator::drop(int fd, const std::string& reason) {
+        auto found = agents_.find(fd);
+        if (found == agents_.end()) {
+            return;
+        }
+        const Agent* agent = found->second.get();
+        for (auto request = requests_.begin(); request != requests_.end();) {
+            if (request->second->agent == agent) {
+                request->second->lost = true;
+                request = requests_.erase(request);
+            } else {
+                ++request;
+            }
+        }
+        if (agent->slots > 0) {
+            ++lost_;
+            utils::Logger::warn("Lost remote worker '" + agent->name + "': " + reason);
+        }
+        close(fd);
+        agents_.erase(found);
+        changed_.notify_all();
+    }
+
+    void Coordinator::cancel_all() {
+        for (const auto& [seq, request] : requests_) {
+            utils::send_all(request->agent->fd, encode_cancel(seq));
+        }
+    }
+
+    void Coordinator::wake() const {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t n = write(wake_fd_, &one, sizeof(one));
+    }
+
+} // namespace dagra::remote
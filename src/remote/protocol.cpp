@@ -0,0 +1,369 @@
+/**
+ * @file protocol.cpp
+ * @brief Implements the coordinator/agent wire protocol.
+ * @version 1.1.0
+ *
+ * This file contains address parsing, socket setup and the message codec.
+ * Messages are written with the JSON helpers in `utils/json.hpp` and read
+ * back with yaml-cpp, which parses JSON as YAML flow style, like the replies
+ * of persistent workers.
+ */
+
+#include "dagra/remote/protocol.hpp"
+#include "dagra/utils/json.hpp"
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+
+namespace dagra::remote {
+
+    namespace {
+
+        /// @brief Largest message body accepted from a peer.
+        constexpr std::size_t MAX_FRAME_BYTES = 64 * 1024 * 1024;
+
+        /// @brief Longest length line accepted before the newline, in digits.
+        constexpr std::size_t MAX_LENGTH_DIGITS = 10;
+
+        /// @brief Pending connections the listening socket queues.
+        constexpr int LISTEN_BACKLOG = 128;
+
+        /// @brief Fills a Unix socket address; false if the path does not fit.
+        bool unix_address(const std::string& path, sockaddr_un& address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+
+        /// @brief Resolves a TCP address; an empty host means every interface.
+        addrinfo* resolve(const Address& address, bool passive) {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_flags = passive ? AI_PASSIVE : 0;
+            addrinfo* result = nullptr;
+            const int rc = getaddrinfo(address.host.empty() ? nullptr : address.host.c_str(), address.port.c_str(),
+                                       &hints, &result);
+            return rc == 0 ? result : nullptr;
+        }
+
+        /// @brief Turns off Nagle's algorithm and enables keep-alive on a TCP socket.
+        void tune_tcp(int fd) {
+            const int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+        }
+
+        /// @brief Starts a message body with its type and sequence number.
+        std::string begin_message(const char* type, std::uint64_t seq) {
+            return std::string("{\"type\": \"") + type + "\", \"seq\": " + std::to_string(seq);
+        }
+
+        /// @brief Reads an optional scalar field, keeping the default if it is missing.
+        template <typename T>
+        void read_field(const YAML::Node& node, const char* key, T& value) {
+            if (node[key] && node[key].IsScalar()) {
+                value = node[key].as<T>();
+            }
+        }
+
+    } // namespace
+
+    std::string Address::describe() const {
+        return kind == Kind::Unix ? "unix:" + path : host + ":" + port;
+    }
+
+    Address parse_address(const std::string& text) {
+        Address address;
+        if (text.rfind("unix:", 0) == 0) {
+            address.kind = Address::Kind::Unix;
+            address.path = text.substr(5);
+            if (address.path.empty()) {
+                throw std::runtime_error("Invalid address '" + text + "': the socket path is empty.");
+            }
+            return address;
+        }
+        const std::size_t colon = text.rfind(':');
+        if (colon == std::string::npos || colon + 1 == text.size()) {
+            throw std::runtime_error("Invalid address '" + text + "' (expected HOST:PORT or unix:PATH).");
+        }
+        address.host = text.substr(0, colon);
+        address.port = text.substr(colon + 1);
+        if (address.host.size() >= 2 && address.host.front() == '[' && address.host.back() == ']') {
+            address.host = address.host.substr(1, address.host.size() - 2);
+        }
+        for (char c : address.port) {
+            if (c < '0' || c > '9') {
+                throw std::runtime_error("Invalid port '" + address.port + "' in address '" + text + "'.");
+            }
+        }
+        return address;
+    }
+
+    int listen_on(const Address& address, Address& bound) {
+        bound = address;
+        if (address.kind == Address::Kind::Unix) {
+            sockaddr_un local{};
+            if (!unix_address(address.path, local)) {
+                throw std::runtime_error("Socket path '" + address.path + "' is too long.");
+            }
+            const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            unlink(address.path.c_str());
+            if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+                listen(fd, LISTEN_BACKLOG) != 0) {
+                const int error = errno;
+                if (fd >= 0) {
+                    close(fd);
+                }
+                throw std::runtime_error("Could not listen on " + address.describe() + ": " + std::strerror(error));
+            }
+            return fd;
+        }
+
+        addrinfo* candidates = resolve(address, true);
+        if (candidates == nullptr) {
+            throw std::runtime_error("Could not resolve " + address.describe() + ".");
+        }
+        int fd = -1;
+        int error = 0;
+        for (addrinfo* candidate = candidates; candidate != nullptr && fd < 0; candidate = candidate->ai_next) {
+            fd = socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+            if (fd < 0) {
+                error = errno;
+                continue;
+            }
+            const int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (bind(fd, candidate->ai_addr, candidate->ai_addrlen) != 0 || listen(fd, LISTEN_BACKLOG) != 0) {
+                error = errno;
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(candidates);
+        if (fd < 0) {
+            throw std::runtime_error("Could not listen on " + address.describe() + ": " + std::strerror(error));
+        }
+
+        sockaddr_storage local{};
+        socklen_t length = sizeof(local);
+        char port[NI_MAXSERV];
+        if (getsockname(fd, reinterpret_cast<sockaddr*>(&local), &length) == 0 &&
+            getnameinfo(reinterpret_cast<sockaddr*>(&local), length, nullptr, 0, port, sizeof(port),
+                        NI_NUMERICSERV) == 0) {
+            bound.port = port;
+        }
+        return fd;
+    }
+
+    int connect_to(const Address& address) {
+        if (address.kind == Address::Kind::Unix) {
+            sockaddr_un remote{};
+            if (!unix_address(address.path, remote)) {
+                errno = ENAMETOOLONG;
+                return -1;
+            }
+            const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+                const int error = errno;
+                close(fd);
+                errno = error;
+                return -1;
+            }
+            return fd;
+        }
+
+        addrinfo* candidates = resolve(address, false);
+        if (candidates == nullptr) {
+            errno = EHOSTUNREACH;
+            return -1;
+        }
+        int fd = -1;
+        int error = 0;
+        for (addrinfo* candidate = candidates; candidate != nullptr && fd < 0; candidate = candidate->ai_next) {
+            fd = socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+            if (fd >= 0 && connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+                error = errno;
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(candidates);
+        if (fd < 0) {
+            errno = error;
+            return -1;
+        }
+        tune_tcp(fd);
+        return fd;
+    }
+
+    std::string frame(const std::string& body) {
+        return std::to_string(body.size()) + "\n" + body;
+    }
+
+    FrameStatus take_frame(std::string& buffer, std::string& body) {
+        const std::size_t newline = buffer.find('\n');
+        if (newline == std::string::npos) {
+            return buffer.size() > MAX_LENGTH_DIGITS ? FrameStatus::Malformed : FrameStatus::Incomplete;
+        }
+        if (newline == 0 || newline > MAX_LENGTH_DIGITS) {
+            return FrameStatus::Malformed;
+        }
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < newline; ++i) {
+            if (buffer[i] < '0' || buffer[i] > '9') {
+                return FrameStatus::Malformed;
+            }
+            length = length * 10 + static_cast<std::size_t>(buffer[i] - '0');
+        }
+        if (length > MAX_FRAME_BYTES) {
+            return FrameStatus::Malformed;
+        }
+        if (buffer.size() - newline - 1 < length) {
+            return FrameStatus::Incomplete;
+        }
+        body = buffer.substr(newline + 1, length);
+        buffer.erase(0, newline + 1 + length);
+        return FrameStatus::Complete;
+    }
+
+    std::string encode_hello(const std::string& name, std::size_t slots) {
+        std::string body = "{\"type\": \"hello\", \"name\": ";
+        utils::append_json_string(body, name);
+        body += ", \"slots\": " + std::to_string(slots) + "}";
+        return frame(body);
+    }
+
+    std::string encode_run(std::uint64_t seq, const core::Task& task, std::chrono::milliseconds kill_grace) {
+        std::string body = begin_message("run", seq);
+        body += ", \"id\": ";
+        utils::append_json_string(body, task.id);
+        body += ", \"command\": ";
+        utils::append_json_string(body, task.command);
+        body += ", \"env\": [";
+        for (std::size_t i = 0; i < task.env_vars.size(); ++i) {
+            body += i > 0 ? ", " : "";
+            utils::append_json_string(body, task.env_vars[i]);
+        }
+        body += "], \"timeout\": " + std::to_string(task.timeout_seconds);
+        body += ", \"kill_grace_ms\": " + std::to_string(kill_grace.count()) + "}";
+        return frame(body);
+    }
+
+    std::string encode_cancel(std::uint64_t seq) {
+        return frame(begin_message("cancel", seq) + "}");
+    }
+
+    std::string encode_output(std::uint64_t seq, bool is_stderr, const std::string& data) {
+        std::string body = begin_message("output", seq);
+        body += is_stderr ? ", \"stderr\": true, \"data\": " : ", \"stderr\": false, \"data\": ";
+        utils::append_json_bytes(body, data);
+        body += '}';
+        return frame(body);
+    }
+
+    std::string encode_exit(std::uint64_t seq, const execution::ExitStatus& status) {
+        const execution::ResourceUsage& usage = status.usage;
+        const int code = status.kind == execution::ExitStatus::Kind::Exited ? status.code : -1;
+        const int signal = status.kind == execution::ExitStatus::Kind::Signaled ? status.signal : 0;
+        const int spawn_error = status.kind == execution::ExitStatus::Kind::SpawnFailed ? status.error : 0;
+        std::string body = begin_message("exit", seq);
+        body += ", \"code\": " + std::to_string(code) + ", \"signal\": " + std::to_string(signal) +
+                ", \"spawn_error\": " + std::to_string(spawn_error) +
+                ", \"timed_out\": " + (status.timed_out ? "true" : "false") +
+                ", \"cancelled\": " + (status.cancelled ? "true" : "false") +
+                ", \"wall_seconds\": " + std::to_string(usage.wall_seconds) +
+                ", \"user_seconds\": " + std::to_string(usage.user_seconds) +
+                ", \"system_seconds\": " + std::to_string(usage.system_seconds) +
+                ", \"max_rss_kb\": " + std::to_string(usage.max_rss_kb) +
+                ", \"voluntary_switches\": " + std::to_string(usage.voluntary_switches) +
+                ", \"involuntary_switches\": " + std::to_string(usage.involuntary_switches) +
+                ", \"read_bytes\": " + std::to_string(usage.read_bytes) +
+                ", \"write_bytes\": " + std::to_string(usage.write_bytes) + "}";
+        return frame(body);
+    }
+
+    bool decode_message(const std::string& body, Message& message) {
+        try {
+            const YAML::Node node = YAML::Load(body);
+            if (!node.IsMap() || !node["type"] || !node["type"].IsScalar()) {
+                return false;
+            }
+            message = Message();
+            message.type = node["type"].as<std::string>();
+            read_field(node, "seq", message.seq);
+
+            if (message.type == "hello") {
+                read_field(node, "name", message.name);
+                read_field(node, "slots", message.slots);
+                return message.slots > 0;
+            }
+            if (message.type == "run") {
+                if (!node["id"] || !node["command"]) {
+                    return false;
+                }
+                message.task.id = node["id"].as<std::string>();
+                message.task.command = node["command"].as<std::string>();
+                if (node["env"] && node["env"].IsSequence()) {
+                    for (const auto& env : node["env"]) {
+                        message.task.env_vars.push_back(env.as<std::string>());
+                    }
+                }
+                read_field(node, "timeout", message.task.timeout_seconds);
+                std::int64_t grace_ms = 0;
+                read_field(node, "kill_grace_ms", grace_ms);
+                message.kill_grace = std::chrono::milliseconds(grace_ms);
+                return true;
+            }
+            if (message.type == "output") {
+                read_field(node, "stderr", message.is_stderr);
+                read_field(node, "data", message.data);
+                return true;
+            }
+            if (message.type == "exit") {
+                execution::ExitStatus& status = message.status;
+                int code = 0;
+                int signal = 0;
+                int spawn_error = 0;
+                read_field(node, "code", code);
+                read_field(node, "signal", signal);
+                read_field(node, "spawn_error", spawn_error);
+                if (spawn_error != 0) {
+                    status.kind = execution::ExitStatus::Kind::SpawnFailed;
+                    status.error = spawn_error;
+                } else if (signal != 0) {
+                    status.kind = execution::ExitStatus::Kind::Signaled;
+                    status.signal = signal;
+                } else {
+                    status.code = code;
+                }
+                read_field(node, "timed_out", status.timed_out);
+                read_field(node, "cancelled", status.cancelled);
+                read_field(node, "wall_seconds", status.usage.wall_seconds);
+                read_field(node, "user_seconds", status.usage.user_seconds);
+                read_field(node, "system_seconds", status.usage.system_seconds);
+                read_field(node, "max_rss_kb", status.usage.max_rss_kb);
+                read_field(node, "voluntary_switches", status.usage.voluntary_switches);
+                read_field(node, "involuntary_switches", status.usage.involuntary_switches);
+                read_field(node, "read_bytes", status.usage.read_bytes);
+                read_field(node, "write_bytes", status.usage.write_bytes);
+                return true;
+            }
+            return message.type == "cancel";
+        } catch (const YAML::Exception&) {
+            return false;
+        }
+    }
+
+} // namespace dagra::remote
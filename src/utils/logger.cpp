@@ -0,0 +1,374 @@
+/**
+ * @file logger.cpp
+ * @brief Implements the asynchronous logging backend.
+ * @version 1.1.0
+ *
+ * This file contains the queue and writer thread behind the static Logger
+ * interface. The queue is a bounded multi-producer, single-consumer ring of
+ * sequence-numbered cells: producers claim a cell with one compare-and-swap
+ * and never take a lock, and the writer thread is the only consumer.
+ */
+
+#include "dagra/utils/logger.hpp"
+#include "dagra/utils/json.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace dagra::utils {
+
+    namespace {
+
+        /// @brief The kind of a queued message.
+        enum class Level : std::uint8_t { Info, Success, Warn, Error, DryRun, Output, OutputErr };
+
+        /// @brief A queued message, stamped with the time of the logging call.
+        struct Record {
+            Level level = Level::Info;
+            std::chrono::system_clock::time_point time;
+            std::string message;
+            std::string detail;
+            std::string task;
+        };
+
+        /// @brief Number of queue cells; must be a power of two.
+        constexpr std::size_t QUEUE_CAPACITY = 8192;
+
+        /// @brief Longest time the writer sleeps before re-checking the queue.
+        constexpr std::chrono::milliseconds IDLE_WAIT{100};
+
+        /**
+         * @class Backend
+         * @brief The message queue and the writer thread that drains it.
+         */
+        class Backend {
+        public:
+            Backend() : cells_(new Cell[QUEUE_CAPACITY]) {
+                for (std::size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                writer_ = std::thread([this]() { run(); });
+            }
+
+            ~Backend() {
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    stopping_ = true;
+                }
+                wake_cv_.notify_one();
+                writer_.join();
+            }
+
+            void set_format(Logger::Format format) { format_.store(format, std::memory_order_relaxed); }
+
+            /**
+             * @brief Queues a record.
+             *
+             * If the queue is full, droppable records are counted and
+             * discarded; the others yield until the writer frees a cell.
+             *
+             * @param record The record to queue.
+             * @param droppable Whether the record may be discarded under pressure.
+             */
+            void push(Record&& record, bool droppable) {
+                std::size_t position = tail_.load(std::memory_order_relaxed);
+                Cell* cell = nullptr;
+                while (true) {
+                    cell = &cells_[position & (QUEUE_CAPACITY - 1)];
+                    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                    if (diff == 0) {
+                        if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (diff < 0) {
+                        if (droppable) {
+                            dropped_.fetch_add(1, std::memory_order_relaxed);
+                            return;
+                        }
+                        wake();
+                        std::this_thread::yield();
+                        position = tail_.load(std::memory_order_relaxed);
+                    } else {
+                        position = tail_.load(std::memory_order_relaxed);
+                    }
+                }
+                cell->record = std::move(record);
+                cell->sequence.store(position + 1, std::memory_order_release);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (sleeping_.load(std::memory_order_relaxed)) {
+                    wake();
+                }
+            }
+
+            /// @brief Waits until every cell claimed before the call has been written.
+            void flush() {
+                const std::size_t target = tail_.load(std::memory_order_acquire);
+                wake();
+                std::unique_lock<std::mutex> lock(mtx_);
+                flushed_cv_.wait(lock, [&]() { return written_ >= target; });
+            }
+
+        private:
+            /// @brief A queue cell; `sequence` tells producers and the consumer whose turn it is.
+            struct Cell {
+                std::atomic<std::size_t> sequence{0};
+                Record record;
+            };
+
+            void wake() {
+                std::lock_guard<std::mutex> lock(mtx_);
+                wake_cv_.notify_one();
+            }
+
+            /// @brief Pops the next record, or returns false if the head cell is not yet published.
+            bool pop(Record& record) {
+                Cell& cell = cells_[head_ & (QUEUE_CAPACITY - 1)];
+                if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                    return false;
+                }
+                record = std::move(cell.record);
+                cell.record = Record{};
+                cell.sequence.store(head_ + QUEUE_CAPACITY, std::memory_order_release);
+                ++head_;
+                return true;
+            }
+
+            /// @brief The writer thread: drains the queue in batches until stopped and empty.
+            void run() {
+                Record record;
+                while (true) {
+                    std::size_t batch = 0;
+                    while (pop(record)) {
+                        format(record);
+                        ++batch;
+                    }
+                    if (batch > 0) {
+                        write_pending();
+                        report_dropped();
+                        std::lock_guard<std::mutex> lock(mtx_);
+                        written_ = head_;
+                        flushed_cv_.notify_all();
+                        continue;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mtx_);
+                    written_ = head_;
+                    flushed_cv_.notify_all();
+                    if (stopping_ && tail_.load(std::memory_order_acquire) == head_) {
+                        break;
+                    }
+                    sleeping_.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    const Cell& next = cells_[head_ & (QUEUE_CAPACITY - 1)];
+                    if (next.sequence.load(std::memory_order_acquire) != head_ + 1 && !stopping_) {
+                        wake_cv_.wait_for(lock, IDLE_WAIT);
+                    }
+                    sleeping_.store(false, std::memory_order_relaxed);
+                }
+            }
+
+            /// @brief Appends text for a stream, writing out buffered text for the other stream first.
+            void emit(std::ostream& stream, const std::string& text) {
+                if (pending_stream_ != nullptr && pending_stream_ != &stream) {
+                    write_pending();
+                }
+                pending_stream_ = &stream;
+                pending_ += text;
+            }
+
+            void write_pending() {
+                if (pending_stream_ != nullptr && !pending_.empty()) {
+                    pending_stream_->write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+                    pending_stream_->flush();
+                }
+                pending_.clear();
+                pending_stream_ = nullptr;
+            }
+
+            void report_dropped() {
+                const std::uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+                if (dropped == 0) {
+                    return;
+                }
+                Record warning;
+                warning.level = Level::Warn;
+                warning.time = std::chrono::system_clock::now();
+                warning.message = std::to_string(dropped) + " log messages were dropped because the log queue was full.";
+                format(warning);
+                write_pending();
+            }
+
+            void format(const Record& record) {
+                if (format_.load(std::memory_order_relaxed) == Logger::Format::Json) {
+                    format_json(record);
+                } else {
+                    format_text(record);
+                }
+            }
+
+            void format_text(const Record& record) {
+                std::string text;
+                switch (record.level) {
+                case Level::Info:
+                    text.append("[INFO]    ").append(record.message);
+                    break;
+                case Level::Success:
+                    text.append(colors::GREEN).append("[SUCCESS] ").append(record.message);
+                    break;
+                case Level::Warn:
+                    text.append(colors::YELLOW).append("[WARN]    ").append(record.message);
+                    break;
+                case Level::Error:
+                    text.append(colors::RED).append("[ERROR]   ").append(record.message);
+                    break;
+                case Level::DryRun:
+                    text.append(colors::CYAN).append("[DRY-RUN] ").append(record.message);
+                    break;
+                case Level::Output:
+                case Level::OutputErr:
+                    for_each_line(record.message, [&](std::string_view line) {
+                        text.append("[").append(record.task).append("] ").append(line).append("\n");
+                    });
+                    emit(record.level == Level::OutputErr ? std::cerr : std::cout, text);
+                    return;
+                }
+                text.append(colors::RESET).append("\n");
+                for_each_line(record.detail, [&](std::string_view line) {
+                    text.append("    | ").append(line).append("\n");
+                });
+                emit(record.level == Level::Error ? std::cerr : std::cout, text);
+            }
+
+            void format_json(const Record& record) {
+                static const char* names[] = {"info", "success", "warn", "error", "dry-run", "output", "output"};
+                const std::string timestamp = format_timestamp(record.time);
+                const char* level = names[static_cast<int>(record.level)];
+
+                std::string text;
+                if (record.level == Level::Output || record.level == Level::OutputErr) {
+                    const char* stream = record.level == Level::OutputErr ? "stderr" : "stdout";
+                    for_each_line(record.message, [&](std::string_view line) {
+                        text.append("{\"ts\":\"").append(timestamp).append("\",\"level\":\"output\",\"task\":");
+                        append_json_string(text, record.task);
+                        text.append(",\"stream\":\"").append(stream).append("\",\"line\":");
+                        append_json_string(text, line);
+                        text.append("}\n");
+                    });
+                } else {
+                    text.append("{\"ts\":\"").append(timestamp).append("\",\"level\":\"").append(level);
+                    text.append("\",\"msg\":");
+                    append_json_string(text, record.message);
+                    if (!record.detail.empty()) {
+                        text.append(",\"detail\":");
+                        append_json_string(text, record.detail);
+                    }
+                    text.append("}\n");
+                }
+                emit(std::cout, text);
+            }
+
+            /// @brief Calls `fn` for each line of `text`, without the newline; a missing final newline is tolerated.
+            template <typename Fn>
+            static void for_each_line(const std::string& text, Fn&& fn) {
+                std::size_t start = 0;
+                while (start < text.size()) {
+                    std::size_t end = text.find('\n', start);
+                    if (end == std::string::npos) {
+                        end = text.size();
+                    }
+                    fn(std::string_view(text).substr(start, end - start));
+                    start = end + 1;
+                }
+            }
+
+            std::unique_ptr<Cell[]> cells_;
+            alignas(64) std::atomic<std::size_t> tail_{0};
+            alignas(64) std::size_t head_ = 0;
+            std::atomic<std::uint64_t> dropped_{0};
+            std::atomic<bool> sleeping_{false};
+            std::atomic<Logger::Format> format_{Logger::Format::Text};
+
+            std::mutex mtx_;
+            std::condition_variable wake_cv_;
+            std::condition_variable flushed_cv_;
+            std::size_t written_ = 0;
+            bool stopping_ = false;
+
+            std::string pending_;
+            std::ostream* pending_stream_ = nullptr;
+
+            std::thread writer_;
+        };
+
+        Backend& backend() {
+            static Backend instance;
+            return instance;
+        }
+
+        /// @brief Stamps and queues a record.
+        void log(Level level, const std::string& message, bool droppable) {
+            Record record;
+            record.level = level;
+            record.time = std::chrono::system_clock::now();
+            record.message = message;
+            backend().push(std::move(record), droppable);
+        }
+
+    } // namespace
+
+    void Logger::set_format(Format format) {
+        backend().set_format(format);
+    }
+
+    void Logger::info(const std::string& message) {
+        log(Level::Info, message, true);
+    }
+
+    void Logger::success(const std::string& message) {
+        log(Level::Success, message, false);
+    }
+
+    void Logger::warn(const std::string& message) {
+        log(Level::Warn, message, false);
+    }
+
+    void Logger::error(const std::string& message) {
+        log(Level::Error, message, false);
+    }
+
+    void Logger::error(const std::string& message, const std::string& detail) {
+        Record record;
+        record.level = Level::Error;
+        record.time = std::chrono::system_clock::now();
+        record.message = message;
+        record.detail = detail;
+        backend().push(std::move(record), false);
+    }
+
+    void Logger::dry_run(const std::string& message) {
+        log(Level::DryRun, message, true);
+    }
+
+    void Logger::output(const std::string& task_id, bool is_stderr, std::string lines) {
+        Record record;
+        record.level = is_stderr ? Level::OutputErr : Level::Output;
+        record.time = std::chrono::system_clock::now();
+        record.message = std::move(lines);
+        record.task = task_id;
+        backend().push(std::move(record), false);
+    }
+
+    void Logger::flush() {
+        backend().flush();
+    }
+
+} // namespace dagra::utils
@@ -0,0 +1,119 @@
+/**
+ * @file file_watcher.cpp
+ * @brief Implements the inotify-based watcher for task input files.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the FileWatcher class. Events
+ * are read in large batches and mapped back to watched paths by directory
+ * descriptor and entry name.
+ */
+
+#include "dagra/watch/file_watcher.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace dagra::watch {
+
+    namespace {
+
+        /// @brief Events that mean a file was written, replaced, created or removed.
+        constexpr std::uint32_t WATCH_MASK =
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+        /// @brief Size of the buffer each read drains events into.
+        constexpr std::size_t EVENT_BUFFER_SIZE = 64 * 1024;
+
+    } // namespace
+
+    FileWatcher::FileWatcher() {
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error(std::string("Failed to start watching files: ") + std::strerror(errno));
+        }
+    }
+
+    FileWatcher::~FileWatcher() {
+        close(fd_);
+    }
+
+    /**
+     * @brief Watches a directory path itself, or a file path through its parent directory.
+     */
+    bool FileWatcher::add(const std::string& path) {
+        std::error_code ec;
+        const fs::path absolute = fs::absolute(path, ec).lexically_normal();
+        if (ec) {
+            return false;
+        }
+        const bool is_directory = fs::is_directory(absolute, ec);
+        fs::path directory = is_directory ? absolute : absolute.parent_path();
+        if (directory.empty()) {
+            directory = "/";
+        }
+
+        const int wd = inotify_add_watch(fd_, directory.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            return false;
+        }
+        Directory& entry = directories_[wd];
+        entry.path = directory.string();
+        if (is_directory) {
+            entry.whole.push_back(path);
+        } else {
+            files_[absolute.string()] = path;
+        }
+        return true;
+    }
+
+    int FileWatcher::fd() const {
+        return fd_;
+    }
+
+    std::vector<std::string> FileWatcher::read_changes() {
+        std::vector<std::string> changed;
+        auto report = [&](const std::string& path) {
+            if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+                changed.push_back(path);
+            }
+        };
+
+        alignas(inotify_event) char buffer[EVENT_BUFFER_SIZE];
+        while (true) {
+            const ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            for (ssize_t offset = 0; offset < n;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                auto directory = directories_.find(event->wd);
+                if (directory == directories_.end()) {
+                    continue;
+                }
+                for (const auto& whole : directory->second.whole) {
+                    report(whole);
+                }
+                if (event->len > 0) {
+                    const std::string full = (fs::path(directory->second.path) / event->name).string();
+                    auto file = files_.find(full);
+                    if (file != files_.end()) {
+                        report(file->second);
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+
+} // namespace dagra::watch
@@ -0,0 +1,275 @@
+/**
+ * @file watch_session.cpp
+ * @brief Implements watch mode: incremental re-execution when task inputs change.
+ * @version 1.1.0
+ *
+ * This file contains the implementation for the WatchSession class. The
+ * session thread only waits on descriptors: the inotify descriptor, the
+ * stop descriptor and an eventfd the run thread signals when it is done.
+ * Cancellation is another eventfd handed to the Runner.
+ */
+
+#include "dagra/watch/watch_session.hpp"
+#include "dagra/utils/logger.hpp"
+#include "dagra/watch/file_watcher.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dagra::watch {
+
+    namespace {
+
+        /// @brief Changed paths listed by name before the rest are only counted.
+        constexpr std::size_t MAX_LISTED_CHANGES = 5;
+
+        /// @brief A run of a subgraph on its own thread.
+        struct ActiveRun {
+            std::vector<core::TaskIndex> tasks; ///< Indices in the full graph, ascending.
+            core::Dag graph;
+            int cancel_fd = eventfd(0, EFD_CLOEXEC);
+            int done_fd = eventfd(0, EFD_CLOEXEC);
+            std::thread thread;
+
+            ~ActiveRun() {
+                close(cancel_fd);
+                close(done_fd);
+            }
+        };
+
+        /// @brief Makes an eventfd readable.
+        void signal_event(int fd) {
+            std::uint64_t one = 1;
+            ssize_t ignored = ::write(fd, &one, sizeof(one));
+            (void)ignored;
+        }
+
+        /// @brief The form of a path used to compare inputs with outputs.
+        std::string normalize(const std::string& path) {
+            std::error_code ec;
+            const std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+            return ec ? path : absolute.lexically_normal().string();
+        }
+
+        /// @brief The union of two ascending index lists.
+        std::vector<core::TaskIndex> merge(const std::vector<core::TaskIndex>& a, const std::vector<core::TaskIndex>& b) {
+            std::vector<core::TaskIndex> result;
+            result.reserve(a.size() + b.size());
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+            return result;
+        }
+
+        /// @brief True if two ascending index lists share an element.
+        bool intersects(const std::vector<core::TaskIndex>& a, const std::vector<core::TaskIndex>& b) {
+            auto i = a.begin();
+            auto j = b.begin();
+            while (i != a.end() && j != b.end()) {
+                if (*i == *j) {
+                    return true;
+                }
+                if (*i < *j) {
+                    ++i;
+                } else {
+                    ++j;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Reads file events until none has arrived for `debounce`.
+         * @param files The watcher, with events pending.
+         * @param debounce The quiet period that ends a burst.
+         * @param stop_fd Ends the wait early when readable.
+         * @return The changed paths, each once.
+         */
+        std::vector<std::string> collect_changes(FileWatcher& files, std::chrono::milliseconds debounce, int stop_fd) {
+            std::vector<std::string> changed = files.read_changes();
+            while (true) {
+                pollfd fds[2] = {{files.fd(), POLLIN, 0}, {stop_fd, POLLIN, 0}};
+                const int rc = poll(fds, 2, static_cast<int>(debounce.count()));
+                if (rc < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (rc <= 0 || fds[1].revents != 0) {
+                    return changed;
+                }
+                for (auto& path : files.read_changes()) {
+                    if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+                        changed.push_back(std::move(path));
+                    }
+                }
+            }
+        }
+
+        /// @brief Logs the changed paths, listing at most a few by name.
+        void report_changes(const std::vector<std::string>& changed) {
+            std::string names;
+            for (std::size_t i = 0; i < changed.size() && i < MAX_LISTED_CHANGES; ++i) {
+                names += (i == 0 ? "" : ", ") + changed[i];
+            }
+            if (changed.size() > MAX_LISTED_CHANGES) {
+                names += " and " + std::to_string(changed.size() - MAX_LISTED_CHANGES) + " more";
+            }
+            utils::Logger::info("Changed: " + names);
+        }
+
+    } // namespace
+
+    WatchSession::WatchSession(const core::Dag& dag, const WatchOptions& options) : dag_(dag), options_(options) {}
+
+    /**
+     * @brief Runs the whole graph once, then reruns affected subgraphs as inputs change.
+     *
+     * Only the first run uses the execution cache. Later runs drop the edges
+     * to unaffected tasks, so their cache keys would lack those dependencies'
+     * keys and could not be compared with the keys of a full run.
+     */
+    void WatchSession::run() {
+        std::unordered_set<std::string> produced;
+        for (const auto& task : dag_.get_all_tasks()) {
+            for (const auto& output : task.outputs) {
+                produced.insert(normalize(output));
+            }
+        }
+        std::unordered_map<std::string, std::vector<core::TaskIndex>> readers;
+        for (core::TaskIndex i = 0; i < dag_.size(); ++i) {
+            for (const auto& input : dag_.task(i).inputs) {
+                if (produced.count(normalize(input)) == 0) {
+                    readers[input].push_back(i);
+                }
+            }
+        }
+
+        FileWatcher files;
+        std::size_t watched = 0;
+        for (const auto& [path, tasks] : readers) {
+            if (files.add(path)) {
+                ++watched;
+            } else {
+                utils::Logger::warn("Cannot watch '" + path + "'; changes to it will be missed.");
+            }
+        }
+        if (watched == 0) {
+            throw std::runtime_error("Nothing to watch: no task declares an input that is not produced by another task.");
+        }
+
+        std::vector<core::TaskIndex> pending(dag_.size());
+        std::iota(pending.begin(), pending.end(), 0);
+        std::unique_ptr<ActiveRun> active;
+        bool first = true;
+
+        auto start = [&]() {
+            active = std::make_unique<ActiveRun>();
+            active->tasks = std::move(pending);
+            pending.clear();
+            active->graph = dag_.subgraph(active->tasks, true);
+
+            execution::RunnerOptions runner_options = options_.runner;
+            runner_options.cancel_fd = active->cancel_fd;
+            if (!first) {
+                runner_options.cache_path.clear();
+                utils::Logger::info("Rerunning " + std::to_string(active->tasks.size()) + " of " +
+                                    std::to_string(dag_.size()) + " tasks.");
+            }
+            first = false;
+
+            ActiveRun* run = active.get();
+            run->thread = std::thread([run, runner_options]() {
+                try {
+                    execution::Runner(run->graph, runner_options).execute_all();
+                } catch (const std::exception& e) {
+                    pollfd cancel{run->cancel_fd, POLLIN, 0};
+                    if (poll(&cancel, 1, 0) == 1) {
+                        utils::Logger::info("Run cancelled.");
+                    } else {
+                        utils::Logger::error(std::string("Run did not complete: ") + e.what());
+                    }
+                }
+                signal_event(run->done_fd);
+            });
+        };
+        auto finish = [&](bool cancel) {
+            if (cancel) {
+                signal_event(active->cancel_fd);
+            }
+            active->thread.join();
+            active.reset();
+        };
+        auto announce = [&]() {
+            utils::Logger::info("Watching " + std::to_string(watched) + " input path(s) for changes.");
+        };
+
+        start();
+        while (true) {
+            pollfd fds[3] = {{files.fd(), POLLIN, 0},
+                             {options_.stop_fd, POLLIN, 0},
+                             {active ? active->done_fd : -1, POLLIN, 0}};
+            if (poll(fds, 3, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Failed to wait for file changes.");
+            }
+
+            if (fds[1].revents != 0) {
+                if (active) {
+                    finish(true);
+                }
+                utils::Logger::info("Stopped watching.");
+                return;
+            }
+
+            if (fds[2].revents != 0) {
+                finish(false);
+                if (!pending.empty()) {
+                    start();
+                } else {
+                    announce();
+                }
+                continue;
+            }
+
+            if (fds[0].revents == 0) {
+                continue;
+            }
+            const std::vector<std::string> changed = collect_changes(files, options_.debounce, options_.stop_fd);
+            std::vector<core::TaskIndex> changed_tasks;
+            for (const auto& path : changed) {
+                auto entry = readers.find(path);
+                if (entry != readers.end()) {
+                    changed_tasks.insert(changed_tasks.end(), entry->second.begin(), entry->second.end());
+                }
+            }
+            if (changed_tasks.empty()) {
+                continue;
+            }
+            report_changes(changed);
+
+            std::vector<core::TaskIndex> affected = dag_.dependent_closure(changed_tasks);
+            if (active && intersects(affected, active->tasks)) {
+                utils::Logger::warn("Inputs of the running tasks changed; restarting the run.");
+                affected = merge(affected, active->tasks);
+                finish(true);
+            }
+            pending = merge(pending, affected);
+            if (!active) {
+                start();
+            }
+        }
+    }
+
+} // namespace dagra::watch
@@ -0,0 +1,37 @@
+/**
+ * @file worker_main.cpp
+ * @brief The entry point for the `dagra-worker` agent.
+ * @version 1.1.0
+ *
+ * This file contains the main function of the agent that lets one graph
+ * spread across several hosts. It connects to a coordinator started with
+ * `dagra config.yaml --listen ADDRESS`, announces its slots, and runs the
+ * tasks it is sent until the coordinator goes away.
+ */
+
+#include "dagra/cli/parser.hpp"
+#include "dagra/remote/agent.hpp"
+#include "dagra/utils/logger.hpp"
+#include <exception>
+#include <string>
+
+/**
+ * @brief The main entry point of the agent.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line argument strings.
+ * @return Returns 0 once the agent stops serving, 1 on failure.
+ */
+int main(int argc, char* argv[]) {
+    try {
+        dagra::remote::Agent agent(dagra::cli::Parser::parse_worker_args(argc, argv));
+        agent.serve();
+    } catch (const std::exception& e) {
+        dagra::utils::Logger::error(std::string("Fatal error: ") + e.what());
+        dagra::utils::Logger::flush();
+        return 1;
+    }
+
+    dagra::utils::Logger::flush();
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file analysis_test.cpp
+ * @brief Unit tests for core::analyze_graph and core::reduce_tasks.
+ * @version 1.1.0
+ *
+ * This file contains tests for the level statistics, the weighted critical
+ * path and speedup ceiling, the detection of redundant edges and the
+ * transitive reduction built from them.
+ */
+
+#include "dagra/core/analysis.hpp"
+#include "test_support.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using dagra::core::GraphAnalysis;
+using dagra::core::TaskIndex;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief The IDs of the given tasks.
+    std::vector<std::string> ids(const dagra::core::Dag& dag, const std::vector<TaskIndex>& tasks) {
+        std::vector<std::string> result;
+        for (TaskIndex task : tasks) {
+            result.push_back(dag.task(task).id);
+        }
+        return result;
+    }
+
+} // namespace
+
+/**
+ * @brief Tests depth, widths, the weighted critical path and the speedup ceiling.
+ */
+TEST(AnalysisTest, MeasuresLevelsAndCriticalPath) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("fetch", "cmd"));
+    dag.add_task(make_task("lint", "cmd"));
+    dag.add_task(make_task("compile", "cmd", {"fetch"}));
+    dag.add_task(make_task("docs", "cmd", {"fetch"}));
+    dag.add_task(make_task("test", "cmd", {"compile", "lint"}));
+    dag.validate();
+
+    // docs outweighs compile, but not compile and test together.
+    const GraphAnalysis analysis = dagra::core::analyze_graph(dag, {1.0, 1.0, 4.0, 6.0, 3.0});
+    EXPECT_EQ(analysis.tasks, 5u);
+    EXPECT_EQ(analysis.edges, 4u);
+    EXPECT_EQ(analysis.depth(), 3u);
+    EXPECT_EQ(analysis.level_widths, (std::vector<std::size_t>{2, 2, 1}));
+    EXPECT_EQ(analysis.max_width, 2u);
+    EXPECT_EQ(analysis.widest_level, 0u);
+    EXPECT_DOUBLE_EQ(analysis.total_work, 15.0);
+    EXPECT_DOUBLE_EQ(analysis.critical_path_cost, 8.0);
+    EXPECT_EQ(ids(dag, analysis.critical_path), (std::vector<std::string>{"fetch", "compile", "test"}));
+    EXPECT_TRUE(analysis.redundant_edges.empty());
+
+    EXPECT_DOUBLE_EQ(analysis.speedup_ceiling(1), 1.0);
+    EXPECT_DOUBLE_EQ(analysis.speedup_ceiling(2), 15.0 / 8.0);
+    EXPECT_DOUBLE_EQ(analysis.speedup_ceiling(100), 15.0 / 8.0);
+    EXPECT_DOUBLE_EQ(GraphAnalysis().speedup_ceiling(8), 1.0);
+
+    std::ostringstream out;
+    dagra::core::write_analysis(dag, analysis, 4, 0, out);
+    EXPECT_NE(out.str().find("5 tasks, 4 edges, depth 3"), std::string::npos) << out.str();
+    EXPECT_NE(out.str().find("No redundant edges"), std::string::npos) << out.str();
+}
+
+/**
+ * @brief Tests that implied and repeated dependencies are found and removed.
+ */
+TEST(AnalysisTest, FindsAndRemovesRedundantEdges) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "cmd", {"a"}));
+    dag.add_task(make_task("c", "cmd", {"b"}));
+    dag.add_task(make_task("side", "cmd"));
+    // a is implied through c -> b -> a, and b through c; side is repeated.
+    dag.add_task(make_task("d", "cmd", {"a", "c", "side", "b", "side"}));
+    dag.validate();
+
+    const GraphAnalysis analysis = dagra::core::analyze_graph(dag, std::vector<double>(dag.size(), 1.0));
+    ASSERT_EQ(analysis.redundant_edges.size(), 3u);
+    EXPECT_EQ(dag.task(analysis.redundant_edges[0].dependency).id, "a");
+    EXPECT_EQ(dag.task(analysis.redundant_edges[1].dependency).id, "b");
+    EXPECT_EQ(dag.task(analysis.redundant_edges[2].dependency).id, "side");
+
+    const std::vector<dagra::core::Task> reduced = dagra::core::reduce_tasks(dag, analysis.redundant_edges);
+    ASSERT_EQ(reduced.size(), 5u);
+    EXPECT_EQ(reduced[4].dependencies, (std::vector<std::string>{"c", "side"}));
+    EXPECT_EQ(reduced[2].dependencies, (std::vector<std::string>{"b"}));
+
+    dagra::core::Dag reduced_dag;
+    for (const auto& task : reduced) {
+        reduced_dag.add_task(task);
+    }
+    reduced_dag.validate();
+    EXPECT_TRUE(dagra::core::analyze_graph(reduced_dag, std::vector<double>(5, 1.0)).redundant_edges.empty());
+
+    std::ostringstream out;
+    dagra::core::write_analysis(dag, analysis, 2, 1, out);
+    EXPECT_NE(out.str().find("Redundant edges: 3 of 7"), std::string::npos) << out.str();
+    EXPECT_NE(out.str().find("  d -> a\n  ... 2 more"), std::string::npos) << out.str();
+}
+
+/**
+ * @brief Tests the threaded search on a large lattice against the known answer.
+ */
+TEST(AnalysisTest, FindsRedundantEdgesInLargeGraphs) {
+    // Each task depends on its two predecessors; the edge to i-2 is implied through i-1.
+    const std::size_t count = 100000;
+    dagra::core::Dag dag;
+    dag.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<std::string> dependencies;
+        for (std::size_t back = 1; back <= 2 && back <= i; ++back) {
+            dependencies.push_back("t" + std::to_string(i - back));
+        }
+        dag.add_task(make_task("t" + std::to_string(i), "cmd", dependencies));
+    }
+    dag.validate();
+
+    const GraphAnalysis analysis = dagra::core::analyze_graph(dag, std::vector<double>(count, 1.0));
+    EXPECT_EQ(analysis.depth(), count);
+    EXPECT_EQ(analysis.max_width, 1u);
+    EXPECT_DOUBLE_EQ(analysis.critical_path_cost, static_cast<double>(count));
+    ASSERT_EQ(analysis.redundant_edges.size(), count - 2);
+    for (std::size_t i = 0; i < analysis.redundant_edges.size(); ++i) {
+        EXPECT_EQ(analysis.redundant_edges[i].task, i + 2);
+        EXPECT_EQ(analysis.redundant_edges[i].dependency, i);
+    }
+}
@@ -0,0 +1,191 @@
+/**
+ * @file cache_test.cpp
+ * @brief Unit tests for the cache::ExecutionCache class and cache keys.
+ * @version 1.1.0
+ *
+ * This file contains tests for cache key computation, persistence and mode
+ * of the memory-mapped cache file, and the Runner skipping up-to-date tasks.
+ */
+
+#include "dagra/cache/execution_cache.hpp"
+#include "dagra/core/dag.hpp"
+#include "dagra/execution/runner.hpp"
+#include "dagra/utils/logger.hpp"
+#include "test_support.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+namespace fs = std::filesystem;
+using dagra::test::make_task;
+
+// Test fixture providing a scratch directory for cache files.
+class CacheTest : public ::testing::Test {
+protected:
+    fs::path dir = fs::temp_directory_path() / "dagra_cache_test";
+
+    void SetUp() override {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    void write_file(const fs::path& path, const std::string& contents) {
+        std::ofstream out(path);
+        out << contents;
+    }
+};
+
+/**
+ * @brief Tests that the key depends on input contents and dependency keys.
+ */
+TEST_F(CacheTest, KeyTracksInputsAndDependencies) {
+    fs::path input = dir / "input.txt";
+    write_file(input, "one");
+
+    dagra::core::Task task = make_task("t", "cat input.txt");
+    task.inputs = {input.string()};
+
+    std::uint64_t first = 0, same = 0, changed = 0, other_dep = 0;
+    ASSERT_TRUE(dagra::cache::compute_key(task, {42}, first));
+    ASSERT_TRUE(dagra::cache::compute_key(task, {42}, same));
+    EXPECT_EQ(first, same);
+
+    ASSERT_TRUE(dagra::cache::compute_key(task, {43}, other_dep));
+    EXPECT_NE(first, other_dep);
+
+    write_file(input, "two");
+    ASSERT_TRUE(dagra::cache::compute_key(task, {42}, changed));
+    EXPECT_NE(first, changed);
+
+    task.inputs = {(dir / "missing.txt").string()};
+    EXPECT_FALSE(dagra::cache::compute_key(task, {}, first));
+}
+
+/**
+ * @brief Tests that stored keys survive a save and reopen.
+ */
+TEST_F(CacheTest, PersistsEntries) {
+    std::string path = (dir / "cache.bin").string();
+    {
+        dagra::cache::ExecutionCache cache;
+        cache.open(path);
+        for (int i = 0; i < 100; ++i) {
+            cache.store("task-" + std::to_string(i), static_cast<std::uint64_t>(i) * 7);
+        }
+        cache.save();
+    }
+
+    dagra::cache::ExecutionCache cache;
+    cache.open(path);
+    std::uint64_t key = 0;
+    ASSERT_TRUE(cache.lookup("task-99", key));
+    EXPECT_EQ(key, 99u * 7);
+    EXPECT_FALSE(cache.lookup("task-100", key));
+}
+
+/**
+ * @brief Tests that a saved cache file gets the umask's mode, then keeps the mode it was given.
+ */
+TEST_F(CacheTest, SavedFileKeepsUsualMode) {
+    std::string path = (dir / "cache.bin").string();
+    const mode_t old_mask = umask(027);
+    dagra::cache::ExecutionCache cache;
+    cache.open(path);
+    cache.store("task", 1);
+    cache.save();
+    umask(old_mask);
+    EXPECT_EQ(fs::status(path).permissions(), fs::perms(0640));
+
+    fs::permissions(path, fs::perms(0664));
+    cache.store("task", 2);
+    cache.save();
+    EXPECT_EQ(fs::status(path).permissions(), fs::perms(0664));
+}
+
+/**
+ * @brief Tests that a corrupt cache file is treated as empty.
+ */
+TEST_F(CacheTest, IgnoresCorruptFile) {
+    std::string path = (dir / "cache.bin").string();
+    write_file(path, "not a cache file at all");
+
+    dagra::cache::ExecutionCache cache;
+    cache.open(path);
+    std::uint64_t key = 0;
+    EXPECT_FALSE(cache.lookup("anything", key));
+}
+
+/**
+ * @brief Tests that runs saving to one shared cache file never publish a torn file or leave temporaries.
+ */
+TEST_F(CacheTest, ConcurrentSavesStayReadable) {
+    std::string path = (dir / "cache.bin").string();
+    auto saver = [&path](const std::string& prefix) {
+        dagra::cache::ExecutionCache cache;
+        cache.open(path);
+        for (int i = 0; i < 50; ++i) {
+            for (int j = 0; j < 20; ++j) {
+                cache.store(prefix + std::to_string(i * 20 + j), static_cast<std::uint64_t>(j) + 1);
+            }
+            cache.save();
+        }
+    };
+    std::thread first(saver, "a-");
+    std::thread second(saver, "b-");
+    first.join();
+    second.join();
+
+    // Whichever run saved last published all of its own entries.
+    dagra::cache::ExecutionCache cache;
+    cache.open(path);
+    std::uint64_t key = 0;
+    EXPECT_TRUE(cache.lookup("a-999", key) || cache.lookup("b-999", key));
+    EXPECT_EQ(key, 20u);
+    EXPECT_EQ(std::distance(fs::directory_iterator(dir), fs::directory_iterator()), 1);
+}
+
+/**
+ * @brief Tests that the Runner skips a task whose key and outputs are unchanged.
+ */
+TEST_F(CacheTest, RunnerSkipsUpToDateTask) {
+    fs::path input = dir / "source.txt";
+    fs::path output = dir / "built.txt";
+    write_file(input, "v1");
+
+    dagra::core::Dag dag;
+    dagra::core::Task task = make_task("build", "cp " + input.string() + " " + output.string());
+    task.inputs = {input.string()};
+    task.outputs = {output.string()};
+    dag.add_task(task);
+
+    dagra::execution::RunnerOptions options;
+    options.cache_path = (dir / "cache.bin").string();
+
+    auto run = [&]() {
+        std::stringstream captured;
+        std::streambuf* old_cout = std::cout.rdbuf(captured.rdbuf());
+        dagra::execution::Runner(dag, options).execute_all();
+        dagra::utils::Logger::flush();
+        std::cout.rdbuf(old_cout);
+        return captured.str();
+    };
+
+    EXPECT_NE(run().find("Success: [build]"), std::string::npos);
+    EXPECT_NE(run().find("Cached: [build]"), std::string::npos);
+
+    fs::remove(output);
+    EXPECT_NE(run().find("Success: [build]"), std::string::npos);
+
+    write_file(input, "v2");
+    EXPECT_NE(run().find("Success: [build]"), std::string::npos);
+    EXPECT_NE(run().find("Cached: [build]"), std::string::npos);
+}
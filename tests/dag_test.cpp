@@ -8,14 +8,21 @@
  */
 
 #include "dagra/core/dag.hpp"
+#include "dagra/core/selection.hpp"
+#include "test_support.hpp"
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dagra::test::make_task;
 
 /**
  * @brief Tests that a task can be added to the DAG and retrieved.
  */
 TEST(DagTest, AddAndGetTask) {
     dagra::core::Dag dag;
-    dagra::core::Task task{"task-1", "echo 'test'", {}};
+    dagra::core::Task task = make_task("task-1", "echo 'test'");
     dag.add_task(task);
 
     const auto& retrieved_task = dag.get_task("task-1");
@@ -28,8 +35,8 @@ TEST(DagTest, AddAndGetTask) {
  */
 TEST(DagTest, ValidationSuccess) {
     dagra::core::Dag dag;
-    dag.add_task({"task-1", "cmd", {}});
-    dag.add_task({"task-2", "cmd", {"task-1"}});
+    dag.add_task(make_task("task-1", "cmd"));
+    dag.add_task(make_task("task-2", "cmd", {"task-1"}));
     
     EXPECT_NO_THROW(dag.validate());
 }
@@ -39,7 +46,7 @@ TEST(DagTest, ValidationSuccess) {
  */
 TEST(DagTest, ValidationFailsWithMissingDependency) {
     dagra::core::Dag dag;
-    dag.add_task({"task-1", "cmd", {"nonexistent-task"}});
+    dag.add_task(make_task("task-1", "cmd", {"nonexistent-task"}));
 
     EXPECT_THROW(dag.validate(), std::runtime_error);
 }
@@ -49,8 +56,8 @@ TEST(DagTest, ValidationFailsWithMissingDependency) {
  */
 TEST(DagTest, ValidationFailsWithSimpleCycle) {
     dagra::core::Dag dag;
-    dag.add_task({"task-1", "cmd", {"task-2"}});
-    dag.add_task({"task-2", "cmd", {"task-1"}});
+    dag.add_task(make_task("task-1", "cmd", {"task-2"}));
+    dag.add_task(make_task("task-2", "cmd", {"task-1"}));
 
     EXPECT_THROW(dag.validate(), std::runtime_error);
 }
@@ -60,9 +67,9 @@ TEST(DagTest, ValidationFailsWithSimpleCycle) {
  */
 TEST(DagTest, ValidationFailsWithTransitiveCycle) {
     dagra::core::Dag dag;
-    dag.add_task({"task-1", "cmd", {"task-3"}});
-    dag.add_task({"task-2", "cmd", {"task-1"}});
-    dag.add_task({"task-3", "cmd", {"task-2"}});
+    dag.add_task(make_task("task-1", "cmd", {"task-3"}));
+    dag.add_task(make_task("task-2", "cmd", {"task-1"}));
+    dag.add_task(make_task("task-3", "cmd", {"task-2"}));
 
     EXPECT_THROW(dag.validate(), std::runtime_error);
 }
@@ -74,3 +81,196 @@ TEST(DagTest, GetNonExistentTask) {
     dagra::core::Dag dag;
     EXPECT_THROW(dag.get_task("nonexistent"), std::runtime_error);
 }
+
+/**
+ * @brief Tests that forward and reverse CSR edges are built from the dependency lists.
+ */
+TEST(DagTest, IndexedEdges) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "cmd", {"a"}));
+    dag.add_task(make_task("c", "cmd", {"a", "b"}));
+
+    dagra::core::TaskIndex a, b, c;
+    ASSERT_TRUE(dag.find("a", a));
+    ASSERT_TRUE(dag.find("b", b));
+    ASSERT_TRUE(dag.find("c", c));
+    EXPECT_EQ(dag.task(c).id, "c");
+
+    auto deps = dag.dependencies(c);
+    ASSERT_EQ(deps.size(), 2u);
+    EXPECT_EQ(deps.begin()[0], a);
+    EXPECT_EQ(deps.begin()[1], b);
+
+    auto dependents = dag.dependents(a);
+    ASSERT_EQ(dependents.size(), 2u);
+    EXPECT_EQ(dependents.begin()[0], b);
+    EXPECT_EQ(dependents.begin()[1], c);
+    EXPECT_TRUE(dag.dependents(c).empty());
+}
+
+/**
+ * @brief Tests that re-adding a task overwrites it in place and refreshes the edges.
+ */
+TEST(DagTest, OverwriteKeepsIndex) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "old"));
+    EXPECT_TRUE(dag.dependencies(1).empty());
+
+    dag.add_task(make_task("b", "new", {"a"}));
+    EXPECT_EQ(dag.size(), 2u);
+    EXPECT_EQ(dag.get_task("b").command, "new");
+    EXPECT_EQ(dag.dependencies(1).size(), 1u);
+}
+
+/**
+ * @brief Tests that unresolved dependencies are reported instead of becoming edges.
+ */
+TEST(DagTest, MissingDependenciesListed) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd", {"ghost", "phantom"}));
+
+    EXPECT_TRUE(dag.dependencies(0).empty());
+    const auto& missing = dag.missing_dependencies();
+    ASSERT_EQ(missing.size(), 2u);
+    EXPECT_EQ(missing[0].name, "ghost");
+    EXPECT_EQ(missing[1].name, "phantom");
+}
+
+/**
+ * @brief Tests that ID lookups keep working as the intern table grows.
+ */
+TEST(DagTest, InternTableGrowth) {
+    dagra::core::Dag dag;
+    for (int i = 0; i < 5000; ++i) {
+        dag.add_task(make_task("task-" + std::to_string(i), "cmd"));
+    }
+    EXPECT_EQ(dag.size(), 5000u);
+    for (int i = 0; i < 5000; i += 499) {
+        dagra::core::TaskIndex index;
+        ASSERT_TRUE(dag.find("task-" + std::to_string(i), index));
+        EXPECT_EQ(index, static_cast<dagra::core::TaskIndex>(i));
+    }
+    dagra::core::TaskIndex unused;
+    EXPECT_FALSE(dag.find("task-5000", unused));
+}
+
+/**
+ * @brief Tests that validating a very long linear chain does not recurse.
+ */
+TEST(DagTest, ValidatesLongChainIteratively) {
+    dagra::core::Dag dag;
+    const int length = 200000;
+    dag.reserve(length);
+    dag.add_task(make_task("n0", "cmd"));
+    for (int i = 1; i < length; ++i) {
+        dag.add_task(make_task("n" + std::to_string(i), "cmd", {"n" + std::to_string(i - 1)}));
+    }
+
+    EXPECT_NO_THROW(dag.validate());
+    EXPECT_EQ(dag.topological_order().size(), static_cast<size_t>(length));
+}
+
+/**
+ * @brief Tests that one pass reports every missing dependency and the full path of every cycle.
+ */
+TEST(DagTest, ReportsAllProblems) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd", {"b"}));
+    dag.add_task(make_task("b", "cmd", {"c"}));
+    dag.add_task(make_task("c", "cmd", {"a"}));
+    dag.add_task(make_task("self", "cmd", {"self"}));
+    dag.add_task(make_task("downstream", "cmd", {"a"}));
+    dag.add_task(make_task("x", "cmd", {"ghost-1"}));
+    dag.add_task(make_task("y", "cmd", {"ghost-2"}));
+
+    auto report = dag.check();
+    EXPECT_FALSE(report.ok());
+    ASSERT_EQ(report.missing.size(), 2u);
+    EXPECT_EQ(report.missing[1].name, "ghost-2");
+
+    ASSERT_EQ(report.cycles.size(), 2u);
+    for (const auto& cycle : report.cycles) {
+        ASSERT_GE(cycle.size(), 2u);
+        EXPECT_EQ(cycle.front(), cycle.back());
+        std::string first = dag.task(cycle.front()).id;
+        if (first == "self") {
+            EXPECT_EQ(cycle.size(), 2u);
+        } else {
+            EXPECT_EQ(cycle.size(), 4u);
+            EXPECT_NE(first, "downstream");
+        }
+    }
+    EXPECT_THROW(dag.validate(), std::runtime_error);
+}
+
+/**
+ * @brief Tests that targets, globs and tags select the right tasks and that the closure forms a runnable subgraph.
+ */
+TEST(DagTest, SelectsTargetClosure) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("fetch", "cmd"));
+    dag.add_task(make_task("build:lib", "cmd", {"fetch"}));
+    dag.add_task(make_task("build:app", "cmd", {"build:lib"}));
+    dag.add_task(make_task("test:app", "cmd", {"build:app"}));
+    dag.add_task(make_task("docs", "cmd", {"fetch"}));
+    dagra::core::Task lint = make_task("lint", "cmd");
+    lint.tags = {"nightly"};
+    dag.add_task(lint);
+    dag.validate();
+
+    auto ids = [](const dagra::core::Dag& graph, const std::vector<dagra::core::TaskIndex>& indices) {
+        std::vector<std::string> names;
+        for (dagra::core::TaskIndex i : indices) {
+            names.push_back(graph.task(i).id);
+        }
+        return names;
+    };
+
+    auto targets = dagra::core::select_targets(dag, {"build:app", "build:*"}, {"nightly"});
+    EXPECT_EQ(ids(dag, targets), (std::vector<std::string>{"build:lib", "build:app", "lint"}));
+
+    auto closure = dag.dependency_closure(dagra::core::select_targets(dag, {"test:app"}, {}));
+    EXPECT_EQ(ids(dag, closure), (std::vector<std::string>{"fetch", "build:lib", "build:app", "test:app"}));
+
+    dagra::core::Dag sub = dag.subgraph(closure);
+    ASSERT_EQ(sub.size(), 4u);
+    EXPECT_TRUE(sub.check().ok());
+    dagra::core::TaskIndex fetch;
+    ASSERT_TRUE(sub.find("fetch", fetch));
+    EXPECT_EQ(sub.dependents(fetch).size(), 1u);
+    EXPECT_EQ(sub.topological_order().size(), 4u);
+
+    EXPECT_THROW(dagra::core::select_targets(dag, {"deploy"}, {}), std::runtime_error);
+    EXPECT_THROW(dagra::core::select_targets(dag, {"deploy:*"}, {}), std::runtime_error);
+    EXPECT_THROW(dagra::core::select_targets(dag, {}, {"weekly"}), std::runtime_error);
+    EXPECT_THROW(dag.subgraph({3}), std::runtime_error);
+}
+
+/**
+ * @brief Tests that the dependent closure follows reverse edges and that external edges can be dropped.
+ */
+TEST(DagTest, SelectsDependentClosure) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("gen", "cmd"));
+    dag.add_task(make_task("lib", "cmd", {"gen"}));
+    dag.add_task(make_task("app", "cmd", {"lib"}));
+    dag.add_task(make_task("docs", "cmd"));
+    dag.add_task(make_task("site", "cmd", {"docs", "app"}));
+    dag.validate();
+
+    auto closure = dag.dependent_closure({1});
+    EXPECT_EQ(closure, (std::vector<dagra::core::TaskIndex>{1, 2, 4}));
+    EXPECT_EQ(dag.dependent_closure({3, 0}), (std::vector<dagra::core::TaskIndex>{0, 1, 2, 3, 4}));
+
+    EXPECT_THROW(dag.subgraph(closure), std::runtime_error);
+    dagra::core::Dag sub = dag.subgraph(closure, true);
+    ASSERT_EQ(sub.size(), 3u);
+    EXPECT_TRUE(sub.check().ok());
+    dagra::core::TaskIndex site;
+    ASSERT_TRUE(sub.find("site", site));
+    ASSERT_EQ(sub.dependencies(site).size(), 1u);
+    EXPECT_EQ(sub.task(*sub.dependencies(site).begin()).id, "app");
+    EXPECT_EQ(sub.topological_order().size(), 3u);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file echo_worker.cpp
+ * @brief A trivial persistent worker used by the worker tests.
+ * @version 1.1.0
+ *
+ * This program speaks the worker protocol described in `worker_pool.hpp`:
+ * it reads length-prefixed JSON requests from stdin and answers each one on
+ * stdout until stdin is closed. The reply echoes the request's command as
+ * its output, except for a few commands that exercise the runner:
+ *
+ * - `pid` replies with the worker's process ID, to observe reuse.
+ * - `exit N` replies with exit code N and no output.
+ * - `crash` exits without replying.
+ * - `sleep N` waits N milliseconds before echoing.
+ */
+
+#include "dagra/utils/json.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+
+namespace {
+
+    /// @brief Writes one framed reply to stdout.
+    void reply(int exit_code, const std::string& output) {
+        std::string body = "{\"exit_code\": " + std::to_string(exit_code) + ", \"output\": ";
+        dagra::utils::append_json_string(body, output);
+        body += '}';
+        std::cout << body.size() << '\n' << body << std::flush;
+    }
+
+} // namespace
+
+/**
+ * @brief Serves requests until stdin is closed.
+ * @return 0 on end of input, 1 on a malformed request or a `crash` request.
+ */
+int main() {
+    std::string length_line;
+    while (std::getline(std::cin, length_line)) {
+        std::string body(std::stoul(length_line), '\0');
+        if (!std::cin.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+            return 1;
+        }
+        const std::string command = YAML::Load(body)["command"].as<std::string>();
+
+        if (command == "pid") {
+            reply(0, std::to_string(getpid()) + "\n");
+        } else if (command.rfind("exit ", 0) == 0) {
+            reply(std::stoi(command.substr(5)), "");
+        } else if (command == "crash") {
+            return 1;
+        } else {
+            if (command.rfind("sleep ", 0) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::stoi(command.substr(6))));
+            }
+            reply(0, command + "\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file event_loop_test.cpp
+ * @brief Unit tests for the execution::EventLoop class.
+ * @version 1.1.0
+ *
+ * This file contains tests that wait for a thousand concurrent children on
+ * one thread, and tests for deadlines, the SIGKILL escalation, cancellation
+ * and callbacks posted from other threads.
+ */
+
+#include "dagra/execution/event_loop.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <csignal>
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using dagra::execution::EventLoop;
+using dagra::execution::ExitStatus;
+using dagra::execution::Process;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief Starts a command as if it were a task.
+    Process start(const std::string& command) {
+        return Process::spawn(make_task("child", command));
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that a thousand sleeping children overlap instead of waiting for each other.
+ */
+TEST(EventLoopTest, WaitsForManyChildren) {
+    ASSERT_GE(dagra::execution::raise_descriptor_limit(), 1100u);
+    constexpr int CHILDREN = 1000;
+
+    EventLoop loop(std::chrono::milliseconds(100));
+    std::vector<int> codes;
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < CHILDREN; ++i) {
+        loop.watch(start(i % 10 == 0 ? "sh -c 'sleep 0.5; exit 4'" : "sleep 0.5"), std::chrono::milliseconds(0),
+                   [&codes](ExitStatus status) { codes.push_back(status.code); });
+    }
+    EXPECT_EQ(loop.watched(), static_cast<std::size_t>(CHILDREN));
+    while (loop.watched() > 0) {
+        loop.run_once();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    ASSERT_EQ(codes.size(), static_cast<std::size_t>(CHILDREN));
+    int failed = 0;
+    for (int code : codes) {
+        failed += code == 4 ? 1 : 0;
+    }
+    EXPECT_EQ(failed, CHILDREN / 10);
+    EXPECT_LT(elapsed.count(), 20.0);
+}
+
+/**
+ * @brief Tests that a deadline sends SIGTERM and that a group ignoring it receives SIGKILL after the grace.
+ */
+TEST(EventLoopTest, EnforcesDeadlines) {
+    EventLoop loop(std::chrono::milliseconds(200));
+    std::vector<ExitStatus> statuses(3);
+    loop.watch(start("sleep 5"), std::chrono::milliseconds(100), [&](ExitStatus status) { statuses[0] = status; });
+    loop.watch(start("trap '' TERM; sleep 5"), std::chrono::milliseconds(100),
+               [&](ExitStatus status) { statuses[1] = status; });
+    loop.watch(start("true"), std::chrono::milliseconds(100), [&](ExitStatus status) { statuses[2] = status; });
+
+    const auto started = std::chrono::steady_clock::now();
+    while (loop.watched() > 0) {
+        loop.run_once();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(3));
+
+    EXPECT_TRUE(statuses[0].timed_out);
+    EXPECT_EQ(statuses[0].signal, SIGTERM);
+    EXPECT_TRUE(statuses[1].timed_out);
+    EXPECT_EQ(statuses[1].signal, SIGKILL);
+    EXPECT_TRUE(statuses[2].success());
+    EXPECT_FALSE(statuses[2].timed_out);
+
+    bool reported = false;
+    loop.watch(start("this-command-does-not-exist"), std::chrono::milliseconds(0), [&](ExitStatus status) {
+        reported = status.kind == ExitStatus::Kind::SpawnFailed;
+    });
+    loop.run_once();
+    EXPECT_TRUE(reported);
+}
+
+/**
+ * @brief Tests that the cancel descriptor terminates every child and that other threads can post callbacks.
+ */
+TEST(EventLoopTest, CancelsChildrenAndRunsPostedCallbacks) {
+    const int cancel_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ASSERT_GE(cancel_fd, 0);
+    EventLoop loop(std::chrono::milliseconds(100), cancel_fd);
+
+    int cancelled = 0;
+    for (int i = 0; i < 4; ++i) {
+        loop.watch(start("sleep 5"), std::chrono::milliseconds(0),
+                   [&](ExitStatus status) { cancelled += status.cancelled ? 1 : 0; });
+    }
+
+    bool posted = false;
+    std::thread poster([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        loop.post([&posted]() { posted = true; });
+        std::uint64_t one = 1;
+        ssize_t ignored = write(cancel_fd, &one, sizeof(one));
+        (void)ignored;
+    });
+    while (!posted) {
+        loop.run_once();
+    }
+    poster.join();
+
+    const auto started = std::chrono::steady_clock::now();
+    while (loop.watched() > 0) {
+        loop.run_once();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(2));
+    EXPECT_EQ(cancelled, 4);
+
+    // A process watched after cancellation is terminated at once.
+    ExitStatus late;
+    loop.watch(start("sleep 5"), std::chrono::milliseconds(0), [&](ExitStatus status) { late = status; });
+    loop.run_once();
+    EXPECT_TRUE(late.cancelled);
+    close(cancel_fd);
+}
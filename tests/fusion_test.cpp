@@ -0,0 +1,93 @@
+/**
+ * @file fusion_test.cpp
+ * @brief Unit tests for core::fuse_tasks.
+ * @version 1.1.0
+ *
+ * This file contains tests for grouping linear chains and batchable
+ * siblings, and for the graph of groups built from them.
+ */
+
+#include "dagra/core/fusion.hpp"
+#include "test_support.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using dagra::core::FusionKind;
+using dagra::core::TaskIndex;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief Adds a batchable task.
+    void add_batchable(dagra::core::Dag& dag, const std::string& id, std::vector<std::string> dependencies) {
+        dagra::core::Task task = make_task(id, "echo " + id, std::move(dependencies));
+        task.batchable = true;
+        dag.add_task(task);
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that a chain collapses into one group and that a branch point ends it.
+ */
+TEST(FusionTest, FusesLinearChains) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("fetch", "cmd"));
+    dag.add_task(make_task("gen", "cmd", {"fetch"}));
+    dag.add_task(make_task("compile", "cmd", {"gen"}));
+    dag.add_task(make_task("test", "cmd", {"compile"}));
+    dag.add_task(make_task("package", "cmd", {"compile"}));
+    dagra::core::Task slow = make_task("deploy", "cmd", {"package"});
+    slow.timeout_seconds = 60;
+    dag.add_task(slow);
+    dag.validate();
+
+    dagra::core::FusedGraph fused = dagra::core::fuse_tasks(dag, {});
+    ASSERT_EQ(fused.graph.size(), 4u);
+    EXPECT_EQ(fused.members[0], (std::vector<TaskIndex>{0, 1, 2}));
+    EXPECT_EQ(fused.kinds[0], FusionKind::Chain);
+    EXPECT_EQ(fused.graph.task(0).id, "fetch..compile");
+    EXPECT_EQ(fused.graph.task(0).command, "cmd && cmd && cmd");
+    EXPECT_EQ(fused.kinds[3], FusionKind::Single);
+    EXPECT_EQ(fused.graph.task(3).id, "deploy");
+
+    TaskIndex test;
+    ASSERT_TRUE(fused.graph.find("test", test));
+    ASSERT_EQ(fused.graph.dependencies(test).size(), 1u);
+    EXPECT_EQ(*fused.graph.dependencies(test).begin(), 0u);
+    EXPECT_EQ(fused.graph.task(test).dependencies, (std::vector<std::string>{"fetch..compile"}));
+    EXPECT_TRUE(fused.graph.check().ok());
+    EXPECT_EQ(fused.graph.topological_order().size(), 4u);
+}
+
+/**
+ * @brief Tests that batchable siblings with equal dependencies are grouped up to the size limit.
+ */
+TEST(FusionTest, BatchesSiblings) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("root", "cmd"));
+    dag.add_task(make_task("other", "cmd"));
+    for (int i = 0; i < 5; ++i) {
+        add_batchable(dag, "gen-" + std::to_string(i), {"root", "other"});
+    }
+    add_batchable(dag, "gen-late", {"other", "root"});
+    add_batchable(dag, "lone", {"root"});
+    dag.add_task(make_task("all", "cmd", {"gen-0", "gen-1", "gen-2", "gen-3", "gen-4", "gen-late", "lone"}));
+    dag.validate();
+
+    dagra::core::FusionOptions options;
+    options.max_group = 4;
+    dagra::core::FusedGraph fused = dagra::core::fuse_tasks(dag, options);
+
+    // root, other, two batches of gen-*, lone, all.
+    ASSERT_EQ(fused.graph.size(), 6u);
+    EXPECT_EQ(fused.members[2], (std::vector<TaskIndex>{2, 3, 4, 5}));
+    EXPECT_EQ(fused.kinds[2], FusionKind::Batch);
+    EXPECT_EQ(fused.members[3], (std::vector<TaskIndex>{6, 7}));
+    EXPECT_EQ(fused.kinds[4], FusionKind::Single);
+    EXPECT_EQ(fused.graph.task(2).command, "echo gen-0; echo gen-1; echo gen-2; echo gen-3");
+    EXPECT_EQ(fused.graph.dependencies(2).size(), 2u);
+    EXPECT_EQ(fused.graph.dependencies(5).size(), 3u);
+    EXPECT_TRUE(fused.graph.check().ok());
+}
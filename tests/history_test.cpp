@@ -0,0 +1,95 @@
+/**
+ * @file history_test.cpp
+ * @brief Unit tests for the history::History class and the report.
+ * @version 1.1.0
+ *
+ * This file contains tests for persisting task runs, the moving average
+ * used by the scheduler, and the ranking and regression check of
+ * `dagra report`.
+ */
+
+#include "dagra/history/history.hpp"
+#include "dagra/history/report.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+using dagra::history::History;
+using dagra::history::RunSample;
+
+namespace {
+
+    /// @brief Builds a sample with the given wall time, CPU time and peak memory.
+    RunSample sample(double wall, double cpu, std::int64_t rss_kb) {
+        RunSample s;
+        s.timestamp = 1700000000;
+        s.wall_seconds = wall;
+        s.user_seconds = cpu;
+        s.max_rss_kb = rss_kb;
+        s.read_bytes = 4096;
+        return s;
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that runs survive a save/load round trip and old runs are dropped.
+ */
+TEST(HistoryTest, PersistsAndCapsRuns) {
+    fs::path path = fs::temp_directory_path() / "dagra_history_test" / "history.tsv";
+    fs::remove_all(path.parent_path());
+
+    History history;
+    history.load(path.string());
+    for (std::size_t i = 0; i < History::MAX_SAMPLES + 5; ++i) {
+        history.record("build", sample(2.0, 1.5, 1000));
+    }
+    history.record("test", sample(1.0, 0.5, 200));
+    history.record("test", sample(3.0, 0.5, 200));
+    const mode_t old_mask = umask(022);
+    history.save();
+    umask(old_mask);
+    // The save goes through a uniquely named temporary that is renamed into place, with the usual mode.
+    EXPECT_EQ(std::distance(fs::directory_iterator(path.parent_path()), fs::directory_iterator()), 1);
+    EXPECT_EQ(fs::status(path).permissions(), fs::perms(0644));
+
+    History loaded;
+    loaded.load(path.string());
+    ASSERT_EQ(loaded.size(), 2);
+    ASSERT_NE(loaded.find("build"), nullptr);
+    EXPECT_EQ(loaded.find("build")->samples.size(), History::MAX_SAMPLES);
+    EXPECT_EQ(loaded.find("test")->samples.back().read_bytes, 4096);
+    EXPECT_DOUBLE_EQ(loaded.find("test")->duration_seconds, 2.0);
+    EXPECT_EQ(loaded.find("missing"), nullptr);
+
+    fs::remove_all(path.parent_path());
+}
+
+/**
+ * @brief Tests that the report ranks by the chosen metric and flags regressions.
+ */
+TEST(HistoryTest, ReportRanksAndFlagsRegressions) {
+    History history;
+    history.record("steady", sample(5.0, 1.0, 100));
+    history.record("steady", sample(5.0, 1.0, 100));
+    history.record("slower", sample(1.0, 4.0, 100));
+    history.record("slower", sample(1.0, 4.0, 100));
+    history.record("slower", sample(2.0, 4.0, 100));
+
+    auto regressions = dagra::history::find_regressions(history, 0.25);
+    ASSERT_EQ(regressions.size(), 1);
+    EXPECT_EQ(regressions[0].task, "slower");
+    EXPECT_EQ(regressions[0].metric, "wall");
+    EXPECT_DOUBLE_EQ(regressions[0].before, 1.0);
+
+    dagra::history::ReportOptions options;
+    options.sort = dagra::history::SortKey::Cpu;
+    std::ostringstream out;
+    dagra::history::write_report(history, options, out);
+    const std::string report = out.str();
+    EXPECT_LT(report.find("slower"), report.find("steady"));
+    EXPECT_NE(report.find("Regressions"), std::string::npos);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file journal_test.cpp
+ * @brief Unit tests for the cache::RunJournal class.
+ * @version 1.1.0
+ *
+ * This file contains tests for the journal keys, for appending and replaying
+ * completed tasks, and for recovery from a journal cut off by a crash.
+ */
+
+#include "dagra/cache/journal.hpp"
+#include "test_support.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+using dagra::test::make_task;
+
+// Test fixture providing a scratch directory
+class JournalTest : public ::testing::Test {
+protected:
+    fs::path dir = fs::temp_directory_path() / "dagra_journal_test";
+    std::string path = (dir / "config.yaml.journal").string();
+
+    void SetUp() override {
+        fs::remove_all(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+};
+
+/**
+ * @brief Tests that editing a task changes its key and its dependents' keys only.
+ */
+TEST_F(JournalTest, KeysCoverDefinitionAndDependencies) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("fetch", "git pull"));
+    dag.add_task(make_task("build", "make", {"fetch"}));
+    dag.add_task(make_task("docs", "doxygen"));
+    dag.validate();
+    const auto keys = dagra::cache::compute_journal_keys(dag);
+
+    dagra::core::Dag edited;
+    dagra::core::Task fetch = make_task("fetch", "git pull");
+    fetch.env_vars = {"GIT_DEPTH=1"};
+    edited.add_task(fetch);
+    edited.add_task(make_task("build", "make", {"fetch"}));
+    edited.add_task(make_task("docs", "doxygen"));
+    edited.validate();
+    const auto edited_keys = dagra::cache::compute_journal_keys(edited);
+
+    EXPECT_NE(edited_keys[0], keys[0]);
+    EXPECT_NE(edited_keys[1], keys[1]);
+    EXPECT_EQ(edited_keys[2], keys[2]);
+}
+
+/**
+ * @brief Tests that appended tasks are replayed, and that a fresh open discards them.
+ */
+TEST_F(JournalTest, AppendAndReplay) {
+    {
+        dagra::cache::RunJournal journal;
+        journal.open(path);
+        for (int i = 0; i < 1000; ++i) {
+            journal.append("task-" + std::to_string(i), static_cast<std::uint64_t>(i) * 7);
+        }
+        journal.close();
+        EXPECT_GE(journal.batches(), 1u);
+        EXPECT_LE(journal.batches(), 1000u);
+    }
+
+    dagra::cache::RunJournal resumed;
+    resumed.load(path);
+    EXPECT_EQ(resumed.loaded(), 1000u);
+    EXPECT_TRUE(resumed.contains("task-10", 70));
+    EXPECT_FALSE(resumed.contains("task-10", 71));
+    EXPECT_FALSE(resumed.contains("task-1000", 7000));
+
+    // Appending after a load keeps the earlier records.
+    resumed.open(path);
+    resumed.append("late", 1);
+    resumed.close();
+    dagra::cache::RunJournal reloaded;
+    reloaded.load(path);
+    EXPECT_EQ(reloaded.loaded(), 1001u);
+
+    // Opening without loading starts a new run.
+    dagra::cache::RunJournal fresh;
+    fresh.open(path);
+    fresh.close();
+    reloaded.load(path);
+    EXPECT_EQ(reloaded.loaded(), 0u);
+}
+
+/**
+ * @brief Tests that a torn last record is ignored and cut off before appending.
+ */
+TEST_F(JournalTest, RecoversFromTornTail) {
+    {
+        dagra::cache::RunJournal journal;
+        journal.open(path);
+        journal.append("a", 1);
+        journal.append("b", 2);
+    }
+    const auto intact = fs::file_size(path);
+    fs::resize_file(path, intact - 5);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "garbage";
+    }
+
+    dagra::cache::RunJournal journal;
+    journal.load(path);
+    EXPECT_EQ(journal.loaded(), 1u);
+    EXPECT_TRUE(journal.contains("a", 1));
+    EXPECT_FALSE(journal.contains("b", 2));
+
+    journal.open(path);
+    journal.append("c", 3);
+    journal.close();
+    EXPECT_EQ(fs::file_size(path), intact);
+
+    dagra::cache::RunJournal reloaded;
+    reloaded.load(path);
+    EXPECT_TRUE(reloaded.contains("a", 1));
+    EXPECT_TRUE(reloaded.contains("c", 3));
+}
@@ -0,0 +1,140 @@
+/**
+ * @file logger_test.cpp
+ * @brief Unit tests for the asynchronous utils::Logger.
+ * @version 1.1.0
+ *
+ * This file contains tests for message ordering and completeness under
+ * concurrent logging, and for the JSON output format and its escaping.
+ */
+
+#include "dagra/utils/logger.hpp"
+#include "dagra/utils/json.hpp"
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test fixture capturing everything the logger writes.
+class LoggerTest : public ::testing::Test {
+protected:
+    std::stringstream captured;
+    std::streambuf* old_cout = nullptr;
+    std::streambuf* old_cerr = nullptr;
+
+    void SetUp() override {
+        dagra::utils::Logger::flush();
+        old_cout = std::cout.rdbuf(captured.rdbuf());
+        old_cerr = std::cerr.rdbuf(captured.rdbuf());
+    }
+
+    void TearDown() override {
+        dagra::utils::Logger::flush();
+        dagra::utils::Logger::set_format(dagra::utils::Logger::Format::Text);
+        std::cout.rdbuf(old_cout);
+        std::cerr.rdbuf(old_cerr);
+    }
+};
+
+/**
+ * @brief Tests that no warning is lost or torn when many threads overrun the queue.
+ */
+TEST_F(LoggerTest, ConcurrentMessagesAreCompleteAndOrderedPerThread) {
+    constexpr int threads = 8;
+    constexpr int per_thread = 2000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                dagra::utils::Logger::warn("t" + std::to_string(t) + " m" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    dagra::utils::Logger::flush();
+
+    std::vector<int> next(threads, 0);
+    std::string line;
+    int lines = 0;
+    while (std::getline(captured, line)) {
+        std::size_t t_pos = line.find("[WARN]    t");
+        ASSERT_NE(t_pos, std::string::npos) << line;
+        int t = std::stoi(line.substr(t_pos + 11));
+        int i = std::stoi(line.substr(line.find(" m") + 2));
+        EXPECT_EQ(i, next[t]++);
+        ++lines;
+    }
+    EXPECT_EQ(lines, threads * per_thread);
+}
+
+/**
+ * @brief Tests that task completions are not dropped when the queue overflows.
+ */
+TEST_F(LoggerTest, SuccessMessagesAreNeverDropped) {
+    constexpr int threads = 8;
+    constexpr int per_thread = 4000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([]() {
+            for (int i = 0; i < per_thread; ++i) {
+                dagra::utils::Logger::success("done");
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    dagra::utils::Logger::flush();
+
+    const std::string text = captured.str();
+    EXPECT_EQ(text.find("dropped"), std::string::npos);
+    int lines = 0;
+    for (std::size_t pos = text.find("[SUCCESS] done"); pos != std::string::npos;
+         pos = text.find("[SUCCESS] done", pos + 1)) {
+        ++lines;
+    }
+    EXPECT_EQ(lines, threads * per_thread);
+}
+
+/**
+ * @brief Tests the JSON format, including escaping and task output events.
+ */
+TEST_F(LoggerTest, JsonFormat) {
+    dagra::utils::Logger::set_format(dagra::utils::Logger::Format::Json);
+    dagra::utils::Logger::info("say \"hi\"\tnow");
+    dagra::utils::Logger::output("build", true, "line one\nline two\n");
+    dagra::utils::Logger::error("Failed", "tail\n");
+    dagra::utils::Logger::flush();
+
+    const std::string text = captured.str();
+    EXPECT_NE(text.find("\"level\":\"info\",\"msg\":\"say \\\"hi\\\"\\tnow\"}"), std::string::npos);
+    EXPECT_NE(text.find("\"task\":\"build\",\"stream\":\"stderr\",\"line\":\"line two\"}"), std::string::npos);
+    EXPECT_NE(text.find("\"msg\":\"Failed\",\"detail\":\"tail\\n\"}"), std::string::npos);
+    EXPECT_EQ(text.rfind("{\"ts\":\"", 0), 0u);
+    EXPECT_EQ(text.find("\033["), std::string::npos);
+}
+
+/**
+ * @brief Tests escaping of control characters.
+ */
+TEST(JsonTest, EscapesControlCharacters) {
+    std::string out;
+    dagra::utils::append_json_string(out, std::string("a\x01\\b", 4));
+    EXPECT_EQ(out, "\"a\\u0001\\\\b\"");
+}
+
+/**
+ * @brief Tests that valid UTF-8 is kept and every invalid byte becomes U+FFFD.
+ */
+TEST(JsonTest, ReplacesInvalidUtf8) {
+    std::string out;
+    dagra::utils::append_json_string(out, "caf\xC3\xA9 \xF0\x9F\x98\x80 \xFF\xC3 \xED\xA0\x80");
+    EXPECT_EQ(out, "\"caf\xC3\xA9 \xF0\x9F\x98\x80 \\ufffd\\ufffd \\ufffd\\ufffd\\ufffd\"");
+
+    out.clear();
+    dagra::utils::append_json_bytes(out, "\xFF\"");
+    EXPECT_EQ(out, "\"\xFF\\\"\"");
+}
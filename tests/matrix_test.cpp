@@ -0,0 +1,116 @@
+/**
+ * @file matrix_test.cpp
+ * @brief Unit tests for core::expand_matrix and core::parse_matrix_range.
+ * @version 1.1.0
+ *
+ * This file contains tests for the order and content of expanded tasks,
+ * the growth of the task list across many matrices, the handling of braces
+ * that are not placeholders, and the rejection of malformed matrices.
+ */
+
+#include "dagra/core/matrix.hpp"
+#include "test_support.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dagra::core::MatrixAxis;
+using dagra::core::Task;
+using dagra::test::make_task;
+
+/**
+ * @brief Tests that every templated field is substituted, the last axis varying fastest.
+ */
+TEST(MatrixTest, ExpandsEveryCombination) {
+    Task prototype = make_task("test:{os}:{shard}", "run --os {os} --shard {shard}", {"build:{os}", "fetch"});
+    prototype.worker = "runner-{os}";
+    prototype.env_vars = {"SHARD={shard}"};
+    prototype.inputs = {"src/{os}/**"};
+    prototype.outputs = {"out/{os}/{shard}.xml"};
+    prototype.tags = {"ci", "{os}"};
+    prototype.timeout_seconds = 30;
+    prototype.resources = {{"cpu", 2.0}};
+
+    std::vector<Task> tasks{make_task("fetch", "git fetch")};
+    dagra::core::expand_matrix(prototype, {{"os", {"linux", "mac"}}, {"shard", {"0", "1", "2"}}}, tasks);
+    ASSERT_EQ(tasks.size(), 7u);
+    EXPECT_EQ(tasks[0].id, "fetch");
+    const std::vector<std::string> ids = {"test:linux:0", "test:linux:1", "test:linux:2",
+                                          "test:mac:0",   "test:mac:1",   "test:mac:2"};
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(tasks[i + 1].id, ids[i]);
+    }
+
+    const Task& task = tasks[5];
+    EXPECT_EQ(task.command, "run --os mac --shard 1");
+    EXPECT_EQ(task.dependencies, (std::vector<std::string>{"build:mac", "fetch"}));
+    EXPECT_EQ(task.worker, "runner-mac");
+    EXPECT_EQ(task.env_vars, (std::vector<std::string>{"SHARD=1"}));
+    EXPECT_EQ(task.inputs, (std::vector<std::string>{"src/mac/**"}));
+    EXPECT_EQ(task.outputs, (std::vector<std::string>{"out/mac/1.xml"}));
+    EXPECT_EQ(task.tags, (std::vector<std::string>{"ci", "mac"}));
+    EXPECT_EQ(task.timeout_seconds, 30);
+    EXPECT_DOUBLE_EQ(task.resources.at("cpu"), 2.0);
+}
+
+/**
+ * @brief Tests that expanding many small matrices into one list keeps the list's geometric growth.
+ *
+ * Reserving room for exactly each matrix would reallocate the whole list on
+ * every call and make loading quadratic in the number of matrix tasks.
+ */
+TEST(MatrixTest, ManySmallMatricesGrowGeometrically) {
+    constexpr int MATRICES = 20000;
+    std::vector<Task> tasks;
+    std::size_t reallocations = 0;
+    for (int i = 0; i < MATRICES; ++i) {
+        Task prototype;
+        prototype.id = "shard-" + std::to_string(i) + "-{n}";
+        prototype.command = "run {n}";
+        const Task* before = tasks.data();
+        dagra::core::expand_matrix(prototype, {{"n", {"0", "1"}}}, tasks);
+        reallocations += tasks.data() != before ? 1 : 0;
+    }
+    ASSERT_EQ(tasks.size(), 2u * MATRICES);
+    EXPECT_EQ(tasks.back().id, "shard-19999-1");
+    EXPECT_LT(reallocations, 64u);
+}
+
+/**
+ * @brief Tests that braces which do not name an axis are left alone.
+ */
+TEST(MatrixTest, KeepsOtherBraces) {
+    Task prototype = make_task("job-{n}", "echo ${HOME} {n} {other} {n}{n} {");
+    std::vector<Task> tasks;
+    dagra::core::expand_matrix(prototype, {{"n", {"7"}}}, tasks);
+    ASSERT_EQ(tasks.size(), 1u);
+    EXPECT_EQ(tasks[0].id, "job-7");
+    EXPECT_EQ(tasks[0].command, "echo ${HOME} 7 {other} 77 {");
+}
+
+/**
+ * @brief Tests integer ranges and the rejection of malformed matrices.
+ */
+TEST(MatrixTest, ParsesRangesAndRejectsMalformedMatrices) {
+    std::vector<std::string> values;
+    ASSERT_TRUE(dagra::core::parse_matrix_range("-1..2", values));
+    EXPECT_EQ(values, (std::vector<std::string>{"-1", "0", "1", "2"}));
+    EXPECT_FALSE(dagra::core::parse_matrix_range("linux", values));
+    EXPECT_FALSE(dagra::core::parse_matrix_range("1..x", values));
+    EXPECT_FALSE(dagra::core::parse_matrix_range("1...3", values));
+    EXPECT_THROW(dagra::core::parse_matrix_range("5..4", values), std::runtime_error);
+    EXPECT_THROW(dagra::core::parse_matrix_range("0..99999999", values), std::runtime_error);
+
+    const Task prototype = make_task("job-{a}", "true");
+    std::vector<Task> tasks;
+    EXPECT_THROW(dagra::core::expand_matrix(prototype, {}, tasks), std::runtime_error);
+    EXPECT_THROW(dagra::core::expand_matrix(prototype, {{"a", {}}}, tasks), std::runtime_error);
+    EXPECT_THROW(dagra::core::expand_matrix(prototype, {{"a", {"1"}}, {"a", {"2"}}}, tasks), std::runtime_error);
+    EXPECT_THROW(dagra::core::expand_matrix(prototype, {{"a", {"1"}}, {"b", {"2"}}}, tasks), std::runtime_error);
+
+    std::vector<std::string> wide(10000, "v");
+    EXPECT_THROW(dagra::core::expand_matrix(make_task("job-{a}-{b}", "true"), {{"a", wide}, {"b", wide}}, tasks),
+                 std::runtime_error);
+    EXPECT_TRUE(tasks.empty());
+}
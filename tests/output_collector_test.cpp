@@ -0,0 +1,96 @@
+/**
+ * @file output_collector_test.cpp
+ * @brief Unit tests for the execution::OutputCollector class.
+ * @version 1.1.0
+ *
+ * This file contains tests for capturing task output through pipes: line
+ * prefixing, per-task log files and the failure tail ring buffer.
+ */
+
+#include "dagra/execution/output_collector.hpp"
+#include "dagra/execution/process.hpp"
+#include "dagra/utils/logger.hpp"
+#include <chrono>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using dagra::execution::OutputCollector;
+using dagra::execution::OutputOptions;
+using dagra::execution::Process;
+
+namespace {
+
+    /// @brief Runs a command with its output captured by the collector and returns the handle.
+    std::shared_ptr<dagra::execution::TaskOutput> run_captured(OutputCollector& collector, const std::string& id,
+                                                               const std::string& command) {
+        int out_pipe[2];
+        int err_pipe[2];
+        EXPECT_EQ(pipe2(out_pipe, O_CLOEXEC), 0);
+        EXPECT_EQ(pipe2(err_pipe, O_CLOEXEC), 0);
+        dagra::core::Task task;
+        task.id = id;
+        task.command = command;
+        Process process = Process::spawn(task, out_pipe[1], err_pipe[1]);
+        close(out_pipe[1]);
+        close(err_pipe[1]);
+        auto output = collector.attach(id, out_pipe[0], err_pipe[0]);
+        EXPECT_TRUE(process.wait().success());
+        output->finish(std::chrono::seconds(5));
+        return output;
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that lines are prefixed with the task ID and the full output is logged.
+ */
+TEST(OutputCollectorTest, PrefixesLinesAndWritesLog) {
+    fs::path dir = fs::temp_directory_path() / "dagra_output_test";
+    fs::remove_all(dir);
+
+    std::stringstream captured;
+    std::streambuf* old_cout = std::cout.rdbuf(captured.rdbuf());
+    std::streambuf* old_cerr = std::cerr.rdbuf(captured.rdbuf());
+    {
+        OutputOptions options;
+        options.log_dir = dir.string();
+        OutputCollector collector(options);
+        auto output = run_captured(collector, "job/1", "printf 'one\\ntwo\\npartial'; echo err >&2");
+        EXPECT_EQ(output->log_path(), (dir / "job_1.log").string());
+    }
+    dagra::utils::Logger::flush();
+    std::cout.rdbuf(old_cout);
+    std::cerr.rdbuf(old_cerr);
+
+    const std::string text = captured.str();
+    EXPECT_NE(text.find("[job/1] one\n[job/1] two\n"), std::string::npos);
+    EXPECT_NE(text.find("[job/1] partial\n"), std::string::npos);
+    EXPECT_NE(text.find("[job/1] err\n"), std::string::npos);
+
+    std::ifstream log(dir / "job_1.log");
+    std::string contents((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("one\ntwo\npartial"), std::string::npos);
+    fs::remove_all(dir);
+}
+
+/**
+ * @brief Tests that the ring buffer keeps only the most recent output, from a line boundary.
+ */
+TEST(OutputCollectorTest, TailKeepsMostRecentOutput) {
+    OutputOptions options;
+    options.echo = false;
+    options.tail_bytes = 64;
+    OutputCollector collector(options);
+
+    auto output = run_captured(collector, "chatty", "sh -c 'i=0; while [ $i -lt 20000 ]; do echo line-$i; i=$((i+1)); done'");
+    const std::string tail = output->tail();
+    EXPECT_LE(tail.size(), 64u);
+    EXPECT_EQ(tail.rfind("line-19999\n"), tail.size() - 11);
+    EXPECT_EQ(tail.rfind("line-", 0), 0u);
+}
@@ -23,8 +23,18 @@ protected:
         outfile << "    command: 'echo A'" << std::endl;
         outfile << "  - id: task-b" << std::endl;
         outfile << "    command: 'echo B'" << std::endl;
+        outfile << "    worker: lint-worker --persistent" << std::endl;
         outfile << "    depends_on:" << std::endl;
         outfile << "      - task-a" << std::endl;
+        outfile << "    inputs: [src/b.c]" << std::endl;
+        outfile << "    outputs: [out/b.o]" << std::endl;
+        outfile << "    cost: 2.5" << std::endl;
+        outfile << "    allow_failure: true" << std::endl;
+        outfile << "    batchable: true" << std::endl;
+        outfile << "    resources: {cpu: 2, db: 1}" << std::endl;
+        outfile << "    tags: [ci, nightly]" << std::endl;
+        outfile << "resources:" << std::endl;
+        outfile << "  db: 2" << std::endl;
         outfile.close();
     }
 
@@ -46,7 +56,7 @@ TEST_F(ParserTest, ParseArgsBasic) {
 }
 
 /**
- * @brief Tests the parsing of the --dry-run flag.
+ * @brief Tests the parsing of the --dry-run, --fuse, --event-loop and --resume flags.
  */
 TEST_F(ParserTest, ParseArgsDryRun) {
     char* argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--dry-run", nullptr};
@@ -55,6 +65,142 @@ TEST_F(ParserTest, ParseArgsDryRun) {
     auto options = dagra::cli::Parser::parse_args(argc, argv);
     EXPECT_EQ(options.config_filepath, "config.yaml");
     EXPECT_TRUE(options.dry_run);
+    EXPECT_FALSE(options.keep_going);
+    EXPECT_FALSE(options.fuse);
+    EXPECT_FALSE(options.event_loop);
+
+    char* fuse_argv[] = {(char*)"dagra", (char*)"--fuse", (char*)"config.yaml", (char*)"--resume", nullptr};
+    EXPECT_TRUE(dagra::cli::Parser::parse_args(4, fuse_argv).fuse);
+    EXPECT_TRUE(dagra::cli::Parser::parse_args(4, fuse_argv).resume);
+
+    char* loop_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--event-loop", (char*)"-j", (char*)"5000", nullptr};
+    EXPECT_TRUE(dagra::cli::Parser::parse_args(5, loop_argv).event_loop);
+    EXPECT_EQ(dagra::cli::Parser::parse_args(5, loop_argv).jobs, 5000u);
+}
+
+/**
+ * @brief Tests that arguments after the config file are targets and that --tag repeats.
+ */
+TEST_F(ParserTest, ParseArgsTargetsAndTags) {
+    char* argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"build:app", (char*)"--tag", (char*)"nightly",
+                    (char*)"test:*", (char*)"--tag=ci", nullptr};
+    auto options = dagra::cli::Parser::parse_args(7, argv);
+    EXPECT_EQ(options.config_filepath, "config.yaml");
+    EXPECT_EQ(options.targets, (std::vector<std::string>{"build:app", "test:*"}));
+    EXPECT_EQ(options.tags, (std::vector<std::string>{"nightly", "ci"}));
+}
+
+/**
+ * @brief Tests the watch flag, its debounce period and its conflicts with --dry-run and --resume.
+ */
+TEST_F(ParserTest, ParseArgsWatch) {
+    char* argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--watch", (char*)"--debounce", (char*)"50", nullptr};
+    auto options = dagra::cli::Parser::parse_args(5, argv);
+    EXPECT_TRUE(options.watch);
+    EXPECT_EQ(options.watch_debounce_ms, 50u);
+
+    char* dry_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--watch", (char*)"--dry-run", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(4, dry_argv), std::runtime_error);
+
+    char* resume_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--watch", (char*)"--resume", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(4, resume_argv), std::runtime_error);
+}
+
+/**
+ * @brief Tests both spellings of the keep-going flag.
+ */
+TEST_F(ParserTest, ParseArgsKeepGoing) {
+    char* short_argv[] = {(char*)"dagra", (char*)"-k", (char*)"config.yaml", nullptr};
+    EXPECT_TRUE(dagra::cli::Parser::parse_args(3, short_argv).keep_going);
+
+    char* long_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--keep-going", nullptr};
+    auto options = dagra::cli::Parser::parse_args(3, long_argv);
+    EXPECT_TRUE(options.keep_going);
+    EXPECT_EQ(options.config_filepath, "config.yaml");
+}
+
+/**
+ * @brief Tests the accepted spellings of the job limit option.
+ */
+TEST_F(ParserTest, ParseArgsJobs) {
+    char* short_argv[] = {(char*)"dagra", (char*)"-j", (char*)"4", (char*)"config.yaml", nullptr};
+    auto options = dagra::cli::Parser::parse_args(4, short_argv);
+    EXPECT_EQ(options.config_filepath, "config.yaml");
+    EXPECT_EQ(options.jobs, 4u);
+
+    char* attached_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"-j8", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(3, attached_argv).jobs, 8u);
+
+    char* long_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--jobs=2", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(3, long_argv).jobs, 2u);
+
+    char* default_argv[] = {(char*)"dagra", (char*)"config.yaml", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(2, default_argv).jobs, 0u);
+}
+
+/**
+ * @brief Tests that an invalid job limit is rejected.
+ */
+TEST_F(ParserTest, ParseArgsInvalidJobs) {
+    char* zero_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"-j", (char*)"0", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(4, zero_argv), std::runtime_error);
+
+    char* text_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--jobs=many", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, text_argv), std::runtime_error);
+
+    char* missing_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"-j", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, missing_argv), std::runtime_error);
+}
+
+/**
+ * @brief Tests parsing of the timeout grace period and the worker request limit.
+ */
+TEST_F(ParserTest, ParseArgsKillGrace) {
+    char* default_argv[] = {(char*)"dagra", (char*)"config.yaml", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(2, default_argv).kill_grace_seconds, 5);
+
+    char* argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--kill-grace", (char*)"0", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(4, argv).kill_grace_seconds, 0);
+
+    char* worker_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--worker-requests=50", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(3, worker_argv).worker_max_requests, 50u);
+
+    char* bad_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--kill-grace=-1", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, bad_argv), std::runtime_error);
+}
+
+/**
+ * @brief Tests the report subcommand, whose configuration file is optional.
+ */
+TEST_F(ParserTest, ParseArgsReport) {
+    char* argv[] = {(char*)"dagra", (char*)"report", (char*)"--sort", (char*)"cpu", (char*)"--top=5", nullptr};
+    auto options = dagra::cli::Parser::parse_args(5, argv);
+    EXPECT_EQ(options.command, dagra::cli::Command::Report);
+    EXPECT_TRUE(options.config_filepath.empty());
+    EXPECT_EQ(options.report_sort, dagra::history::SortKey::Cpu);
+    EXPECT_EQ(options.report_limit, 5);
+
+    char* bad_argv[] = {(char*)"dagra", (char*)"report", (char*)"--sort=speed", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, bad_argv), std::runtime_error);
+}
+
+/**
+ * @brief Tests the analyze subcommand and its --reduce option.
+ */
+TEST_F(ParserTest, ParseArgsAnalyze) {
+    char* argv[] = {(char*)"dagra", (char*)"analyze", (char*)"config.yaml", (char*)"deploy", (char*)"-j4",
+                    (char*)"--reduce", (char*)"reduced.yaml", nullptr};
+    auto options = dagra::cli::Parser::parse_args(7, argv);
+    EXPECT_EQ(options.command, dagra::cli::Command::Analyze);
+    EXPECT_EQ(options.config_filepath, "config.yaml");
+    EXPECT_EQ(options.targets, (std::vector<std::string>{"deploy"}));
+    EXPECT_EQ(options.jobs, 4u);
+    EXPECT_EQ(options.reduce_path, "reduced.yaml");
+
+    char* missing_argv[] = {(char*)"dagra", (char*)"analyze", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(2, missing_argv), std::runtime_error);
+    char* run_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--reduce=out.yaml", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, run_argv), std::runtime_error);
 }
 
 /**
@@ -79,8 +225,116 @@ TEST_F(ParserTest, ParseYamlSuccess) {
 
     EXPECT_EQ(tasks[1].id, "task-b");
     EXPECT_EQ(tasks[1].command, "echo B");
+    EXPECT_TRUE(tasks[0].worker.empty());
+    EXPECT_EQ(tasks[1].worker, "lint-worker --persistent");
     ASSERT_EQ(tasks[1].dependencies.size(), 1);
     EXPECT_EQ(tasks[1].dependencies[0], "task-a");
+    ASSERT_EQ(tasks[1].inputs.size(), 1);
+    EXPECT_EQ(tasks[1].inputs[0], "src/b.c");
+    ASSERT_EQ(tasks[1].outputs.size(), 1);
+    EXPECT_EQ(tasks[1].outputs[0], "out/b.o");
+    EXPECT_FALSE(tasks[0].is_cacheable());
+    EXPECT_TRUE(tasks[1].is_cacheable());
+    EXPECT_DOUBLE_EQ(tasks[0].cost, 0.0);
+    EXPECT_DOUBLE_EQ(tasks[1].cost, 2.5);
+    EXPECT_FALSE(tasks[0].allow_failure);
+    EXPECT_TRUE(tasks[1].allow_failure);
+    EXPECT_FALSE(tasks[0].batchable);
+    EXPECT_TRUE(tasks[1].batchable);
+    EXPECT_TRUE(tasks[0].resources.empty());
+    ASSERT_EQ(tasks[1].resources.size(), 2u);
+    EXPECT_DOUBLE_EQ(tasks[1].resources.at("cpu"), 2.0);
+    EXPECT_DOUBLE_EQ(tasks[1].resources.at("db"), 1.0);
+    EXPECT_TRUE(tasks[0].tags.empty());
+    EXPECT_EQ(tasks[1].tags, (std::vector<std::string>{"ci", "nightly"}));
+}
+
+/**
+ * @brief Tests that the top-level resource pools are parsed and invalid amounts rejected.
+ */
+TEST_F(ParserTest, ParseConfigResourcePools) {
+    dagra::cli::Config config = dagra::cli::Parser::parse_config("test_config.yaml");
+    ASSERT_EQ(config.tasks.size(), 2u);
+    ASSERT_EQ(config.resource_pools.size(), 1u);
+    EXPECT_DOUBLE_EQ(config.resource_pools.at("db"), 2.0);
+
+    {
+        std::ofstream outfile("test_config.yaml");
+        outfile << "resources: {db: 0}\ntasks:\n  - id: a\n    command: 'true'\n";
+    }
+    EXPECT_THROW(dagra::cli::Parser::parse_config("test_config.yaml"), std::runtime_error);
+
+    {
+        std::ofstream outfile("test_config.yaml");
+        outfile << "tasks:\n  - id: a\n    command: 'true'\n    resources: {memory_mb: lots}\n";
+    }
+    EXPECT_THROW(dagra::cli::Parser::parse_config("test_config.yaml"), std::runtime_error);
+}
+
+/**
+ * @brief Tests that a task with a matrix is expanded into one task per combination.
+ */
+TEST_F(ParserTest, ParseConfigMatrix) {
+    {
+        std::ofstream outfile("test_config.yaml");
+        outfile << "tasks:\n"
+                   "  - id: build-{platform}\n"
+                   "    command: 'make PLATFORM={platform}'\n"
+                   "    matrix: {platform: [linux, mac]}\n"
+                   "  - id: test-{platform}-{shard}\n"
+                   "    command: 'run-tests --shard {shard} --home ${HOME}'\n"
+                   "    depends_on: ['build-{platform}']\n"
+                   "    timeout: 60\n"
+                   "    matrix:\n"
+                   "      platform: [linux, mac]\n"
+                   "      shard: 0..2\n";
+    }
+    const auto tasks = dagra::cli::Parser::parse_yaml("test_config.yaml");
+    ASSERT_EQ(tasks.size(), 8u);
+    EXPECT_EQ(tasks[1].id, "build-mac");
+    EXPECT_EQ(tasks[1].command, "make PLATFORM=mac");
+    EXPECT_EQ(tasks[2].id, "test-linux-0");
+    EXPECT_EQ(tasks[4].id, "test-linux-2");
+    EXPECT_EQ(tasks[7].id, "test-mac-2");
+    EXPECT_EQ(tasks[7].command, "run-tests --shard 2 --home ${HOME}");
+    EXPECT_EQ(tasks[7].dependencies, (std::vector<std::string>{"build-mac"}));
+    EXPECT_EQ(tasks[7].timeout_seconds, 60);
+
+    for (const char* matrix : {"[linux]", "{platform: []}", "{platform: 3..1}", "{platform: linux}"}) {
+        std::ofstream outfile("test_config.yaml");
+        outfile << "tasks:\n  - id: build-{platform}\n    command: 'true'\n    matrix: " << matrix << "\n";
+        outfile.close();
+        EXPECT_THROW(dagra::cli::Parser::parse_config("test_config.yaml"), std::runtime_error) << matrix;
+    }
+}
+
+/**
+ * @brief Tests that a written configuration parses back to the same tasks and pools.
+ */
+TEST_F(ParserTest, WriteConfigRoundTrip) {
+    const dagra::cli::Config original = dagra::cli::Parser::parse_config("test_config.yaml");
+    dagra::cli::Parser::write_config(original, "test_config.yaml");
+    const dagra::cli::Config written = dagra::cli::Parser::parse_config("test_config.yaml");
+
+    EXPECT_EQ(written.resource_pools, original.resource_pools);
+    ASSERT_EQ(written.tasks.size(), original.tasks.size());
+    for (std::size_t i = 0; i < original.tasks.size(); ++i) {
+        const auto& a = original.tasks[i];
+        const auto& b = written.tasks[i];
+        EXPECT_EQ(b.id, a.id);
+        EXPECT_EQ(b.command, a.command);
+        EXPECT_EQ(b.worker, a.worker);
+        EXPECT_EQ(b.dependencies, a.dependencies);
+        EXPECT_EQ(b.timeout_seconds, a.timeout_seconds);
+        EXPECT_DOUBLE_EQ(b.cost, a.cost);
+        EXPECT_EQ(b.allow_failure, a.allow_failure);
+        EXPECT_EQ(b.batchable, a.batchable);
+        EXPECT_EQ(b.env_vars, a.env_vars);
+        EXPECT_EQ(b.inputs, a.inputs);
+        EXPECT_EQ(b.outputs, a.outputs);
+        EXPECT_EQ(b.tags, a.tags);
+        EXPECT_EQ(b.resources, a.resources);
+    }
 }
 
 /**
@@ -89,3 +343,32 @@ TEST_F(ParserTest, ParseYamlSuccess) {
 TEST_F(ParserTest, ParseYamlFileNotExist) {
     EXPECT_THROW(dagra::cli::Parser::parse_yaml("nonexistent.yaml"), std::runtime_error);
 }
+
+/**
+ * @brief Tests the --listen option and the command line of dagra-worker.
+ */
+TEST_F(ParserTest, ParseDistributedArgs) {
+    char* listen_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--listen", (char*)":7420", nullptr};
+    EXPECT_EQ(dagra::cli::Parser::parse_args(4, listen_argv).listen_address, ":7420");
+
+    char* bad_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--listen=build-host", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(3, bad_argv), std::runtime_error);
+
+    char* fuse_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--listen", (char*)":7420", (char*)"--fuse", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(5, fuse_argv), std::runtime_error);
+    char* loop_argv[] = {(char*)"dagra", (char*)"config.yaml", (char*)"--listen", (char*)":7420", (char*)"--event-loop", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_args(5, loop_argv), std::runtime_error);
+
+    char* worker_argv[] = {(char*)"dagra-worker", (char*)"coordinator:7420", (char*)"--slots", (char*)"8",
+                           (char*)"--name=build-03", (char*)"--once", nullptr};
+    dagra::remote::AgentOptions agent = dagra::cli::Parser::parse_worker_args(6, worker_argv);
+    EXPECT_EQ(agent.address, "coordinator:7420");
+    EXPECT_EQ(agent.slots, 8u);
+    EXPECT_EQ(agent.name, "build-03");
+    EXPECT_TRUE(agent.once);
+
+    char* missing_argv[] = {(char*)"dagra-worker", (char*)"--slots", (char*)"8", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_worker_args(3, missing_argv), std::runtime_error);
+    char* zero_argv[] = {(char*)"dagra-worker", (char*)"unix:/tmp/dagra.sock", (char*)"--slots", (char*)"0", nullptr};
+    EXPECT_THROW(dagra::cli::Parser::parse_worker_args(4, zero_argv), std::runtime_error);
+}
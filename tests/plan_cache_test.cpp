@@ -0,0 +1,159 @@
+/**
+ * @file plan_cache_test.cpp
+ * @brief Unit tests for the compiled execution plan cache.
+ * @version 1.1.0
+ *
+ * This file contains tests for compiling a graph into a plan file, loading
+ * it back without parsing, and rejecting stale or damaged plans.
+ */
+
+#include "dagra/cache/plan_cache.hpp"
+#include "dagra/core/dag.hpp"
+#include "test_support.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using dagra::test::make_task;
+
+// Test fixture providing a scratch directory and a small validated graph.
+class PlanCacheTest : public ::testing::Test {
+protected:
+    fs::path dir = fs::temp_directory_path() / "dagra_plan_cache_test";
+    dagra::core::Dag dag;
+
+    void SetUp() override {
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+
+        dagra::core::Task build = make_task("build", "make all", {"fetch", "configure"});
+        build.timeout_seconds = 30;
+        build.env_vars = {"CC=clang", "JOBS=8"};
+        build.inputs = {"src/main.cpp"};
+        build.outputs = {"bin/app"};
+        build.cost = 12.5;
+        build.allow_failure = true;
+        build.batchable = true;
+        build.worker = "cc-worker --persistent";
+        build.resources = {{"cpu", 4.0}, {"db", 1.0}, {"memory_mb", 512.0}};
+        build.tags = {"ci", "nightly"};
+        dag.add_task(make_task("fetch", "git pull"));
+        dag.add_task(make_task("configure", "./configure", {"fetch"}));
+        dag.add_task(build);
+        dag.validate();
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    std::vector<dagra::core::TaskIndex> dependencies(const dagra::core::Dag& graph, dagra::core::TaskIndex i) {
+        return {graph.dependencies(i).begin(), graph.dependencies(i).end()};
+    }
+};
+
+/**
+ * @brief Tests that runs compiling one shared plan file never publish a torn plan or leave temporaries.
+ */
+TEST_F(PlanCacheTest, ConcurrentSavesStayLoadable) {
+    const std::string path = (dir / "config.yaml.plan").string();
+    auto saver = [&]() {
+        for (int i = 0; i < 50; ++i) {
+            dagra::cache::save_plan(dag, {}, path, 1234);
+        }
+    };
+    std::thread first(saver);
+    std::thread second(saver);
+    first.join();
+    second.join();
+
+    dagra::core::Dag loaded;
+    std::map<std::string, double> loaded_pools;
+    EXPECT_TRUE(dagra::cache::load_plan(path, 1234, loaded, loaded_pools));
+    EXPECT_EQ(loaded.size(), dag.size());
+    EXPECT_EQ(std::distance(fs::directory_iterator(dir), fs::directory_iterator()), 1);
+}
+
+/**
+ * @brief Tests that a plan round trip reproduces every task field and both edge directions, and the file has the usual mode.
+ */
+TEST_F(PlanCacheTest, RoundTrip) {
+    const std::string path = (dir / "config.yaml.plan").string();
+    const std::map<std::string, double> pools = {{"db", 2.0}, {"gpu", 0.5}};
+    const mode_t old_mask = umask(022);
+    dagra::cache::save_plan(dag, pools, path, 1234);
+    umask(old_mask);
+    EXPECT_EQ(fs::status(path).permissions(), fs::perms(0644));
+
+    dagra::core::Dag loaded;
+    std::map<std::string, double> loaded_pools;
+    ASSERT_TRUE(dagra::cache::load_plan(path, 1234, loaded, loaded_pools));
+    EXPECT_EQ(loaded_pools, pools);
+    ASSERT_EQ(loaded.size(), dag.size());
+    for (dagra::core::TaskIndex i = 0; i < dag.size(); ++i) {
+        const auto& expected = dag.task(i);
+        const auto& actual = loaded.task(i);
+        EXPECT_EQ(actual.id, expected.id);
+        EXPECT_EQ(actual.command, expected.command);
+        EXPECT_EQ(actual.worker, expected.worker);
+        EXPECT_EQ(actual.dependencies, expected.dependencies);
+        EXPECT_EQ(actual.timeout_seconds, expected.timeout_seconds);
+        EXPECT_EQ(actual.env_vars, expected.env_vars);
+        EXPECT_EQ(actual.inputs, expected.inputs);
+        EXPECT_EQ(actual.outputs, expected.outputs);
+        EXPECT_DOUBLE_EQ(actual.cost, expected.cost);
+        EXPECT_EQ(actual.allow_failure, expected.allow_failure);
+        EXPECT_EQ(actual.batchable, expected.batchable);
+        EXPECT_EQ(actual.resources, expected.resources);
+        EXPECT_EQ(actual.tags, expected.tags);
+        EXPECT_EQ(dependencies(loaded, i), dependencies(dag, i));
+    }
+
+    dagra::core::TaskIndex fetch;
+    ASSERT_TRUE(loaded.find("fetch", fetch));
+    EXPECT_EQ(loaded.dependents(fetch).size(), 2u);
+    EXPECT_TRUE(loaded.check().ok());
+    EXPECT_EQ(loaded.topological_order().size(), 3u);
+}
+
+/**
+ * @brief Tests that plans compiled from other contents, or damaged on disk, are ignored.
+ */
+TEST_F(PlanCacheTest, RejectsStaleAndCorruptPlans) {
+    const fs::path path = dir / "config.yaml.plan";
+    dagra::core::Dag loaded;
+    std::map<std::string, double> pools;
+    EXPECT_FALSE(dagra::cache::load_plan(path.string(), 1234, loaded, pools));
+
+    dagra::cache::save_plan(dag, {}, path.string(), 1234);
+    EXPECT_FALSE(dagra::cache::load_plan(path.string(), 4321, loaded, pools));
+
+    fs::resize_file(path, fs::file_size(path) - 3);
+    EXPECT_FALSE(dagra::cache::load_plan(path.string(), 1234, loaded, pools));
+    EXPECT_EQ(loaded.size(), 0u);
+}
+
+/**
+ * @brief Tests that the configuration hash follows the file contents.
+ */
+TEST_F(PlanCacheTest, ConfigHashTracksContents) {
+    const fs::path config = dir / "config.yaml";
+    std::ofstream(config) << "tasks: []\n";
+    std::uint64_t first = 0;
+    std::uint64_t second = 0;
+    ASSERT_TRUE(dagra::cache::hash_config(config.string(), first));
+    ASSERT_TRUE(dagra::cache::hash_config(config.string(), second));
+    EXPECT_EQ(first, second);
+
+    std::ofstream(config) << "tasks: [ ]\n";
+    ASSERT_TRUE(dagra::cache::hash_config(config.string(), second));
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(dagra::cache::hash_config((dir / "missing.yaml").string(), second));
+}
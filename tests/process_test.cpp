@@ -0,0 +1,266 @@
+/**
+ * @file process_test.cpp
+ * @brief Unit tests for the execution::Process launcher.
+ * @version 1.1.0
+ *
+ * This file contains tests for command classification, environment merging
+ * and exit status decoding of spawned task processes.
+ */
+
+#include "dagra/execution/process.hpp"
+#include "test_support.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+using dagra::execution::ExitStatus;
+using dagra::execution::Process;
+using dagra::test::make_task;
+
+/**
+ * @brief Tests that simple commands are executed directly and complex ones via the shell.
+ */
+TEST(ProcessTest, ShellDetection) {
+    EXPECT_FALSE(dagra::execution::needs_shell("echo hello"));
+    EXPECT_FALSE(dagra::execution::needs_shell("g++ -O2 -o app main.cpp --flag=value"));
+    EXPECT_TRUE(dagra::execution::needs_shell("echo 'quoted'"));
+    EXPECT_TRUE(dagra::execution::needs_shell("make && make test"));
+    EXPECT_TRUE(dagra::execution::needs_shell("echo $HOME"));
+    EXPECT_TRUE(dagra::execution::needs_shell("ls *.cpp"));
+    EXPECT_TRUE(dagra::execution::needs_shell("FOO=bar ./tool"));
+    EXPECT_TRUE(dagra::execution::needs_shell("cd build"));
+
+    auto argv = dagra::execution::build_argv("echo  a\tb", false);
+    ASSERT_EQ(argv.size(), 3u);
+    EXPECT_EQ(argv[0], "echo");
+    EXPECT_EQ(argv[2], "b");
+}
+
+/**
+ * @brief Tests that task variables override parent variables with the same key.
+ */
+TEST(ProcessTest, EnvironmentMerge) {
+    setenv("DAGRA_PROCESS_TEST", "parent", 1);
+    auto env = dagra::execution::build_environment({"DAGRA_PROCESS_TEST=task", "DAGRA_NEW=1"});
+
+    EXPECT_NE(std::find(env.begin(), env.end(), "DAGRA_PROCESS_TEST=task"), env.end());
+    EXPECT_EQ(std::find(env.begin(), env.end(), "DAGRA_PROCESS_TEST=parent"), env.end());
+    EXPECT_NE(std::find(env.begin(), env.end(), "DAGRA_NEW=1"), env.end());
+    unsetenv("DAGRA_PROCESS_TEST");
+}
+
+/**
+ * @brief Tests that exit codes, signals and spawn failures are decoded.
+ */
+TEST(ProcessTest, ExitStatusDecoding) {
+    ExitStatus ok = Process::spawn(make_task("t", "true")).wait();
+    EXPECT_TRUE(ok.success());
+
+    ExitStatus code = Process::spawn(make_task("t", "sh -c 'exit 3'")).wait();
+    EXPECT_EQ(code.kind, ExitStatus::Kind::Exited);
+    EXPECT_EQ(code.code, 3);
+
+    ExitStatus killed = Process::spawn(make_task("t", "kill -TERM $$")).wait();
+    EXPECT_EQ(killed.kind, ExitStatus::Kind::Signaled);
+    EXPECT_EQ(killed.signal, SIGTERM);
+
+    ExitStatus missing = Process::spawn(make_task("t", "dagra-no-such-program")).wait();
+    EXPECT_EQ(missing.kind, ExitStatus::Kind::SpawnFailed);
+    EXPECT_FALSE(missing.success());
+}
+
+/**
+ * @brief Tests that task environment variables reach the child process.
+ */
+TEST(ProcessTest, PassesEnvironment) {
+    dagra::core::Task task = make_task("t", "test \"$DAGRA_VALUE\" = expected");
+    task.env_vars = {"DAGRA_VALUE=expected"};
+    EXPECT_TRUE(Process::spawn(task).wait().success());
+
+    task.env_vars = {"DAGRA_VALUE=other"};
+    EXPECT_FALSE(Process::spawn(task).wait().success());
+}
+
+/**
+ * @brief Tests that a deadline terminates the whole process group, including
+ *        background grandchildren, and is reported as a timeout.
+ */
+TEST(ProcessTest, TimeoutKillsProcessGroup) {
+    const std::string pid_file = "process_test_grandchild.pid";
+    dagra::core::Task task = make_task("t", "sleep 30 & echo $! > " + pid_file + "; wait");
+
+    auto started = std::chrono::steady_clock::now();
+    ExitStatus status = Process::spawn(task).wait_with_timeout(std::chrono::milliseconds(300),
+                                                               std::chrono::milliseconds(100));
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    EXPECT_TRUE(status.timed_out);
+    EXPECT_FALSE(status.success());
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+
+    std::ifstream in(pid_file);
+    pid_t grandchild = 0;
+    ASSERT_TRUE(in >> grandchild);
+    std::remove(pid_file.c_str());
+
+    // The grandchild is either gone or a zombie waiting to be reaped by init.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ifstream stat("/proc/" + std::to_string(grandchild) + "/stat");
+    std::string pid_field, comm, state;
+    if (stat >> pid_field >> comm >> state) {
+        EXPECT_EQ(state, "Z");
+    }
+}
+
+/**
+ * @brief Tests that destroying a process that was never waited for kills its group and reaps it.
+ */
+TEST(ProcessTest, DestructorKillsUnwaitedProcess) {
+    const std::string pid_file = "process_test_unwaited.pid";
+    std::remove(pid_file.c_str());
+    pid_t child = -1;
+    pid_t grandchild = 0;
+    {
+        Process process = Process::spawn(make_task("t", "sleep 30 & echo $! > " + pid_file + "; wait"));
+        child = process.pid();
+        ASSERT_GT(child, 0);
+        for (int i = 0; i < 200 && grandchild == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::ifstream in(pid_file);
+            in >> grandchild;
+        }
+        ASSERT_GT(grandchild, 0);
+    }
+    std::remove(pid_file.c_str());
+
+    // The child has been reaped, so it no longer exists even as a zombie.
+    EXPECT_NE(access(("/proc/" + std::to_string(child)).c_str(), F_OK), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ifstream stat("/proc/" + std::to_string(grandchild) + "/stat");
+    std::string pid_field, comm, state;
+    if (stat >> pid_field >> comm >> state) {
+        EXPECT_EQ(state, "Z");
+    }
+}
+
+/**
+ * @brief Tests that a command reading stdin gets end of file instead of dagra's stdin.
+ *
+ * From a terminal, a task in its own process group reading the inherited
+ * stdin would be stopped by SIGTTIN and never exit.
+ */
+TEST(ProcessTest, StdinIsEmpty) {
+    ExitStatus status = Process::spawn(make_task("t", "cat")).wait_with_timeout(std::chrono::seconds(5),
+                                                                                std::chrono::milliseconds(100));
+    EXPECT_TRUE(status.success());
+    EXPECT_FALSE(status.timed_out);
+}
+
+/**
+ * @brief Tests that a process finishing before its deadline is not marked as timed out.
+ */
+TEST(ProcessTest, FinishesBeforeDeadline) {
+    ExitStatus status = Process::spawn(make_task("t", "true")).wait_with_timeout(std::chrono::seconds(5),
+                                                                                 std::chrono::milliseconds(100));
+    EXPECT_TRUE(status.success());
+    EXPECT_FALSE(status.timed_out);
+}
+
+/**
+ * @brief Tests that a readable cancel descriptor terminates a process without a deadline.
+ */
+TEST(ProcessTest, CancelTerminatesProcess) {
+    const int cancel_fd = eventfd(0, EFD_CLOEXEC);
+    ASSERT_GE(cancel_fd, 0);
+    std::thread canceller([cancel_fd]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::uint64_t one = 1;
+        ASSERT_EQ(write(cancel_fd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    });
+
+    auto started = std::chrono::steady_clock::now();
+    ExitStatus status = Process::spawn(make_task("t", "sleep 30"))
+                            .wait_with_timeout(std::chrono::milliseconds(0), std::chrono::milliseconds(100), cancel_fd);
+    canceller.join();
+    close(cancel_fd);
+
+    EXPECT_TRUE(status.cancelled);
+    EXPECT_FALSE(status.timed_out);
+    EXPECT_FALSE(status.success());
+    EXPECT_EQ(status.describe(), "Cancelled");
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+}
+
+/**
+ * @brief Tests that a fused script reports each exit code and stops a chain at the first failure.
+ */
+TEST(ProcessTest, FusedScriptReportsEachCommand) {
+    dagra::core::Task first = make_task("first", "cd / # leaves the working directory only for this command");
+    dagra::core::Task failing = make_task("failing", "test \"$(pwd)\" = / || exit 7");
+    dagra::core::Task last = make_task("last", "true");
+    const std::vector<const dagra::core::Task*> tasks{&first, &failing, &last};
+
+    for (bool stop_on_failure : {true, false}) {
+        int status_pipe[2];
+        ASSERT_EQ(pipe(status_pipe), 0);
+        dagra::core::Task shell = make_task("fused", dagra::execution::build_fused_script(tasks, stop_on_failure));
+        ExitStatus status = Process::spawn(shell, -1, -1, status_pipe[1]).wait();
+        close(status_pipe[1]);
+        std::string report;
+        char buffer[256];
+        for (ssize_t n; (n = read(status_pipe[0], buffer, sizeof(buffer))) > 0;) {
+            report.append(buffer, static_cast<std::size_t>(n));
+        }
+        close(status_pipe[0]);
+
+        const std::vector<int> codes = dagra::execution::parse_fused_status(report, tasks.size());
+        EXPECT_EQ(codes, (std::vector<int>{0, 7, stop_on_failure ? -1 : 0}));
+        EXPECT_EQ(status.success(), !stop_on_failure);
+    }
+}
+
+/**
+ * @brief Tests that a `memory_mb` request limits the child's data segment from its start.
+ */
+TEST(ProcessTest, AppliesMemoryLimitBeforeExec) {
+    dagra::core::Task task = make_task("t", "ulimit -d; cat");
+    task.resources = {{"memory_mb", 64.0}};
+    int out_pipe[2];
+    ASSERT_EQ(pipe(out_pipe), 0);
+    Process process = Process::spawn(task, out_pipe[1]);
+    close(out_pipe[1]);
+    ASSERT_GT(process.pid(), 0);
+    EXPECT_EQ(getpgid(process.pid()), process.pid());
+
+    std::string output;
+    char buffer[64];
+    for (ssize_t n; (n = read(out_pipe[0], buffer, sizeof(buffer))) > 0;) {
+        output.append(buffer, static_cast<std::size_t>(n));
+    }
+    close(out_pipe[0]);
+    EXPECT_TRUE(process.wait().success());
+    EXPECT_EQ(output, "65536\n");
+
+    task.command = "dagra-no-such-program";
+    EXPECT_EQ(Process::spawn(task).wait().kind, ExitStatus::Kind::SpawnFailed);
+}
+
+/**
+ * @brief Tests that reaping a child reports its wall time and resource usage.
+ */
+TEST(ProcessTest, ReportsResourceUsage) {
+    ExitStatus status =
+        Process::spawn(make_task("t", "sh -c 'i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done'")).wait();
+    ASSERT_TRUE(status.success());
+    EXPECT_GT(status.usage.wall_seconds, 0.0);
+    EXPECT_GE(status.usage.wall_seconds, status.usage.user_seconds * 0.5);
+    EXPECT_GT(status.usage.user_seconds + status.usage.system_seconds, 0.0);
+    EXPECT_GT(status.usage.max_rss_kb, 0);
+}
@@ -0,0 +1,227 @@
+/**
+ * @file remote_test.cpp
+ * @brief Unit tests for distributed execution: the protocol, the coordinator and the agents.
+ * @version 1.1.0
+ *
+ * This file contains tests for address parsing and message framing, and
+ * tests that run tasks on real `dagra-worker` agents started on localhost,
+ * including the rescheduling of tasks whose agent is lost.
+ */
+
+#include "dagra/execution/runner.hpp"
+#include "dagra/remote/coordinator.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using dagra::execution::Process;
+using dagra::remote::Coordinator;
+using dagra::remote::RemoteResult;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief Starts a `dagra-worker` agent with its output discarded.
+    Process start_agent(const std::string& address, const std::string& name, std::size_t slots) {
+        const int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        Process agent = Process::spawn(make_task("agent", std::string(DAGRA_WORKER_BINARY) + " " + address +
+                                                              " --slots " + std::to_string(slots) + " --name " + name +
+                                                              " --once"),
+                                       null_fd, null_fd);
+        close(null_fd);
+        return agent;
+    }
+
+    /// @brief Waits until the coordinator has the given number of agents, for at most five seconds.
+    bool wait_for_agents(const Coordinator& coordinator, std::size_t count) {
+        for (int i = 0; i < 500 && coordinator.agents() != count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return coordinator.agents() == count;
+    }
+
+    /// @brief Runs a task on the coordinator and returns its result and stdout.
+    std::pair<RemoteResult, std::string> run_captured(Coordinator& coordinator, const dagra::core::Task& task) {
+        int out_pipe[2];
+        EXPECT_EQ(pipe2(out_pipe, O_CLOEXEC), 0);
+        RemoteResult result = coordinator.run(task, out_pipe[1], -1);
+        close(out_pipe[1]);
+        std::string output;
+        char buffer[4096];
+        ssize_t n = 0;
+        while ((n = read(out_pipe[0], buffer, sizeof(buffer))) > 0) {
+            output.append(buffer, static_cast<std::size_t>(n));
+        }
+        close(out_pipe[0]);
+        return {result, output};
+    }
+
+} // namespace
+
+/**
+ * @brief Tests address parsing, framing and a message round trip.
+ */
+TEST(RemoteTest, ParsesAddressesAndMessages) {
+    const auto tcp = dagra::remote::parse_address("10.0.0.5:7420");
+    EXPECT_EQ(tcp.host, "10.0.0.5");
+    EXPECT_EQ(tcp.port, "7420");
+    EXPECT_EQ(dagra::remote::parse_address("[::1]:80").host, "::1");
+    EXPECT_EQ(dagra::remote::parse_address(":7420").host, "");
+    EXPECT_EQ(dagra::remote::parse_address("unix:/tmp/dagra.sock").path, "/tmp/dagra.sock");
+    for (const char* bad : {"build-host", "build-host:", "build-host:http", "unix:"}) {
+        EXPECT_THROW(dagra::remote::parse_address(bad), std::runtime_error) << bad;
+    }
+
+    dagra::core::Task task = make_task("compile:a", "cc -c \"a.c\"");
+    task.env_vars = {"CFLAGS=-O2"};
+    task.timeout_seconds = 30;
+    std::string buffer = dagra::remote::encode_run(7, task, std::chrono::milliseconds(500));
+    std::string partial = buffer.substr(0, buffer.size() - 1);
+    std::string body;
+    EXPECT_EQ(dagra::remote::take_frame(partial, body), dagra::remote::FrameStatus::Incomplete);
+    buffer += dagra::remote::encode_cancel(7);
+    ASSERT_EQ(dagra::remote::take_frame(buffer, body), dagra::remote::FrameStatus::Complete);
+
+    dagra::remote::Message message;
+    ASSERT_TRUE(dagra::remote::decode_message(body, message));
+    EXPECT_EQ(message.type, "run");
+    EXPECT_EQ(message.seq, 7u);
+    EXPECT_EQ(message.task.command, task.command);
+    EXPECT_EQ(message.task.env_vars, task.env_vars);
+    EXPECT_EQ(message.task.timeout_seconds, 30);
+    EXPECT_EQ(message.kill_grace.count(), 500);
+    ASSERT_EQ(dagra::remote::take_frame(buffer, body), dagra::remote::FrameStatus::Complete);
+    EXPECT_TRUE(buffer.empty());
+
+    dagra::execution::ExitStatus status;
+    status.kind = dagra::execution::ExitStatus::Kind::Signaled;
+    status.signal = 15;
+    status.timed_out = true;
+    status.usage.max_rss_kb = 2048;
+    std::string exit_frame = dagra::remote::encode_exit(7, status);
+    ASSERT_EQ(dagra::remote::take_frame(exit_frame, body), dagra::remote::FrameStatus::Complete);
+    ASSERT_TRUE(dagra::remote::decode_message(body, message));
+    EXPECT_EQ(message.status.kind, dagra::execution::ExitStatus::Kind::Signaled);
+    EXPECT_EQ(message.status.signal, 15);
+    EXPECT_TRUE(message.status.timed_out);
+    EXPECT_EQ(message.status.usage.max_rss_kb, 2048);
+
+    std::string garbage = "12x\n{}";
+    EXPECT_EQ(dagra::remote::take_frame(garbage, body), dagra::remote::FrameStatus::Malformed);
+}
+
+/**
+ * @brief Tests that tasks are spread over several agents and their output and exit codes come back.
+ */
+TEST(RemoteTest, RunsTasksOnSeveralAgents) {
+    dagra::remote::CoordinatorOptions options;
+    options.address = "127.0.0.1:0";
+    Coordinator coordinator(options);
+    Process first = start_agent(coordinator.address(), "first", 2);
+    Process second = start_agent(coordinator.address(), "second", 2);
+    ASSERT_TRUE(wait_for_agents(coordinator, 2));
+    EXPECT_EQ(coordinator.slots(), 4u);
+
+    std::vector<std::future<std::pair<RemoteResult, std::string>>> runs;
+    for (int i = 0; i < 4; ++i) {
+        dagra::core::Task task =
+            make_task("echo:" + std::to_string(i), "sleep 0.2; echo \"$GREETING\" " + std::to_string(i));
+        task.env_vars = {"GREETING=hello"};
+        runs.push_back(std::async(std::launch::async, [&coordinator, task]() { return run_captured(coordinator, task); }));
+    }
+    std::set<std::string> agents;
+    for (int i = 0; i < 4; ++i) {
+        auto [result, output] = runs[static_cast<std::size_t>(i)].get();
+        EXPECT_TRUE(result.success()) << result.error;
+        EXPECT_EQ(output, "hello " + std::to_string(i) + "\n");
+        agents.insert(result.agent);
+    }
+    EXPECT_EQ(agents, (std::set<std::string>{"first", "second"}));
+
+    RemoteResult failed = coordinator.run(make_task("fail", "exit 3"), -1, -1);
+    EXPECT_FALSE(failed.success());
+    EXPECT_TRUE(failed.error.empty());
+    EXPECT_EQ(failed.status.code, 3);
+
+    dagra::core::Task slow = make_task("slow", "sleep 5");
+    slow.timeout_seconds = 1;
+    EXPECT_TRUE(coordinator.run(slow, -1, -1).status.timed_out);
+
+    first.terminate(std::chrono::milliseconds(1000));
+    second.terminate(std::chrono::milliseconds(1000));
+}
+
+/**
+ * @brief Tests that a task whose agent disappears is run again on another agent.
+ */
+TEST(RemoteTest, ReschedulesTasksOfLostAgents) {
+    const fs::path dir = fs::temp_directory_path() / "dagra_remote_lost";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string flag = (dir / "started").string();
+
+    dagra::remote::CoordinatorOptions options;
+    options.address = "127.0.0.1:0";
+    Coordinator coordinator(options);
+    Process doomed = start_agent(coordinator.address(), "doomed", 1);
+    ASSERT_TRUE(wait_for_agents(coordinator, 1));
+
+    dagra::core::Task task =
+        make_task("flaky", "if [ -e " + flag + " ]; then echo rerun; else touch " + flag + "; sleep 2; fi");
+    auto run = std::async(std::launch::async, [&]() { return run_captured(coordinator, task); });
+    for (int i = 0; i < 500 && !fs::exists(flag); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(fs::exists(flag));
+    doomed.terminate(std::chrono::milliseconds(0));
+
+    Process survivor = start_agent(coordinator.address(), "survivor", 1);
+    auto [result, output] = run.get();
+    EXPECT_TRUE(result.success()) << result.error;
+    EXPECT_EQ(result.agent, "survivor");
+    EXPECT_EQ(output, "rerun\n");
+    EXPECT_EQ(coordinator.lost(), 1u);
+
+    survivor.terminate(std::chrono::milliseconds(1000));
+    fs::remove_all(dir);
+}
+
+/**
+ * @brief Tests a whole run dispatched by the runner to agents over a Unix socket.
+ */
+TEST(RemoteTest, RunnerDispatchesToAgents) {
+    const fs::path dir = fs::temp_directory_path() / "dagra_remote_runner";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string address = "unix:" + (dir / "coordinator.sock").string();
+
+    dagra::core::Dag dag;
+    dag.add_task(make_task("generate", "echo data > " + (dir / "data").string()));
+    dag.add_task(make_task("left", "cat " + (dir / "data").string() + " > " + (dir / "left").string(), {"generate"}));
+    dag.add_task(make_task("right", "cat " + (dir / "data").string() + " > " + (dir / "right").string(), {"generate"}));
+    dag.validate();
+
+    Process agent = start_agent(address, "agent", 2);
+    dagra::execution::RunnerOptions options;
+    options.listen_address = address;
+    EXPECT_NO_THROW(dagra::execution::Runner(dag, options).execute_all());
+
+    std::ifstream left(dir / "left");
+    std::string line;
+    EXPECT_TRUE(std::getline(left, line));
+    EXPECT_EQ(line, "data");
+    EXPECT_TRUE(fs::exists(dir / "right"));
+    EXPECT_FALSE(fs::exists(dir / "coordinator.sock"));
+
+    // With --once, the agent exits when the coordinator goes away.
+    EXPECT_TRUE(agent.wait_with_timeout(std::chrono::seconds(5), std::chrono::milliseconds(100)).success());
+    fs::remove_all(dir);
+}
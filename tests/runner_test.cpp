@@ -10,10 +10,27 @@
 
 #include "dagra/execution/runner.hpp"
 #include "dagra/core/dag.hpp"
-#include "dagra/utils/logger.hpp" // For Logger to redirect output if needed
+#include "dagra/execution/process.hpp"
+#include "dagra/utils/logger.hpp" // For Logger::flush before inspecting output
+#include "test_support.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using dagra::test::make_task;
 
 // Test fixture for Runner tests
 class RunnerTest : public ::testing::Test {
@@ -27,9 +44,9 @@ protected:
 
     void SetUp() override {
         // Add some tasks for testing a linear dependency chain
-        dag.add_task({"task-a", "echo A", {}});
-        dag.add_task({"task-b", "echo B", {"task-a"}});
-        dag.add_task({"task-c", "echo C", {"task-b"}});
+        dag.add_task(make_task("task-a", "echo A"));
+        dag.add_task(make_task("task-b", "echo B", {"task-a"}));
+        dag.add_task(make_task("task-c", "echo C", {"task-b"}));
 
         // Redirect std::cout to our stringstream
         old_cout_buf = std::cout.rdbuf();
@@ -41,11 +58,19 @@ protected:
     }
 
     void TearDown() override {
+        // Let the logger's writer thread finish before the streams are restored
+        dagra::utils::Logger::flush();
         // Restore std::cout
         std::cout.rdbuf(old_cout_buf);
         // Restore std::cerr
         std::cerr.rdbuf(old_cerr_buf);
     }
+
+    // Returns everything logged so far
+    std::string output() {
+        dagra::utils::Logger::flush();
+        return captured_output.str();
+    }
 };
 
 /**
@@ -59,7 +84,7 @@ TEST_F(RunnerTest, DryRunPrintsExecutionPlan) {
     dagra::execution::Runner runner(dag, true); // dry_run = true
     runner.execute_all();
 
-    std::string output = captured_output.str();
+    std::string output = this->output();
     
     // Check for expected dry-run messages and task IDs in the output
     EXPECT_NE(output.find("[DRY-RUN] Starting dry run."), std::string::npos);
@@ -82,16 +107,471 @@ TEST_F(RunnerTest, DryRunPrintsExecutionPlan) {
 TEST_F(RunnerTest, DryRunDetectsDeadlock) {
     // Clear previous tasks and set up a cycle
     dagra::core::Dag cyclic_dag;
-    cyclic_dag.add_task({"t1", "cmd1", {"t2"}});
-    cyclic_dag.add_task({"t2", "cmd2", {"t1"}});
+    cyclic_dag.add_task(make_task("t1", "cmd1", {"t2"}));
+    cyclic_dag.add_task(make_task("t2", "cmd2", {"t1"}));
 
     dagra::execution::Runner runner(cyclic_dag, true); // dry_run = true
     runner.execute_all();
 
-    std::string output = captured_output.str();
+    std::string output = this->output();
     
     // Check for deadlock detection message and involved tasks
     EXPECT_NE(output.find("[ERROR]   Deadlock detected in dry run."), std::string::npos);
     EXPECT_NE(output.find("- Task: t1"), std::string::npos);
     EXPECT_NE(output.find("- Task: t2"), std::string::npos);
 }
+
+/**
+ * @brief Tests that a real run executes every task and reports success.
+ */
+TEST_F(RunnerTest, ExecutesAllTasks) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("first", "true"));
+    run_dag.add_task(make_task("second", "true", {"first"}));
+    run_dag.add_task(make_task("third", "true", {"first"}));
+
+    dagra::execution::Runner runner(run_dag);
+    EXPECT_NO_THROW(runner.execute_all());
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("Success: [first]"), std::string::npos);
+    EXPECT_NE(output.find("Success: [second]"), std::string::npos);
+    EXPECT_NE(output.find("Success: [third]"), std::string::npos);
+}
+
+/**
+ * @brief Tests that a failing task halts the run with an error.
+ */
+TEST_F(RunnerTest, FailingTaskThrows) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("broken", "false"));
+    run_dag.add_task(make_task("never", "true", {"broken"}));
+
+    dagra::execution::Runner runner(run_dag);
+    EXPECT_THROW(runner.execute_all(), std::runtime_error);
+    EXPECT_EQ(output().find("Success: [never]"), std::string::npos);
+}
+
+/**
+ * @brief Tests that task output is prefixed and that a failure shows the task's last output.
+ */
+TEST_F(RunnerTest, FailureShowsOutputTail) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("noisy", "sh -c 'echo compiling; echo boom >&2; exit 3'"));
+
+    dagra::execution::Runner runner(run_dag);
+    EXPECT_THROW(runner.execute_all(), std::runtime_error);
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("[noisy] compiling\n"), std::string::npos);
+    EXPECT_NE(output.find("Last output of [noisy]:"), std::string::npos);
+    EXPECT_NE(output.find("    | boom\n"), std::string::npos);
+}
+
+/**
+ * @brief Tests that a single job slot still runs a wide fan-out to completion.
+ */
+TEST_F(RunnerTest, SingleJobRunsFanOut) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("root", "true"));
+    for (int i = 0; i < 8; ++i) {
+        run_dag.add_task(make_task("leaf-" + std::to_string(i), "true", {"root"}));
+    }
+
+    dagra::execution::RunnerOptions options;
+    options.jobs = 1;
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("up to 1 parallel jobs"), std::string::npos);
+    EXPECT_NE(output.find("Success: [leaf-7]"), std::string::npos);
+}
+
+/**
+ * @brief Tests that `trace_path` produces a Chrome trace with a slice per task and the queueing spans.
+ */
+TEST_F(RunnerTest, WritesChromeTrace) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("fetch", "true"));
+    run_dag.add_task(make_task("build \"all\"", "true", {"fetch"}));
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "dagra_runner_trace.json";
+    std::filesystem::remove(path);
+
+    dagra::execution::RunnerOptions options;
+    options.trace_path = path.string();
+    dagra::execution::Runner runner(run_dag, options);
+    ASSERT_NO_THROW(runner.execute_all());
+
+    std::ifstream in(path);
+    std::stringstream trace;
+    trace << in.rdbuf();
+    const std::string json = trace.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"ph\":\"X\",\"cat\":\"task\",\"name\":\"fetch\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"build \\\"all\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"cat\":\"process\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"b\",\"cat\":\"ready\""), std::string::npos);
+    EXPECT_NE(json.find("\"outcome\":\"succeeded\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker "), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Tests that an in-process executor replaces process spawning and its result is honoured.
+ */
+TEST_F(RunnerTest, InProcessExecutor) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("one", "this-command-does-not-exist"));
+    run_dag.add_task(make_task("two", "this-command-does-not-exist", {"one"}));
+
+    std::atomic<int> calls{0};
+    dagra::execution::RunnerOptions options;
+    options.executor = [&](const dagra::core::Task&) {
+        ++calls;
+        return true;
+    };
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+    EXPECT_EQ(calls.load(), 2);
+
+    options.executor = [&](const dagra::core::Task& task) { return task.id != "one"; };
+    dagra::execution::Runner failing(run_dag, options);
+    EXPECT_THROW(failing.execute_all(), std::runtime_error);
+}
+
+/**
+ * @brief Tests that tasks sharing a single-slot pool never run at the same time.
+ */
+TEST_F(RunnerTest, ResourcePoolLimitsConcurrency) {
+    dagra::core::Dag run_dag;
+    for (int i = 0; i < 6; ++i) {
+        dagra::core::Task task = make_task("migrate-" + std::to_string(i), "true");
+        task.resources = {{"db", 1.0}};
+        run_dag.add_task(task);
+    }
+
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    dagra::execution::RunnerOptions options;
+    options.jobs = 4;
+    options.resource_pools = {{"db", 1.0}};
+    options.executor = [&](const dagra::core::Task&) {
+        const int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --active;
+        return true;
+    };
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+    EXPECT_EQ(peak.load(), 1);
+
+    options.resource_pools.clear();
+    dagra::execution::Runner undeclared(run_dag, options);
+    EXPECT_THROW(undeclared.execute_all(), std::runtime_error);
+}
+
+/**
+ * @brief Tests that a task waiting for a worker does not hold pool capacity that a better task needs.
+ *
+ * With one worker, `queued` is ready while `root` runs. It must not take the
+ * `db` slot until a worker is free, so `critical`, released by `root`, is
+ * admitted first.
+ */
+TEST_F(RunnerTest, ResourcesAreHeldOnlyByStartedTasks) {
+    dagra::core::Dag run_dag;
+    dagra::core::Task root = make_task("root", "true");
+    root.cost = 10.0;
+    dagra::core::Task critical = make_task("critical", "true", {"root"});
+    critical.cost = 100.0;
+    critical.resources = {{"db", 1.0}};
+    dagra::core::Task queued = make_task("queued", "true");
+    queued.cost = 9.0;
+    queued.resources = {{"db", 1.0}};
+    run_dag.add_task(root);
+    run_dag.add_task(critical);
+    run_dag.add_task(queued);
+    run_dag.validate();
+
+    std::mutex mtx;
+    std::vector<std::string> order;
+    dagra::execution::RunnerOptions options;
+    options.jobs = 1;
+    options.resource_pools = {{"db", 1.0}};
+    options.executor = [&](const dagra::core::Task& task) {
+        std::lock_guard<std::mutex> lock(mtx);
+        order.push_back(task.id);
+        return true;
+    };
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+    EXPECT_EQ(order, (std::vector<std::string>{"root", "critical", "queued"}));
+}
+
+/**
+ * @brief Tests that the event loop runs hundreds of tasks at once and reports failures and timeouts.
+ */
+TEST_F(RunnerTest, EventLoopRunsTasksConcurrently) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("root", "true"));
+    for (int i = 0; i < 300; ++i) {
+        run_dag.add_task(make_task("sleep-" + std::to_string(i), "sleep 0.5", {"root"}));
+    }
+    run_dag.add_task(make_task("noisy", "sh -c 'echo compiling; echo boom >&2; exit 3'", {"root"}));
+    dagra::core::Task slow = make_task("slow", "sleep 10", {"root"});
+    slow.timeout_seconds = 1;
+    run_dag.add_task(slow);
+    run_dag.add_task(make_task("after-sleep", "echo done", {"sleep-299"}));
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "dagra_event_loop_trace.json";
+    dagra::execution::RunnerOptions options;
+    options.event_loop = true;
+    options.jobs = 400;
+    options.keep_going = true;
+    options.kill_grace = std::chrono::milliseconds(100);
+    options.trace_path = path.string();
+    dagra::execution::Runner runner(run_dag, options);
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_THROW(runner.execute_all(), std::runtime_error);
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(10));
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("up to 400 parallel jobs on an event loop"), std::string::npos);
+    EXPECT_NE(output.find("[after-sleep] done\n"), std::string::npos);
+    EXPECT_NE(output.find("Last output of [noisy]:"), std::string::npos);
+    EXPECT_NE(output.find("    | boom\n"), std::string::npos);
+    EXPECT_NE(output.find("Timeout: [slow] exceeded 1 seconds"), std::string::npos);
+    EXPECT_NE(output.find("Summary: 302 succeeded, 2 failed, 0 skipped."), std::string::npos);
+
+    std::ifstream in(path);
+    std::stringstream trace;
+    trace << in.rdbuf();
+    EXPECT_NE(trace.str().find("\"name\":\"worker 0\""), std::string::npos);
+    EXPECT_EQ(trace.str().find("\"name\":\"worker 400\""), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Tests that a critical-path task released mid-run starts ahead of cheaper siblings already ready.
+ *
+ * With two workers, `root` and one sibling start first. When `root`
+ * finishes, `critical` heads the priority heap and must take the next free
+ * worker instead of waiting behind the siblings.
+ */
+TEST_F(RunnerTest, CriticalTaskReleasedLaterStartsNext) {
+    const std::filesystem::path started = std::filesystem::temp_directory_path() / "dagra_runner_priority.txt";
+    std::filesystem::remove(started);
+
+    dagra::core::Dag run_dag;
+    dagra::core::Task root = make_task("root", "echo root >> " + started.string());
+    dagra::core::Task critical = make_task("critical", "echo critical >> " + started.string(), {"root"});
+    critical.cost = 100.0;
+    run_dag.add_task(root);
+    run_dag.add_task(critical);
+    for (int i = 0; i < 10; ++i) {
+        dagra::core::Task sibling = make_task("sibling-" + std::to_string(i),
+                                  "echo sibling >> " + started.string() + "; sleep 0.2");
+        sibling.cost = 0.1;
+        run_dag.add_task(sibling);
+    }
+    run_dag.validate();
+
+    dagra::execution::RunnerOptions options;
+    options.jobs = 2;
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+
+    std::ifstream in(started);
+    std::vector<std::string> order;
+    for (std::string line; std::getline(in, line);) {
+        order.push_back(line);
+    }
+    ASSERT_EQ(order.size(), 12u);
+    const auto position = std::find(order.begin(), order.end(), "critical") - order.begin();
+    EXPECT_LE(position, 2);
+    std::filesystem::remove(started);
+}
+
+/**
+ * @brief Tests that keep-going skips only a failed task's dependents and ends with a summary.
+ */
+TEST_F(RunnerTest, KeepGoingSkipsOnlyDownstream) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("root", "true"));
+    run_dag.add_task(make_task("broken", "false", {"root"}));
+    run_dag.add_task(make_task("after-broken", "true", {"broken"}));
+    run_dag.add_task(make_task("last", "true", {"after-broken"}));
+    run_dag.add_task(make_task("independent", "true", {"root"}));
+    run_dag.add_task(make_task("after-independent", "true", {"independent"}));
+
+    dagra::execution::RunnerOptions options;
+    options.keep_going = true;
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_THROW(runner.execute_all(), std::runtime_error);
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("Success: [after-independent]"), std::string::npos);
+    EXPECT_EQ(output.find("Running: [after-broken]"), std::string::npos);
+    EXPECT_NE(output.find("Skipping 2 task(s) that depend on [broken]: after-broken, last"), std::string::npos);
+    EXPECT_NE(output.find("Summary: 3 succeeded, 1 failed, 2 skipped."), std::string::npos);
+    EXPECT_NE(output.find("Failed tasks: broken"), std::string::npos);
+}
+
+/**
+ * @brief Tests that a task allowed to fail neither fails the run nor blocks its dependents.
+ */
+TEST_F(RunnerTest, AllowFailureContinues) {
+    dagra::core::Task flaky = make_task("flaky", "false");
+    flaky.allow_failure = true;
+    dagra::core::Dag run_dag;
+    run_dag.add_task(flaky);
+    run_dag.add_task(make_task("after", "true", {"flaky"}));
+
+    dagra::execution::Runner runner(run_dag);
+    EXPECT_NO_THROW(runner.execute_all());
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("Continuing: [flaky] is allowed to fail."), std::string::npos);
+    EXPECT_NE(output.find("Success: [after]"), std::string::npos);
+    EXPECT_NE(output.find("Summary: 1 succeeded, 0 failed, 1 failed (allowed), 0 skipped."), std::string::npos);
+}
+
+/**
+ * @brief Tests that fused chains and batches run in one shell each and still report every task.
+ */
+TEST_F(RunnerTest, FusedTasksReportIndividually) {
+    dagra::core::Dag run_dag;
+    run_dag.add_task(make_task("gen", "echo gen"));
+    run_dag.add_task(make_task("compile", "exit 3", {"gen"}));
+    run_dag.add_task(make_task("link", "echo link", {"compile"}));
+    for (const char* id : {"lint-a", "lint-b", "lint-c"}) {
+        dagra::core::Task lint = make_task(id, std::string("echo ") + id);
+        lint.batchable = true;
+        run_dag.add_task(lint);
+    }
+    run_dag.validate();
+
+    dagra::execution::RunnerOptions options;
+    options.fuse = true;
+    options.keep_going = true;
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_THROW(runner.execute_all(), std::runtime_error);
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("Task fusion: 6 tasks run as 2 invocations."), std::string::npos);
+    EXPECT_NE(output.find("Running: [gen..link] -> 3 fused tasks"), std::string::npos);
+    EXPECT_NE(output.find("Running: [lint-a..lint-c] -> 3 fused tasks"), std::string::npos);
+    EXPECT_NE(output.find("Success: [gen]"), std::string::npos);
+    EXPECT_NE(output.find("Failed: [compile] (Exit code: 3)"), std::string::npos);
+    EXPECT_NE(output.find("Skipping 1 task(s) that depend on [compile]: link"), std::string::npos);
+    EXPECT_EQ(output.find("[gen..link] link"), std::string::npos);
+    EXPECT_NE(output.find("[lint-a..lint-c] lint-c"), std::string::npos);
+    EXPECT_NE(output.find("Summary: 4 succeeded, 1 failed, 1 skipped."), std::string::npos);
+}
+
+/**
+ * @brief Tests that tasks with a worker are sent to the echo worker and report its replies.
+ */
+TEST_F(RunnerTest, WorkerTasksUsePersistentWorkers) {
+    dagra::core::Dag run_dag;
+    for (const char* command : {"lint a.py", "lint b.py", "exit 4"}) {
+        dagra::core::Task lint = make_task(std::string("worker-") + command, command);
+        lint.worker = DAGRA_ECHO_WORKER;
+        lint.allow_failure = true;
+        run_dag.add_task(lint);
+    }
+    run_dag.validate();
+
+    dagra::execution::RunnerOptions options;
+    options.jobs = 1;
+    dagra::execution::Runner runner(run_dag, options);
+    EXPECT_NO_THROW(runner.execute_all());
+
+    std::string output = this->output();
+    EXPECT_NE(output.find("[worker-lint a.py] lint a.py"), std::string::npos);
+    EXPECT_NE(output.find("[worker-lint b.py] lint b.py"), std::string::npos);
+    EXPECT_NE(output.find("Failed: [worker-exit 4] (Exit code: 4)"), std::string::npos);
+    EXPECT_NE(output.find("Summary: 2 succeeded, 0 failed, 1 failed (allowed), 0 skipped."), std::string::npos);
+}
+
+/**
+ * @brief Tests that a resumed run skips the tasks the journal records and reruns the rest.
+ */
+TEST_F(RunnerTest, ResumeSkipsJournaledTasks) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "dagra_runner_resume";
+    std::filesystem::remove_all(dir);
+    const std::string marker = (dir / "ran").string();
+
+    dagra::core::Dag run_dag;
+    dagra::core::Task lint = make_task("lint", "echo lint >> " + marker + "; false", {"fetch"});
+    lint.allow_failure = true;
+    run_dag.add_task(make_task("fetch", "echo fetch >> " + marker));
+    run_dag.add_task(lint);
+    run_dag.add_task(
+        make_task("build", "echo build >> " + marker + "; test -f " + (dir / "fixed").string(), {"lint"}));
+    run_dag.add_task(make_task("package", "echo package >> " + marker, {"build"}));
+    run_dag.validate();
+    std::filesystem::create_directories(dir);
+
+    dagra::execution::RunnerOptions options;
+    options.journal_path = (dir / "config.yaml.journal").string();
+    EXPECT_THROW(dagra::execution::Runner(run_dag, options).execute_all(), std::runtime_error);
+
+    std::ofstream(dir / "fixed").close();
+    options.resume = true;
+    EXPECT_NO_THROW(dagra::execution::Runner(run_dag, options).execute_all());
+
+    std::ifstream ran(marker);
+    std::stringstream lines;
+    lines << ran.rdbuf();
+    EXPECT_EQ(lines.str(), "fetch\nlint\nbuild\nbuild\npackage\n");
+    std::string output = this->output();
+    EXPECT_NE(output.find("Resuming: 2 of 4 tasks were completed by an earlier run."), std::string::npos);
+    EXPECT_NE(output.find("Summary: 2 succeeded, 2 resumed, 0 failed, 0 skipped."), std::string::npos);
+    std::filesystem::remove_all(dir);
+}
+
+/**
+ * @brief Tests that SIGINT to a dagra run terminates and reaps the running task's process group.
+ *
+ * Tasks run in their own process groups, so the interrupt reaches only
+ * dagra, which must cancel the run instead of leaving the groups behind.
+ */
+TEST_F(RunnerTest, InterruptStopsRunningTaskGroups) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "dagra_runner_interrupt";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string pid_file = (dir / "task.pid").string();
+    std::ofstream(dir / "config.yaml") << "tasks:\n"
+                                          "  - id: long\n"
+                                          "    command: \"echo $$ > " + pid_file + "; exec sleep 37\"\n";
+
+    const int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    dagra::execution::Process run = dagra::execution::Process::spawn(
+        make_task("dagra", std::string(DAGRA_BINARY) + " " + (dir / "config.yaml").string()), null_fd, null_fd);
+    close(null_fd);
+    ASSERT_GT(run.pid(), 0);
+
+    pid_t group = 0;
+    for (int i = 0; i < 500 && group == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::ifstream(pid_file) >> group;
+    }
+    ASSERT_GT(group, 0);
+    ASSERT_EQ(kill(-group, 0), 0);
+
+    kill(run.pid(), SIGINT);
+    const dagra::execution::ExitStatus status =
+        run.wait_with_timeout(std::chrono::seconds(10), std::chrono::milliseconds(100));
+    EXPECT_FALSE(status.timed_out);
+    EXPECT_EQ(status.code, 1);
+    EXPECT_EQ(status.signal, 0);
+
+    EXPECT_EQ(kill(-group, 0), -1);
+    EXPECT_EQ(errno, ESRCH);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,221 @@
+/**
+ * @file scheduler_test.cpp
+ * @brief Unit tests for the execution::Scheduler class.
+ * @version 1.1.0
+ *
+ * This file contains tests for the dependency-tracking ready queue, checking
+ * that tasks are released exactly when their last dependency completes.
+ */
+
+#include "dagra/execution/scheduler.hpp"
+#include "dagra/core/dag.hpp"
+#include "test_support.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief Finds the scheduler index of the task with the given ID.
+    size_t index_of(const dagra::execution::Scheduler& scheduler, const std::string& id) {
+        for (size_t i = 0; i < scheduler.size(); ++i) {
+            if (scheduler.task(i).id == id) {
+                return i;
+            }
+        }
+        return scheduler.size();
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that only dependency-free tasks are ready initially.
+ */
+TEST(SchedulerTest, InitialReadySet) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "cmd", {"a"}));
+
+    dagra::execution::Scheduler scheduler(dag);
+    ASSERT_TRUE(scheduler.has_ready());
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "a");
+    EXPECT_FALSE(scheduler.has_ready());
+}
+
+/**
+ * @brief Tests that a dependent is released as soon as its own dependencies finish,
+ *        regardless of unrelated tasks that are still pending.
+ */
+TEST(SchedulerTest, ReleasesDependentOnLastDependency) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("slow", "cmd"));
+    dag.add_task(make_task("fast", "cmd"));
+    dag.add_task(make_task("after-fast", "cmd", {"fast"}));
+    dag.add_task(make_task("join", "cmd", {"slow", "fast"}));
+
+    dagra::execution::Scheduler scheduler(dag);
+    while (scheduler.has_ready()) {
+        scheduler.pop_ready();
+    }
+
+    scheduler.mark_completed(index_of(scheduler, "fast"));
+    ASSERT_TRUE(scheduler.has_ready());
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "after-fast");
+    EXPECT_FALSE(scheduler.has_ready());
+
+    scheduler.mark_completed(index_of(scheduler, "slow"));
+    ASSERT_TRUE(scheduler.has_ready());
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "join");
+}
+
+/**
+ * @brief Tests that tasks with an unknown dependency never become ready.
+ */
+TEST(SchedulerTest, MissingDependencyBlocksTask) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd", {"ghost"}));
+
+    dagra::execution::Scheduler scheduler(dag);
+    EXPECT_FALSE(scheduler.has_ready());
+    EXPECT_FALSE(scheduler.finished());
+}
+
+/**
+ * @brief Tests that the ready task heading the longest chain is dispatched first.
+ */
+TEST(SchedulerTest, DispatchesCriticalPathFirst) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("short", "cmd"));
+    dag.add_task(make_task("long-1", "cmd"));
+    dag.add_task(make_task("long-2", "cmd", {"long-1"}));
+    dag.add_task(make_task("long-3", "cmd", {"long-2"}));
+
+    dagra::execution::Scheduler scheduler(dag);
+    EXPECT_DOUBLE_EQ(scheduler.priority(index_of(scheduler, "long-1")), 3.0);
+    EXPECT_DOUBLE_EQ(scheduler.priority(index_of(scheduler, "short")), 1.0);
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "long-1");
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "short");
+}
+
+/**
+ * @brief Tests that weights override chain length and that ties keep declaration order.
+ */
+TEST(SchedulerTest, WeightsAndDeterministicTies) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "cmd"));
+    dag.add_task(make_task("c", "cmd"));
+    dag.add_task(make_task("after-a", "cmd", {"a"}));
+
+    // "c" alone outweighs the chain a -> after-a; "a" and "b" then tie.
+    dagra::execution::Scheduler scheduler(dag, {1.0, 3.0, 10.0, 2.0});
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "c");
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "a");
+    EXPECT_EQ(scheduler.task(scheduler.pop_ready()).id, "b");
+}
+
+/**
+ * @brief Tests that a failure skips exactly the transitive dependents and leaves other branches runnable.
+ */
+TEST(SchedulerTest, FailureSkipsOnlyDownstream) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("root", "cmd"));
+    dag.add_task(make_task("bad", "cmd", {"root"}));
+    dag.add_task(make_task("good", "cmd", {"root"}));
+    dag.add_task(make_task("after-bad", "cmd", {"bad"}));
+    dag.add_task(make_task("join", "cmd", {"after-bad", "good"}));
+    dag.add_task(make_task("after-good", "cmd", {"good"}));
+
+    dagra::execution::Scheduler scheduler(dag);
+    scheduler.mark_completed(scheduler.pop_ready());
+    ASSERT_EQ(scheduler.task(scheduler.pop_ready()).id, "bad");
+    ASSERT_EQ(scheduler.task(scheduler.pop_ready()).id, "good");
+
+    std::vector<dagra::core::TaskIndex> skipped = scheduler.mark_failed(index_of(scheduler, "bad"));
+    ASSERT_EQ(skipped.size(), 2u);
+    EXPECT_EQ(scheduler.task(skipped[0]).id, "after-bad");
+    EXPECT_EQ(scheduler.task(skipped[1]).id, "join");
+    EXPECT_FALSE(scheduler.finished());
+
+    scheduler.mark_completed(index_of(scheduler, "good"));
+    ASSERT_TRUE(scheduler.has_ready());
+    size_t next = scheduler.pop_ready();
+    EXPECT_EQ(scheduler.task(next).id, "after-good");
+    EXPECT_FALSE(scheduler.has_ready());
+    scheduler.mark_completed(next);
+    EXPECT_TRUE(scheduler.finished());
+    EXPECT_EQ(scheduler.completed_count(), 3u);
+}
+
+/**
+ * @brief Tests that tasks are admitted only while their resources fit, with smaller tasks backfilled.
+ */
+TEST(SchedulerTest, AdmitsByResourcesAndBackfills) {
+    dagra::core::Dag dag;
+    dagra::core::Task big = make_task("big", "cmd");
+    big.resources = {{"cpu", 3.0}};
+    dagra::core::Task medium = make_task("medium", "cmd");
+    medium.resources = {{"cpu", 2.0}, {"db", 1.0}};
+    dagra::core::Task small = make_task("small", "cmd");
+    small.resources = {{"cpu", 1.0}, {"db", 1.0}};
+    dagra::core::Task free_task = make_task("free", "cmd");
+    dag.add_task(medium);
+    dag.add_task(big);
+    dag.add_task(small);
+    dag.add_task(free_task);
+
+    // Priorities follow declaration order: medium, big, small, free.
+    dagra::execution::Scheduler scheduler(dag, {4.0, 3.0, 2.0, 1.0});
+    scheduler.set_capacity({{"cpu", 4.0}, {"db", 1.0}});
+
+    size_t index = 0;
+    ASSERT_TRUE(scheduler.pop_admissible(index));
+    EXPECT_EQ(scheduler.task(index).id, "medium");
+    // "big" needs 3 cpu but only 2 are left, and "small" needs the busy db: only "free" fits.
+    ASSERT_TRUE(scheduler.pop_admissible(index));
+    EXPECT_EQ(scheduler.task(index).id, "free");
+    EXPECT_FALSE(scheduler.pop_admissible(index));
+
+    scheduler.mark_completed(index_of(scheduler, "medium"));
+    ASSERT_TRUE(scheduler.pop_admissible(index));
+    EXPECT_EQ(scheduler.task(index).id, "big");
+    ASSERT_TRUE(scheduler.pop_admissible(index));
+    EXPECT_EQ(scheduler.task(index).id, "small");
+    EXPECT_FALSE(scheduler.has_ready());
+
+    dagra::core::Task greedy = make_task("greedy", "cmd");
+    greedy.resources = {{"gpu", 1.0}};
+    dag.add_task(greedy);
+    dagra::execution::Scheduler unknown(dag);
+    EXPECT_THROW(unknown.set_capacity({{"cpu", 4.0}, {"db", 1.0}}), std::runtime_error);
+    EXPECT_THROW(unknown.set_capacity({{"cpu", 2.0}, {"db", 1.0}, {"gpu", 1.0}}), std::runtime_error);
+}
+
+/**
+ * @brief Tests that tasks completed by an earlier run release their dependents before dispatch.
+ */
+TEST(SchedulerTest, ResumedTasksAreNotDispatched) {
+    dagra::core::Dag dag;
+    dag.add_task(make_task("a", "cmd"));
+    dag.add_task(make_task("b", "cmd", {"a"}));
+    dag.add_task(make_task("c", "cmd", {"b"}));
+    dag.add_task(make_task("d", "cmd"));
+    dag.validate();
+
+    dagra::execution::Scheduler scheduler(dag);
+    scheduler.mark_resumed({1, 1, 0, 0});
+    EXPECT_EQ(scheduler.completed_count(), 2u);
+    EXPECT_TRUE(scheduler.is_completed(index_of(scheduler, "b")));
+
+    std::vector<std::string> dispatched;
+    while (scheduler.has_ready()) {
+        const size_t index = scheduler.pop_ready();
+        dispatched.push_back(scheduler.task(index).id);
+        scheduler.mark_completed(index);
+    }
+    EXPECT_EQ(dispatched, (std::vector<std::string>{"c", "d"}));
+    EXPECT_TRUE(scheduler.finished());
+}
@@ -0,0 +1,35 @@
+/**
+ * @file test_support.hpp
+ * @brief Helpers shared by the Dagra unit tests.
+ * @version 1.1.0
+ *
+ * This file contains the task builder the tests use instead of positional
+ * aggregate initializers, which leave every later `Task` field unnamed and
+ * trip `-Wmissing-field-initializers`.
+ */
+
+#pragma once
+
+#include "dagra/core/task.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dagra::test {
+
+    /**
+     * @brief Builds a task with the given ID, command and dependencies; every other field keeps its default.
+     * @param id The task ID.
+     * @param command The command to run.
+     * @param dependencies The IDs of the tasks it depends on.
+     * @return The task.
+     */
+    inline core::Task make_task(std::string id, std::string command, std::vector<std::string> dependencies = {}) {
+        core::Task task;
+        task.id = std::move(id);
+        task.command = std::move(command);
+        task.dependencies = std::move(dependencies);
+        return task;
+    }
+
+} // namespace dagra::test
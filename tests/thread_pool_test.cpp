@@ -0,0 +1,78 @@
+/**
+ * @file thread_pool_test.cpp
+ * @brief Unit tests for the execution::ThreadPool class.
+ * @version 1.1.0
+ *
+ * This file contains tests for the work-stealing thread pool, checking that
+ * every submitted job runs, also when submitted from several threads, and
+ * that concurrency never exceeds the pool size.
+ */
+
+#include "dagra/execution/thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Tests that every submitted job is executed before the pool is destroyed.
+ */
+TEST(ThreadPoolTest, RunsAllJobs) {
+    std::atomic<int> counter{0};
+    {
+        dagra::execution::ThreadPool pool(4);
+        EXPECT_EQ(pool.size(), 4u);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&counter]() { ++counter; });
+        }
+    }
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+/**
+ * @brief Tests that no more jobs run concurrently than there are workers.
+ */
+TEST(ThreadPoolTest, BoundsConcurrency) {
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    {
+        dagra::execution::ThreadPool pool(2);
+        for (int i = 0; i < 16; ++i) {
+            pool.submit([&]() {
+                int now = ++active;
+                int seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                --active;
+            });
+        }
+    }
+    EXPECT_LE(peak.load(), 2);
+}
+
+/**
+ * @brief Tests that jobs submitted from several threads at once, including the workers, all run.
+ */
+TEST(ThreadPoolTest, RunsJobsSubmittedConcurrently) {
+    std::atomic<int> counter{0};
+    {
+        dagra::execution::ThreadPool pool(4);
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < 4; ++t) {
+            submitters.emplace_back([&]() {
+                for (int i = 0; i < 500; ++i) {
+                    pool.submit([&]() {
+                        ++counter;
+                        pool.submit([&counter]() { ++counter; });
+                    });
+                }
+            });
+        }
+        for (auto& submitter : submitters) {
+            submitter.join();
+        }
+    }
+    EXPECT_EQ(counter.load(), 4000);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file watch_test.cpp
+ * @brief Unit tests for the watch::FileWatcher and watch::WatchSession classes.
+ * @version 1.1.0
+ *
+ * This file contains tests for detecting changes to watched inputs and for
+ * rerunning only the tasks affected by a change.
+ */
+
+#include "dagra/watch/file_watcher.hpp"
+#include "dagra/watch/watch_session.hpp"
+#include "dagra/utils/logger.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief Creates an empty scratch directory for one test.
+    fs::path scratch_directory(const std::string& name) {
+        const fs::path directory = fs::temp_directory_path() / ("dagra_watch_test_" + name);
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+        return directory;
+    }
+
+    void write_file(const fs::path& path, const std::string& content) {
+        std::ofstream out(path, std::ios::trunc);
+        out << content;
+    }
+
+    /// @brief Counts the lines of a file; a missing file has none.
+    std::size_t line_count(const fs::path& path) {
+        std::ifstream in(path);
+        std::size_t lines = 0;
+        for (std::string line; std::getline(in, line);) {
+            ++lines;
+        }
+        return lines;
+    }
+
+    /// @brief Polls a condition until it holds or five seconds have passed.
+    bool eventually(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (condition()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return condition();
+    }
+
+} // namespace
+
+/**
+ * @brief Tests that a write to a watched file is reported under its declared path and unrelated files are ignored.
+ */
+TEST(WatchTest, FileWatcherReportsWatchedFiles) {
+    const fs::path directory = scratch_directory("watcher");
+    const std::string watched = (directory / "watched.txt").string();
+    write_file(watched, "a");
+
+    dagra::watch::FileWatcher watcher;
+    ASSERT_TRUE(watcher.add(watched));
+    EXPECT_FALSE(watcher.add((directory / "missing" / "file.txt").string()));
+
+    write_file(directory / "unrelated.txt", "b");
+    write_file(watched, "c");
+
+    pollfd fds{watcher.fd(), POLLIN, 0};
+    ASSERT_EQ(poll(&fds, 1, 5000), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(watcher.read_changes(), (std::vector<std::string>{watched}));
+    EXPECT_TRUE(watcher.read_changes().empty());
+
+    fs::remove_all(directory);
+}
+
+/**
+ * @brief Tests that a session runs everything once, then reruns only the changed task's dependent closure.
+ */
+TEST(WatchTest, RerunsAffectedSubgraph) {
+    const fs::path directory = scratch_directory("session");
+    const std::string source = (directory / "source.txt").string();
+    const std::string copy = (directory / "copy.txt").string();
+    const std::string other = (directory / "other.txt").string();
+    const fs::path use_log = directory / "use.log";
+    const fs::path other_log = directory / "other.log";
+    write_file(source, "1");
+    write_file(other, "1");
+
+    dagra::core::Dag dag;
+    dagra::core::Task produce = make_task("produce", "cp " + source + " " + copy);
+    produce.inputs = {source};
+    produce.outputs = {copy};
+    dagra::core::Task use = make_task("use", "echo run >> " + use_log.string(), {"produce"});
+    use.inputs = {copy};
+    dagra::core::Task unrelated = make_task("unrelated", "echo run >> " + other_log.string());
+    unrelated.inputs = {other};
+    dag.add_task(produce);
+    dag.add_task(use);
+    dag.add_task(unrelated);
+    dag.validate();
+
+    dagra::watch::WatchOptions options;
+    options.debounce = std::chrono::milliseconds(20);
+    options.stop_fd = eventfd(0, EFD_CLOEXEC);
+    ASSERT_GE(options.stop_fd, 0);
+
+    std::thread session([&]() { dagra::watch::WatchSession(dag, options).run(); });
+
+    EXPECT_TRUE(eventually([&]() { return line_count(use_log) == 1 && line_count(other_log) == 1; }));
+    // Let the first run finish before changing its input.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    write_file(source, "2");
+    EXPECT_TRUE(eventually([&]() { return line_count(use_log) == 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(line_count(other_log), 1u);
+    EXPECT_EQ(line_count(use_log), 2u);
+
+    std::uint64_t one = 1;
+    ASSERT_EQ(write(options.stop_fd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    session.join();
+    close(options.stop_fd);
+    dagra::utils::Logger::flush();
+
+    fs::remove_all(directory);
+}
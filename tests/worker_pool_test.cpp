@@ -0,0 +1,118 @@
+/**
+ * @file worker_pool_test.cpp
+ * @brief Unit tests for the execution::WorkerPool class.
+ * @version 1.1.0
+ *
+ * This file contains tests for the worker protocol helpers and for reuse,
+ * recycling and failure handling of persistent workers, driven by the echo
+ * worker built alongside the tests.
+ */
+
+#include "dagra/execution/worker_pool.hpp"
+#include "test_support.hpp"
+#include <gtest/gtest.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using dagra::execution::WorkerOptions;
+using dagra::execution::WorkerPool;
+using dagra::execution::WorkerReply;
+using dagra::test::make_task;
+
+namespace {
+
+    /// @brief A task served by the echo worker.
+    dagra::core::Task echo_task(const std::string& command) {
+        dagra::core::Task task = make_task("lint", command);
+        task.worker = DAGRA_ECHO_WORKER;
+        return task;
+    }
+
+    constexpr std::chrono::milliseconds NO_TIMEOUT{0};
+
+} // namespace
+
+/**
+ * @brief Tests the request framing and reply decoding.
+ */
+TEST(WorkerPoolTest, EncodesRequestsAndDecodesReplies) {
+    dagra::core::Task task = make_task("lint:a", "lint \"a.py\"");
+    task.inputs = {"a.py"};
+    const std::string body = R"({"id": "lint:a", "command": "lint \"a.py\"", "inputs": ["a.py"], "outputs": []})";
+    EXPECT_EQ(dagra::execution::encode_worker_request(task), std::to_string(body.size()) + "\n" + body);
+
+    int code = -1;
+    std::string output;
+    ASSERT_TRUE(dagra::execution::decode_worker_reply(R"({"exit_code": 2, "output": "line\nnext é"})", code, output));
+    EXPECT_EQ(code, 2);
+    EXPECT_EQ(output, "line\nnext \xc3\xa9");
+    ASSERT_TRUE(dagra::execution::decode_worker_reply(R"({"exit_code": 0})", code, output));
+    EXPECT_TRUE(output.empty());
+    EXPECT_FALSE(dagra::execution::decode_worker_reply(R"({"output": "x"})", code, output));
+    EXPECT_FALSE(dagra::execution::decode_worker_reply("{not json", code, output));
+}
+
+/**
+ * @brief Tests that consecutive requests are served by the same worker process.
+ */
+TEST(WorkerPoolTest, ReusesWorkers) {
+    WorkerPool pool;
+    WorkerReply echo = pool.run(echo_task("hello world"), NO_TIMEOUT);
+    ASSERT_TRUE(echo.success()) << echo.error;
+    EXPECT_EQ(echo.output, "hello world\n");
+
+    WorkerReply first = pool.run(echo_task("pid"), NO_TIMEOUT);
+    WorkerReply second = pool.run(echo_task("pid"), NO_TIMEOUT);
+    EXPECT_EQ(first.output, second.output);
+    EXPECT_NE(first.output, std::to_string(getpid()) + "\n");
+    EXPECT_EQ(pool.started(), 1u);
+}
+
+/**
+ * @brief Tests that workers are replaced after the request limit and after a failure.
+ */
+TEST(WorkerPoolTest, RecyclesWorkers) {
+    WorkerOptions options;
+    options.max_requests = 2;
+    WorkerPool pool(options);
+    const std::string first = pool.run(echo_task("pid"), NO_TIMEOUT).output;
+    EXPECT_EQ(pool.run(echo_task("pid"), NO_TIMEOUT).output, first);
+    const std::string second = pool.run(echo_task("pid"), NO_TIMEOUT).output;
+    EXPECT_NE(second, first);
+
+    WorkerReply failed = pool.run(echo_task("exit 3"), NO_TIMEOUT);
+    EXPECT_FALSE(failed.success());
+    EXPECT_TRUE(failed.error.empty());
+    EXPECT_EQ(failed.status.code, 3);
+    EXPECT_NE(pool.run(echo_task("pid"), NO_TIMEOUT).output, second);
+    EXPECT_EQ(pool.started(), 3u);
+}
+
+/**
+ * @brief Tests that a crash, a timeout and a cancellation are reported and the worker replaced.
+ */
+TEST(WorkerPoolTest, ReportsBrokenWorkers) {
+    WorkerOptions options;
+    options.kill_grace = std::chrono::milliseconds(100);
+    WorkerPool pool(options);
+
+    WorkerReply crashed = pool.run(echo_task("crash"), NO_TIMEOUT);
+    EXPECT_FALSE(crashed.success());
+    EXPECT_EQ(crashed.error, "worker exited before replying");
+
+    WorkerReply slow = pool.run(echo_task("sleep 5000"), std::chrono::milliseconds(50));
+    EXPECT_FALSE(slow.success());
+    EXPECT_TRUE(slow.status.timed_out);
+
+    const int cancel_fd = eventfd(1, EFD_CLOEXEC);
+    WorkerReply cancelled = pool.run(echo_task("sleep 5000"), NO_TIMEOUT, cancel_fd);
+    close(cancel_fd);
+    EXPECT_TRUE(cancelled.status.cancelled);
+
+    dagra::core::Task missing = echo_task("pid");
+    missing.worker = "/nonexistent/worker";
+    EXPECT_NE(pool.run(missing, NO_TIMEOUT).error.find("could not start worker"), std::string::npos);
+
+    EXPECT_TRUE(pool.run(echo_task("still works"), NO_TIMEOUT).success());
+    EXPECT_EQ(pool.started(), 4u);
+}